@@ -4,7 +4,7 @@
 #include "Document.h"
 
 #include <ftk/Core/Context.h>
-#include <ftk/Core/ImageIO.h>
+#include <ftk/Core/ImageCache.h>
 
 using namespace ftk;
 
@@ -15,14 +15,30 @@ namespace imageview
         const std::filesystem::path& path)
     {
         _path = path;
+        _image = ObservableValue<std::shared_ptr<Image> >::create();
 
-        auto io = context->getSystem<ImageIO>();
-        auto read = io->read(path);
-        _image = read->read();
+        // Get the image from the cache.
+        auto cache = context->getSystem<ImageCache>();
+        _cache = cache;
+        cache->pin(path);
+        _requestId = cache->get(
+            path,
+            ImageIOOptions(),
+            ImageIOPriority::Normal,
+            [this](const std::shared_ptr<Image>& image)
+            {
+                _image->setIfChanged(image);
+            }).id;
     }
 
     Document::~Document()
-    {}
+    {
+        if (auto cache = _cache.lock())
+        {
+            cache->cancelRequests({ _requestId });
+            cache->unpin(_path);
+        }
+    }
 
     std::shared_ptr<Document> Document::create(
         const std::shared_ptr<Context>& context,
@@ -49,6 +65,11 @@ namespace imageview
     }
 
     const std::shared_ptr<ftk::Image>& Document::getImage() const
+    {
+        return _image->get();
+    }
+
+    std::shared_ptr<ftk::IObservableValue<std::shared_ptr<ftk::Image> > > Document::observeImage() const
     {
         return _image;
     }
@@ -6,9 +6,15 @@
 #include <ftk/UI/DocumentModel.h>
 
 #include <ftk/Core/Image.h>
+#include <ftk/Core/ObservableValue.h>
 
 #include <filesystem>
 
+namespace ftk
+{
+    class ImageCache;
+}
+
 namespace imageview
 {
     //! Document.
@@ -39,14 +45,21 @@ namespace imageview
         ///@}
 
         //! \name Image
+        //!
+        //! The image is read asynchronously, and is null until it has
+        //! been read. The image is pinned in the image cache while the
+        //! document is open.
         ///@{
 
         const std::shared_ptr<ftk::Image>& getImage() const;
+        std::shared_ptr<ftk::IObservableValue<std::shared_ptr<ftk::Image> > > observeImage() const;
 
         ///@}
 
     private:
         std::filesystem::path _path;
-        std::shared_ptr<ftk::Image> _image;
+        std::weak_ptr<ftk::ImageCache> _cache;
+        uint64_t _requestId = 0;
+        std::shared_ptr<ftk::ObservableValue<std::shared_ptr<ftk::Image> > > _image;
     };
 }
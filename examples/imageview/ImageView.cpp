@@ -21,9 +21,19 @@ namespace imageview
     {
         IWidget::_init(context, "examples::imageview::ImageView", parent);
 
-        _image = doc->getImage();
         _zoom = ObservableValue<float>::create(1.F);
         _channelDisplay = ObservableValue<ChannelDisplay>::create(ChannelDisplay::Color);
+
+        // Observe the image, which is read asynchronously.
+        _imageObserver = ValueObserver<std::shared_ptr<Image> >::create(
+            doc->observeImage(),
+            [this](const std::shared_ptr<Image>& value)
+            {
+                _image = value;
+                frame();
+                setSizeUpdate();
+                setDrawUpdate();
+            });
     }
 
     ImageView::~ImageView()
@@ -62,6 +62,7 @@ namespace imageview
 
     private:
         std::shared_ptr<ftk::Image> _image;
+        std::shared_ptr<ftk::ValueObserver<std::shared_ptr<ftk::Image> > > _imageObserver;
         std::shared_ptr<ftk::ObservableValue<float> > _zoom;
         bool _frameInit = true;
         std::shared_ptr<ftk::ObservableValue<ftk::ChannelDisplay> > _channelDisplay;
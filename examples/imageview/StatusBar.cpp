@@ -36,20 +36,30 @@ namespace imageview
             app->getDocumentModel()->observeCurrent(),
             [this, appWeak](const std::shared_ptr<IDocument>& idoc)
             {
-                std::string text;
                 if (auto doc = std::dynamic_pointer_cast<Document>(idoc))
                 {
-                    if (auto image = doc->getImage())
-                    {
-                        const Size2I& size = image->getSize();
-                        text = Format("Size: {0}x{1}, Aspect ratio: {2}, Type: {3}").
-                            arg(size.w).
-                            arg(size.h).
-                            arg(image->getAspect(), 2).
-                            arg(image->getType());
-                    }
+                    _imageObserver = ValueObserver<std::shared_ptr<Image> >::create(
+                        doc->observeImage(),
+                        [this](const std::shared_ptr<Image>& image)
+                        {
+                            std::string text;
+                            if (image)
+                            {
+                                const Size2I& size = image->getSize();
+                                text = Format("Size: {0}x{1}, Aspect ratio: {2}, Type: {3}").
+                                    arg(size.w).
+                                    arg(size.h).
+                                    arg(image->getAspect(), 2).
+                                    arg(image->getType());
+                            }
+                            _labels["Info"]->setText(text);
+                        });
+                }
+                else
+                {
+                    _imageObserver.reset();
+                    _labels["Info"]->setText(std::string());
                 }
-                _labels["Info"]->setText(text);
             });
     }
 
@@ -39,5 +39,6 @@ namespace imageview
         std::shared_ptr<ftk::HorizontalLayout> _layout;
 
         std::shared_ptr<ftk::ValueObserver<std::shared_ptr<ftk::IDocument> > > _currentObserver;
+        std::shared_ptr<ftk::ValueObserver<std::shared_ptr<ftk::Image> > > _imageObserver;
     };
 }
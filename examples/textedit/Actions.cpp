@@ -43,11 +43,25 @@ namespace textedit
                         {
                             _actionsUpdate();
                         });
+                    _hasUndoObserver = ValueObserver<bool>::create(
+                        doc->getModel()->observeHasUndo(),
+                        [this](bool)
+                        {
+                            _actionsUpdate();
+                        });
+                    _hasRedoObserver = ValueObserver<bool>::create(
+                        doc->getModel()->observeHasRedo(),
+                        [this](bool)
+                        {
+                            _actionsUpdate();
+                        });
                 }
                 else
                 {
                     _changedObserver.reset();
                     _selectionObserver.reset();
+                    _hasUndoObserver.reset();
+                    _hasRedoObserver.reset();
                     _actionsUpdate();
                 }
             });
@@ -338,9 +352,14 @@ namespace textedit
         const auto doc = std::dynamic_pointer_cast<Document>(_current.lock());
         const bool current = doc.get();
         TextEditSelection selection;
+        bool hasUndo = false;
+        bool hasRedo = false;
         if (doc)
         {
-            selection = doc->getModel()->getSelection();
+            const auto& model = doc->getModel();
+            selection = model->getSelection();
+            hasUndo = model->observeHasUndo()->get();
+            hasRedo = model->observeHasRedo()->get();
         }
 
         _actions["File/Close"]->setEnabled(current);
@@ -348,8 +367,8 @@ namespace textedit
         _actions["File/Save"]->setEnabled(doc ? doc->isChanged() : false);
         _actions["File/SaveAs"]->setEnabled(current);
 
-        _actions["Edit/Undo"]->setEnabled(false);
-        _actions["Edit/Redo"]->setEnabled(false);
+        _actions["Edit/Undo"]->setEnabled(hasUndo);
+        _actions["Edit/Redo"]->setEnabled(hasRedo);
         _actions["Edit/Cut"]->setEnabled(current && selection.isValid());
         _actions["Edit/Copy"]->setEnabled(current && selection.isValid());
         _actions["Edit/Paste"]->setEnabled(current);
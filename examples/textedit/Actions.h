@@ -61,6 +61,8 @@ namespace textedit
         std::shared_ptr<ftk::ValueObserver<std::shared_ptr<ftk::IDocument> > > _currentObserver;
         std::shared_ptr<ftk::ValueObserver<bool> > _changedObserver;
         std::shared_ptr<ftk::ValueObserver<ftk::TextEditSelection> > _selectionObserver;
+        std::shared_ptr<ftk::ValueObserver<bool> > _hasUndoObserver;
+        std::shared_ptr<ftk::ValueObserver<bool> > _hasRedoObserver;
         std::shared_ptr<ftk::ValueObserver<WindowSettings> > _windowSettingsObserver;
         std::shared_ptr<ftk::ValueObserver<bool> > _fullScreenObserver;
     };
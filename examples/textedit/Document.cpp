@@ -13,13 +13,15 @@ namespace textedit
         const std::shared_ptr<Context>& context,
         const std::filesystem::path& path)
     {
-        std::vector<std::string> lines;
         if (!path.empty())
         {
-            // Read the file.
-            lines = readLines(path);
+            // Map the file. The lines are read as they are displayed.
+            _model = TextEditModel::create(context, MappedText::create(path));
+        }
+        else
+        {
+            _model = TextEditModel::create(context);
         }
-        _model = TextEditModel::create(context, lines);
 
         _path = ObservableValue<std::filesystem::path>::create(path);
         _name = ObservableValue<std::string>::create();
@@ -29,11 +31,13 @@ namespace textedit
         _nameUpdate();
 
         // Observe changes to the text and update the name.
-        _textObserver = ListObserver<std::string>::create(
-            _model->observeText(),
-            [this](const std::vector<std::string>&)
+        // The lines that are added while the file is indexed are not
+        // changes.
+        _linesObserver = ValueObserver<ObservableListChange>::create(
+            _model->observeLines(),
+            [this](const ObservableListChange&)
             {
-                if (_changed->setIfChanged(true))
+                if (!_model->isReadOnly() && _changed->setIfChanged(true))
                 {
                     _nameUpdate();
                 }
@@ -95,19 +99,39 @@ namespace textedit
 
     void Document::save()
     {
-        writeLines(_path->get(), _model->getText());
+        _write(_path->get());
         _changed->setIfChanged(false);
         _nameUpdate();
     }
 
     void Document::saveAs(const std::filesystem::path& path)
     {
-        writeLines(path, _model->getText());
+        _write(path);
         _path->setIfChanged(path);
         _changed->setIfChanged(false);
         _nameUpdate();
     }
 
+    void Document::_write(const std::filesystem::path& path)
+    {
+        // Write a temporary file and then replace the file, since the
+        // file may be memory mapped by the model.
+        std::filesystem::path tmp = path;
+        tmp += ".tmp";
+        {
+            // Write the lines one at a time so that memory mapped files
+            // are not copied into memory.
+            auto io = FileIO::create(tmp, FileMode::Write);
+            const size_t count = _model->getLineCount();
+            for (size_t i = 0; i < count; ++i)
+            {
+                io->write(_model->getLine(i));
+                io->write8('\n');
+            }
+        }
+        std::filesystem::rename(tmp, path);
+    }
+
     void Document::_nameUpdate()
     {
         const std::filesystem::path& path = _path->get();
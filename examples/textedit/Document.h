@@ -59,6 +59,7 @@ namespace textedit
         ///@}
 
     private:
+        void _write(const std::filesystem::path&);
         void _nameUpdate();
 
         std::shared_ptr<ftk::TextEditModel> _model;
@@ -66,6 +67,6 @@ namespace textedit
         std::shared_ptr<ftk::ObservableValue<std::string> > _name;
         std::shared_ptr<ftk::ObservableValue<std::string> > _tooltip;
         std::shared_ptr<ftk::ObservableValue<bool> > _changed;
-        std::shared_ptr<ftk::ListObserver<std::string> > _textObserver;
+        std::shared_ptr<ftk::ValueObserver<ftk::ObservableListChange> > _linesObserver;
     };
 }
@@ -48,12 +48,16 @@ namespace textedit
             {
                 if (auto doc = std::dynamic_pointer_cast<Document>(idoc))
                 {
-                    _textObserver = ListObserver<std::string>::create(
-                        doc->getModel()->observeText(),
-                        [this](const std::vector<std::string>& lines)
+                    std::weak_ptr<TextEditModel> modelWeak(doc->getModel());
+                    _linesObserver = ValueObserver<ObservableListChange>::create(
+                        doc->getModel()->observeLines(),
+                        [this, modelWeak](const ObservableListChange&)
                         {
-                            _labels["Lines2"]->setText(Format("{0}").
-                                arg(lines.size()));
+                            if (auto model = modelWeak.lock())
+                            {
+                                _labels["Lines2"]->setText(Format("{0}").
+                                    arg(model->getLineCount()));
+                            }
                         });
                     _cursorObserver = ValueObserver<TextEditPos>::create(
                         doc->getModel()->observeCursor(),
@@ -66,7 +70,7 @@ namespace textedit
                 }
                 else
                 {
-                    _textObserver.reset();
+                    _linesObserver.reset();
                     _labels["Lines2"]->setText(std::string());
                     _labels["Cursor2"]->setText(std::string());
                 }
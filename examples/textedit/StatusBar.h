@@ -40,7 +40,7 @@ namespace textedit
         std::shared_ptr<ftk::HorizontalLayout> _layout;
 
         std::shared_ptr<ftk::ValueObserver<std::shared_ptr<ftk::IDocument> > > _currentObserver;
-        std::shared_ptr<ftk::ListObserver<std::string> > _textObserver;
+        std::shared_ptr<ftk::ValueObserver<ftk::ObservableListChange> > _linesObserver;
         std::shared_ptr<ftk::ValueObserver<ftk::TextEditPos> > _cursorObserver;
     };
 }
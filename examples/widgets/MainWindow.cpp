@@ -19,14 +19,18 @@
 #include "Splitters.h"
 #include "Stack.h"
 
+#include <ftk/Core/SoftwareRender.h>
+
 using namespace ftk;
 
 namespace widgets
 {
     void MainWindow::_init(
         const std::shared_ptr<Context>& context,
-        const std::shared_ptr<App>& app)
+        const std::shared_ptr<App>& app,
+        bool software)
     {
+        _software = software;
         ftk::MainWindow::_init(context, app, Size2I(1920, 1080));
 
         _tabWidget = TabWidget::create(context);
@@ -53,10 +57,18 @@ namespace widgets
 
     std::shared_ptr<MainWindow> MainWindow::create(
         const std::shared_ptr<Context>& context,
-        const std::shared_ptr<App>& app)
+        const std::shared_ptr<App>& app,
+        bool software)
     {
         auto out = std::shared_ptr<MainWindow>(new MainWindow);
-        out->_init(context, app);
+        out->_init(context, app, software);
         return out;
     }
+
+    std::shared_ptr<IRender> MainWindow::_createRender(const std::shared_ptr<LogSystem>& logSystem)
+    {
+        return _software ?
+            SoftwareRender::create(logSystem) :
+            ftk::MainWindow::_createRender(logSystem);
+    }
 }
@@ -16,7 +16,8 @@ namespace widgets
     protected:
         void _init(
             const std::shared_ptr<Context>&,
-            const std::shared_ptr<App>&);
+            const std::shared_ptr<App>&,
+            bool software);
 
         MainWindow() = default;
 
@@ -25,9 +26,14 @@ namespace widgets
 
         static std::shared_ptr<MainWindow> create(
             const std::shared_ptr<Context>&,
-            const std::shared_ptr<App>&);
+            const std::shared_ptr<App>&,
+            bool software = false);
+
+    protected:
+        std::shared_ptr<IRender> _createRender(const std::shared_ptr<LogSystem>&) override;
 
     private:
+        bool _software = false;
         std::shared_ptr<ftk::TabWidget> _tabWidget;
     };
 }
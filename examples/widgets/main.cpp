@@ -6,13 +6,29 @@
 #include <ftk/UI/App.h>
 #include <ftk/UI/FileBrowser.h>
 
+#include <chrono>
+
 FTK_MAIN()
 {
     try
     {
         // Create the context and application.
         auto context = ftk::Context::create();
-        auto app = ftk::App::create(context, argc, argv, "bellows", "Bellows example");
+        auto softwareCmdLineOption = ftk::CmdLineFlagOption::create(
+            { "-software" },
+            "Use the software renderer.");
+        auto benchmarkCmdLineOption = ftk::CmdLineFlagOption::create(
+            { "-benchmark" },
+            "Print the frames per second for the OpenGL and software renderers.",
+            "Testing");
+        auto app = ftk::App::create(
+            context,
+            argc,
+            argv,
+            "widgets",
+            "Widgets example",
+            {},
+            { softwareCmdLineOption, benchmarkCmdLineOption });
         if (app->getExit() != 0)
             return app->getExit();
 
@@ -20,11 +36,40 @@ FTK_MAIN()
         auto fileBrowserSystem = context->getSystem<FileBrowserSystem>();
         fileBrowserSystem->setNativeFileDialog(false);
 
-        // Create the window.
-        auto window = widgets::MainWindow::create(context, app);
+        if (benchmarkCmdLineOption->found())
+        {
+            // Draw a number of frames with each renderer.
+            const size_t frames = 100;
+            for (const bool software : { false, true })
+            {
+                auto window = widgets::MainWindow::create(context, app, software);
+                window->show();
+                app->tick();
+                const auto t0 = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < frames; ++i)
+                {
+                    window->setDrawUpdate();
+                    app->tick();
+                }
+                const auto t1 = std::chrono::steady_clock::now();
+                const std::chrono::duration<float> diff = t1 - t0;
+                std::cout << (software ? "Software" : "OpenGL") <<
+                    " frames per second: " << frames / diff.count() << std::endl;
+                window->hide();
+                app->removeWindow(window);
+            }
+        }
+        else
+        {
+            // Create the window.
+            auto window = widgets::MainWindow::create(
+                context,
+                app,
+                softwareCmdLineOption->found());
 
-        // Run the application.
-        app->run();
+            // Run the application.
+            app->run();
+        }
     }
     catch (const std::exception& e)
     {
@@ -50,10 +50,25 @@ namespace ftk
         return out;
     }
 
-    std::shared_ptr<BoxPackNode> BoxPack::insert(const Size2I& size)
+    bool BoxPack::hasNode(BoxPackID id) const
+    {
+        return _idToNode.find(id) != _idToNode.end();
+    }
+
+    size_t BoxPack::getCount() const
+    {
+        return _idToNode.size();
+    }
+
+    int64_t BoxPack::getUsedArea() const
+    {
+        return _usedArea;
+    }
+
+    std::shared_ptr<BoxPackNode> BoxPack::insert(const Size2I& size, bool evict)
     {
         auto out = _insert(_root, size);
-        if (!out)
+        if (!out && evict)
         {
             std::vector<std::shared_ptr<BoxPackNode> > nodes;
             _getNodes(_root, nodes);
@@ -85,6 +100,15 @@ namespace ftk
         return out;
     }
 
+    void BoxPack::clear()
+    {
+        const Box2I box = _root->box;
+        _root = std::make_shared<BoxPackNode>();
+        _root->box = box;
+        _idToNode.clear();
+        _usedArea = 0;
+    }
+
     void BoxPack::_getNodes(
         const std::shared_ptr<BoxPackNode>& node,
         std::vector<std::shared_ptr<BoxPackNode> >& nodes) const
@@ -123,6 +147,7 @@ namespace ftk
                 node->id = _id++;
                 node->timestamp = _timestamp++;
                 _idToNode[node->id] = node;
+                _usedArea += static_cast<int64_t>(nodeSize.w) * nodeSize.h;
                 out = node;
             }
             else if (sizeAndBorder.w <= nodeSize.w &&
@@ -168,6 +193,7 @@ namespace ftk
         if (i != _idToNode.end())
         {
             _idToNode.erase(i);
+            _usedArea -= static_cast<int64_t>(node->box.w()) * node->box.h();
         }
         if (node->children[0])
         {
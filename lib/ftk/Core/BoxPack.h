@@ -55,9 +55,24 @@ namespace ftk
 
         std::vector<std::shared_ptr<BoxPackNode> > getNodes() const;
 
+        //! Get a node and update the timestamp.
         std::shared_ptr<BoxPackNode> getNode(BoxPackID);
 
-        std::shared_ptr<BoxPackNode> insert(const Size2I&);
+        //! Get whether a node exists without updating the timestamp.
+        bool hasNode(BoxPackID) const;
+
+        //! Get the number of occupied nodes.
+        size_t getCount() const;
+
+        //! Get the area of the occupied nodes.
+        int64_t getUsedArea() const;
+
+        //! Insert a box. If there is no room and eviction is enabled, the
+        //! least recently used node that is large enough is replaced.
+        std::shared_ptr<BoxPackNode> insert(const Size2I&, bool evict = true);
+
+        //! Remove all of the nodes. IDs are not reused after clearing.
+        void clear();
 
     private:
         void _getNodes(
@@ -74,6 +89,7 @@ namespace ftk
         std::shared_ptr<BoxPackNode> _root;
         BoxPackID _id = 0;
         BoxPackTimestamp _timestamp = 0;
+        int64_t _usedArea = 0;
         std::map<BoxPackID, std::shared_ptr<BoxPackNode>> _idToNode;
     };
 
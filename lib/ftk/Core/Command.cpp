@@ -3,6 +3,8 @@
 
 #include <ftk/Core/Command.h>
 
+#include <deque>
+
 namespace ftk
 {
     ICommand::~ICommand()
@@ -10,8 +12,9 @@ namespace ftk
 
     struct CommandStack::Private
     {
-        std::vector<std::shared_ptr<ICommand> > commands;
+        std::deque<std::shared_ptr<ICommand> > commands;
         int64_t currentIndex = -1;
+        size_t max = 0;
         std::shared_ptr<ObservableValue<bool> > hasUndo;
         std::shared_ptr<ObservableValue<bool> > hasRedo;
     };
@@ -33,6 +36,20 @@ namespace ftk
         return out;
     }
 
+    size_t CommandStack::getMax() const
+    {
+        return _p->max;
+    }
+
+    void CommandStack::setMax(size_t value)
+    {
+        FTK_P();
+        if (value == p.max)
+            return;
+        p.max = value;
+        _limit();
+    }
+
     void CommandStack::push(const std::shared_ptr<ICommand>& command)
     {
         FTK_P();
@@ -43,7 +60,9 @@ namespace ftk
         p.commands.push_back(command);
         p.currentIndex = p.currentIndex + 1;
         command->exec();
+        _limit();
         p.hasUndo->setIfChanged(true);
+        p.hasRedo->setIfChanged(false);
     }
 
     std::shared_ptr<IObservableValue<bool> > CommandStack::observeHasUndo() const
@@ -81,6 +100,26 @@ namespace ftk
         }
     }
 
+    void CommandStack::_limit()
+    {
+        FTK_P();
+        if (p.max > 0)
+        {
+            while (p.commands.size() > p.max &&
+                static_cast<int64_t>(p.commands.size()) - 1 > p.currentIndex)
+            {
+                p.commands.pop_back();
+            }
+            while (p.commands.size() > p.max)
+            {
+                p.commands.pop_front();
+                p.currentIndex = p.currentIndex - 1;
+            }
+            p.hasUndo->setIfChanged(p.currentIndex >= 0);
+            p.hasRedo->setIfChanged(p.currentIndex < static_cast<int64_t>(p.commands.size()) - 1);
+        }
+    }
+
     void CommandStack::clear()
     {
         FTK_P();
@@ -39,6 +39,15 @@ namespace ftk
         //! Create a new command stack.
         static std::shared_ptr<CommandStack> create();
 
+        //! Get the maximum number of commands.
+        size_t getMax() const;
+
+        //! Set the maximum number of commands. When the stack is larger
+        //! than the maximum, the commands that can be redone are removed
+        //! first and then the oldest commands. A value of zero means there
+        //! is no maximum.
+        void setMax(size_t);
+
         //! Execute a command and push it onto the stack.
         void push(const std::shared_ptr<ICommand>&);
 
@@ -58,6 +67,8 @@ namespace ftk
         void redo();
 
     private:
+        void _limit();
+
         FTK_PRIVATE();
     };
 
@@ -5,6 +5,7 @@
 
 #include <ftk/Core/FontSystem.h>
 #include <ftk/Core/Format.h>
+#include <ftk/Core/ImageCache.h>
 #include <ftk/Core/ImageIO.h>
 #include <ftk/Core/OS.h>
 #include <ftk/Core/Timer.h>
@@ -29,6 +30,7 @@ namespace ftk
 
         addSystem(FontSystem::create(shared_from_this()));
         addSystem(ImageIO::create(shared_from_this()));
+        addSystem(ImageCache::create(shared_from_this()));
         addSystem(TimerSystem::create(shared_from_this()));
     }
 
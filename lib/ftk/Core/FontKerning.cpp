@@ -0,0 +1,316 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/FontSystemPrivate.h>
+
+#include FT_TRUETYPE_TABLES_H
+#include FT_TRUETYPE_TAGS_H
+
+#include <algorithm>
+
+namespace ftk
+{
+    namespace
+    {
+        const uint16_t lookupTypePairPos = 2;
+        const uint16_t lookupTypeExtension = 9;
+
+        uint16_t readU16(const std::vector<uint8_t>& data, size_t offset)
+        {
+            return offset + 2 <= data.size() ?
+                (static_cast<uint16_t>(data[offset]) << 8) | data[offset + 1] :
+                0;
+        }
+
+        int16_t readS16(const std::vector<uint8_t>& data, size_t offset)
+        {
+            return static_cast<int16_t>(readU16(data, offset));
+        }
+
+        uint32_t readU32(const std::vector<uint8_t>& data, size_t offset)
+        {
+            return (static_cast<uint32_t>(readU16(data, offset)) << 16) |
+                readU16(data, offset + 2);
+        }
+
+        size_t getValueRecordSize(uint16_t valueFormat)
+        {
+            size_t out = 0;
+            for (uint16_t i = valueFormat & 0xff; i; i >>= 1)
+            {
+                out += (i & 1) * 2;
+            }
+            return out;
+        }
+
+        //! Get the offset of the X advance in a value record, or -1 if the
+        //! record does not have an X advance.
+        int getXAdvanceOffset(uint16_t valueFormat)
+        {
+            return (valueFormat & 0x4) ?
+                static_cast<int>(getValueRecordSize(valueFormat & 0x3)) :
+                -1;
+        }
+
+        std::unordered_map<uint16_t, uint16_t> readCoverage(
+            const std::vector<uint8_t>& data,
+            size_t offset)
+        {
+            std::unordered_map<uint16_t, uint16_t> out;
+            const uint16_t format = readU16(data, offset);
+            const uint16_t count = readU16(data, offset + 2);
+            if (1 == format)
+            {
+                for (uint16_t i = 0; i < count; ++i)
+                {
+                    out[readU16(data, offset + 4 + i * 2)] = i;
+                }
+            }
+            else if (2 == format)
+            {
+                for (uint16_t i = 0; i < count; ++i)
+                {
+                    const size_t range = offset + 4 + i * 6;
+                    const uint16_t start = readU16(data, range);
+                    const uint16_t end = readU16(data, range + 2);
+                    const uint16_t index = readU16(data, range + 4);
+                    for (uint32_t glyph = start; glyph <= end; ++glyph)
+                    {
+                        out[glyph] = index + (glyph - start);
+                    }
+                }
+            }
+            return out;
+        }
+
+        std::unordered_map<uint16_t, uint16_t> readClassDef(
+            const std::vector<uint8_t>& data,
+            size_t offset)
+        {
+            std::unordered_map<uint16_t, uint16_t> out;
+            const uint16_t format = readU16(data, offset);
+            if (1 == format)
+            {
+                const uint16_t start = readU16(data, offset + 2);
+                const uint16_t count = readU16(data, offset + 4);
+                for (uint16_t i = 0; i < count; ++i)
+                {
+                    if (const uint16_t value = readU16(data, offset + 6 + i * 2))
+                    {
+                        out[start + i] = value;
+                    }
+                }
+            }
+            else if (2 == format)
+            {
+                const uint16_t count = readU16(data, offset + 2);
+                for (uint16_t i = 0; i < count; ++i)
+                {
+                    const size_t range = offset + 4 + i * 6;
+                    const uint16_t start = readU16(data, range);
+                    const uint16_t end = readU16(data, range + 2);
+                    const uint16_t value = readU16(data, range + 4);
+                    for (uint32_t glyph = start; glyph <= end && value; ++glyph)
+                    {
+                        out[glyph] = value;
+                    }
+                }
+            }
+            return out;
+        }
+    }
+
+    FontKerning::FontKerning(FT_Face ftFace)
+    {
+        FT_ULong size = 0;
+        if (FT_IS_SFNT(ftFace) &&
+            !FT_Load_Sfnt_Table(ftFace, TTAG_GPOS, 0, nullptr, &size) &&
+            size > 0)
+        {
+            std::vector<uint8_t> data(size);
+            if (!FT_Load_Sfnt_Table(ftFace, TTAG_GPOS, 0, data.data(), &size))
+            {
+                _read(data);
+            }
+        }
+        _legacy = _lookups.empty() && FT_HAS_KERNING(ftFace);
+    }
+
+    bool FontKerning::isValid() const
+    {
+        return !_lookups.empty() || _legacy;
+    }
+
+    FT_Long FontKerning::getKerning(FT_Face ftFace, FT_UInt left, FT_UInt right) const
+    {
+        FT_Long out = 0;
+        if (_legacy)
+        {
+            FT_Vector ftVector;
+            if (!FT_Get_Kerning(ftFace, left, right, FT_KERNING_UNSCALED, &ftVector))
+            {
+                out = ftVector.x;
+            }
+        }
+        else if (left < 0x10000 && right < 0x10000)
+        {
+            // The adjustments of each lookup are combined, and the first
+            // subtable of a lookup that applies is used.
+            const uint32_t key = (left << 16) | right;
+            for (const auto& lookup : _lookups)
+            {
+                for (const auto& subtable : lookup)
+                {
+                    if (!subtable.pairs.empty())
+                    {
+                        const auto i = subtable.pairs.find(key);
+                        if (i != subtable.pairs.end())
+                        {
+                            out += i->second;
+                            break;
+                        }
+                    }
+                    else if (subtable.coverage.find(left) != subtable.coverage.end())
+                    {
+                        const auto i = subtable.classDef1.find(left);
+                        const auto j = subtable.classDef2.find(right);
+                        const size_t class1 = i != subtable.classDef1.end() ? i->second : 0;
+                        const size_t class2 = j != subtable.classDef2.end() ? j->second : 0;
+                        const size_t index = class1 * subtable.class2Count + class2;
+                        if (class2 < subtable.class2Count && index < subtable.values.size())
+                        {
+                            out += subtable.values[index];
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+        return out;
+    }
+
+    void FontKerning::_read(const std::vector<uint8_t>& data)
+    {
+        // Find the lookups of the "kern" feature.
+        const size_t featureList = readU16(data, 6);
+        const size_t lookupList = readU16(data, 8);
+        std::vector<uint16_t> lookupIndices;
+        const uint16_t featureCount = readU16(data, featureList);
+        for (uint16_t i = 0; i < featureCount; ++i)
+        {
+            const size_t record = featureList + 2 + i * 6;
+            if (readU32(data, record) == FT_MAKE_TAG('k', 'e', 'r', 'n'))
+            {
+                const size_t feature = featureList + readU16(data, record + 4);
+                const uint16_t count = readU16(data, feature + 2);
+                for (uint16_t j = 0; j < count; ++j)
+                {
+                    lookupIndices.push_back(readU16(data, feature + 4 + j * 2));
+                }
+            }
+        }
+        std::sort(lookupIndices.begin(), lookupIndices.end());
+        lookupIndices.erase(
+            std::unique(lookupIndices.begin(), lookupIndices.end()),
+            lookupIndices.end());
+
+        // Read the pair adjustment lookups.
+        const uint16_t lookupCount = readU16(data, lookupList);
+        for (const uint16_t index : lookupIndices)
+        {
+            if (index >= lookupCount)
+                continue;
+            const size_t lookup = lookupList + readU16(data, lookupList + 2 + index * 2);
+            const uint16_t type = readU16(data, lookup);
+            const uint16_t subtableCount = readU16(data, lookup + 4);
+            _lookups.push_back(std::vector<Subtable>());
+            for (uint16_t i = 0; i < subtableCount; ++i)
+            {
+                size_t subtable = lookup + readU16(data, lookup + 6 + i * 2);
+                uint16_t subtableType = type;
+                if (lookupTypeExtension == type)
+                {
+                    subtableType = readU16(data, subtable + 2);
+                    subtable += readU32(data, subtable + 4);
+                }
+                if (lookupTypePairPos == subtableType)
+                {
+                    _readPairPos(data, subtable, _lookups.size() - 1);
+                }
+            }
+            if (_lookups.back().empty())
+            {
+                _lookups.pop_back();
+            }
+        }
+    }
+
+    void FontKerning::_readPairPos(const std::vector<uint8_t>& data, size_t offset, size_t lookup)
+    {
+        const uint16_t format = readU16(data, offset);
+        const uint16_t valueFormat1 = readU16(data, offset + 4);
+        const uint16_t valueFormat2 = readU16(data, offset + 6);
+        const int xAdvance = getXAdvanceOffset(valueFormat1);
+        if (xAdvance < 0)
+            return;
+        const size_t valueSize1 = getValueRecordSize(valueFormat1);
+        const size_t valueSize2 = getValueRecordSize(valueFormat2);
+        Subtable subtable;
+        if (1 == format)
+        {
+            const auto coverage = readCoverage(data, offset + readU16(data, offset + 2));
+            const uint16_t pairSetCount = readU16(data, offset + 8);
+            for (const auto& i : coverage)
+            {
+                if (i.second >= pairSetCount)
+                    continue;
+                const size_t pairSet = offset + readU16(data, offset + 10 + i.second * 2);
+                const uint16_t count = readU16(data, pairSet);
+                const size_t recordSize = 2 + valueSize1 + valueSize2;
+                if (pairSet + 2 > data.size() ||
+                    count * recordSize > data.size() - (pairSet + 2))
+                    continue;
+                for (uint16_t j = 0; j < count; ++j)
+                {
+                    const size_t record = pairSet + 2 + j * recordSize;
+                    const int16_t value = readS16(data, record + 2 + xAdvance);
+                    if (value != 0)
+                    {
+                        const uint32_t key = (static_cast<uint32_t>(i.first) << 16) |
+                            readU16(data, record);
+                        subtable.pairs[key] = value;
+                    }
+                }
+            }
+            if (subtable.pairs.empty())
+                return;
+        }
+        else if (2 == format)
+        {
+            subtable.coverage = readCoverage(data, offset + readU16(data, offset + 2));
+            subtable.classDef1 = readClassDef(data, offset + readU16(data, offset + 8));
+            subtable.classDef2 = readClassDef(data, offset + readU16(data, offset + 10));
+            const uint16_t class1Count = readU16(data, offset + 12);
+            subtable.class2Count = readU16(data, offset + 14);
+            const size_t recordSize = valueSize1 + valueSize2;
+
+            // Reject the subtable if the class records don't fit in the
+            // table data.
+            const size_t valueCount =
+                static_cast<size_t>(class1Count) * subtable.class2Count;
+            if (offset + 16 > data.size() ||
+                valueCount * recordSize > data.size() - (offset + 16))
+                return;
+            subtable.values.resize(valueCount);
+            for (size_t i = 0; i < subtable.values.size(); ++i)
+            {
+                subtable.values[i] = readS16(data, offset + 16 + i * recordSize + xAdvance);
+            }
+        }
+        else
+        {
+            return;
+        }
+        _lookups[lookup].push_back(std::move(subtable));
+    }
+}
@@ -1,24 +1,37 @@
 // SPDX-License-Identifier: BSD-3-Clause
 // Copyright Contributors to the feather-tk project.
 
-#include <ftk/Core/FontSystem.h>
+#include <ftk/Core/FontSystemPrivate.h>
 
 #include <ftk/Core/Context.h>
 #include <ftk/Core/Error.h>
 #include <ftk/Core/Format.h>
+#include <ftk/Core/ImageConvert.h>
 #include <ftk/Core/LRUCache.h>
 #include <ftk/Core/LogSystem.h>
+#include <ftk/Core/RasterCache.h>
 #include <ftk/Core/String.h>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
+#include FT_MODULE_H
+#include FT_OUTLINE_H
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <codecvt>
+#include <condition_variable>
+#include <deque>
 #include <limits>
+#include <list>
 #include <locale>
-#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace ftk_resource
 {
@@ -35,6 +48,11 @@ namespace ftk
         "Bold",
         "Mono");
 
+    FTK_ENUM_IMPL(
+        GlyphMode,
+        "Bitmap",
+        "SDF");
+
     std::string getFont(Font value)
     {
         const std::array<std::string, static_cast<size_t>(Font::Count)> data =
@@ -46,6 +64,76 @@ namespace ftk
         return data[static_cast<size_t>(value)];
     }
 
+    namespace
+    {
+        struct FontIDs
+        {
+            FontIDs()
+            {
+                // The empty family is always ID zero, the same as a default
+                // constructed GlyphInfo.
+                families.push_back(std::string());
+                ids[families.back()] = 0;
+            }
+
+            std::deque<std::string> families;
+            std::unordered_map<std::string, FontID> ids;
+            std::mutex mutex;
+        };
+
+        FontIDs& getFontIDs()
+        {
+            static FontIDs fontIDs;
+            return fontIDs;
+        }
+    }
+
+    FontID getFontID(const std::string& family)
+    {
+        FontIDs& fontIDs = getFontIDs();
+        std::unique_lock<std::mutex> lock(fontIDs.mutex);
+        const auto i = fontIDs.ids.find(family);
+        if (i != fontIDs.ids.end())
+        {
+            return i->second;
+        }
+        if (fontIDs.families.size() > std::numeric_limits<FontID>::max())
+        {
+            throw std::runtime_error("Too many font families");
+        }
+        const FontID out = static_cast<FontID>(fontIDs.families.size());
+        fontIDs.families.push_back(family);
+        fontIDs.ids[family] = out;
+        return out;
+    }
+
+    const std::string& getFontFamily(FontID value)
+    {
+        FontIDs& fontIDs = getFontIDs();
+        std::unique_lock<std::mutex> lock(fontIDs.mutex);
+        return value < fontIDs.families.size() ?
+            fontIDs.families[value] :
+            fontIDs.families.front();
+    }
+
+    int TextRun::getPrefixWidth(size_t value) const
+    {
+        const size_t index = std::lower_bound(offsets.begin(), offsets.end(), value) -
+            offsets.begin();
+        return index < boxes.size() ? boxes[index].min.x : size.w;
+    }
+
+    size_t TextRun::getIndex(int value) const
+    {
+        return std::partition_point(
+            boxes.begin(),
+            boxes.end(),
+            [value](const Box2I& box)
+            {
+                return box.max.x < value;
+            }) - boxes.begin();
+    }
+
     namespace
     {
 #if defined(_WINDOWS)
@@ -56,22 +144,212 @@ namespace ftk
 #endif // _WINDOWS
     }
 
+    namespace
+    {
+        const size_t threadCountMax = 4;
+        const size_t requestTimeout = 5;
+        const size_t runCacheMax = 4 * megabyte;
+
+        struct RunKey
+        {
+            std::string text;
+            FontID fontID = 0;
+            int fontSize = 0;
+            int maxLineWidth = 0;
+
+            bool operator == (const RunKey& other) const
+            {
+                return
+                    text == other.text &&
+                    fontID == other.fontID &&
+                    fontSize == other.fontSize &&
+                    maxLineWidth == other.maxLineWidth;
+            }
+        };
+
+        struct RunKeyHash
+        {
+            std::size_t operator() (const RunKey& value) const noexcept
+            {
+                std::size_t out = std::hash<std::string>()(value.text);
+                hashCombine(out, value.fontID);
+                hashCombine(out, value.fontSize);
+                hashCombine(out, value.maxLineWidth);
+                return out;
+            }
+        };
+
+        //! Cached text run. The glyphs with kerning are copies of the
+        //! cached glyphs with the advance adjusted. The copies are kept
+        //! with the run and only made again when the cached glyph changes.
+        struct RunEntry
+        {
+            std::shared_ptr<const TextRun> run;
+            std::vector<std::shared_ptr<Glyph> > glyphs;
+            std::vector<std::shared_ptr<Glyph> > kerned;
+        };
+
+        size_t getByteCount(const TextRun& value)
+        {
+            return sizeof(TextRun) +
+                value.text.size() +
+                value.codes.size() * sizeof(uint32_t) +
+                value.offsets.size() * sizeof(size_t) +
+                value.boxes.size() * sizeof(Box2I) +
+                value.kerning.size() * sizeof(int) +
+                value.codes.size() * 2 * sizeof(std::shared_ptr<Glyph>);
+        }
+
+        void setSDFSpread(FT_Library ftLibrary)
+        {
+            FT_Int spread = sdfGlyphSpread;
+            FT_Property_Set(ftLibrary, "sdf", "spread", &spread);
+            FT_Property_Set(ftLibrary, "bsdf", "spread", &spread);
+        }
+
+        // Glyphs with a size of zero are the size independent SDF glyphs.
+        std::shared_ptr<Glyph> getGlyph(
+            FT_Face ftFace,
+            const GlyphInfo& info,
+            ImageType imageType,
+            bool render)
+        {
+            auto out = std::make_shared<Glyph>();
+            out->info = info;
+            out->sdf = 0 == info.size;
+            FT_Error ftError = FT_Set_Pixel_Sizes(
+                ftFace,
+                0,
+                static_cast<int>(out->sdf ? sdfGlyphSize : info.size));
+            if (ftError)
+            {
+                throw std::runtime_error(
+                    Format("Cannot set pixel sizes: \"{0}\"").arg(getFontFamily(info.fontID)));
+            }
+            if (auto ftGlyphIndex = FT_Get_Char_Index(ftFace, info.code))
+            {
+                // SDF glyphs are scaled, so they are not hinted.
+                ftError = FT_Load_Glyph(
+                    ftFace,
+                    ftGlyphIndex,
+                    out->sdf ? FT_LOAD_NO_HINTING : FT_LOAD_FORCE_AUTOHINT);
+                if (ftError)
+                {
+                    throw std::runtime_error(
+                        Format("Cannot load glyph: \"{0}\"").arg(getFontFamily(info.fontID)));
+                }
+                if (out->sdf &&
+                    FT_GLYPH_FORMAT_OUTLINE == ftFace->glyph->format &&
+                    0 == ftFace->glyph->outline.n_points)
+                {
+                    // Glyphs without an outline, like spaces, only have
+                    // metrics.
+                    render = false;
+                }
+                if (render)
+                {
+                    FT_Render_Mode renderMode = out->sdf ?
+                        FT_RENDER_MODE_SDF :
+                        FT_RENDER_MODE_NORMAL;
+                    ftError = FT_Render_Glyph(ftFace->glyph, renderMode);
+                    if (ftError)
+                    {
+                        throw std::runtime_error(
+                            Format("Cannot render glyph: \"{0}\"").arg(getFontFamily(info.fontID)));
+                    }
+
+                    auto ftBitmap = ftFace->glyph->bitmap;
+                    const ImageInfo imageInfo(ftBitmap.width, ftBitmap.rows, imageType);
+                    out->image = Image::create(imageInfo);
+                    ImageConvertOptions convertOptions;
+                    convertOptions.luminanceToAlpha = true;
+                    const size_t rowByteCount = imageInfo.size.w * getChannelCount(imageInfo.type);
+                    for (size_t y = 0; y < ftBitmap.rows; ++y)
+                    {
+                        convertPixels(
+                            ftBitmap.buffer + y * ftBitmap.pitch,
+                            ImageType::L_U8,
+                            out->image->getData() + y * rowByteCount,
+                            imageInfo.type,
+                            imageInfo.size.w,
+                            convertOptions);
+                    }
+                    out->offset = V2I(ftFace->glyph->bitmap_left, ftFace->glyph->bitmap_top);
+                }
+                else
+                {
+                    // Compute the bitmap offset from the hinted outline
+                    // without rendering.
+                    FT_BBox ftBBox;
+                    FT_Outline_Get_CBox(&ftFace->glyph->outline, &ftBBox);
+                    out->offset = V2I(
+                        static_cast<int>(std::floor(ftBBox.xMin / 64.F)),
+                        static_cast<int>(std::ceil(ftBBox.yMax / 64.F)));
+                }
+                out->advance = ftFace->glyph->advance.x / 64;
+                out->lsbDelta = ftFace->glyph->lsb_delta;
+                out->rsbDelta = ftFace->glyph->rsb_delta;
+            }
+            return out;
+        }
+    }
+
     struct FontSystem::Private
     {
-        std::shared_ptr<Glyph> getGlyph(uint32_t code, const FontInfo&);
-        void measure(
-            const std::basic_string<ftk_char_t>& utf32,
+        std::shared_ptr<Glyph> getGlyph(
+            const GlyphInfo&,
+            bool request,
+            bool* loaded = nullptr);
+        std::shared_ptr<Glyph> getMetricsGlyph(const GlyphInfo&);
+        std::shared_ptr<Glyph> rasterize(FT_Face, const GlyphInfo&);
+        std::shared_ptr<RunEntry> getRun(
+            const std::string&,
             const FontInfo&,
-            int maxLineWidth,
-            Size2I&,
-            std::vector<Box2I>* = nullptr);
+            int maxLineWidth);
+        void measure(TextRun&);
+        void request(const std::vector<GlyphInfo>&);
+        void run();
 
-        std::map<std::string, std::vector<uint8_t> > fontData;
-        FT_Library ftLibrary = nullptr;
-        std::map<std::string, FT_Face> ftFaces;
-        std::wstring_convert<std::codecvt_utf8<ftk_char_t>, ftk_char_t> utf32Convert;
         ImageType imageType = ImageType::L_U8;
-        LRUCache<GlyphInfo, std::shared_ptr<Glyph> > glyphCache;
+        GlyphMode glyphMode = GlyphMode::Bitmap;
+        bool async = false;
+        std::shared_ptr<ObservableValue<size_t> > glyphsLoaded;
+
+        // The FreeType objects used by the calling threads.
+        struct Face
+        {
+            FT_Library ftLibrary = nullptr;
+            std::unordered_map<FontID, FT_Face> ftFaces;
+            std::wstring_convert<std::codecvt_utf8<ftk_char_t>, ftk_char_t> utf32Convert;
+            LRUCache<GlyphInfo, std::shared_ptr<Glyph> > metricsCache;
+            LRUCache<GlyphInfo, std::shared_ptr<Glyph> > sdfCache;
+            std::unordered_map<FontID, std::unique_ptr<FontKerning> > kerning;
+            LRUCache<RunKey, std::shared_ptr<RunEntry>, RunKeyHash> runCache;
+            std::mutex mutex;
+        };
+        Face face;
+
+        struct Mutex
+        {
+            std::unordered_map<FontID, std::shared_ptr<std::vector<uint8_t> > > fontData;
+            std::unordered_map<FontID, uint64_t> fontHashes;
+            std::shared_ptr<RasterCache> rasterCache;
+            LRUCache<GlyphInfo, std::shared_ptr<Glyph> > glyphCache;
+            std::list<GlyphInfo> requests;
+            std::unordered_set<GlyphInfo> pending;
+            size_t loaded = 0;
+            std::array<GlyphStats, static_cast<size_t>(GlyphMode::Count)> stats;
+            std::mutex mutex;
+        };
+        Mutex mutex;
+
+        struct Thread
+        {
+            std::condition_variable cv;
+            std::vector<std::thread> threads;
+            std::atomic<bool> running;
+        };
+        Thread thread;
     };
 
     FontSystem::FontSystem(const std::shared_ptr<Context>& context) :
@@ -80,33 +358,44 @@ namespace ftk
     {
         FTK_P();
 
-        p.fontData[getFont(Font::Regular)] = ftk_resource::NotoSansRegular;
-        p.fontData[getFont(Font::Bold)] = ftk_resource::NotoSansBold;
-        p.fontData[getFont(Font::Mono)] = ftk_resource::NotoMonoRegular;
+        p.mutex.fontData[getFontID(getFont(Font::Regular))] =
+            std::make_shared<std::vector<uint8_t> >(ftk_resource::NotoSansRegular);
+        p.mutex.fontData[getFontID(getFont(Font::Bold))] =
+            std::make_shared<std::vector<uint8_t> >(ftk_resource::NotoSansBold);
+        p.mutex.fontData[getFontID(getFont(Font::Mono))] =
+            std::make_shared<std::vector<uint8_t> >(ftk_resource::NotoMonoRegular);
+        for (const auto& i : p.mutex.fontData)
+        {
+            p.mutex.fontHashes[i.first] = getRasterCacheHash(i.second->data(), i.second->size());
+        }
 
 #if defined(FTK_API_GLES_2)
         //! \bug Some GLES 2 implementations (Pi Zero W) only support RGBA?
         p.imageType = ImageType::RGBA_U8;
 #endif // FTK_API_GLES_2
+        p.face.runCache.setMax(runCacheMax);
+        p.glyphsLoaded = ObservableValue<size_t>::create(0);
+        p.thread.running = true;
         try
         {
-            FT_Error ftError = FT_Init_FreeType(&p.ftLibrary);
+            FT_Error ftError = FT_Init_FreeType(&p.face.ftLibrary);
             if (ftError)
             {
                 throw std::runtime_error("FreeType cannot be initialized");
             }
+            setSDFSpread(p.face.ftLibrary);
 
-            for (const auto& i : p.fontData)
+            for (const auto& i : p.mutex.fontData)
             {
                 ftError = FT_New_Memory_Face(
-                    p.ftLibrary,
-                    i.second.data(),
-                    i.second.size(),
+                    p.face.ftLibrary,
+                    i.second->data(),
+                    i.second->size(),
                     0,
-                    &p.ftFaces[i.first]);
+                    &p.face.ftFaces[i.first]);
                 if (ftError)
                 {
-                    throw std::runtime_error(Format("Cannot create font: \"{0}\"").arg(i.first));
+                    throw std::runtime_error(Format("Cannot create font: \"{0}\"").arg(getFontFamily(i.first)));
                 }
             }
         }
@@ -123,13 +412,21 @@ namespace ftk
     FontSystem::~FontSystem()
     {
         FTK_P();
-        if (p.ftLibrary)
+        p.thread.running = false;
+        for (auto& thread : p.thread.threads)
         {
-            for (const auto& i : p.ftFaces)
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+        if (p.face.ftLibrary)
+        {
+            for (const auto& i : p.face.ftFaces)
             {
                 FT_Done_Face(i.second);
             }
-            FT_Done_FreeType(p.ftLibrary);
+            FT_Done_FreeType(p.face.ftLibrary);
         }
     }
 
@@ -141,36 +438,65 @@ namespace ftk
     void FontSystem::addFont(const std::string& name, const uint8_t* data, size_t size)
     {
         FTK_P();
-        p.fontData[name] = std::vector<uint8_t>(size);
-        memcpy(p.fontData[name].data(), data, size);
+        auto fontData = std::make_shared<std::vector<uint8_t> >(size);
+        memcpy(fontData->data(), data, size);
+        std::unique_lock<std::mutex> faceLock(p.face.mutex);
+        FT_Face ftFace = nullptr;
         FT_Error ftError = FT_New_Memory_Face(
-            p.ftLibrary,
-            p.fontData[name].data(),
+            p.face.ftLibrary,
+            fontData->data(),
             size,
             0,
-            &p.ftFaces[name]);
+            &ftFace);
         if (ftError)
         {
             throw std::runtime_error(Format("Cannot create font: \"{0}\"").arg(name));
         }
+        const FontID fontID = getFontID(name);
+        const auto i = p.face.ftFaces.find(fontID);
+        if (i != p.face.ftFaces.end())
+        {
+            FT_Done_Face(i->second);
+        }
+        p.face.ftFaces[fontID] = ftFace;
+        p.face.kerning.erase(fontID);
+        p.face.metricsCache.clear();
+        p.face.sdfCache.clear();
+        p.face.runCache.clear();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        p.mutex.fontData[fontID] = fontData;
+        p.mutex.fontHashes[fontID] = getRasterCacheHash(data, size);
+        p.mutex.glyphCache.clear();
     }
 
     size_t FontSystem::getGlyphCacheSize() const
     {
-        return _p->glyphCache.getSize();
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.glyphCache.getSize();
     }
 
     float FontSystem::getGlyphCachePercentage() const
     {
-        return _p->glyphCache.getPercentage();
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.glyphCache.getPercentage();
+    }
+
+    GlyphStats FontSystem::getGlyphStats(GlyphMode value) const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.stats[static_cast<size_t>(value)];
     }
 
     FontMetrics FontSystem::getMetrics(const FontInfo& info)
     {
         FTK_P();
         FontMetrics out;
-        const auto ftFaceIt = p.ftFaces.find(info.family);
-        if (ftFaceIt != p.ftFaces.end())
+        std::unique_lock<std::mutex> lock(p.face.mutex);
+        const auto ftFaceIt = p.face.ftFaces.find(getFontID(info.family));
+        if (ftFaceIt != p.face.ftFaces.end())
         {
             FT_Error ftError = FT_Set_Pixel_Sizes(ftFaceIt->second, 0, info.size);
             out.ascender = ftFaceIt->second->size->metrics.ascender / 64;
@@ -186,15 +512,8 @@ namespace ftk
         int maxLineWidth)
     {
         FTK_P();
-        Size2I out;
-        try
-        {
-            const auto utf32 = p.utf32Convert.from_bytes(text);
-            p.measure(utf32, fontInfo, maxLineWidth, out);
-        }
-        catch (const std::exception&)
-        {}
-        return out;
+        std::unique_lock<std::mutex> lock(p.face.mutex);
+        return p.getRun(text, fontInfo, maxLineWidth)->run->size;
     }
 
     std::vector<Box2I> FontSystem::getBoxes(
@@ -203,16 +522,25 @@ namespace ftk
         int maxLineWidth)
     {
         FTK_P();
-        std::vector<Box2I> out;
-        try
-        {
-            const auto utf32 = p.utf32Convert.from_bytes(text);
-            Size2I size;
-            p.measure(utf32, fontInfo, maxLineWidth, size, &out);
-        }
-        catch (const std::exception&)
-        {}
-        return out;
+        std::unique_lock<std::mutex> lock(p.face.mutex);
+        return p.getRun(text, fontInfo, maxLineWidth)->run->boxes;
+    }
+
+    std::shared_ptr<const TextRun> FontSystem::getRun(
+        const std::string& text,
+        const FontInfo& fontInfo,
+        int maxLineWidth)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.face.mutex);
+        return p.getRun(text, fontInfo, maxLineWidth)->run;
+    }
+
+    size_t FontSystem::getRunCacheSize() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.face.mutex);
+        return p.face.runCache.getSize();
     }
 
     std::vector<std::shared_ptr<Glyph> > FontSystem::getGlyphs(
@@ -221,12 +549,30 @@ namespace ftk
     {
         FTK_P();
         std::vector<std::shared_ptr<Glyph> > out;
+        std::unique_lock<std::mutex> lock(p.face.mutex);
         try
         {
-            const auto utf32 = p.utf32Convert.from_bytes(text);
-            for (const auto& i : utf32)
+            const auto entry = p.getRun(text, fontInfo, 0);
+            const auto& run = entry->run;
+            out.reserve(run->codes.size());
+            GlyphInfo info(0, run->fontID, static_cast<uint16_t>(fontInfo.size));
+            for (size_t i = 0; i < run->codes.size(); ++i)
             {
-                out.push_back(p.getGlyph(i, fontInfo));
+                info.code = run->codes[i];
+                auto glyph = p.getGlyph(info, true);
+                const int kerning = i + 1 < run->kerning.size() ? run->kerning[i + 1] : 0;
+                if (glyph && kerning != 0)
+                {
+                    if (entry->glyphs[i] != glyph)
+                    {
+                        auto kerned = std::make_shared<Glyph>(*glyph);
+                        kerned->advance += kerning;
+                        entry->glyphs[i] = glyph;
+                        entry->kerned[i] = kerned;
+                    }
+                    glyph = entry->kerned[i];
+                }
+                out.push_back(glyph);
             }
         }
         catch (const std::exception&)
@@ -234,93 +580,432 @@ namespace ftk
         return out;
     }
 
-    std::shared_ptr<Glyph> FontSystem::Private::getGlyph(uint32_t code, const FontInfo& fontInfo)
+    GlyphMode FontSystem::getGlyphMode() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.face.mutex);
+        return p.glyphMode;
+    }
+
+    void FontSystem::setGlyphMode(GlyphMode value)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.face.mutex);
+        p.glyphMode = value;
+    }
+
+    std::shared_ptr<RasterCache> FontSystem::getRasterCache() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.rasterCache;
+    }
+
+    void FontSystem::setRasterCache(const std::shared_ptr<RasterCache>& value)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        p.mutex.rasterCache = value;
+    }
+
+    bool FontSystem::isAsync() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.face.mutex);
+        return p.async;
+    }
+
+    void FontSystem::setAsync(bool value)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.face.mutex);
+        p.async = value;
+    }
+
+    void FontSystem::prefetchGlyphs(const std::string& text, const FontInfo& fontInfo)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.face.mutex);
+        const auto run = p.getRun(text, fontInfo, 0)->run;
+        std::vector<GlyphInfo> infos;
+        infos.reserve(run->codes.size());
+        const uint16_t fontSize = GlyphMode::SDF == p.glyphMode ?
+            0 :
+            static_cast<uint16_t>(fontInfo.size);
+        for (const auto code : run->codes)
+        {
+            infos.push_back(GlyphInfo(code, run->fontID, fontSize));
+        }
+        p.request(infos);
+    }
+
+    bool FontSystem::hasPendingGlyphs() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return !p.mutex.pending.empty() || p.mutex.loaded != p.glyphsLoaded->get();
+    }
+
+    std::shared_ptr<IObservableValue<size_t> > FontSystem::observeGlyphsLoaded() const
+    {
+        return _p->glyphsLoaded;
+    }
+
+    void FontSystem::tick()
+    {
+        FTK_P();
+        size_t loaded = 0;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            loaded = p.mutex.loaded;
+        }
+        p.glyphsLoaded->setIfChanged(loaded);
+    }
+
+    std::chrono::milliseconds FontSystem::getTickTime() const
+    {
+        return std::chrono::milliseconds(10);
+    }
+
+    bool FontSystem::hasPendingWork() const
+    {
+        return hasPendingGlyphs();
+    }
+
+    std::shared_ptr<Glyph> FontSystem::Private::getGlyph(
+        const GlyphInfo& info,
+        bool request,
+        bool* loaded)
     {
         std::shared_ptr<Glyph> out;
-        if (!glyphCache.get(GlyphInfo(code, fontInfo), out))
+        if (GlyphMode::SDF == glyphMode && info.size > 0)
+        {
+            // Combine the metrics for the font size with the image of the
+            // size independent SDF glyph.
+            if (!face.sdfCache.get(info, out))
+            {
+                bool sdfLoaded = false;
+                const auto sdfGlyph = getGlyph(
+                    GlyphInfo(info.code, info.fontID, 0),
+                    request,
+                    &sdfLoaded);
+                out = std::make_shared<Glyph>(*getMetricsGlyph(info));
+                out->sdf = true;
+                out->imageScale = info.size / static_cast<float>(sdfGlyphSize);
+                if (sdfGlyph->image)
+                {
+                    out->image = sdfGlyph->image;
+                    out->offset = sdfGlyph->offset;
+                }
+                if (sdfLoaded)
+                {
+                    face.sdfCache.add(info, out);
+                }
+            }
+            return out;
+        }
         {
+            std::unique_lock<std::mutex> lock(mutex.mutex);
+            if (mutex.glyphCache.get(info, out))
+            {
+                if (loaded)
+                {
+                    *loaded = true;
+                }
+                return out;
+            }
+        }
+        if (!async)
+        {
+            const auto ftFaceIt = face.ftFaces.find(info.fontID);
+            if (ftFaceIt != face.ftFaces.end())
+            {
+                out = rasterize(ftFaceIt->second, info);
+            }
+            else
+            {
+                out = std::make_shared<Glyph>();
+                out->info = info;
+            }
+            std::unique_lock<std::mutex> lock(mutex.mutex);
+            mutex.glyphCache.add(info, out);
+            if (loaded)
+            {
+                *loaded = true;
+            }
+        }
+        else
+        {
+            // Use a glyph with only the metrics until the worker threads
+            // have rasterized it.
+            if (request)
+            {
+                this->request({ info });
+            }
+            out = getMetricsGlyph(info);
+        }
+        return out;
+    }
+
+    std::shared_ptr<Glyph> FontSystem::Private::getMetricsGlyph(const GlyphInfo& info)
+    {
+        std::shared_ptr<Glyph> out;
+        if (!face.metricsCache.get(info, out))
+        {
+            const auto ftFaceIt = face.ftFaces.find(info.fontID);
+            if (ftFaceIt != face.ftFaces.end())
+            {
+                out = ftk::getGlyph(ftFaceIt->second, info, imageType, false);
+            }
+            else
+            {
+                out = std::make_shared<Glyph>();
+                out->info = info;
+            }
+            face.metricsCache.add(info, out);
+        }
+        return out;
+    }
+
+    std::shared_ptr<Glyph> FontSystem::Private::rasterize(FT_Face ftFace, const GlyphInfo& info)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        std::shared_ptr<RasterCache> rasterCache;
+        std::string key;
+        {
+            std::unique_lock<std::mutex> lock(mutex.mutex);
+            rasterCache = mutex.rasterCache;
+            if (rasterCache)
+            {
+                const auto i = mutex.fontHashes.find(info.fontID);
+                key = "glyph:" +
+                    std::to_string(i != mutex.fontHashes.end() ? i->second : 0) + ":" +
+                    std::to_string(info.size) + ":" +
+                    std::to_string(info.code) + ":" +
+                    std::to_string(static_cast<int>(imageType));
+            }
+        }
+        std::shared_ptr<Glyph> out;
+        std::shared_ptr<Image> image;
+        std::vector<int32_t> data;
+        bool cached = false;
+        if (rasterCache && rasterCache->get(key, image, &data) && 5 == data.size())
+        {
+            cached = true;
             out = std::make_shared<Glyph>();
-            out->info = GlyphInfo(code, fontInfo);
+            out->info = info;
+            out->image = image;
+            out->offset = V2I(data[0], data[1]);
+            out->advance = data[2];
+            out->lsbDelta = data[3];
+            out->rsbDelta = data[4];
+            out->sdf = 0 == info.size;
+        }
+        else
+        {
+            out = ftk::getGlyph(ftFace, info, imageType, true);
+            if (rasterCache)
+            {
+                rasterCache->add(
+                    key,
+                    out->image,
+                    { out->offset.x, out->offset.y, out->advance, out->lsbDelta, out->rsbDelta });
+            }
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mutex.mutex);
+        GlyphStats& stats = mutex.stats[static_cast<size_t>(
+            out->sdf ? GlyphMode::SDF : GlyphMode::Bitmap)];
+        const auto time = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+        if (cached)
+        {
+            ++stats.cacheCount;
+            stats.cacheTime += time;
+        }
+        else
+        {
+            ++stats.glyphCount;
+            stats.byteCount += out->image ? out->image->getByteCount() : 0;
+            stats.time += time;
+        }
+        return out;
+    }
 
-            const auto ftFaceIt = ftFaces.find(fontInfo.family);
-            if (ftFaceIt != ftFaces.end())
+    std::shared_ptr<RunEntry> FontSystem::Private::getRun(
+        const std::string& text,
+        const FontInfo& fontInfo,
+        int maxLineWidth)
+    {
+        RunKey key;
+        key.text = text;
+        key.fontID = getFontID(fontInfo.family);
+        key.fontSize = fontInfo.size;
+        key.maxLineWidth = maxLineWidth;
+        std::shared_ptr<RunEntry> out;
+        if (!face.runCache.get(key, out))
+        {
+            auto run = std::make_shared<TextRun>();
+            run->text = text;
+            run->fontInfo = fontInfo;
+            run->fontID = key.fontID;
+            run->maxLineWidth = maxLineWidth;
+            try
             {
-                FT_Error ftError = FT_Set_Pixel_Sizes(
-                    ftFaceIt->second,
-                    0,
-                    static_cast<int>(fontInfo.size));
-                if (ftError)
+                const auto utf32 = face.utf32Convert.from_bytes(text);
+                run->codes.reserve(utf32.size());
+                for (const auto& i : utf32)
                 {
-                    throw std::runtime_error(
-                        Format("Cannot set pixel sizes: \"{0}\"").arg(fontInfo.family));
+                    run->codes.push_back(i);
                 }
-                if (auto ftGlyphIndex = FT_Get_Char_Index(ftFaceIt->second, code))
+                run->offsets.reserve(utf32.size());
+                for (size_t i = 0; i < text.size(); ++i)
                 {
-                    ftError = FT_Load_Glyph(ftFaceIt->second, ftGlyphIndex, FT_LOAD_FORCE_AUTOHINT);
-                    if (ftError)
+                    if ((static_cast<uint8_t>(text[i]) & 0xc0) != 0x80)
                     {
-                        throw std::runtime_error(
-                            Format("Cannot load glyph: \"{0}\"").arg(fontInfo.family));
+                        run->offsets.push_back(i);
                     }
-                    FT_Render_Mode renderMode = FT_RENDER_MODE_NORMAL;
-                    uint8_t renderModeChannels = 1;
-                    ftError = FT_Render_Glyph(ftFaceIt->second->glyph, renderMode);
-                    if (ftError)
+                }
+                measure(*run);
+            }
+            catch (const std::exception&)
+            {}
+            out = std::make_shared<RunEntry>();
+            out->run = run;
+            out->glyphs.resize(run->codes.size());
+            out->kerned.resize(run->codes.size());
+            face.runCache.add(key, out, getByteCount(*run));
+        }
+        return out;
+    }
+
+    void FontSystem::Private::request(const std::vector<GlyphInfo>& infos)
+    {
+        bool notify = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex.mutex);
+            for (const auto& info : infos)
+            {
+                if (!mutex.glyphCache.contains(info) &&
+                    mutex.pending.find(info) == mutex.pending.end())
+                {
+                    mutex.pending.insert(info);
+                    mutex.requests.push_back(info);
+                    notify = true;
+                }
+            }
+        }
+        if (notify)
+        {
+            if (thread.threads.empty())
+            {
+                const size_t threadCount = std::min(
+                    threadCountMax,
+                    std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(2)) - 1);
+                for (size_t i = 0; i < threadCount; ++i)
+                {
+                    thread.threads.push_back(std::thread(
+                        [this]
+                        {
+                            run();
+                        }));
+                }
+            }
+            thread.cv.notify_all();
+        }
+    }
+
+    void FontSystem::Private::run()
+    {
+        // FreeType objects cannot be shared between threads, so each worker
+        // thread has its own library and faces.
+        FT_Library ftLibrary = nullptr;
+        if (FT_Init_FreeType(&ftLibrary))
+        {
+            return;
+        }
+        setSDFSpread(ftLibrary);
+        std::unordered_map<FontID, std::pair<std::shared_ptr<std::vector<uint8_t> >, FT_Face> > ftFaces;
+        while (thread.running)
+        {
+            GlyphInfo info;
+            bool valid = false;
+            std::shared_ptr<std::vector<uint8_t> > fontData;
+            {
+                std::unique_lock<std::mutex> lock(mutex.mutex);
+                if (thread.cv.wait_for(
+                    lock,
+                    std::chrono::milliseconds(requestTimeout),
+                    [this]
                     {
-                        throw std::runtime_error(
-                            Format("Cannot render glyph: \"{0}\"").arg(fontInfo.family));
+                        return !mutex.requests.empty();
+                    }))
+                {
+                    info = mutex.requests.front();
+                    mutex.requests.pop_front();
+                    valid = true;
+                    const auto i = mutex.fontData.find(info.fontID);
+                    if (i != mutex.fontData.end())
+                    {
+                        fontData = i->second;
                     }
-
-                    auto ftBitmap = ftFaceIt->second->glyph->bitmap;
-                    const ImageInfo imageInfo(ftBitmap.width, ftBitmap.rows, imageType);
-                    out->image = Image::create(imageInfo);
-                    for (size_t y = 0; y < ftBitmap.rows; ++y)
+                }
+            }
+            if (valid)
+            {
+                std::shared_ptr<Glyph> glyph;
+                try
+                {
+                    auto i = ftFaces.find(info.fontID);
+                    if (i != ftFaces.end() && i->second.first != fontData)
                     {
-                        const int channelCount = getChannelCount(imageInfo.type);
-                        uint8_t* dataP = out->image->getData() + y * imageInfo.size.w * channelCount;
-                        const unsigned char* bitmapP = ftBitmap.buffer + y * ftBitmap.pitch;
-                        switch (channelCount)
+                        FT_Done_Face(i->second.second);
+                        ftFaces.erase(i);
+                        i = ftFaces.end();
+                    }
+                    if (i == ftFaces.end() && fontData)
+                    {
+                        FT_Face ftFace = nullptr;
+                        if (!FT_New_Memory_Face(
+                            ftLibrary,
+                            fontData->data(),
+                            fontData->size(),
+                            0,
+                            &ftFace))
                         {
-                        case 1:
-                            memcpy(dataP, bitmapP, imageInfo.size.w);
-                            break;
-                        case 2:
-                            for (size_t x = 0; x < imageInfo.size.w; ++x)
-                            {
-                                dataP[x * 2 + 0] = bitmapP[x];
-                                dataP[x * 2 + 1] = bitmapP[x];
-                            }
-                            break;
-                        case 3:
-                            for (size_t x = 0; x < imageInfo.size.w; ++x)
-                            {
-                                dataP[x * 3 + 0] = bitmapP[x];
-                                dataP[x * 3 + 1] = bitmapP[x];
-                                dataP[x * 3 + 2] = bitmapP[x];
-                            }
-                            break;
-                        case 4:
-                            for (size_t x = 0; x < imageInfo.size.w; ++x)
-                            {
-                                dataP[x * 4 + 0] = bitmapP[x];
-                                dataP[x * 4 + 1] = bitmapP[x];
-                                dataP[x * 4 + 2] = bitmapP[x];
-                                dataP[x * 4 + 3] = bitmapP[x];
-                            }
-                            break;
-                        default: break;
+                            i = ftFaces.insert(std::make_pair(
+                                info.fontID,
+                                std::make_pair(fontData, ftFace))).first;
                         }
                     }
-                    out->offset = V2I(ftFaceIt->second->glyph->bitmap_left, ftFaceIt->second->glyph->bitmap_top);
-                    out->advance = ftFaceIt->second->glyph->advance.x / 64;
-                    out->lsbDelta = ftFaceIt->second->glyph->lsb_delta;
-                    out->rsbDelta = ftFaceIt->second->glyph->rsb_delta;
+                    if (i != ftFaces.end())
+                    {
+                        glyph = rasterize(i->second.second, info);
+                    }
+                }
+                catch (const std::exception&)
+                {}
+                if (!glyph)
+                {
+                    glyph = std::make_shared<Glyph>();
+                    glyph->info = info;
+                }
+                // Don't cache the glyph if the font was replaced while it
+                // was being rasterized.
+                std::unique_lock<std::mutex> lock(mutex.mutex);
+                const auto i = mutex.fontData.find(info.fontID);
+                if (i == mutex.fontData.end() || i->second == fontData)
+                {
+                    mutex.glyphCache.add(info, glyph);
                 }
+                mutex.pending.erase(info);
+                ++mutex.loaded;
             }
-
-            glyphCache.add(out->info, out);
         }
-        return out;
+        for (const auto& i : ftFaces)
+        {
+            FT_Done_Face(i.second.second);
+        }
+        FT_Done_FreeType(ftLibrary);
     }
 
     namespace
@@ -331,15 +1016,15 @@ namespace ftk
         }
     }
 
-    void FontSystem::Private::measure(
-        const std::basic_string<ftk_char_t>& utf32,
-        const FontInfo& fontInfo,
-        int maxLineWidth,
-        Size2I& size,
-        std::vector<Box2I>* glyphGeom)
+    void FontSystem::Private::measure(TextRun& run)
     {
-        const auto ftFaceIt = ftFaces.find(fontInfo.family);
-        if (ftFaceIt != ftFaces.end())
+        const std::vector<uint32_t>& utf32 = run.codes;
+        const FontInfo& fontInfo = run.fontInfo;
+        const int maxLineWidth = run.maxLineWidth;
+        Size2I& size = run.size;
+        std::vector<Box2I>* glyphGeom = &run.boxes;
+        const auto ftFaceIt = face.ftFaces.find(run.fontID);
+        if (ftFaceIt != face.ftFaces.end())
         {
             V2I pos;
             FT_Error ftError = FT_Set_Pixel_Sizes(
@@ -352,14 +1037,46 @@ namespace ftk
                     Format("Cannot set pixel sizes: \"{0}\"").arg(fontInfo.family));
             }
 
+            auto kerningIt = face.kerning.find(ftFaceIt->first);
+            if (kerningIt == face.kerning.end())
+            {
+                kerningIt = face.kerning.insert(std::make_pair(
+                    ftFaceIt->first,
+                    std::unique_ptr<FontKerning>(new FontKerning(ftFaceIt->second)))).first;
+            }
+            const FontKerning* kerning = kerningIt->second->isValid() ?
+                kerningIt->second.get() :
+                nullptr;
+            const FT_Fixed xScale = ftFaceIt->second->size->metrics.x_scale;
+            run.kerning.resize(utf32.size(), 0);
+
             const int h = ftFaceIt->second->size->metrics.height / 64;
             pos.y = h;
             auto textLine = utf32.end();
             int textLineX = 0;
             int32_t rsbDeltaPrev = 0;
+            FT_UInt indexPrev = 0;
+            GlyphInfo info(0, ftFaceIt->first, static_cast<uint16_t>(fontInfo.size));
             for (auto utf32It = utf32.begin(); utf32It != utf32.end(); ++utf32It)
             {
-                const auto glyph = getGlyph(*utf32It, fontInfo);
+                info.code = *utf32It;
+                const auto glyph = getGlyph(info, false);
+
+                if (kerning)
+                {
+                    const FT_UInt index = FT_Get_Char_Index(ftFaceIt->second, *utf32It);
+                    int x = 0;
+                    if (indexPrev && index && pos.x > 0)
+                    {
+                        const FT_Pos value = FT_MulFix(
+                            kerning->getKerning(ftFaceIt->second, indexPrev, index),
+                            xScale);
+                        x = static_cast<int>((value + (value >= 0 ? 32 : -32)) / 64);
+                    }
+                    run.kerning[utf32It - utf32.begin()] = x;
+                    pos.x += x;
+                    indexPrev = index;
+                }
 
                 if (glyphGeom)
                 {
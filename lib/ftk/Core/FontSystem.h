@@ -6,10 +6,13 @@
 #include <ftk/Core/Box.h>
 #include <ftk/Core/ISystem.h>
 #include <ftk/Core/Image.h>
+#include <ftk/Core/LRUCache.h>
+#include <ftk/Core/ObservableValue.h>
 
 namespace ftk
 {
     class Context;
+    class RasterCache;
 
     //! \name Fonts
     ///@{
@@ -29,6 +32,25 @@ namespace ftk
     //! Get a built-in font.
     std::string getFont(Font);
 
+    //! Glyph rasterization modes.
+    enum class GlyphMode
+    {
+        Bitmap, //!< Rasterize a bitmap for each font size
+        SDF,    //!< Rasterize a signed distance field once for all font sizes
+
+        Count,
+        First = Bitmap
+    };
+    FTK_ENUM(GlyphMode);
+
+    //! The font size that SDF glyphs are rasterized at.
+    const uint16_t sdfGlyphSize = 48;
+
+    //! The distance in pixels, at the SDF glyph size, that is covered by the
+    //! SDF glyph values. A value of 128 is on the glyph outline and values
+    //! greater than 128 are inside.
+    const int sdfGlyphSpread = 6;
+
     //! Font information.
     struct FontInfo
     {
@@ -51,14 +73,37 @@ namespace ftk
         int lineHeight = 0;
     };
 
-    //! Font glyph information.
+    //! Font ID. Font families are interned as small integers so that
+    //! glyph lookups do not need to compare or copy strings.
+    typedef uint16_t FontID;
+
+    //! Get the ID of a font family. This function is thread safe.
+    FontID getFontID(const std::string& family);
+
+    //! Get the font family of an ID. This function is thread safe.
+    const std::string& getFontFamily(FontID);
+
+    //! Font glyph information. The information is small enough to be
+    //! packed into a single 64-bit key.
     struct GlyphInfo
     {
         GlyphInfo() = default;
+
+        //! Create glyph information from font information. This looks up
+        //! the font ID, use the other constructor for many glyphs.
         GlyphInfo(uint32_t code, const FontInfo&);
 
-        uint32_t code     = 0;
-        FontInfo fontInfo;
+        GlyphInfo(uint32_t code, FontID, uint16_t size);
+
+        uint32_t code   = 0;
+        FontID   fontID = 0;
+        uint16_t size   = 0;
+
+        //! Get the packed key.
+        uint64_t getKey() const;
+
+        //! Get the font information.
+        FontInfo getFontInfo() const;
 
         bool operator == (const GlyphInfo&) const;
         bool operator != (const GlyphInfo&) const;
@@ -66,18 +111,75 @@ namespace ftk
     };
 
     //! Font glyph.
+    //!
+    //! SDF glyphs share the image of the size independent SDF glyph. The
+    //! image and offset are in the pixels of the SDF glyph size, and are
+    //! multiplied by the image scale to get the pixels of the font size.
     struct Glyph
     {
         GlyphInfo              info;
         std::shared_ptr<Image> image;
         V2I                    offset;
-        int                    advance  = 0;
-        int32_t                lsbDelta = 0;
-        int32_t                rsbDelta = 0;
+        int                    advance    = 0;
+        int32_t                lsbDelta   = 0;
+        int32_t                rsbDelta   = 0;
+        bool                   sdf        = false;
+        float                  imageScale = 1.F;
+    };
+
+    //! Glyph rasterization statistics.
+    struct GlyphStats
+    {
+        size_t glyphCount = 0; //!< The number of rasterized glyphs
+        size_t byteCount  = 0; //!< The number of bytes in the rasterized glyph images
+        std::chrono::microseconds time = std::chrono::microseconds(0); //!< The rasterization time
+        size_t cacheCount = 0; //!< The number of glyphs read from the raster cache
+        std::chrono::microseconds cacheTime = std::chrono::microseconds(0); //!< The raster cache read time
+    };
+
+    //! Shaped and measured text run. Text runs are cached by the font system
+    //! and shared, so they are immutable.
+    //!
+    //! Shaping applies the kerning of the font to the glyph positions.
+    //! Ligatures and complex scripts are not supported, each code point is
+    //! drawn with a single glyph.
+    struct TextRun
+    {
+        std::string           text;
+        FontInfo              fontInfo;
+        FontID                fontID       = 0;
+        int                   maxLineWidth = 0;
+
+        //! The code points of the text.
+        std::vector<uint32_t> codes;
+
+        //! The UTF-8 byte offset of each code point.
+        std::vector<size_t>   offsets;
+
+        Size2I                size;
+
+        //! The box of each code point.
+        std::vector<Box2I>    boxes;
+
+        //! The kerning between each code point and the previous code point
+        //! on the same line, in pixels.
+        std::vector<int>      kerning;
+
+        //! Get the width of the text up to the given UTF-8 byte offset.
+        //! This is only meaningful for runs with a single line.
+        int getPrefixWidth(size_t) const;
+
+        //! Get the index of the first code point that ends at or after the
+        //! given position. This is only meaningful for runs with a single
+        //! line.
+        size_t getIndex(int) const;
     };
 
     //! Font system.
     //!
+    //! The font system functions are thread safe. Glyphs can optionally be
+    //! rasterized by a pool of worker threads, see setAsync().
+    //!
     //! \todo Add text elide functionality.
     //! \todo Add support for gamma correction?
     //! - https://www.freetype.org/freetype2/docs/text-rendering-general.html
@@ -106,6 +208,9 @@ namespace ftk
         //! Get the percentage of the glyph cache in use.
         float getGlyphCachePercentage() const;
 
+        //! Get the rasterization statistics for a glyph mode.
+        GlyphStats getGlyphStats(GlyphMode) const;
+
         ///@}
 
         //! \name Measure
@@ -126,18 +231,74 @@ namespace ftk
             const FontInfo&,
             int maxLineWidth = 0);
 
+        //! Get the measured text run for the given string. Text runs are
+        //! kept in a cache with a bounded size.
+        std::shared_ptr<const TextRun> getRun(
+            const std::string&,
+            const FontInfo&,
+            int maxLineWidth = 0);
+
+        //! Get the text run cache size in bytes.
+        size_t getRunCacheSize() const;
+
         ///@}
 
         //! \name Glyphs
         ///@{
 
-        //! Get the glyphs for the given string.
+        //! Get the glyphs for the given string. The glyph advances include
+        //! the kerning from the text run, so the glyphs can be drawn
+        //! directly.
         std::vector<std::shared_ptr<Glyph> > getGlyphs(
             const std::string&,
             const FontInfo&);
 
+        //! Get the glyph mode.
+        GlyphMode getGlyphMode() const;
+
+        //! Set the glyph mode. In SDF mode each glyph is rasterized once
+        //! and drawn at any font size by the renderer.
+        void setGlyphMode(GlyphMode);
+
+        //! Get the raster cache.
+        std::shared_ptr<RasterCache> getRasterCache() const;
+
+        //! Set the raster cache. Rasterized glyphs are read from and added
+        //! to the raster cache.
+        void setRasterCache(const std::shared_ptr<RasterCache>&);
+
         ///@}
 
+        //! \name Asynchronous Glyphs
+        ///@{
+
+        //! Get whether glyphs are rasterized asynchronously.
+        bool isAsync() const;
+
+        //! Set whether glyphs are rasterized asynchronously. In async mode
+        //! measuring and getting glyphs do not block on rasterization.
+        //! Glyphs that are not in the cache are returned with their metrics
+        //! but without an image, and are rasterized by the worker threads.
+        void setAsync(bool);
+
+        //! Request the glyphs for the given string to be rasterized by the
+        //! worker threads.
+        void prefetchGlyphs(const std::string&, const FontInfo&);
+
+        //! Get whether there are glyphs that are waiting to be rasterized,
+        //! or that have been rasterized but not yet observed.
+        bool hasPendingGlyphs() const;
+
+        //! Observe the number of glyphs rasterized by the worker threads.
+        //! The value is updated when the system is ticked.
+        std::shared_ptr<IObservableValue<size_t> > observeGlyphsLoaded() const;
+
+        ///@}
+
+        void tick() override;
+        std::chrono::milliseconds getTickTime() const override;
+        bool hasPendingWork() const override;
+
     private:
         FTK_PRIVATE();
     };
@@ -151,5 +312,20 @@ namespace ftk
     ///@}
 }
 
+namespace std
+{
+    template<>
+    struct hash<ftk::FontInfo>
+    {
+        std::size_t operator() (const ftk::FontInfo&) const noexcept;
+    };
+
+    template<>
+    struct hash<ftk::GlyphInfo>
+    {
+        std::size_t operator() (const ftk::GlyphInfo&) const noexcept;
+    };
+}
+
 #include <ftk/Core/FontSystemInline.h>
 
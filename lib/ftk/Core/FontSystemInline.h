@@ -25,12 +25,32 @@ namespace ftk
 
     inline GlyphInfo::GlyphInfo(uint32_t code, const FontInfo& fontInfo) :
         code(code),
-        fontInfo(fontInfo)
+        fontID(getFontID(fontInfo.family)),
+        size(static_cast<uint16_t>(fontInfo.size))
     {}
 
+    inline GlyphInfo::GlyphInfo(uint32_t code, FontID fontID, uint16_t size) :
+        code(code),
+        fontID(fontID),
+        size(size)
+    {}
+
+    inline uint64_t GlyphInfo::getKey() const
+    {
+        return
+            (static_cast<uint64_t>(fontID) << 48) |
+            (static_cast<uint64_t>(size) << 32) |
+            static_cast<uint64_t>(code);
+    }
+
+    inline FontInfo GlyphInfo::getFontInfo() const
+    {
+        return FontInfo(getFontFamily(fontID), size);
+    }
+
     inline bool GlyphInfo::operator == (const GlyphInfo & other) const
     {
-        return code == other.code && fontInfo == other.fontInfo;
+        return getKey() == other.getKey();
     }
 
     inline bool GlyphInfo::operator != (const GlyphInfo& other) const
@@ -40,6 +60,21 @@ namespace ftk
 
     inline bool GlyphInfo::operator < (const GlyphInfo& other) const
     {
-        return std::tie(code, fontInfo) < std::tie(other.code, other.fontInfo);
+        return getKey() < other.getKey();
+    }
+}
+
+namespace std
+{
+    inline std::size_t hash<ftk::FontInfo>::operator() (const ftk::FontInfo& value) const noexcept
+    {
+        std::size_t out = std::hash<std::string>()(value.family);
+        ftk::hashCombine(out, value.size);
+        return out;
+    }
+
+    inline std::size_t hash<ftk::GlyphInfo>::operator() (const ftk::GlyphInfo& value) const noexcept
+    {
+        return std::hash<uint64_t>()(value.getKey());
     }
 }
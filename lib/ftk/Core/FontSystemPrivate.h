@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/FontSystem.h>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <unordered_map>
+#include <vector>
+
+namespace ftk
+{
+    //! Font kerning.
+    //!
+    //! The pair adjustments are read from the OpenType GPOS "kern" feature.
+    //! Fonts without a GPOS table fall back to the legacy "kern" table with
+    //! FreeType.
+    class FontKerning
+    {
+    public:
+        FontKerning(FT_Face);
+
+        //! Get whether the font has kerning.
+        bool isValid() const;
+
+        //! Get the horizontal kerning between two glyph indices, in font
+        //! units.
+        FT_Long getKerning(FT_Face, FT_UInt left, FT_UInt right) const;
+
+    private:
+        void _read(const std::vector<uint8_t>&);
+        void _readPairPos(const std::vector<uint8_t>&, size_t offset, size_t lookup);
+
+        struct Subtable
+        {
+            //! Format 1 glyph pairs.
+            std::unordered_map<uint32_t, int16_t> pairs;
+
+            //! Format 2 class pairs.
+            std::unordered_map<uint16_t, uint16_t> coverage;
+            std::unordered_map<uint16_t, uint16_t> classDef1;
+            std::unordered_map<uint16_t, uint16_t> classDef2;
+            uint16_t class2Count = 0;
+            std::vector<int16_t> values;
+        };
+        std::vector<std::vector<Subtable> > _lookups;
+        bool _legacy = false;
+    };
+}
@@ -38,4 +38,9 @@ namespace ftk
     {
         return std::chrono::milliseconds(0);
     }
+
+    bool ISystem::hasPendingWork() const
+    {
+        return false;
+    }
 }
\ No newline at end of file
@@ -38,6 +38,11 @@ namespace ftk
         //! Get the system tick time interval.
         virtual std::chrono::milliseconds getTickTime() const;
 
+        //! Get whether the system has asynchronous work in progress. The
+        //! application event loop keeps ticking the systems instead of
+        //! waiting for events while any system has work in progress.
+        virtual bool hasPendingWork() const;
+
     protected:
         std::weak_ptr<Context> _context;
         std::string _name;
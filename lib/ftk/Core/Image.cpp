@@ -6,9 +6,14 @@
 #include <ftk/Core/Error.h>
 #include <ftk/Core/String.h>
 
+#include <algorithm>
 #include <array>
 #include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
 #include <sstream>
+#include <unordered_map>
 
 namespace ftk
 {
@@ -122,6 +127,8 @@ namespace ftk
         std::size_t out = 0;
         const size_t w = size.w;
         const size_t h = size.h;
+        const size_t w2 = (w + 1) / 2;
+        const size_t h2 = (h + 1) / 2;
         const size_t alignment = layout.alignment;
         switch (type)
         {
@@ -151,11 +158,12 @@ namespace ftk
         case ImageType::RGBA_F32: out = getAlignedByteCount(w * 4 * 4, alignment) * h; break;
 
             //! \todo Is YUV data aligned?
-        case ImageType::YUV_420P_U8:  out = w * h + (w / 2 * h / 2) + (w / 2 * h / 2); break;
-        case ImageType::YUV_422P_U8:  out = w * h + (w / 2 * h) + (w / 2 * h); break;
+            // The chroma planes of odd sized images are rounded up.
+        case ImageType::YUV_420P_U8:  out = w * h + (w2 * h2) * 2; break;
+        case ImageType::YUV_422P_U8:  out = w * h + (w2 * h) * 2; break;
         case ImageType::YUV_444P_U8:  out = w * h * 3; break;
-        case ImageType::YUV_420P_U16: out = (w * h + (w / 2 * h / 2) + (w / 2 * h / 2)) * 2; break;
-        case ImageType::YUV_422P_U16: out = (w * h + (w / 2 * h) + (w / 2 * h)) * 2; break;
+        case ImageType::YUV_420P_U16: out = (w * h + (w2 * h2) * 2) * 2; break;
+        case ImageType::YUV_422P_U16: out = (w * h + (w2 * h) * 2) * 2; break;
         case ImageType::YUV_444P_U16: out = (w * h * 3) * 2; break;
 
         case ImageType::ARGB_4444_Premult: out = w * h * 4 * 2; break;
@@ -165,6 +173,152 @@ namespace ftk
         return out;
     }
 
+    namespace
+    {
+        //! Get the size of the memory block used for an allocation. There
+        //! are four block sizes for each power of two, so that at most a
+        //! quarter of a block is unused.
+        size_t getBlockByteCount(size_t value)
+        {
+            size_t pow2 = imageDataAlignment;
+            while (pow2 * 2 <= value)
+            {
+                pow2 *= 2;
+            }
+            const size_t step = std::max(pow2 / 4, imageDataAlignment);
+            return (value + step - 1) / step * step;
+        }
+
+        class ImageMemoryPool
+        {
+        public:
+            uint8_t* alloc(size_t byteCount)
+            {
+                uint8_t* out = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    ++_stats.allocCount;
+                    _stats.byteCount += byteCount;
+                    _stats.byteCountMax = std::max(_stats.byteCountMax, _stats.byteCount);
+                    const auto i = _blocks.find(byteCount);
+                    if (i != _blocks.end() && !i->second.empty())
+                    {
+                        out = i->second.back();
+                        i->second.pop_back();
+                        _stats.poolByteCount -= byteCount;
+                        ++_stats.poolHits;
+                    }
+                }
+                if (!out)
+                {
+                    out = static_cast<uint8_t*>(alignedAlloc(byteCount, imageDataAlignment));
+                    if (!out)
+                    {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        _stats.byteCount -= byteCount;
+                        throw std::bad_alloc();
+                    }
+                }
+                return out;
+            }
+
+            void free(uint8_t* data, size_t byteCount)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _stats.byteCount -= byteCount;
+                    if (_stats.poolByteCount + byteCount <= _max)
+                    {
+                        _blocks[byteCount].push_back(data);
+                        _stats.poolByteCount += byteCount;
+                        data = nullptr;
+                    }
+                }
+                if (data)
+                {
+                    alignedFree(data);
+                }
+            }
+
+            ImageMemoryStats getStats()
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                return _stats;
+            }
+
+            void setMax(size_t value)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _max = value;
+                _trim();
+            }
+
+            void clear()
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                for (auto& i : _blocks)
+                {
+                    for (auto j : i.second)
+                    {
+                        alignedFree(j);
+                    }
+                }
+                _blocks.clear();
+                _stats.poolByteCount = 0;
+            }
+
+        private:
+            void _trim()
+            {
+                // Release the largest blocks first.
+                std::vector<size_t> sizes;
+                for (const auto& i : _blocks)
+                {
+                    sizes.push_back(i.first);
+                }
+                std::sort(sizes.begin(), sizes.end(), std::greater<size_t>());
+                for (auto size : sizes)
+                {
+                    auto& blocks = _blocks[size];
+                    while (_stats.poolByteCount > _max && !blocks.empty())
+                    {
+                        alignedFree(blocks.back());
+                        blocks.pop_back();
+                        _stats.poolByteCount -= size;
+                    }
+                }
+            }
+
+            std::mutex _mutex;
+            std::unordered_map<size_t, std::vector<uint8_t*> > _blocks;
+            ImageMemoryStats _stats;
+            size_t _max = imageMemoryPoolMax;
+        };
+
+        //! The pool is not destroyed so that images can be released
+        //! during static destruction.
+        ImageMemoryPool& getImageMemoryPool()
+        {
+            static ImageMemoryPool* pool = new ImageMemoryPool;
+            return *pool;
+        }
+    }
+
+    ImageMemoryStats getImageMemoryStats()
+    {
+        return getImageMemoryPool().getStats();
+    }
+
+    void setImageMemoryPoolMax(size_t value)
+    {
+        getImageMemoryPool().setMax(value);
+    }
+
+    void clearImageMemoryPool()
+    {
+        getImageMemoryPool().clear();
+    }
+
     Image::Image(const ImageInfo& info, uint8_t* externalData) :
         _info(info)
     {
@@ -177,13 +331,19 @@ namespace ftk
         {
             // Allocate a bit of extra space since FFmpeg sws_scale()
             // can read past the end.
-            _data.resize(_byteCount + 16);
-            _dataP = _data.data();
+            _poolByteCount = getBlockByteCount(_byteCount + 16);
+            _poolData = getImageMemoryPool().alloc(_poolByteCount);
+            _dataP = _poolData;
         }
     }
 
     Image::~Image()
-    {}
+    {
+        if (_poolData)
+        {
+            getImageMemoryPool().free(_poolData, _poolByteCount);
+        }
+    }
 
     std::shared_ptr<Image> Image::create(const ImageInfo& info)
     {
@@ -157,7 +157,37 @@ namespace ftk
     //! Image tags.
     typedef std::map<std::string, std::string> ImageTags;
 
+    //! Alignment of the image data in bytes.
+    const size_t imageDataAlignment = 64;
+
+    //! Default maximum size of the image memory pool in bytes.
+    const size_t imageMemoryPoolMax = 64 * megabyte;
+
+    //! Image memory statistics.
+    struct ImageMemoryStats
+    {
+        size_t allocCount = 0;    //!< Number of allocations
+        size_t poolHits = 0;      //!< Allocations that reused pooled memory
+        size_t byteCount = 0;     //!< Size of the memory used by images
+        size_t byteCountMax = 0;  //!< Peak size of the memory used by images
+        size_t poolByteCount = 0; //!< Size of the memory held by the pool
+    };
+
+    //! Get the image memory statistics.
+    ImageMemoryStats getImageMemoryStats();
+
+    //! Set the maximum size of the image memory pool in bytes.
+    void setImageMemoryPoolMax(size_t);
+
+    //! Release the memory held by the image memory pool.
+    void clearImageMemoryPool();
+
     //! Image.
+    //!
+    //! The image data is allocated from a memory pool that reuses the
+    //! memory of released images with a similar size. The data is aligned
+    //! to imageDataAlignment and is not initialized, use zero() to clear
+    //! it.
     class Image : public std::enable_shared_from_this<Image>
     {
         FTK_NON_COPYABLE(Image);
@@ -223,7 +253,8 @@ namespace ftk
         ImageInfo _info;
         ImageTags _tags;
         size_t _byteCount = 0;
-        std::vector<uint8_t> _data;
+        size_t _poolByteCount = 0;
+        uint8_t* _poolData = nullptr;
         uint8_t* _dataP = nullptr;
     };
 
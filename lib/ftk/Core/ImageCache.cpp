@@ -0,0 +1,399 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/ImageCache.h>
+
+#include <ftk/Core/Context.h>
+#include <ftk/Core/LRUCache.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace ftk
+{
+    namespace
+    {
+        //! Get the key for a file and options. The modification time is not
+        //! included, so that pins are kept when a file changes.
+        std::string getBaseKey(
+            const std::filesystem::path& path,
+            const ImageIOOptions& options)
+        {
+            std::string out = path.u8string();
+            for (const auto& i : options)
+            {
+                out += '\n' + i.first + '=' + i.second;
+            }
+            return out;
+        }
+
+        std::string getKey(
+            const std::filesystem::path& path,
+            const std::string& baseKey)
+        {
+            std::error_code ec;
+            const auto time = std::filesystem::last_write_time(path, ec);
+            return baseKey + '\n' + std::to_string(!ec ? time.time_since_epoch().count() : 0);
+        }
+
+        bool isReady(const std::shared_future<std::shared_ptr<Image> >& future)
+        {
+            return future.valid() &&
+                future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        std::shared_ptr<Image> getImage(const std::shared_future<std::shared_ptr<Image> >& future)
+        {
+            std::shared_ptr<Image> out;
+            try
+            {
+                out = future.get();
+            }
+            catch (const std::exception&)
+            {}
+            return out;
+        }
+    }
+
+    struct ImageCache::Private
+    {
+        std::weak_ptr<ImageIO> io;
+        uint64_t id = 0;
+
+        LRUCache<std::string, std::shared_ptr<Image> > cache;
+
+        struct Pin
+        {
+            size_t count = 0;
+            std::string key;
+            std::shared_ptr<Image> image;
+        };
+        std::unordered_map<std::string, Pin> pins;
+
+        struct Read
+        {
+            uint64_t id = 0;
+            std::shared_future<std::shared_ptr<Image> > future;
+        };
+        std::unordered_map<std::string, Read> reads;
+
+        struct Request
+        {
+            uint64_t id = 0;
+            std::string key;
+            std::shared_future<std::shared_ptr<Image> > future;
+            std::function<void(const std::shared_ptr<Image>&)> callback;
+        };
+        std::list<Request> requests;
+
+        ImageCacheStats stats;
+        size_t evictions = 0;
+
+        void add(const std::string& key, const std::shared_ptr<Image>&);
+    };
+
+    ImageCache::ImageCache(const std::shared_ptr<Context>& context) :
+        ISystem(context, "ftk::ImageCache"),
+        _p(new Private)
+    {
+        FTK_P();
+        p.io = context->getSystem<ImageIO>();
+        p.cache.setMax(imageCacheMax);
+    }
+
+    ImageCache::~ImageCache()
+    {
+        FTK_P();
+        if (auto io = p.io.lock())
+        {
+            std::vector<uint64_t> ids;
+            for (const auto& i : p.reads)
+            {
+                ids.push_back(i.second.id);
+            }
+            io->cancelRequests(ids);
+        }
+    }
+
+    std::shared_ptr<ImageCache> ImageCache::create(const std::shared_ptr<Context>& context)
+    {
+        return std::shared_ptr<ImageCache>(new ImageCache(context));
+    }
+
+    size_t ImageCache::getMax() const
+    {
+        return _p->cache.getMax();
+    }
+
+    void ImageCache::setMax(size_t value)
+    {
+        _p->cache.setMax(value);
+    }
+
+    ImageCacheRequest ImageCache::get(
+        const std::filesystem::path& path,
+        const ImageIOOptions& options,
+        ImageIOPriority priority,
+        const std::function<void(const std::shared_ptr<Image>&)>& callback)
+    {
+        FTK_P();
+        const std::string baseKey = getBaseKey(path, options);
+        const std::string key = getKey(path, baseKey);
+        ImageCacheRequest out;
+        out.id = p.id++;
+
+        // Look for the image in the pins and the cache.
+        std::shared_ptr<Image> image;
+        const auto i = p.pins.find(baseKey);
+        if (i != p.pins.end() && i->second.key == key && i->second.image)
+        {
+            image = i->second.image;
+        }
+        else
+        {
+            p.cache.get(key, image);
+        }
+
+        if (image)
+        {
+            ++p.stats.hits;
+            std::promise<std::shared_ptr<Image> > promise;
+            promise.set_value(image);
+            out.future = promise.get_future().share();
+        }
+        else
+        {
+            // Share the read if the image is already being read.
+            auto j = p.reads.find(key);
+            if (j != p.reads.end())
+            {
+                ++p.stats.shared;
+            }
+            else
+            {
+                ++p.stats.misses;
+                Private::Read read;
+                if (auto io = p.io.lock())
+                {
+                    auto request = io->requestRead(path, options, priority);
+                    read.id = request.id;
+                    read.future = request.future.share();
+                }
+                else
+                {
+                    std::promise<std::shared_ptr<Image> > promise;
+                    promise.set_value(nullptr);
+                    read.future = promise.get_future().share();
+                }
+                j = p.reads.insert(std::make_pair(key, read)).first;
+            }
+            out.future = j->second.future;
+        }
+
+        Private::Request request;
+        request.id = out.id;
+        request.key = key;
+        request.future = out.future;
+        request.callback = callback;
+        p.requests.push_back(request);
+        return out;
+    }
+
+    void ImageCache::cancelRequests(const std::vector<uint64_t>& ids)
+    {
+        FTK_P();
+        std::vector<std::string> keys;
+        auto i = p.requests.begin();
+        while (i != p.requests.end())
+        {
+            if (std::find(ids.begin(), ids.end(), i->id) != ids.end())
+            {
+                keys.push_back(i->key);
+                i = p.requests.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        // Cancel the reads that no other requests are waiting for.
+        std::vector<uint64_t> readIds;
+        for (const auto& key : keys)
+        {
+            const auto j = p.reads.find(key);
+            if (j != p.reads.end() &&
+                std::none_of(
+                    p.requests.begin(),
+                    p.requests.end(),
+                    [&key](const Private::Request& request)
+                    {
+                        return request.key == key;
+                    }))
+            {
+                readIds.push_back(j->second.id);
+                p.reads.erase(j);
+            }
+        }
+        if (!readIds.empty())
+        {
+            if (auto io = p.io.lock())
+            {
+                io->cancelRequests(readIds);
+            }
+        }
+    }
+
+    void ImageCache::pin(
+        const std::filesystem::path& path,
+        const ImageIOOptions& options)
+    {
+        FTK_P();
+        const std::string baseKey = getBaseKey(path, options);
+        Private::Pin& pin = p.pins[baseKey];
+        if (0 == pin.count)
+        {
+            // Move the image out of the cache so that it is not evicted.
+            pin.key = getKey(path, baseKey);
+            if (p.cache.contains(pin.key))
+            {
+                p.cache.get(pin.key, pin.image);
+                p.cache.remove(pin.key);
+            }
+        }
+        ++pin.count;
+    }
+
+    void ImageCache::unpin(
+        const std::filesystem::path& path,
+        const ImageIOOptions& options)
+    {
+        FTK_P();
+        const auto i = p.pins.find(getBaseKey(path, options));
+        if (i != p.pins.end())
+        {
+            --i->second.count;
+            if (0 == i->second.count)
+            {
+                const Private::Pin pin = i->second;
+                p.pins.erase(i);
+                if (pin.image)
+                {
+                    p.add(pin.key, pin.image);
+                }
+            }
+        }
+    }
+
+    size_t ImageCache::getRequestCount() const
+    {
+        return _p->requests.size();
+    }
+
+    void ImageCache::clear()
+    {
+        FTK_P();
+        p.evictions += p.cache.getEvictions();
+        p.cache.clear();
+        p.cache.resetStats();
+    }
+
+    ImageCacheStats ImageCache::getStats() const
+    {
+        FTK_P();
+        ImageCacheStats out = p.stats;
+        out.count = p.cache.getCount();
+        out.byteCount = p.cache.getSize();
+        for (const auto& i : p.pins)
+        {
+            if (i.second.image)
+            {
+                ++out.pinnedCount;
+                out.pinnedByteCount += i.second.image->getByteCount();
+            }
+        }
+        out.evictions = p.evictions + p.cache.getEvictions();
+        return out;
+    }
+
+    void ImageCache::resetStats()
+    {
+        FTK_P();
+        p.stats = ImageCacheStats();
+        p.evictions = 0;
+        p.cache.resetStats();
+    }
+
+    void ImageCache::tick()
+    {
+        FTK_P();
+
+        // Add the images that have been read.
+        auto i = p.reads.begin();
+        while (i != p.reads.end())
+        {
+            if (isReady(i->second.future))
+            {
+                if (auto image = getImage(i->second.future))
+                {
+                    p.add(i->first, image);
+                }
+                i = p.reads.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        // Call the callbacks of the requests that have finished. The
+        // callbacks may make new requests.
+        std::list<Private::Request> finished;
+        auto j = p.requests.begin();
+        while (j != p.requests.end())
+        {
+            if (isReady(j->future))
+            {
+                finished.push_back(*j);
+                j = p.requests.erase(j);
+            }
+            else
+            {
+                ++j;
+            }
+        }
+        for (const auto& request : finished)
+        {
+            if (request.callback)
+            {
+                request.callback(getImage(request.future));
+            }
+        }
+    }
+
+    std::chrono::milliseconds ImageCache::getTickTime() const
+    {
+        return std::chrono::milliseconds(10);
+    }
+
+    bool ImageCache::hasPendingWork() const
+    {
+        return !_p->requests.empty();
+    }
+
+    void ImageCache::Private::add(
+        const std::string& key,
+        const std::shared_ptr<Image>& image)
+    {
+        // Pinned images are stored with the pin.
+        const auto i = pins.find(key.substr(0, key.rfind('\n')));
+        if (i != pins.end() && i->second.key == key)
+        {
+            i->second.image = image;
+        }
+        else
+        {
+            cache.add(key, image, image->getByteCount());
+        }
+    }
+}
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/ImageIO.h>
+#include <ftk/Core/Memory.h>
+
+namespace ftk
+{
+    //! \name Image Cache
+    ///@{
+
+    //! Default image cache size in bytes.
+    const size_t imageCacheMax = 512 * megabyte;
+
+    //! Image cache request.
+    struct ImageCacheRequest
+    {
+        uint64_t id = 0;
+        std::shared_future<std::shared_ptr<Image> > future;
+    };
+
+    //! Image cache statistics.
+    struct ImageCacheStats
+    {
+        size_t count = 0;           //!< Number of cached images, not including pinned images
+        size_t byteCount = 0;       //!< Size of the cached images, not including pinned images
+        size_t pinnedCount = 0;     //!< Number of pinned images
+        size_t pinnedByteCount = 0; //!< Size of the pinned images
+        size_t hits = 0;            //!< Requests that found a cached image
+        size_t misses = 0;          //!< Requests that started a read
+        size_t shared = 0;          //!< Requests that shared a read in progress
+        size_t evictions = 0;       //!< Images that have been evicted
+    };
+
+    //! Image cache.
+    //!
+    //! The image cache stores decoded images so that they can be shared
+    //! across the application. Images are identified by the file path,
+    //! the file modification time, and the I/O options, so a file that
+    //! changes is read again.
+    //!
+    //! The least recently used images are evicted when the size of the
+    //! cache is larger than the maximum. Pinned images, for example images
+    //! that are currently displayed, are not evicted and do not count
+    //! towards the maximum.
+    //!
+    //! Requests for an image that is already being read share the same
+    //! read. The callbacks are called from tick(). The image cache
+    //! functions should be called from the main thread.
+    class ImageCache : public ISystem
+    {
+    protected:
+        ImageCache(const std::shared_ptr<Context>&);
+
+    public:
+        virtual ~ImageCache();
+
+        //! Create a new system.
+        static std::shared_ptr<ImageCache> create(const std::shared_ptr<Context>&);
+
+        //! Get the maximum size of the cache in bytes.
+        size_t getMax() const;
+
+        //! Set the maximum size of the cache in bytes.
+        void setMax(size_t);
+
+        //! Request an image. The image is read if it is not in the cache.
+        //! If the file cannot be read the future throws the error, and the
+        //! callback is given a null image.
+        ImageCacheRequest get(
+            const std::filesystem::path&,
+            const ImageIOOptions& = ImageIOOptions(),
+            ImageIOPriority = ImageIOPriority::Normal,
+            const std::function<void(const std::shared_ptr<Image>&)>& = nullptr);
+
+        //! Cancel requests. The read is canceled when no other requests
+        //! are waiting for it.
+        void cancelRequests(const std::vector<uint64_t>&);
+
+        //! Pin an image. Pins are counted, so each call to pin() should be
+        //! matched with a call to unpin(). An image can be pinned before it
+        //! has been read.
+        void pin(
+            const std::filesystem::path&,
+            const ImageIOOptions& = ImageIOOptions());
+
+        //! Unpin an image.
+        void unpin(
+            const std::filesystem::path&,
+            const ImageIOOptions& = ImageIOOptions());
+
+        //! Get the number of requests that have not finished.
+        size_t getRequestCount() const;
+
+        //! Remove the images that are not pinned.
+        void clear();
+
+        //! Get the statistics.
+        ImageCacheStats getStats() const;
+
+        //! Reset the hit, miss, shared, and eviction statistics.
+        void resetStats();
+
+        void tick() override;
+        std::chrono::milliseconds getTickTime() const override;
+        bool hasPendingWork() const override;
+
+    private:
+        FTK_PRIVATE();
+    };
+
+    ///@}
+}
@@ -0,0 +1,674 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/ImageConvertPrivate.h>
+
+#include <ftk/Core/Error.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/String.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <thread>
+
+namespace ftk
+{
+    namespace
+    {
+        //! Minimum size of a stripe of rows that is processed by a thread.
+        const size_t stripeByteCountMin = 256 * kilobyte;
+
+        //! Luminance weights (Rec. 709).
+        const float lumR = .2126F;
+        const float lumG = .7152F;
+        const float lumB = .0722F;
+
+        inline float toFullRange(float value)
+        {
+            return (value - (16.F / 255.F)) * (255.F / (235.F - 16.F));
+        }
+
+        inline float toLegalRange(float value)
+        {
+            return value * ((235.F - 16.F) / 255.F) + (16.F / 255.F);
+        }
+
+        inline float clamp01(float value)
+        {
+            value = value > 0.F ? value : 0.F;
+            return value < 1.F ? value : 1.F;
+        }
+
+        inline bool isYUV(ImageType type)
+        {
+            return type >= ImageType::YUV_420P_U8 && type <= ImageType::YUV_444P_U16;
+        }
+    }
+
+    FTK_ENUM_IMPL(
+        ImageAlphaConvert,
+        "None",
+        "Premultiply",
+        "Unpremultiply");
+
+    bool ImageConvertOptions::operator == (const ImageConvertOptions& other) const
+    {
+        return
+            alpha == other.alpha &&
+            bgr == other.bgr &&
+            luminanceToAlpha == other.luminanceToAlpha &&
+            threadCount == other.threadCount &&
+            simd == other.simd;
+    }
+
+    bool ImageConvertOptions::operator != (const ImageConvertOptions& other) const
+    {
+        return !(*this == other);
+    }
+
+    bool isConvertOutput(ImageType value)
+    {
+        return value != ImageType::None && !isYUV(value);
+    }
+
+    std::string getImageConvertSIMD()
+    {
+        return simd::getLabel(simd::getISA());
+    }
+
+    ImageType getFloatImageType(int channelCount)
+    {
+        ImageType out = ImageType::None;
+        switch (channelCount)
+        {
+        case 1: out = ImageType::L_F32; break;
+        case 2: out = ImageType::LA_F32; break;
+        case 3: out = ImageType::RGB_F32; break;
+        case 4: out = ImageType::RGBA_F32; break;
+        default: break;
+        }
+        return out;
+    }
+
+    void parallelRows(
+        int rowCount,
+        size_t rowByteCount,
+        size_t threadCount,
+        const std::function<void(int y0, int y1)>& func)
+    {
+        if (rowCount <= 0)
+            return;
+        if (0 == threadCount)
+        {
+            threadCount = std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(1));
+        }
+        const size_t stripeCount = std::max(std::min(
+            std::min(threadCount, static_cast<size_t>(rowCount)),
+            rowByteCount * rowCount / stripeByteCountMin), size_t(1));
+        std::vector<std::future<void> > futures;
+        for (size_t i = 1; i < stripeCount; ++i)
+        {
+            futures.push_back(std::async(
+                std::launch::async,
+                func,
+                static_cast<int>(rowCount * i / stripeCount),
+                static_cast<int>(rowCount * (i + 1) / stripeCount)));
+        }
+        func(0, static_cast<int>(rowCount / stripeCount));
+        for (auto& future : futures)
+        {
+            future.get();
+        }
+    }
+
+    ImageRowConverter::ImageRowConverter(
+        const ImageInfo& inInfo,
+        const ImageInfo& outInfo,
+        const ImageConvertOptions& options) :
+        _inInfo(inInfo),
+        _outInfo(outInfo),
+        _options(options),
+        _isa(simd::getISA(options.simd)),
+        _inFormat(_getFormat(inInfo.type)),
+        _outFormat(_getFormat(outInfo.type))
+    {
+        if (0 == _inFormat.channelCount || !isConvertOutput(outInfo.type))
+        {
+            throw std::invalid_argument(Format("Cannot convert: {0} to {1}").
+                arg(inInfo.type).
+                arg(outInfo.type));
+        }
+        if (inInfo.size.w != outInfo.size.w)
+        {
+            throw std::invalid_argument("The image widths do not match");
+        }
+        const bool inYUV =
+            Component::YUV_U8 == _inFormat.component ||
+            Component::YUV_U16 == _inFormat.component;
+        _inRowByteCount = getAlignedByteCount(
+            inInfo.size.w * _inFormat.pixelByteCount,
+            inInfo.layout.alignment);
+
+        const Endian endian = getEndian();
+        _inSwap = !inYUV && _inFormat.componentByteCount > 1 && inInfo.layout.endian != endian;
+        _outSwap = _outFormat.componentByteCount > 1 && outInfo.layout.endian != endian;
+        _swapRB = options.bgr && _inFormat.channelCount >= 3;
+        _flipX = inInfo.layout.mirror.x != outInfo.layout.mirror.x;
+        _inLegal = !inYUV && VideoLevels::LegalRange == inInfo.videoLevels;
+        _outLegal = VideoLevels::LegalRange == outInfo.videoLevels;
+        const int inChannels = _inFormat.channelCount;
+        const int outChannels = _outFormat.channelCount;
+        _luminanceToAlpha = options.luminanceToAlpha && 1 == inChannels;
+        _remapNeeded =
+            inChannels != outChannels ||
+            _swapRB ||
+            _flipX ||
+            _inLegal ||
+            _outLegal ||
+            options.alpha != ImageAlphaConvert::None;
+
+        // Find the fastest conversion.
+        const bool sameLevels = inInfo.videoLevels == outInfo.videoLevels;
+        if (inInfo.type == outInfo.type &&
+            !inYUV &&
+            !_swapRB &&
+            !_flipX &&
+            sameLevels &&
+            ImageAlphaConvert::None == options.alpha &&
+            _inSwap == _outSwap)
+        {
+            _mode = Mode::Copy;
+        }
+        else if (
+            Component::U8 == _inFormat.component &&
+            Component::U8 == _outFormat.component &&
+            !_flipX &&
+            sameLevels &&
+            ((1 == inChannels && outChannels > 1 && ImageAlphaConvert::None == options.alpha) ||
+             (4 == inChannels && 4 == outChannels && options.alpha != ImageAlphaConvert::Unpremultiply)))
+        {
+            _mode = Mode::U8;
+        }
+    }
+
+    size_t ImageRowConverter::getOutRowByteCount() const
+    {
+        return getAlignedByteCount(
+            _outInfo.size.w * _outFormat.pixelByteCount,
+            _outInfo.layout.alignment);
+    }
+
+    void ImageRowConverter::convert(
+        const uint8_t* inData,
+        int            inRow,
+        uint8_t*       outRow,
+        Scratch&       scratch) const
+    {
+        const size_t w = _inInfo.size.w;
+        switch (_mode)
+        {
+        case Mode::Copy:
+            memcpy(outRow, inData + inRow * _inRowByteCount, w * _inFormat.pixelByteCount);
+            break;
+        case Mode::U8:
+        {
+            const uint8_t* inP = inData + inRow * _inRowByteCount;
+            if (1 == _inFormat.channelCount)
+            {
+                switch (_outFormat.channelCount)
+                {
+                case 2: simd::l8ToLA8(_isa, inP, outRow, w, _luminanceToAlpha); break;
+                case 3: simd::l8ToRGB8(_isa, inP, outRow, w); break;
+                case 4: simd::l8ToRGBA8(_isa, inP, outRow, w, _luminanceToAlpha); break;
+                default: break;
+                }
+            }
+            else
+            {
+                simd::rgba8(
+                    _isa,
+                    inP,
+                    outRow,
+                    w,
+                    _swapRB,
+                    ImageAlphaConvert::Premultiply == _options.alpha);
+            }
+            break;
+        }
+        case Mode::Float:
+        {
+            scratch.in.resize(w * 4);
+            _decode(inData, inRow, scratch.in.data(), scratch);
+            const float* p = scratch.in.data();
+            if (_remapNeeded)
+            {
+                scratch.out.resize(w * 4);
+                _remap(scratch.in.data(), scratch.out.data());
+                p = scratch.out.data();
+            }
+            _encode(p, outRow);
+            break;
+        }
+        }
+    }
+
+    void ImageRowConverter::_decode(
+        const uint8_t* inData,
+        int            inRow,
+        float*         out,
+        Scratch&       scratch) const
+    {
+        const size_t w = _inInfo.size.w;
+        const size_t count = w * _inFormat.channelCount;
+        const uint8_t* inP = inData + inRow * _inRowByteCount;
+        if (_inSwap)
+        {
+            const size_t byteCount = w * _inFormat.pixelByteCount;
+            scratch.bytes.resize(byteCount);
+            endian(
+                inP,
+                scratch.bytes.data(),
+                byteCount / _inFormat.componentByteCount,
+                _inFormat.componentByteCount);
+            inP = scratch.bytes.data();
+        }
+        switch (_inFormat.component)
+        {
+        case Component::U8: simd::u8ToF32(_isa, inP, out, count); break;
+        case Component::U16: simd::u16ToF32(_isa, inP, out, count); break;
+        case Component::U32: simd::u32ToF32(_isa, inP, out, count); break;
+        case Component::F16: simd::f16ToF32(_isa, inP, out, count); break;
+        case Component::F32: memcpy(out, inP, count * sizeof(float)); break;
+        case Component::U10:
+            for (size_t x = 0; x < w; ++x, inP += 4, out += 3)
+            {
+                uint32_t value = 0;
+                memcpy(&value, inP, 4);
+                out[0] = ((value >> 22) & 0x3ff) / 1023.F;
+                out[1] = ((value >> 12) & 0x3ff) / 1023.F;
+                out[2] = ((value >> 2) & 0x3ff) / 1023.F;
+            }
+            break;
+        case Component::U4:
+            for (size_t x = 0; x < w; ++x, inP += 2, out += 4)
+            {
+                uint16_t value = 0;
+                memcpy(&value, inP, 2);
+                out[0] = ((value >> 8) & 0xf) / 15.F;
+                out[1] = ((value >> 4) & 0xf) / 15.F;
+                out[2] = (value & 0xf) / 15.F;
+                out[3] = ((value >> 12) & 0xf) / 15.F;
+            }
+            break;
+        case Component::YUV_U8:
+        case Component::YUV_U16:
+            _decodeYUV(inData, inRow, out);
+            break;
+        default: break;
+        }
+    }
+
+    void ImageRowConverter::_decodeYUV(
+        const uint8_t* inData,
+        int            inRow,
+        float*         out) const
+    {
+        const int w = _inInfo.size.w;
+        const int h = _inInfo.size.h;
+        // The chroma planes of odd sized images are rounded up.
+        int xShift = 0;
+        int yShift = 0;
+        switch (_inInfo.type)
+        {
+        case ImageType::YUV_420P_U8:
+        case ImageType::YUV_420P_U16:
+            xShift = 1;
+            yShift = 1;
+            break;
+        case ImageType::YUV_422P_U8:
+        case ImageType::YUV_422P_U16:
+            xShift = 1;
+            break;
+        default: break;
+        }
+        const int cw = (w + xShift) >> xShift;
+        const int ch = (h + yShift) >> yShift;
+        const bool u16 = Component::YUV_U16 == _inFormat.component;
+        const size_t componentByteCount = u16 ? 2 : 1;
+        const int cy = inRow >> yShift;
+        const uint8_t* yP = inData + inRow * w * componentByteCount;
+        const uint8_t* cbP = inData + (w * h + cy * cw) * componentByteCount;
+        const uint8_t* crP = cbP + cw * ch * componentByteCount;
+        auto read = [u16](const uint8_t* p, int i)
+            {
+                if (u16)
+                {
+                    uint16_t value;
+                    memcpy(&value, p + i * 2, 2);
+                    return value / 65535.F;
+                }
+                return p[i] / 255.F;
+            };
+        const V4F k = getYUVCoefficients(_inInfo.yuvCoefficients);
+        const bool legal = VideoLevels::LegalRange == _inInfo.videoLevels;
+        for (int x = 0; x < w; ++x, out += 3)
+        {
+            const int cx = x >> xShift;
+            float yv = read(yP, x);
+            float cb = read(cbP, cx);
+            float cr = read(crP, cx);
+            if (legal)
+            {
+                yv = toFullRange(yv);
+                cb = (cb - (16.F / 255.F)) * (255.F / (240.F - 16.F));
+                cr = (cr - (16.F / 255.F)) * (255.F / (240.F - 16.F));
+            }
+            cb -= .5F;
+            cr -= .5F;
+            out[0] = yv + k.x * cr;
+            out[1] = yv - k.y * cr - k.z * cb;
+            out[2] = yv + k.w * cb;
+        }
+    }
+
+    void ImageRowConverter::_remap(const float* in, float* out) const
+    {
+        const int w = _inInfo.size.w;
+        const int inChannels = _inFormat.channelCount;
+        const int outChannels = _outFormat.channelCount;
+
+        // Premultiply four channel images with the SIMD kernel.
+        if (4 == inChannels &&
+            4 == outChannels &&
+            !_swapRB &&
+            !_flipX &&
+            !_inLegal &&
+            !_outLegal &&
+            ImageAlphaConvert::Premultiply == _options.alpha)
+        {
+            memcpy(out, in, w * 4 * sizeof(float));
+            simd::premultiplyRGBA(_isa, out, w);
+            return;
+        }
+
+        const int r = _swapRB ? 2 : 0;
+        const int b = _swapRB ? 0 : 2;
+        for (int x = 0; x < w; ++x, out += outChannels)
+        {
+            const float* p = in + (_flipX ? (w - 1 - x) : x) * inChannels;
+            float c[4] = { 0.F, 0.F, 0.F, 1.F };
+            switch (inChannels)
+            {
+            case 1:
+                c[0] = c[1] = c[2] = p[0];
+                if (_luminanceToAlpha)
+                {
+                    c[3] = p[0];
+                }
+                break;
+            case 2:
+                c[0] = c[1] = c[2] = p[0];
+                c[3] = p[1];
+                break;
+            case 3:
+                c[0] = p[r];
+                c[1] = p[1];
+                c[2] = p[b];
+                break;
+            case 4:
+                c[0] = p[r];
+                c[1] = p[1];
+                c[2] = p[b];
+                c[3] = p[3];
+                break;
+            default: break;
+            }
+            if (_inLegal)
+            {
+                c[0] = toFullRange(c[0]);
+                c[1] = toFullRange(c[1]);
+                c[2] = toFullRange(c[2]);
+            }
+            switch (_options.alpha)
+            {
+            case ImageAlphaConvert::Premultiply:
+                c[0] *= c[3];
+                c[1] *= c[3];
+                c[2] *= c[3];
+                break;
+            case ImageAlphaConvert::Unpremultiply:
+                if (c[3] > 0.F)
+                {
+                    c[0] /= c[3];
+                    c[1] /= c[3];
+                    c[2] /= c[3];
+                }
+                else
+                {
+                    c[0] = c[1] = c[2] = 0.F;
+                }
+                break;
+            default: break;
+            }
+            if (_outLegal)
+            {
+                c[0] = toLegalRange(c[0]);
+                c[1] = toLegalRange(c[1]);
+                c[2] = toLegalRange(c[2]);
+            }
+            switch (outChannels)
+            {
+            case 1:
+                out[0] = inChannels <= 2 ? c[0] : (c[0] * lumR + c[1] * lumG + c[2] * lumB);
+                break;
+            case 2:
+                out[0] = inChannels <= 2 ? c[0] : (c[0] * lumR + c[1] * lumG + c[2] * lumB);
+                out[1] = c[3];
+                break;
+            case 3:
+                out[0] = c[0];
+                out[1] = c[1];
+                out[2] = c[2];
+                break;
+            case 4:
+                out[0] = c[0];
+                out[1] = c[1];
+                out[2] = c[2];
+                out[3] = c[3];
+                break;
+            default: break;
+            }
+        }
+    }
+
+    void ImageRowConverter::_encode(const float* in, uint8_t* out) const
+    {
+        const size_t w = _outInfo.size.w;
+        const size_t count = w * _outFormat.channelCount;
+        uint8_t* outP = out;
+        switch (_outFormat.component)
+        {
+        case Component::U8: simd::f32ToU8(_isa, in, out, count); break;
+        case Component::U16: simd::f32ToU16(_isa, in, out, count); break;
+        case Component::U32: simd::f32ToU32(_isa, in, out, count); break;
+        case Component::F16: simd::f32ToF16(_isa, in, out, count); break;
+        case Component::F32: memcpy(out, in, count * sizeof(float)); break;
+        case Component::U10:
+            for (size_t x = 0; x < w; ++x, in += 3, out += 4)
+            {
+                const uint32_t value =
+                    (static_cast<uint32_t>(std::lrint(clamp01(in[0]) * 1023.F)) << 22) |
+                    (static_cast<uint32_t>(std::lrint(clamp01(in[1]) * 1023.F)) << 12) |
+                    (static_cast<uint32_t>(std::lrint(clamp01(in[2]) * 1023.F)) << 2);
+                memcpy(out, &value, 4);
+            }
+            break;
+        case Component::U4:
+            for (size_t x = 0; x < w; ++x, in += 4, out += 2)
+            {
+                const uint16_t value = static_cast<uint16_t>(
+                    (std::lrint(clamp01(in[3]) * 15.F) << 12) |
+                    (std::lrint(clamp01(in[0]) * 15.F) << 8) |
+                    (std::lrint(clamp01(in[1]) * 15.F) << 4) |
+                    std::lrint(clamp01(in[2]) * 15.F));
+                memcpy(out, &value, 2);
+            }
+            break;
+        default: break;
+        }
+        if (_outSwap)
+        {
+            endian(
+                outP,
+                w * _outFormat.pixelByteCount / _outFormat.componentByteCount,
+                _outFormat.componentByteCount);
+        }
+    }
+
+    ImageRowConverter::PixelFormat ImageRowConverter::_getFormat(ImageType type)
+    {
+        PixelFormat out;
+        switch (type)
+        {
+        case ImageType::RGB_U10:
+            out.channelCount = 3;
+            out.component = Component::U10;
+            out.componentByteCount = 4;
+            out.pixelByteCount = 4;
+            break;
+        case ImageType::ARGB_4444_Premult:
+            out.channelCount = 4;
+            out.component = Component::U4;
+            out.componentByteCount = 2;
+            out.pixelByteCount = 2;
+            break;
+        case ImageType::YUV_420P_U8:
+        case ImageType::YUV_422P_U8:
+        case ImageType::YUV_444P_U8:
+            out.channelCount = 3;
+            out.component = Component::YUV_U8;
+            out.componentByteCount = 1;
+            break;
+        case ImageType::YUV_420P_U16:
+        case ImageType::YUV_422P_U16:
+        case ImageType::YUV_444P_U16:
+            out.channelCount = 3;
+            out.component = Component::YUV_U16;
+            out.componentByteCount = 2;
+            break;
+        case ImageType::None:
+            break;
+        default:
+        {
+            out.channelCount = getChannelCount(type);
+            const int bitDepth = getBitDepth(type);
+            bool isFloat = false;
+            switch (type)
+            {
+            case ImageType::L_F16:
+            case ImageType::L_F32:
+            case ImageType::LA_F16:
+            case ImageType::LA_F32:
+            case ImageType::RGB_F16:
+            case ImageType::RGB_F32:
+            case ImageType::RGBA_F16:
+            case ImageType::RGBA_F32:
+                isFloat = true;
+                break;
+            default: break;
+            }
+            switch (bitDepth)
+            {
+            case 8: out.component = Component::U8; break;
+            case 16: out.component = isFloat ? Component::F16 : Component::U16; break;
+            case 32: out.component = isFloat ? Component::F32 : Component::U32; break;
+            default: break;
+            }
+            out.componentByteCount = bitDepth / 8;
+            out.pixelByteCount = out.channelCount * out.componentByteCount;
+            break;
+        }
+        }
+        return out;
+    }
+
+    void convertPixels(
+        const uint8_t* in,
+        ImageType      inType,
+        uint8_t*       out,
+        ImageType      outType,
+        size_t         count,
+        const ImageConvertOptions& options)
+    {
+        if (isYUV(inType))
+        {
+            throw std::invalid_argument(Format("Cannot convert: {0} to {1}").
+                arg(inType).
+                arg(outType));
+        }
+        const ImageRowConverter converter(
+            ImageInfo(count, 1, inType),
+            ImageInfo(count, 1, outType),
+            options);
+        ImageRowConverter::Scratch scratch;
+        converter.convert(in, 0, out, scratch);
+    }
+
+    void convertImage(
+        const ImageInfo& inInfo,
+        const uint8_t*   in,
+        const ImageInfo& outInfo,
+        uint8_t*         out,
+        const ImageConvertOptions& options)
+    {
+        if (inInfo.size != outInfo.size)
+        {
+            throw std::invalid_argument("The image sizes do not match");
+        }
+        const ImageRowConverter converter(inInfo, outInfo, options);
+        const int h = outInfo.size.h;
+        const bool flipY = inInfo.layout.mirror.y != outInfo.layout.mirror.y;
+        const size_t outRowByteCount = converter.getOutRowByteCount();
+        parallelRows(
+            h,
+            outRowByteCount,
+            options.threadCount,
+            [&converter, in, out, h, flipY, outRowByteCount](int y0, int y1)
+            {
+                ImageRowConverter::Scratch scratch;
+                for (int y = y0; y < y1; ++y)
+                {
+                    converter.convert(
+                        in,
+                        flipY ? (h - 1 - y) : y,
+                        out + y * outRowByteCount,
+                        scratch);
+                }
+            });
+    }
+
+    void convertImage(
+        const std::shared_ptr<const Image>& in,
+        const std::shared_ptr<Image>& out,
+        const ImageConvertOptions& options)
+    {
+        convertImage(in->getInfo(), in->getData(), out->getInfo(), out->getData(), options);
+    }
+
+    std::shared_ptr<Image> convertImage(
+        const std::shared_ptr<const Image>& in,
+        ImageType type,
+        const ImageConvertOptions& options)
+    {
+        ImageInfo info = in->getInfo();
+        info.type = type;
+        info.videoLevels = VideoLevels::FullRange;
+        info.layout = ImageLayout(info.layout.mirror);
+        auto out = Image::create(info);
+        out->setTags(in->getTags());
+        convertImage(in, out, options);
+        return out;
+    }
+}
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/Image.h>
+
+namespace ftk
+{
+    //! \name Image Conversion
+    ///@{
+
+    //! Image alpha conversions.
+    enum class ImageAlphaConvert
+    {
+        None,
+        Premultiply,
+        Unpremultiply,
+
+        Count,
+        First = None
+    };
+    FTK_ENUM(ImageAlphaConvert);
+
+    //! Image conversion options.
+    struct ImageConvertOptions
+    {
+        ImageAlphaConvert alpha = ImageAlphaConvert::None;
+
+        //! The red and blue channels of the input are swapped (i.e., BGR
+        //! and BGRA data).
+        bool bgr = false;
+
+        //! Copy the luminance of L images to the output alpha, for example
+        //! to convert glyph coverage.
+        bool luminanceToAlpha = false;
+
+        //! Number of threads, zero uses the hardware concurrency.
+        size_t threadCount = 0;
+
+        //! Use SIMD instructions when they are available.
+        bool simd = true;
+
+        bool operator == (const ImageConvertOptions&) const;
+        bool operator != (const ImageConvertOptions&) const;
+    };
+
+    //! Get whether an image type can be used as a conversion output. The
+    //! YUV types can only be used as inputs.
+    bool isConvertOutput(ImageType);
+
+    //! Get the SIMD instruction set used for image conversion.
+    std::string getImageConvertSIMD();
+
+    //! Convert pixels. The input and output are single rows of pixels
+    //! with the native endian.
+    void convertPixels(
+        const uint8_t* in,
+        ImageType      inType,
+        uint8_t*       out,
+        ImageType      outType,
+        size_t         count,
+        const ImageConvertOptions& = ImageConvertOptions());
+
+    //! Convert image data. The images must be the same size. The image
+    //! layouts and video levels are converted, and the rows are flipped
+    //! when the mirroring is different. The rows are converted in
+    //! parallel.
+    //!
+    //! Throws:
+    //! - std::invalid_argument
+    void convertImage(
+        const ImageInfo& inInfo,
+        const uint8_t*   in,
+        const ImageInfo& outInfo,
+        uint8_t*         out,
+        const ImageConvertOptions& = ImageConvertOptions());
+
+    //! Convert an image.
+    //!
+    //! Throws:
+    //! - std::invalid_argument
+    void convertImage(
+        const std::shared_ptr<const Image>& in,
+        const std::shared_ptr<Image>& out,
+        const ImageConvertOptions& = ImageConvertOptions());
+
+    //! Convert an image to a new image with the given type. The new image
+    //! has full range video levels and the default layout, with the same
+    //! mirroring as the input.
+    //!
+    //! Throws:
+    //! - std::invalid_argument
+    std::shared_ptr<Image> convertImage(
+        const std::shared_ptr<const Image>&,
+        ImageType,
+        const ImageConvertOptions& = ImageConvertOptions());
+
+    ///@}
+}
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/ImageConvert.h>
+#include <ftk/Core/ImageSIMDPrivate.h>
+
+#include <functional>
+
+namespace ftk
+{
+    //! Get the float image type with the given number of channels.
+    ImageType getFloatImageType(int channelCount);
+
+    //! Run a function on stripes of rows in parallel. The number of
+    //! stripes is limited so that small images are processed on the
+    //! calling thread.
+    void parallelRows(
+        int rowCount,
+        size_t rowByteCount,
+        size_t threadCount,
+        const std::function<void(int y0, int y1)>&);
+
+    //! Convert rows of image data.
+    class ImageRowConverter
+    {
+    public:
+        //! Throws:
+        //! - std::invalid_argument
+        ImageRowConverter(
+            const ImageInfo& inInfo,
+            const ImageInfo& outInfo,
+            const ImageConvertOptions&);
+
+        //! Scratch buffers, one for each thread.
+        struct Scratch
+        {
+            std::vector<float> in;
+            std::vector<float> out;
+            std::vector<uint8_t> bytes;
+        };
+
+        //! Get the number of bytes in an output row.
+        size_t getOutRowByteCount() const;
+
+        //! Convert the input data row to an output row.
+        void convert(
+            const uint8_t* inData,
+            int            inRow,
+            uint8_t*       outRow,
+            Scratch&) const;
+
+    private:
+        void _decode(const uint8_t* inData, int inRow, float*, Scratch&) const;
+        void _decodeYUV(const uint8_t* inData, int inRow, float*) const;
+        void _remap(const float*, float*) const;
+        void _encode(const float*, uint8_t*) const;
+
+        enum class Mode
+        {
+            Copy,
+            U8,
+            Float
+        };
+
+        enum class Component
+        {
+            None,
+            U8,
+            U16,
+            U32,
+            F16,
+            F32,
+            U10,
+            U4,
+            YUV_U8,
+            YUV_U16
+        };
+
+        struct PixelFormat
+        {
+            int channelCount = 0;
+            Component component = Component::None;
+            size_t componentByteCount = 0;
+            size_t pixelByteCount = 0;
+        };
+
+        static PixelFormat _getFormat(ImageType);
+
+        ImageInfo _inInfo;
+        ImageInfo _outInfo;
+        ImageConvertOptions _options;
+        simd::ISA _isa = simd::ISA::Scalar;
+        PixelFormat _inFormat;
+        PixelFormat _outFormat;
+        size_t _inRowByteCount = 0;
+        Mode _mode = Mode::Float;
+        bool _inSwap = false;
+        bool _outSwap = false;
+        bool _swapRB = false;
+        bool _flipX = false;
+        bool _inLegal = false;
+        bool _outLegal = false;
+        bool _luminanceToAlpha = false;
+        bool _remapNeeded = false;
+    };
+}
@@ -3,12 +3,27 @@
 
 #include <ftk/Core/ImageIO.h>
 
+#include <ftk/Core/Error.h>
+#include <ftk/Core/Format.h>
 #include <ftk/Core/PNG.h>
+#include <ftk/Core/String.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 namespace ftk
 {
+    namespace
+    {
+        const size_t threadCountMax = 4;
+        const size_t requestTimeout = 5;
+    }
+
     ImageIOOptions merge(const ImageIOOptions& a, const ImageIOOptions& b)
     {
         ImageIOOptions out = b;
@@ -29,6 +44,17 @@ namespace ftk
     IImageReader::~IImageReader()
     {}
 
+    void IImageReader::readInto(const std::shared_ptr<Image>& image)
+    {
+        const auto tmp = read();
+        if (!tmp || !image || tmp->getInfo() != image->getInfo())
+        {
+            throw std::runtime_error(Format("Cannot read: \"{0}\"").
+                arg(_path.u8string()));
+        }
+        memcpy(image->getData(), tmp->getData(), image->getByteCount());
+    }
+
     IImageWriter::IImageWriter(
         const std::filesystem::path& path,
         const ImageIOOptions&) :
@@ -122,14 +148,89 @@ namespace ftk
         return nullptr;
     }
 
+    FTK_ENUM_IMPL(
+        ImageIOPriority,
+        "Low",
+        "Normal",
+        "High");
+
+    struct ImageIO::Private
+    {
+        uint64_t id = 0;
+
+        struct Request
+        {
+            uint64_t id = 0;
+            std::filesystem::path path;
+            ImageIOOptions options;
+            ImageIOPriority priority = ImageIOPriority::Normal;
+            std::shared_ptr<IImagePlugin> plugin;
+            bool infoOnly = false;
+            std::promise<ImageInfo> infoPromise;
+            std::promise<std::shared_ptr<Image> > imagePromise;
+            std::function<void(const ImageInfo&)> infoCallback;
+            std::function<void(const std::shared_ptr<Image>&)> imageCallback;
+            ImageInfo info;
+            std::shared_ptr<Image> image;
+            std::exception_ptr error;
+            bool canceled = false;
+        };
+
+        struct Mutex
+        {
+            std::list<std::shared_ptr<Request> > requests;
+            std::list<std::shared_ptr<Request> > running;
+            std::list<std::shared_ptr<Request> > finished;
+            bool stopped = false;
+            std::mutex mutex;
+        };
+        Mutex mutex;
+
+        struct Thread
+        {
+            std::condition_variable cv;
+            std::vector<std::thread> threads;
+            std::atomic<bool> running;
+        };
+        Thread thread;
+
+        void add(const std::shared_ptr<Request>&);
+        void run();
+        static void finish(const std::shared_ptr<Request>&);
+        static void cancel(const std::shared_ptr<Request>&);
+    };
+
     ImageIO::ImageIO(const std::shared_ptr<Context>& context) :
-        ISystem(context, "ftk::ImageIO")
+        ISystem(context, "ftk::ImageIO"),
+        _p(new Private)
     {
+        FTK_P();
+        p.thread.running = true;
         _plugins.push_front(std::shared_ptr<IImagePlugin>(new png::ImagePlugin));
     }
 
     ImageIO::~ImageIO()
-    {}
+    {
+        FTK_P();
+        p.thread.running = false;
+        for (auto& thread : p.thread.threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+        std::list<std::shared_ptr<Private::Request> > requests;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            p.mutex.stopped = true;
+            requests = std::move(p.mutex.requests);
+        }
+        for (const auto& request : requests)
+        {
+            Private::cancel(request);
+        }
+    }
 
     std::shared_ptr<ImageIO> ImageIO::create(const std::shared_ptr<Context>& context)
     {
@@ -151,13 +252,9 @@ namespace ftk
         const ImageIOOptions& options)
     {
         std::shared_ptr<IImageReader> out;
-        for (const auto& plugin : _plugins)
+        if (auto plugin = _getReadPlugin(path, options))
         {
-            if (plugin->canRead(path, options))
-            {
-                out = plugin->read(path, options);
-                break;
-            }
+            out = plugin->read(path, options);
         }
         return out;
     }
@@ -168,13 +265,9 @@ namespace ftk
         const ImageIOOptions& options)
     {
         std::shared_ptr<IImageReader> out;
-        for (const auto& plugin : _plugins)
+        if (auto plugin = _getReadPlugin(path, options))
         {
-            if (plugin->canRead(path, options))
-            {
-                out = plugin->read(path, memory, options);
-                break;
-            }
+            out = plugin->read(path, memory, options);
         }
         return out;
     }
@@ -195,4 +288,281 @@ namespace ftk
         }
         return out;
     }
-}
\ No newline at end of file
+
+    ImageInfoRequest ImageIO::requestInfo(
+        const std::filesystem::path& path,
+        const ImageIOOptions& options,
+        ImageIOPriority priority,
+        const std::function<void(const ImageInfo&)>& callback)
+    {
+        FTK_P();
+        auto request = std::make_shared<Private::Request>();
+        request->id = p.id++;
+        request->path = path;
+        request->options = options;
+        request->priority = priority;
+        request->plugin = _getReadPlugin(path, options);
+        request->infoOnly = true;
+        request->infoCallback = callback;
+        ImageInfoRequest out;
+        out.id = request->id;
+        out.future = request->infoPromise.get_future();
+        p.add(request);
+        return out;
+    }
+
+    ImageReadRequest ImageIO::requestRead(
+        const std::filesystem::path& path,
+        const ImageIOOptions& options,
+        ImageIOPriority priority,
+        const std::function<void(const std::shared_ptr<Image>&)>& callback)
+    {
+        FTK_P();
+        auto request = std::make_shared<Private::Request>();
+        request->id = p.id++;
+        request->path = path;
+        request->options = options;
+        request->priority = priority;
+        request->plugin = _getReadPlugin(path, options);
+        request->imageCallback = callback;
+        ImageReadRequest out;
+        out.id = request->id;
+        out.future = request->imagePromise.get_future();
+        p.add(request);
+        return out;
+    }
+
+    void ImageIO::cancelRequests(const std::vector<uint64_t>& ids)
+    {
+        FTK_P();
+        std::list<std::shared_ptr<Private::Request> > requests;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            auto i = p.mutex.requests.begin();
+            while (i != p.mutex.requests.end())
+            {
+                if (std::find(ids.begin(), ids.end(), (*i)->id) != ids.end())
+                {
+                    requests.push_back(*i);
+                    i = p.mutex.requests.erase(i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+
+            // Requests that are running are canceled when they finish.
+            for (const auto& request : p.mutex.running)
+            {
+                if (std::find(ids.begin(), ids.end(), request->id) != ids.end())
+                {
+                    request->canceled = true;
+                }
+            }
+
+            // Requests that have finished are not given to the callbacks.
+            i = p.mutex.finished.begin();
+            while (i != p.mutex.finished.end())
+            {
+                if (std::find(ids.begin(), ids.end(), (*i)->id) != ids.end())
+                {
+                    i = p.mutex.finished.erase(i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+        for (const auto& request : requests)
+        {
+            Private::cancel(request);
+        }
+    }
+
+    size_t ImageIO::getRequestCount() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.requests.size() +
+            p.mutex.running.size() +
+            p.mutex.finished.size();
+    }
+
+    void ImageIO::tick()
+    {
+        FTK_P();
+        std::list<std::shared_ptr<Private::Request> > finished;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            finished = std::move(p.mutex.finished);
+        }
+        for (const auto& request : finished)
+        {
+            if (request->infoCallback)
+            {
+                request->infoCallback(request->info);
+            }
+            if (request->imageCallback)
+            {
+                request->imageCallback(request->image);
+            }
+        }
+    }
+
+    std::chrono::milliseconds ImageIO::getTickTime() const
+    {
+        return std::chrono::milliseconds(10);
+    }
+
+    bool ImageIO::hasPendingWork() const
+    {
+        return getRequestCount() > 0;
+    }
+
+    std::shared_ptr<IImagePlugin> ImageIO::_getReadPlugin(
+        const std::filesystem::path& path,
+        const ImageIOOptions& options)
+    {
+        std::shared_ptr<IImagePlugin> out;
+        for (const auto& plugin : _plugins)
+        {
+            if (plugin->canRead(path, options))
+            {
+                out = plugin;
+                break;
+            }
+        }
+        return out;
+    }
+
+    void ImageIO::Private::add(const std::shared_ptr<Request>& request)
+    {
+        bool valid = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex.mutex);
+            if (!mutex.stopped)
+            {
+                valid = true;
+                auto i = mutex.requests.begin();
+                while (i != mutex.requests.end() && (*i)->priority >= request->priority)
+                {
+                    ++i;
+                }
+                mutex.requests.insert(i, request);
+            }
+        }
+        if (valid)
+        {
+            if (thread.threads.empty())
+            {
+                const size_t threadCount = std::min(
+                    threadCountMax,
+                    std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(2)) - 1);
+                for (size_t i = 0; i < threadCount; ++i)
+                {
+                    thread.threads.push_back(std::thread(
+                        [this]
+                        {
+                            run();
+                        }));
+                }
+            }
+            thread.cv.notify_one();
+        }
+        else
+        {
+            cancel(request);
+        }
+    }
+
+    void ImageIO::Private::run()
+    {
+        while (thread.running)
+        {
+            std::shared_ptr<Request> request;
+            {
+                std::unique_lock<std::mutex> lock(mutex.mutex);
+                if (thread.cv.wait_for(
+                    lock,
+                    std::chrono::milliseconds(requestTimeout),
+                    [this]
+                    {
+                        return !mutex.requests.empty();
+                    }))
+                {
+                    request = mutex.requests.front();
+                    mutex.requests.pop_front();
+                    mutex.running.push_back(request);
+                }
+            }
+            if (request)
+            {
+                try
+                {
+                    std::shared_ptr<IImageReader> reader;
+                    if (request->plugin)
+                    {
+                        reader = request->plugin->read(request->path, request->options);
+                    }
+                    if (!reader)
+                    {
+                        throw std::runtime_error(Format("Cannot read: \"{0}\"").
+                            arg(request->path.u8string()));
+                    }
+                    if (request->infoOnly)
+                    {
+                        request->info = reader->getInfo();
+                    }
+                    else
+                    {
+                        request->image = reader->read();
+                    }
+                }
+                catch (const std::exception&)
+                {
+                    request->error = std::current_exception();
+                }
+                bool canceled = false;
+                {
+                    std::unique_lock<std::mutex> lock(mutex.mutex);
+                    mutex.running.remove(request);
+                    canceled = request->canceled;
+                    if (!canceled)
+                    {
+                        mutex.finished.push_back(request);
+                    }
+                }
+                if (canceled)
+                {
+                    cancel(request);
+                }
+                else
+                {
+                    finish(request);
+                }
+            }
+        }
+    }
+
+    void ImageIO::Private::finish(const std::shared_ptr<Request>& request)
+    {
+        if (request->error)
+        {
+            request->infoPromise.set_exception(request->error);
+            request->imagePromise.set_exception(request->error);
+        }
+        else
+        {
+            request->infoPromise.set_value(request->info);
+            request->imagePromise.set_value(request->image);
+        }
+    }
+
+    void ImageIO::Private::cancel(const std::shared_ptr<Request>& request)
+    {
+        request->infoPromise.set_value(ImageInfo());
+        request->imagePromise.set_value(nullptr);
+    }
+}
@@ -7,6 +7,8 @@
 #include <ftk/Core/ISystem.h>
 #include <ftk/Core/Image.h>
 
+#include <functional>
+#include <future>
 #include <list>
 
 namespace ftk
@@ -37,6 +39,12 @@ namespace ftk
             //! Read the image.
             virtual std::shared_ptr<Image> read() = 0;
 
+            //! Read the image into existing image memory, for example to
+            //! reuse an image. The image must have the same size and type
+            //! as getInfo(). The default implementation copies the result
+            //! of read().
+            virtual void readInto(const std::shared_ptr<Image>&);
+
         protected:
             std::filesystem::path _path;
         };
@@ -103,7 +111,39 @@ namespace ftk
             std::vector<std::string> _extensions;
         };
         
+        //! Image I/O request priority.
+        enum class ImageIOPriority
+        {
+            Low,
+            Normal,
+            High,
+
+            Count,
+            First = Low
+        };
+        FTK_ENUM(ImageIOPriority);
+
+        //! Asynchronous image information request.
+        struct ImageInfoRequest
+        {
+            uint64_t id = 0;
+            std::future<ImageInfo> future;
+        };
+
+        //! Asynchronous image read request.
+        struct ImageReadRequest
+        {
+            uint64_t id = 0;
+            std::future<std::shared_ptr<Image> > future;
+        };
+
         //! Image I/O system.
+        //!
+        //! Asynchronous requests are handled by a pool of worker threads.
+        //! Requests with a higher priority are started first, and requests
+        //! with the same priority are started in the order they were made.
+        //! The callbacks are called from tick(), on the same thread as the
+        //! other systems.
         class ImageIO : public ISystem
         {
         protected:
@@ -138,8 +178,50 @@ namespace ftk
                 const ImageInfo&,
                 const ImageIOOptions& = ImageIOOptions());
 
+            //! \name Asynchronous Requests
+            //!
+            //! If the file cannot be read the future throws the error, and
+            //! the callback is given an invalid result. The futures of
+            //! requests that are canceled before they finish return an
+            //! invalid result, and the callbacks of canceled requests are
+            //! not called.
+            ///@{
+
+            //! Request information about an image. Only the image header
+            //! is read.
+            ImageInfoRequest requestInfo(
+                const std::filesystem::path&,
+                const ImageIOOptions& = ImageIOOptions(),
+                ImageIOPriority = ImageIOPriority::Normal,
+                const std::function<void(const ImageInfo&)>& = nullptr);
+
+            //! Request an image.
+            ImageReadRequest requestRead(
+                const std::filesystem::path&,
+                const ImageIOOptions& = ImageIOOptions(),
+                ImageIOPriority = ImageIOPriority::Normal,
+                const std::function<void(const std::shared_ptr<Image>&)>& = nullptr);
+
+            //! Cancel requests.
+            void cancelRequests(const std::vector<uint64_t>&);
+
+            //! Get the number of requests that have not finished.
+            size_t getRequestCount() const;
+
+            ///@}
+
+            void tick() override;
+            std::chrono::milliseconds getTickTime() const override;
+            bool hasPendingWork() const override;
+
         private:
+            std::shared_ptr<IImagePlugin> _getReadPlugin(
+                const std::filesystem::path&,
+                const ImageIOOptions&);
+
             std::list<std::shared_ptr<IImagePlugin> > _plugins;
+
+            FTK_PRIVATE();
         };
         
         ///@}
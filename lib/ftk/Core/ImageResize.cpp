@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/ImageResize.h>
+
+#include <ftk/Core/Error.h>
+#include <ftk/Core/ImageConvertPrivate.h>
+#include <ftk/Core/Math.h>
+#include <ftk/Core/String.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ftk
+{
+    namespace
+    {
+        float getSupport(ImageResizeFilter filter)
+        {
+            float out = 0.F;
+            switch (filter)
+            {
+            case ImageResizeFilter::Box: out = .5F; break;
+            case ImageResizeFilter::Bilinear: out = 1.F; break;
+            case ImageResizeFilter::Lanczos: out = 3.F; break;
+            default: break;
+            }
+            return out;
+        }
+
+        double getFilterValue(ImageResizeFilter filter, double t)
+        {
+            double out = 0.0;
+            switch (filter)
+            {
+            case ImageResizeFilter::Box:
+                out = t >= -.5 && t < .5 ? 1.0 : 0.0;
+                break;
+            case ImageResizeFilter::Bilinear:
+                t = std::abs(t);
+                out = t < 1.0 ? 1.0 - t : 0.0;
+                break;
+            case ImageResizeFilter::Lanczos:
+                t = std::abs(t);
+                if (t < 1.0e-6)
+                {
+                    out = 1.0;
+                }
+                else if (t < 3.0)
+                {
+                    const double x = pi * t;
+                    out = 3.0 * std::sin(x) * std::sin(x / 3.0) / (x * x);
+                }
+                break;
+            default: break;
+            }
+            return out;
+        }
+
+        //! Filter weights for each output pixel.
+        struct Weights
+        {
+            std::vector<int> starts;
+            std::vector<int> counts;
+            std::vector<float> weights;
+            size_t stride = 0;
+        };
+
+        Weights getWeights(int inSize, int outSize, ImageResizeFilter filter)
+        {
+            Weights out;
+            const double scale = outSize / static_cast<double>(inSize);
+            const double filterScale = std::max(1.0 / scale, 1.0);
+            const double support = getSupport(filter) * filterScale;
+            out.stride = static_cast<size_t>(std::ceil(support * 2.0)) + 1;
+            out.starts.resize(outSize);
+            out.counts.resize(outSize);
+            out.weights.resize(outSize * out.stride, 0.F);
+            std::vector<double> tmp(out.stride);
+            for (int i = 0; i < outSize; ++i)
+            {
+                const double center = (i + .5) / scale;
+                const int x0 = std::max(static_cast<int>(std::floor(center - support)), 0);
+                const int x1 = std::min(static_cast<int>(std::ceil(center + support)), inSize);
+                double sum = 0.0;
+                int count = 0;
+                for (int x = x0; x < x1 && count < static_cast<int>(out.stride); ++x, ++count)
+                {
+                    tmp[count] = getFilterValue(filter, (x + .5 - center) / filterScale);
+                    sum += tmp[count];
+                }
+                float* weights = out.weights.data() + i * out.stride;
+                if (std::abs(sum) > 1.0e-9)
+                {
+                    out.starts[i] = x0;
+                    out.counts[i] = count;
+                    for (int j = 0; j < count; ++j)
+                    {
+                        weights[j] = static_cast<float>(tmp[j] / sum);
+                    }
+                }
+                else
+                {
+                    // Use the nearest pixel if no pixels are in the filter.
+                    out.starts[i] = clamp(static_cast<int>(center), 0, inSize - 1);
+                    out.counts[i] = 1;
+                    weights[0] = 1.F;
+                }
+            }
+            return out;
+        }
+    }
+
+    FTK_ENUM_IMPL(
+        ImageResizeFilter,
+        "Box",
+        "Bilinear",
+        "Lanczos");
+
+    bool ImageResizeOptions::operator == (const ImageResizeOptions& other) const
+    {
+        return
+            filter == other.filter &&
+            threadCount == other.threadCount &&
+            simd == other.simd;
+    }
+
+    bool ImageResizeOptions::operator != (const ImageResizeOptions& other) const
+    {
+        return !(*this == other);
+    }
+
+    void resizeImage(
+        const ImageInfo& inInfo,
+        const uint8_t*   in,
+        const ImageInfo& outInfo,
+        uint8_t*         out,
+        const ImageResizeOptions& options)
+    {
+        if (!inInfo.size.isValid() || !outInfo.size.isValid())
+        {
+            throw std::invalid_argument("Invalid image size");
+        }
+        const int inW = inInfo.size.w;
+        const int inH = inInfo.size.h;
+        const int outW = outInfo.size.w;
+        const int outH = outInfo.size.h;
+        const int channelCount = getChannelCount(outInfo.type);
+        const size_t rowSize = outW * channelCount;
+        const simd::ISA isa = simd::getISA(options.simd);
+
+        // The input is converted to floats with the output channels, and
+        // the floats are converted to the output.
+        ImageConvertOptions convertOptions;
+        convertOptions.simd = options.simd;
+        ImageInfo decodeInfo(inW, inH, getFloatImageType(channelCount));
+        decodeInfo.layout.mirror = inInfo.layout.mirror;
+        ImageInfo encodeInfo(outW, outH, getFloatImageType(channelCount));
+        encodeInfo.layout.mirror = inInfo.layout.mirror;
+        const ImageRowConverter decoder(inInfo, decodeInfo, convertOptions);
+        const ImageRowConverter encoder(encodeInfo, outInfo, convertOptions);
+        const size_t outRowByteCount = encoder.getOutRowByteCount();
+
+        // Resize the rows horizontally.
+        const Weights xWeights = getWeights(inW, outW, options.filter);
+        std::vector<float> tmp(inH * rowSize);
+        parallelRows(
+            inH,
+            inW * channelCount * sizeof(float),
+            options.threadCount,
+            [&decoder, &xWeights, &tmp, in, inW, outW, rowSize, channelCount, isa](int y0, int y1)
+            {
+                ImageRowConverter::Scratch scratch;
+                std::vector<float> row(inW * channelCount);
+                for (int y = y0; y < y1; ++y)
+                {
+                    float* tmpP = tmp.data() + y * rowSize;
+                    if (inW == outW)
+                    {
+                        decoder.convert(in, y, reinterpret_cast<uint8_t*>(tmpP), scratch);
+                    }
+                    else
+                    {
+                        decoder.convert(in, y, reinterpret_cast<uint8_t*>(row.data()), scratch);
+                        simd::resampleRow(
+                            isa,
+                            row.data(),
+                            tmpP,
+                            outW,
+                            channelCount,
+                            xWeights.starts.data(),
+                            xWeights.counts.data(),
+                            xWeights.weights.data(),
+                            xWeights.stride);
+                    }
+                }
+            });
+
+        // Resize the columns and convert to the output.
+        const Weights yWeights = getWeights(inH, outH, options.filter);
+        const bool flipY = inInfo.layout.mirror.y != outInfo.layout.mirror.y;
+        parallelRows(
+            outH,
+            outRowByteCount,
+            options.threadCount,
+            [&encoder, &yWeights, &tmp, out, outH, rowSize, outRowByteCount, flipY, isa](int y0, int y1)
+            {
+                ImageRowConverter::Scratch scratch;
+                std::vector<float> row(rowSize);
+                for (int y = y0; y < y1; ++y)
+                {
+                    std::fill(row.begin(), row.end(), 0.F);
+                    const float* weights = yWeights.weights.data() + y * yWeights.stride;
+                    for (int i = 0; i < yWeights.counts[y]; ++i)
+                    {
+                        simd::mulAdd(
+                            isa,
+                            row.data(),
+                            tmp.data() + (yWeights.starts[y] + i) * rowSize,
+                            weights[i],
+                            rowSize);
+                    }
+                    encoder.convert(
+                        reinterpret_cast<const uint8_t*>(row.data()),
+                        0,
+                        out + (flipY ? (outH - 1 - y) : y) * outRowByteCount,
+                        scratch);
+                }
+            });
+    }
+
+    void resizeImage(
+        const std::shared_ptr<const Image>& in,
+        const std::shared_ptr<Image>& out,
+        const ImageResizeOptions& options)
+    {
+        resizeImage(in->getInfo(), in->getData(), out->getInfo(), out->getData(), options);
+    }
+
+    std::shared_ptr<Image> resizeImage(
+        const std::shared_ptr<const Image>& in,
+        const Size2I& size,
+        const ImageResizeOptions& options)
+    {
+        ImageInfo info = in->getInfo();
+        info.size = size;
+        info.layout = ImageLayout(info.layout.mirror);
+        if (!isConvertOutput(info.type))
+        {
+            info.type = 8 == getBitDepth(info.type) ? ImageType::RGB_U8 : ImageType::RGB_U16;
+            info.videoLevels = VideoLevels::FullRange;
+        }
+        auto out = Image::create(info);
+        out->setTags(in->getTags());
+        resizeImage(in, out, options);
+        return out;
+    }
+}
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/Image.h>
+
+namespace ftk
+{
+    //! \name Image Resizing
+    ///@{
+
+    //! Image resize filters.
+    enum class ImageResizeFilter
+    {
+        Box,
+        Bilinear,
+        Lanczos,
+
+        Count,
+        First = Box
+    };
+    FTK_ENUM(ImageResizeFilter);
+
+    //! Image resize options.
+    struct ImageResizeOptions
+    {
+        ImageResizeFilter filter = ImageResizeFilter::Bilinear;
+
+        //! Number of threads, zero uses the hardware concurrency.
+        size_t threadCount = 0;
+
+        //! Use SIMD instructions when they are available.
+        bool simd = true;
+
+        bool operator == (const ImageResizeOptions&) const;
+        bool operator != (const ImageResizeOptions&) const;
+    };
+
+    //! Resize image data. The filters are widened when downscaling so that
+    //! every input pixel contributes to the output. The input is converted
+    //! to the output type, so the output can be any type that is a
+    //! conversion output.
+    //!
+    //! Throws:
+    //! - std::invalid_argument
+    void resizeImage(
+        const ImageInfo& inInfo,
+        const uint8_t*   in,
+        const ImageInfo& outInfo,
+        uint8_t*         out,
+        const ImageResizeOptions& = ImageResizeOptions());
+
+    //! Resize an image.
+    //!
+    //! Throws:
+    //! - std::invalid_argument
+    void resizeImage(
+        const std::shared_ptr<const Image>& in,
+        const std::shared_ptr<Image>& out,
+        const ImageResizeOptions& = ImageResizeOptions());
+
+    //! Resize an image to a new image with the given size. YUV images are
+    //! resized to RGB images with the same bit depth.
+    //!
+    //! Throws:
+    //! - std::invalid_argument
+    std::shared_ptr<Image> resizeImage(
+        const std::shared_ptr<const Image>&,
+        const Size2I&,
+        const ImageResizeOptions& = ImageResizeOptions());
+
+    ///@}
+}
@@ -0,0 +1,848 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/ImageSIMDPrivate.h>
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FTK_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define FTK_TARGET_AVX2
+#else // _MSC_VER
+#define FTK_TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+#endif // _MSC_VER
+#endif // __x86_64__
+
+namespace ftk
+{
+    namespace simd
+    {
+        namespace
+        {
+#if defined(FTK_SIMD_X86)
+            bool hasAVX2()
+            {
+#if defined(_MSC_VER)
+                int info[4] = { 0, 0, 0, 0 };
+                __cpuid(info, 0);
+                if (info[0] < 7)
+                {
+                    return false;
+                }
+                __cpuid(info, 1);
+                const bool fma = info[2] & (1 << 12);
+                const bool osxsave = info[2] & (1 << 27);
+                const bool f16c = info[2] & (1 << 29);
+                if (!fma || !osxsave || !f16c || (_xgetbv(0) & 6) != 6)
+                {
+                    return false;
+                }
+                __cpuidex(info, 7, 0);
+                return info[1] & (1 << 5);
+#else // _MSC_VER
+                // All of the CPUs with AVX2 also have F16C.
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif // _MSC_VER
+            }
+#endif // FTK_SIMD_X86
+
+            template<typename T>
+            inline T load(const uint8_t* p)
+            {
+                T out;
+                memcpy(&out, p, sizeof(T));
+                return out;
+            }
+
+            template<typename T>
+            inline void store(uint8_t* p, T value)
+            {
+                memcpy(p, &value, sizeof(T));
+            }
+
+            inline float clamp01(float value)
+            {
+                // Written so that NaN values become zero, the same as the
+                // SIMD versions.
+                value = value > 0.F ? value : 0.F;
+                return value < 1.F ? value : 1.F;
+            }
+
+            inline uint8_t premultiply8(uint8_t c, uint8_t a)
+            {
+                // Divide by 255 with rounding.
+                const unsigned int t = c * a + 128;
+                return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+            }
+
+            void u8ToF32Scalar(const uint8_t* in, float* out, size_t count)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out[i] = static_cast<float>(in[i]) * (1.F / 255.F);
+                }
+            }
+
+            void u16ToF32Scalar(const uint8_t* in, float* out, size_t count)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out[i] = static_cast<float>(load<uint16_t>(in + i * 2)) * (1.F / 65535.F);
+                }
+            }
+
+            void f16ToF32Scalar(const uint8_t* in, float* out, size_t count)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out[i] = halfToFloat(load<uint16_t>(in + i * 2));
+                }
+            }
+
+            void f32ToU8Scalar(const float* in, uint8_t* out, size_t count)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out[i] = static_cast<uint8_t>(std::lrint(clamp01(in[i]) * 255.F));
+                }
+            }
+
+            void f32ToU16Scalar(const float* in, uint8_t* out, size_t count)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    store(out + i * 2, static_cast<uint16_t>(std::lrint(clamp01(in[i]) * 65535.F)));
+                }
+            }
+
+            void f32ToF16Scalar(const float* in, uint8_t* out, size_t count)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    store(out + i * 2, floatToHalf(in[i]));
+                }
+            }
+
+            void l8ToLA8Scalar(const uint8_t* in, uint8_t* out, size_t count, bool alphaFromL)
+            {
+                for (size_t i = 0; i < count; ++i, out += 2)
+                {
+                    out[0] = in[i];
+                    out[1] = alphaFromL ? in[i] : 255;
+                }
+            }
+
+            void l8ToRGBA8Scalar(const uint8_t* in, uint8_t* out, size_t count, bool alphaFromL)
+            {
+                for (size_t i = 0; i < count; ++i, out += 4)
+                {
+                    out[0] = in[i];
+                    out[1] = in[i];
+                    out[2] = in[i];
+                    out[3] = alphaFromL ? in[i] : 255;
+                }
+            }
+
+            void rgba8Scalar(const uint8_t* in, uint8_t* out, size_t count, bool swapRB, bool premultiply)
+            {
+                const int r = swapRB ? 2 : 0;
+                const int b = swapRB ? 0 : 2;
+                for (size_t i = 0; i < count; ++i, in += 4, out += 4)
+                {
+                    const uint8_t a = in[3];
+                    const uint8_t c[3] = { in[r], in[1], in[b] };
+                    out[0] = premultiply ? premultiply8(c[0], a) : c[0];
+                    out[1] = premultiply ? premultiply8(c[1], a) : c[1];
+                    out[2] = premultiply ? premultiply8(c[2], a) : c[2];
+                    out[3] = a;
+                }
+            }
+
+            void premultiplyRGBAScalar(float* p, size_t count)
+            {
+                for (size_t i = 0; i < count; ++i, p += 4)
+                {
+                    p[0] *= p[3];
+                    p[1] *= p[3];
+                    p[2] *= p[3];
+                }
+            }
+
+            void mulAddScalar(float* out, const float* in, float weight, size_t count)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out[i] += in[i] * weight;
+                }
+            }
+
+#if defined(FTK_SIMD_X86)
+            //! \name SSE2
+            ///@{
+
+            void u8ToF32SSE2(const uint8_t* in, float* out, size_t count)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128 scale = _mm_set1_ps(1.F / 255.F);
+                size_t i = 0;
+                for (; i + 16 <= count; i += 16)
+                {
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                    const __m128i lo = _mm_unpacklo_epi8(v, zero);
+                    const __m128i hi = _mm_unpackhi_epi8(v, zero);
+                    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+                    _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+                    _mm_storeu_ps(out + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+                    _mm_storeu_ps(out + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+                }
+                u8ToF32Scalar(in + i, out + i, count - i);
+            }
+
+            void u16ToF32SSE2(const uint8_t* in, float* out, size_t count)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128 scale = _mm_set1_ps(1.F / 65535.F);
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8)
+                {
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 2));
+                    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)), scale));
+                    _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)), scale));
+                }
+                u16ToF32Scalar(in + i * 2, out + i, count - i);
+            }
+
+            inline __m128i f32ToI32SSE2(const float* in, __m128 scale)
+            {
+                const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in), _mm_setzero_ps()), _mm_set1_ps(1.F));
+                return _mm_cvtps_epi32(_mm_mul_ps(v, scale));
+            }
+
+            void f32ToU8SSE2(const float* in, uint8_t* out, size_t count)
+            {
+                const __m128 scale = _mm_set1_ps(255.F);
+                size_t i = 0;
+                for (; i + 16 <= count; i += 16)
+                {
+                    const __m128i a = _mm_packs_epi32(f32ToI32SSE2(in + i, scale), f32ToI32SSE2(in + i + 4, scale));
+                    const __m128i b = _mm_packs_epi32(f32ToI32SSE2(in + i + 8, scale), f32ToI32SSE2(in + i + 12, scale));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(a, b));
+                }
+                f32ToU8Scalar(in + i, out + i, count - i);
+            }
+
+            void f32ToU16SSE2(const float* in, uint8_t* out, size_t count)
+            {
+                // SSE2 does not have an unsigned 32-bit pack, so the values
+                // are offset into the signed range and back.
+                const __m128 scale = _mm_set1_ps(65535.F);
+                const __m128i offset32 = _mm_set1_epi32(32768);
+                const __m128i offset16 = _mm_set1_epi16(-32768);
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8)
+                {
+                    const __m128i a = _mm_sub_epi32(f32ToI32SSE2(in + i, scale), offset32);
+                    const __m128i b = _mm_sub_epi32(f32ToI32SSE2(in + i + 4, scale), offset32);
+                    _mm_storeu_si128(
+                        reinterpret_cast<__m128i*>(out + i * 2),
+                        _mm_xor_si128(_mm_packs_epi32(a, b), offset16));
+                }
+                f32ToU16Scalar(in + i, out + i * 2, count - i);
+            }
+
+            void l8ToLA8SSE2(const uint8_t* in, uint8_t* out, size_t count, bool alphaFromL)
+            {
+                const __m128i opaque = _mm_set1_epi8(-1);
+                size_t i = 0;
+                for (; i + 16 <= count; i += 16)
+                {
+                    const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                    const __m128i a = alphaFromL ? l : opaque;
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2), _mm_unpacklo_epi8(l, a));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2 + 16), _mm_unpackhi_epi8(l, a));
+                }
+                l8ToLA8Scalar(in + i, out + i * 2, count - i, alphaFromL);
+            }
+
+            void l8ToRGBA8SSE2(const uint8_t* in, uint8_t* out, size_t count, bool alphaFromL)
+            {
+                const __m128i opaque = _mm_set1_epi8(-1);
+                size_t i = 0;
+                for (; i + 16 <= count; i += 16)
+                {
+                    const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                    const __m128i a = alphaFromL ? l : opaque;
+                    const __m128i llLo = _mm_unpacklo_epi8(l, l);
+                    const __m128i laLo = _mm_unpacklo_epi8(l, a);
+                    const __m128i llHi = _mm_unpackhi_epi8(l, l);
+                    const __m128i laHi = _mm_unpackhi_epi8(l, a);
+                    __m128i* outP = reinterpret_cast<__m128i*>(out + i * 4);
+                    _mm_storeu_si128(outP + 0, _mm_unpacklo_epi16(llLo, laLo));
+                    _mm_storeu_si128(outP + 1, _mm_unpackhi_epi16(llLo, laLo));
+                    _mm_storeu_si128(outP + 2, _mm_unpacklo_epi16(llHi, laHi));
+                    _mm_storeu_si128(outP + 3, _mm_unpackhi_epi16(llHi, laHi));
+                }
+                l8ToRGBA8Scalar(in + i, out + i * 4, count - i, alphaFromL);
+            }
+
+            inline __m128i premultiply8SSE2(__m128i v, __m128i alphaMask)
+            {
+                const __m128i a = _mm_shufflehi_epi16(
+                    _mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)),
+                    _MM_SHUFFLE(3, 3, 3, 3));
+                __m128i t = _mm_add_epi16(_mm_mullo_epi16(v, a), _mm_set1_epi16(128));
+                t = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+                return _mm_or_si128(_mm_andnot_si128(alphaMask, t), _mm_and_si128(alphaMask, v));
+            }
+
+            void rgba8SSE2(const uint8_t* in, uint8_t* out, size_t count, bool swapRB, bool premultiply)
+            {
+                const __m128i agMask = _mm_set1_epi32(static_cast<int>(0xff00ff00));
+                const __m128i byteMask = _mm_set1_epi32(0xff);
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+                size_t i = 0;
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+                    if (swapRB)
+                    {
+                        v = _mm_or_si128(
+                            _mm_and_si128(v, agMask),
+                            _mm_or_si128(
+                                _mm_and_si128(_mm_srli_epi32(v, 16), byteMask),
+                                _mm_slli_epi32(_mm_and_si128(v, byteMask), 16)));
+                    }
+                    if (premultiply)
+                    {
+                        v = _mm_packus_epi16(
+                            premultiply8SSE2(_mm_unpacklo_epi8(v, zero), alphaMask),
+                            premultiply8SSE2(_mm_unpackhi_epi8(v, zero), alphaMask));
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), v);
+                }
+                rgba8Scalar(in + i * 4, out + i * 4, count - i, swapRB, premultiply);
+            }
+
+            void premultiplyRGBASSE2(float* p, size_t count)
+            {
+                const __m128 alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+                for (size_t i = 0; i < count; ++i, p += 4)
+                {
+                    const __m128 v = _mm_loadu_ps(p);
+                    const __m128 c = _mm_mul_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)));
+                    _mm_storeu_ps(p, _mm_or_ps(_mm_andnot_ps(alphaMask, c), _mm_and_ps(alphaMask, v)));
+                }
+            }
+
+            void mulAddSSE2(float* out, const float* in, float weight, size_t count)
+            {
+                const __m128 w = _mm_set1_ps(weight);
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8)
+                {
+                    _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), w)));
+                    _mm_storeu_ps(out + i + 4, _mm_add_ps(_mm_loadu_ps(out + i + 4), _mm_mul_ps(_mm_loadu_ps(in + i + 4), w)));
+                }
+                mulAddScalar(out + i, in + i, weight, count - i);
+            }
+
+            void resampleRGBASSE2(
+                const float* in,
+                float* out,
+                size_t outCount,
+                const int* starts,
+                const int* counts,
+                const float* weights,
+                size_t weightStride)
+            {
+                for (size_t i = 0; i < outCount; ++i, out += 4)
+                {
+                    const float* inP = in + starts[i] * 4;
+                    const float* w = weights + i * weightStride;
+                    __m128 sum = _mm_setzero_ps();
+                    for (int j = 0; j < counts[i]; ++j, inP += 4)
+                    {
+                        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(inP), _mm_set1_ps(w[j])));
+                    }
+                    _mm_storeu_ps(out, sum);
+                }
+            }
+
+            ///@}
+
+            //! \name AVX2
+            ///@{
+
+            FTK_TARGET_AVX2 void u8ToF32AVX2(const uint8_t* in, float* out, size_t count)
+            {
+                const __m256 scale = _mm256_set1_ps(1.F / 255.F);
+                size_t i = 0;
+                for (; i + 16 <= count; i += 16)
+                {
+                    const __m256i a = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)));
+                    const __m256i b = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i + 8)));
+                    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(a), scale));
+                    _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(b), scale));
+                }
+                u8ToF32Scalar(in + i, out + i, count - i);
+            }
+
+            FTK_TARGET_AVX2 void u16ToF32AVX2(const uint8_t* in, float* out, size_t count)
+            {
+                const __m256 scale = _mm256_set1_ps(1.F / 65535.F);
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8)
+                {
+                    const __m256i v = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 2)));
+                    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+                }
+                u16ToF32Scalar(in + i * 2, out + i, count - i);
+            }
+
+            FTK_TARGET_AVX2 void f16ToF32AVX2(const uint8_t* in, float* out, size_t count)
+            {
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8)
+                {
+                    _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 2))));
+                }
+                f16ToF32Scalar(in + i * 2, out + i, count - i);
+            }
+
+            FTK_TARGET_AVX2 inline __m256i f32ToI32AVX2(const float* in, __m256 scale)
+            {
+                const __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in), _mm256_setzero_ps()), _mm256_set1_ps(1.F));
+                return _mm256_cvtps_epi32(_mm256_mul_ps(v, scale));
+            }
+
+            FTK_TARGET_AVX2 void f32ToU8AVX2(const float* in, uint8_t* out, size_t count)
+            {
+                // The packs work within 128-bit lanes, so the result is
+                // permuted back into order.
+                const __m256 scale = _mm256_set1_ps(255.F);
+                const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+                size_t i = 0;
+                for (; i + 32 <= count; i += 32)
+                {
+                    const __m256i a = _mm256_packs_epi32(f32ToI32AVX2(in + i, scale), f32ToI32AVX2(in + i + 8, scale));
+                    const __m256i b = _mm256_packs_epi32(f32ToI32AVX2(in + i + 16, scale), f32ToI32AVX2(in + i + 24, scale));
+                    _mm256_storeu_si256(
+                        reinterpret_cast<__m256i*>(out + i),
+                        _mm256_permutevar8x32_epi32(_mm256_packus_epi16(a, b), order));
+                }
+                f32ToU8Scalar(in + i, out + i, count - i);
+            }
+
+            FTK_TARGET_AVX2 void f32ToU16AVX2(const float* in, uint8_t* out, size_t count)
+            {
+                const __m256 scale = _mm256_set1_ps(65535.F);
+                size_t i = 0;
+                for (; i + 16 <= count; i += 16)
+                {
+                    const __m256i v = _mm256_packus_epi32(f32ToI32AVX2(in + i, scale), f32ToI32AVX2(in + i + 8, scale));
+                    _mm256_storeu_si256(
+                        reinterpret_cast<__m256i*>(out + i * 2),
+                        _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0)));
+                }
+                f32ToU16Scalar(in + i, out + i * 2, count - i);
+            }
+
+            FTK_TARGET_AVX2 void f32ToF16AVX2(const float* in, uint8_t* out, size_t count)
+            {
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8)
+                {
+                    _mm_storeu_si128(
+                        reinterpret_cast<__m128i*>(out + i * 2),
+                        _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+                }
+                f32ToF16Scalar(in + i, out + i * 2, count - i);
+            }
+
+            FTK_TARGET_AVX2 inline __m256i premultiply8AVX2(__m256i v, __m256i alphaMask)
+            {
+                const __m256i a = _mm256_shufflehi_epi16(
+                    _mm256_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)),
+                    _MM_SHUFFLE(3, 3, 3, 3));
+                __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(v, a), _mm256_set1_epi16(128));
+                t = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+                return _mm256_blendv_epi8(t, v, alphaMask);
+            }
+
+            FTK_TARGET_AVX2 void rgba8AVX2(const uint8_t* in, uint8_t* out, size_t count, bool swapRB, bool premultiply)
+            {
+                const __m256i swap = _mm256_setr_epi8(
+                    2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                    2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+                const __m256i zero = _mm256_setzero_si256();
+                const __m256i alphaMask = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i * 4));
+                    if (swapRB)
+                    {
+                        v = _mm256_shuffle_epi8(v, swap);
+                    }
+                    if (premultiply)
+                    {
+                        v = _mm256_packus_epi16(
+                            premultiply8AVX2(_mm256_unpacklo_epi8(v, zero), alphaMask),
+                            premultiply8AVX2(_mm256_unpackhi_epi8(v, zero), alphaMask));
+                    }
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4), v);
+                }
+                rgba8SSE2(in + i * 4, out + i * 4, count - i, swapRB, premultiply);
+            }
+
+            FTK_TARGET_AVX2 void mulAddAVX2(float* out, const float* in, float weight, size_t count)
+            {
+                const __m256 w = _mm256_set1_ps(weight);
+                size_t i = 0;
+                for (; i + 16 <= count; i += 16)
+                {
+                    _mm256_storeu_ps(out + i, _mm256_fmadd_ps(_mm256_loadu_ps(in + i), w, _mm256_loadu_ps(out + i)));
+                    _mm256_storeu_ps(out + i + 8, _mm256_fmadd_ps(_mm256_loadu_ps(in + i + 8), w, _mm256_loadu_ps(out + i + 8)));
+                }
+                mulAddScalar(out + i, in + i, weight, count - i);
+            }
+
+            FTK_TARGET_AVX2 void resampleRGBAAVX2(
+                const float* in,
+                float* out,
+                size_t outCount,
+                const int* starts,
+                const int* counts,
+                const float* weights,
+                size_t weightStride)
+            {
+                // Two input pixels are accumulated at a time, and the
+                // halves are added at the end.
+                for (size_t i = 0; i < outCount; ++i, out += 4)
+                {
+                    const float* inP = in + starts[i] * 4;
+                    const float* w = weights + i * weightStride;
+                    const int count = counts[i];
+                    __m256 sum = _mm256_setzero_ps();
+                    int j = 0;
+                    for (; j + 2 <= count; j += 2, inP += 8)
+                    {
+                        const __m256 weight = _mm256_setr_ps(w[j], w[j], w[j], w[j], w[j + 1], w[j + 1], w[j + 1], w[j + 1]);
+                        sum = _mm256_fmadd_ps(_mm256_loadu_ps(inP), weight, sum);
+                    }
+                    __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+                    if (j < count)
+                    {
+                        sum4 = _mm_fmadd_ps(_mm_loadu_ps(inP), _mm_set1_ps(w[j]), sum4);
+                    }
+                    _mm_storeu_ps(out, sum4);
+                }
+            }
+
+            ///@}
+#endif // FTK_SIMD_X86
+        }
+
+        ISA getISA()
+        {
+#if defined(FTK_SIMD_X86)
+            static const ISA isa = hasAVX2() ? ISA::AVX2 : ISA::SSE2;
+            return isa;
+#else // FTK_SIMD_X86
+            return ISA::Scalar;
+#endif // FTK_SIMD_X86
+        }
+
+        ISA getISA(bool simd)
+        {
+            return simd ? getISA() : ISA::Scalar;
+        }
+
+        const char* getLabel(ISA value)
+        {
+            const char* out = "Scalar";
+            switch (value)
+            {
+            case ISA::SSE2: out = "SSE2"; break;
+            case ISA::AVX2: out = "AVX2"; break;
+            default: break;
+            }
+            return out;
+        }
+
+        float halfToFloat(uint16_t value)
+        {
+            // Reference:
+            // * https://gist.github.com/rygorous/2156668
+            const uint32_t shiftedExp = 0x7c00 << 13;
+            uint32_t bits = (value & 0x7fff) << 13;
+            const uint32_t exp = shiftedExp & bits;
+            bits += (127 - 15) << 23;
+            if (shiftedExp == exp)
+            {
+                // Infinity or NaN.
+                bits += (128 - 16) << 23;
+            }
+            else if (0 == exp)
+            {
+                // Zero or denormal.
+                const uint32_t magicBits = 113 << 23;
+                float magic = 0.F;
+                memcpy(&magic, &magicBits, 4);
+                bits += 1 << 23;
+                float tmp = 0.F;
+                memcpy(&tmp, &bits, 4);
+                tmp -= magic;
+                memcpy(&bits, &tmp, 4);
+            }
+            bits |= static_cast<uint32_t>(value & 0x8000) << 16;
+            float out = 0.F;
+            memcpy(&out, &bits, 4);
+            return out;
+        }
+
+        uint16_t floatToHalf(float value)
+        {
+            // Reference:
+            // * https://gist.github.com/rygorous/2156668
+            uint32_t bits = 0;
+            memcpy(&bits, &value, 4);
+            const uint32_t sign = bits & 0x80000000u;
+            bits ^= sign;
+            uint16_t out = 0;
+            if (bits >= 0x47800000u)
+            {
+                // Infinity or NaN.
+                out = bits > 0x7f800000u ? 0x7e00 : 0x7c00;
+            }
+            else if (bits < 0x38800000u)
+            {
+                // Zero or denormal, rounded by adding a magic number.
+                const uint32_t magicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+                float magic = 0.F;
+                memcpy(&magic, &magicBits, 4);
+                float tmp = 0.F;
+                memcpy(&tmp, &bits, 4);
+                tmp += magic;
+                memcpy(&bits, &tmp, 4);
+                out = static_cast<uint16_t>(bits - magicBits);
+            }
+            else
+            {
+                // Normal, rounded to the nearest even value.
+                const uint32_t mantissaOdd = (bits >> 13) & 1;
+                bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xfff;
+                bits += mantissaOdd;
+                out = static_cast<uint16_t>(bits >> 13);
+            }
+            return out | static_cast<uint16_t>(sign >> 16);
+        }
+
+        void u8ToF32(ISA isa, const uint8_t* in, float* out, size_t count)
+        {
+            switch (isa)
+            {
+#if defined(FTK_SIMD_X86)
+            case ISA::SSE2: u8ToF32SSE2(in, out, count); break;
+            case ISA::AVX2: u8ToF32AVX2(in, out, count); break;
+#endif // FTK_SIMD_X86
+            default: u8ToF32Scalar(in, out, count); break;
+            }
+        }
+
+        void u16ToF32(ISA isa, const uint8_t* in, float* out, size_t count)
+        {
+            switch (isa)
+            {
+#if defined(FTK_SIMD_X86)
+            case ISA::SSE2: u16ToF32SSE2(in, out, count); break;
+            case ISA::AVX2: u16ToF32AVX2(in, out, count); break;
+#endif // FTK_SIMD_X86
+            default: u16ToF32Scalar(in, out, count); break;
+            }
+        }
+
+        void u32ToF32(ISA, const uint8_t* in, float* out, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = static_cast<float>(load<uint32_t>(in + i * 4) / 4294967295.0);
+            }
+        }
+
+        void f16ToF32(ISA isa, const uint8_t* in, float* out, size_t count)
+        {
+            switch (isa)
+            {
+#if defined(FTK_SIMD_X86)
+            case ISA::AVX2: f16ToF32AVX2(in, out, count); break;
+#endif // FTK_SIMD_X86
+            default: f16ToF32Scalar(in, out, count); break;
+            }
+        }
+
+        void f32ToU8(ISA isa, const float* in, uint8_t* out, size_t count)
+        {
+            switch (isa)
+            {
+#if defined(FTK_SIMD_X86)
+            case ISA::SSE2: f32ToU8SSE2(in, out, count); break;
+            case ISA::AVX2: f32ToU8AVX2(in, out, count); break;
+#endif // FTK_SIMD_X86
+            default: f32ToU8Scalar(in, out, count); break;
+            }
+        }
+
+        void f32ToU16(ISA isa, const float* in, uint8_t* out, size_t count)
+        {
+            switch (isa)
+            {
+#if defined(FTK_SIMD_X86)
+            case ISA::SSE2: f32ToU16SSE2(in, out, count); break;
+            case ISA::AVX2: f32ToU16AVX2(in, out, count); break;
+#endif // FTK_SIMD_X86
+            default: f32ToU16Scalar(in, out, count); break;
+            }
+        }
+
+        void f32ToU32(ISA, const float* in, uint8_t* out, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const double value = static_cast<double>(clamp01(in[i])) * 4294967295.0;
+                store(out + i * 4, static_cast<uint32_t>(std::llrint(value)));
+            }
+        }
+
+        void f32ToF16(ISA isa, const float* in, uint8_t* out, size_t count)
+        {
+            switch (isa)
+            {
+#if defined(FTK_SIMD_X86)
+            case ISA::AVX2: f32ToF16AVX2(in, out, count); break;
+#endif // FTK_SIMD_X86
+            default: f32ToF16Scalar(in, out, count); break;
+            }
+        }
+
+        void l8ToLA8(ISA isa, const uint8_t* in, uint8_t* out, size_t count, bool alphaFromL)
+        {
+            switch (isa)
+            {
+#if defined(FTK_SIMD_X86)
+            case ISA::SSE2:
+            case ISA::AVX2: l8ToLA8SSE2(in, out, count, alphaFromL); break;
+#endif // FTK_SIMD_X86
+            default: l8ToLA8Scalar(in, out, count, alphaFromL); break;
+            }
+        }
+
+        void l8ToRGB8(ISA, const uint8_t* in, uint8_t* out, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i, out += 3)
+            {
+                out[0] = in[i];
+                out[1] = in[i];
+                out[2] = in[i];
+            }
+        }
+
+        void l8ToRGBA8(ISA isa, const uint8_t* in, uint8_t* out, size_t count, bool alphaFromL)
+        {
+            switch (isa)
+            {
+#if defined(FTK_SIMD_X86)
+            case ISA::SSE2:
+            case ISA::AVX2: l8ToRGBA8SSE2(in, out, count, alphaFromL); break;
+#endif // FTK_SIMD_X86
+            default: l8ToRGBA8Scalar(in, out, count, alphaFromL); break;
+            }
+        }
+
+        void rgba8(ISA isa, const uint8_t* in, uint8_t* out, size_t count, bool swapRB, bool premultiply)
+        {
+            switch (isa)
+            {
+#if defined(FTK_SIMD_X86)
+            case ISA::SSE2: rgba8SSE2(in, out, count, swapRB, premultiply); break;
+            case ISA::AVX2: rgba8AVX2(in, out, count, swapRB, premultiply); break;
+#endif // FTK_SIMD_X86
+            default: rgba8Scalar(in, out, count, swapRB, premultiply); break;
+            }
+        }
+
+        void premultiplyRGBA(ISA isa, float* p, size_t count)
+        {
+            switch (isa)
+            {
+#if defined(FTK_SIMD_X86)
+            case ISA::SSE2:
+            case ISA::AVX2: premultiplyRGBASSE2(p, count); break;
+#endif // FTK_SIMD_X86
+            default: premultiplyRGBAScalar(p, count); break;
+            }
+        }
+
+        void mulAdd(ISA isa, float* out, const float* in, float weight, size_t count)
+        {
+            switch (isa)
+            {
+#if defined(FTK_SIMD_X86)
+            case ISA::SSE2: mulAddSSE2(out, in, weight, count); break;
+            case ISA::AVX2: mulAddAVX2(out, in, weight, count); break;
+#endif // FTK_SIMD_X86
+            default: mulAddScalar(out, in, weight, count); break;
+            }
+        }
+
+        void resampleRow(
+            ISA isa,
+            const float* in,
+            float* out,
+            size_t outCount,
+            size_t channelCount,
+            const int* starts,
+            const int* counts,
+            const float* weights,
+            size_t weightStride)
+        {
+#if defined(FTK_SIMD_X86)
+            if (4 == channelCount)
+            {
+                switch (isa)
+                {
+                case ISA::SSE2:
+                    resampleRGBASSE2(in, out, outCount, starts, counts, weights, weightStride);
+                    return;
+                case ISA::AVX2:
+                    resampleRGBAAVX2(in, out, outCount, starts, counts, weights, weightStride);
+                    return;
+                default: break;
+                }
+            }
+#endif // FTK_SIMD_X86
+            for (size_t i = 0; i < outCount; ++i, out += channelCount)
+            {
+                const float* inP = in + starts[i] * channelCount;
+                const float* w = weights + i * weightStride;
+                for (size_t c = 0; c < channelCount; ++c)
+                {
+                    out[c] = 0.F;
+                }
+                for (int j = 0; j < counts[i]; ++j, inP += channelCount)
+                {
+                    for (size_t c = 0; c < channelCount; ++c)
+                    {
+                        out[c] += inP[c] * w[j];
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ftk
+{
+    //! Image processing kernels. The kernels have SSE2 and AVX2 versions
+    //! on x86-64, and scalar versions for other platforms. The SIMD and
+    //! scalar versions of the conversion kernels give the same results.
+    namespace simd
+    {
+        //! Instruction sets.
+        enum class ISA
+        {
+            Scalar,
+            SSE2,
+            AVX2 //!< AVX2 with FMA and F16C
+        };
+
+        //! Get the best instruction set available on this CPU.
+        ISA getISA();
+
+        //! Get the instruction set to use.
+        ISA getISA(bool simd);
+
+        //! Get the instruction set name.
+        const char* getLabel(ISA);
+
+        //! Convert a half float to a float.
+        float halfToFloat(uint16_t);
+
+        //! Convert a float to a half float, rounding to the nearest value.
+        uint16_t floatToHalf(float);
+
+        //! \name Component Conversion
+        //! Convert components to and from normalized floats. Integer
+        //! components are clamped and rounded to the nearest value.
+        ///@{
+
+        void u8ToF32(ISA, const uint8_t*, float*, size_t count);
+        void u16ToF32(ISA, const uint8_t*, float*, size_t count);
+        void u32ToF32(ISA, const uint8_t*, float*, size_t count);
+        void f16ToF32(ISA, const uint8_t*, float*, size_t count);
+        void f32ToU8(ISA, const float*, uint8_t*, size_t count);
+        void f32ToU16(ISA, const float*, uint8_t*, size_t count);
+        void f32ToU32(ISA, const float*, uint8_t*, size_t count);
+        void f32ToF16(ISA, const float*, uint8_t*, size_t count);
+
+        ///@}
+
+        //! \name Eight Bit Pixels
+        ///@{
+
+        //! Expand L_U8 pixels to LA_U8. The alpha is either opaque or
+        //! copied from the luminance.
+        void l8ToLA8(ISA, const uint8_t*, uint8_t*, size_t count, bool alphaFromL);
+
+        //! Expand L_U8 pixels to RGB_U8.
+        void l8ToRGB8(ISA, const uint8_t*, uint8_t*, size_t count);
+
+        //! Expand L_U8 pixels to RGBA_U8. The alpha is either opaque or
+        //! copied from the luminance.
+        void l8ToRGBA8(ISA, const uint8_t*, uint8_t*, size_t count, bool alphaFromL);
+
+        //! Convert RGBA_U8 pixels, optionally swapping the red and blue
+        //! channels and premultiplying the alpha.
+        void rgba8(ISA, const uint8_t*, uint8_t*, size_t count, bool swapRB, bool premultiply);
+
+        ///@}
+
+        //! \name Float Pixels
+        ///@{
+
+        //! Premultiply RGBA float pixels in place.
+        void premultiplyRGBA(ISA, float*, size_t count);
+
+        //! Multiply the input by a weight and add it to the output.
+        void mulAdd(ISA, float* out, const float* in, float weight, size_t count);
+
+        //! Resample a row of pixels with a filter. Each output pixel is the
+        //! weighted sum of "counts[i]" input pixels starting at "starts[i]",
+        //! with the weights stored in "weights" at "i * weightStride".
+        void resampleRow(
+            ISA,
+            const float* in,
+            float* out,
+            size_t outCount,
+            size_t channelCount,
+            const int* starts,
+            const int* counts,
+            const float* weights,
+            size_t weightStride);
+
+        ///@}
+    }
+}
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace ftk
+{
+    //! Implicit treap.
+    //!
+    //! The treap is a balanced tree that stores a sequence of values by
+    //! position. Each node also stores a summary of the values in its
+    //! subtree, such as their sum or range, so that the summary of a
+    //! range of values can be found without visiting them. Getting and
+    //! setting a value, and the summary queries, are O(log n). Inserting
+    //! and removing values are O(log n) plus the number of values.
+    //!
+    //! The summary type must be default constructible as the summary of
+    //! no values, constructible from a value, and have a merge() function
+    //! that adds the summary of the values that follow.
+    template<typename T, typename S>
+    class ImplicitTreap
+    {
+    public:
+        //! \name Values
+        ///@{
+
+        //! Get the number of values.
+        size_t getSize() const;
+
+        //! Get a value.
+        const T& get(size_t) const;
+
+        //! Set a value.
+        void set(size_t, const T&);
+
+        //! Insert copies of a value.
+        void insert(size_t index, size_t count, const T&);
+
+        //! Insert values.
+        void insert(size_t index, const std::vector<T>&);
+
+        //! Remove values.
+        void remove(size_t index, size_t count);
+
+        //! Remove all of the values.
+        void clear();
+
+        ///@}
+
+        //! \name Summary
+        ///@{
+
+        //! Get the summary of all of the values.
+        S getSummary() const;
+
+        //! Get the summary of the first values.
+        S getPrefix(size_t count) const;
+
+        //! Find the first value at or after the given index for which the
+        //! predicate is true. The predicate is given the summary of the
+        //! values from the index up to and including the value, and it
+        //! must stay true for the following values once it is true. The
+        //! number of values is returned if the predicate is never true.
+        template<typename F>
+        size_t find(size_t index, const F&) const;
+
+        ///@}
+
+    private:
+        struct Node
+        {
+            T value = T();
+            S summary;
+            uint32_t size = 0;
+            uint32_t priority = 0;
+            int32_t left = -1;
+            int32_t right = -1;
+        };
+
+        uint32_t _getSize(int32_t) const;
+        int32_t _getNode(size_t) const;
+        void _update(int32_t);
+        template<typename G>
+        int32_t _build(size_t count, const G&);
+        void _split(int32_t, size_t, int32_t& left, int32_t& right);
+        int32_t _merge(int32_t, int32_t);
+        void _insert(size_t index, int32_t);
+        void _free(int32_t);
+        template<typename F>
+        size_t _find(int32_t, size_t, S&, const F&) const;
+
+        std::vector<Node> _nodes;
+        std::vector<int32_t> _freeNodes;
+        int32_t _root = -1;
+        uint32_t _random = 0x9e3779b9;
+    };
+}
+
+#include <ftk/Core/ImplicitTreapInline.h>
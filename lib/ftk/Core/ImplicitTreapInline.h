@@ -0,0 +1,369 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <algorithm>
+
+namespace ftk
+{
+    template<typename T, typename S>
+    inline size_t ImplicitTreap<T, S>::getSize() const
+    {
+        return _getSize(_root);
+    }
+
+    template<typename T, typename S>
+    inline const T& ImplicitTreap<T, S>::get(size_t index) const
+    {
+        return _nodes[_getNode(index)].value;
+    }
+
+    template<typename T, typename S>
+    inline void ImplicitTreap<T, S>::set(size_t index, const T& value)
+    {
+        if (index >= getSize())
+            return;
+
+        // Set the value and then update the nodes on the path to it.
+        std::vector<int32_t> path;
+        int32_t node = _root;
+        while (node >= 0)
+        {
+            path.push_back(node);
+            const Node& n = _nodes[node];
+            const uint32_t leftSize = _getSize(n.left);
+            if (index < leftSize)
+            {
+                node = n.left;
+            }
+            else if (index == leftSize)
+            {
+                break;
+            }
+            else
+            {
+                index -= leftSize + 1;
+                node = n.right;
+            }
+        }
+        _nodes[path.back()].value = value;
+        for (auto i = path.rbegin(); i != path.rend(); ++i)
+        {
+            _update(*i);
+        }
+    }
+
+    template<typename T, typename S>
+    inline void ImplicitTreap<T, S>::insert(size_t index, size_t count, const T& value)
+    {
+        _insert(index, _build(
+            count,
+            [&value](size_t) -> const T&
+            {
+                return value;
+            }));
+    }
+
+    template<typename T, typename S>
+    inline void ImplicitTreap<T, S>::insert(size_t index, const std::vector<T>& values)
+    {
+        _insert(index, _build(
+            values.size(),
+            [&values](size_t i) -> const T&
+            {
+                return values[i];
+            }));
+    }
+
+    template<typename T, typename S>
+    inline void ImplicitTreap<T, S>::remove(size_t index, size_t count)
+    {
+        const size_t size = getSize();
+        index = std::min(index, size);
+        count = std::min(count, size - index);
+        if (0 == count)
+            return;
+        int32_t left = -1;
+        int32_t middle = -1;
+        int32_t right = -1;
+        _split(_root, index, left, right);
+        _split(right, count, middle, right);
+        _free(middle);
+        _root = _merge(left, right);
+    }
+
+    template<typename T, typename S>
+    inline void ImplicitTreap<T, S>::clear()
+    {
+        _nodes.clear();
+        _freeNodes.clear();
+        _root = -1;
+    }
+
+    template<typename T, typename S>
+    inline S ImplicitTreap<T, S>::getSummary() const
+    {
+        return _root >= 0 ? _nodes[_root].summary : S();
+    }
+
+    template<typename T, typename S>
+    inline S ImplicitTreap<T, S>::getPrefix(size_t count) const
+    {
+        S out;
+        int32_t node = _root;
+        while (node >= 0)
+        {
+            const Node& n = _nodes[node];
+            const uint32_t leftSize = _getSize(n.left);
+            if (count < leftSize)
+            {
+                node = n.left;
+            }
+            else
+            {
+                if (n.left >= 0)
+                {
+                    out.merge(_nodes[n.left].summary);
+                }
+                if (count == leftSize)
+                    break;
+                out.merge(S(n.value));
+                count -= leftSize + 1;
+                node = n.right;
+            }
+        }
+        return out;
+    }
+
+    template<typename T, typename S>
+    template<typename F>
+    inline size_t ImplicitTreap<T, S>::find(size_t index, const F& predicate) const
+    {
+        S summary;
+        return _find(_root, index, summary, predicate);
+    }
+
+    template<typename T, typename S>
+    inline uint32_t ImplicitTreap<T, S>::_getSize(int32_t node) const
+    {
+        return node >= 0 ? _nodes[node].size : 0;
+    }
+
+    template<typename T, typename S>
+    inline int32_t ImplicitTreap<T, S>::_getNode(size_t index) const
+    {
+        int32_t node = _root;
+        while (node >= 0)
+        {
+            const Node& n = _nodes[node];
+            const uint32_t leftSize = _getSize(n.left);
+            if (index < leftSize)
+            {
+                node = n.left;
+            }
+            else if (index == leftSize)
+            {
+                break;
+            }
+            else
+            {
+                index -= leftSize + 1;
+                node = n.right;
+            }
+        }
+        return node;
+    }
+
+    template<typename T, typename S>
+    inline void ImplicitTreap<T, S>::_update(int32_t node)
+    {
+        Node& n = _nodes[node];
+        n.size = 1;
+        S summary;
+        if (n.left >= 0)
+        {
+            n.size += _nodes[n.left].size;
+            summary = _nodes[n.left].summary;
+        }
+        summary.merge(S(n.value));
+        if (n.right >= 0)
+        {
+            n.size += _nodes[n.right].size;
+            summary.merge(_nodes[n.right].summary);
+        }
+        n.summary = summary;
+    }
+
+    template<typename T, typename S>
+    template<typename G>
+    inline int32_t ImplicitTreap<T, S>::_build(size_t count, const G& getValue)
+    {
+        // Build the tree in linear time with the nodes on the right edge
+        // kept in a stack.
+        std::vector<int32_t> stack;
+        for (size_t i = 0; i < count; ++i)
+        {
+            int32_t node = 0;
+            if (!_freeNodes.empty())
+            {
+                node = _freeNodes.back();
+                _freeNodes.pop_back();
+            }
+            else
+            {
+                node = static_cast<int32_t>(_nodes.size());
+                _nodes.push_back(Node());
+            }
+            _random ^= _random << 13;
+            _random ^= _random >> 17;
+            _random ^= _random << 5;
+            Node& n = _nodes[node];
+            n.value = getValue(i);
+            n.summary = S(n.value);
+            n.size = 1;
+            n.priority = _random;
+            n.left = -1;
+            n.right = -1;
+            while (!stack.empty() && _nodes[stack.back()].priority < n.priority)
+            {
+                n.left = stack.back();
+                stack.pop_back();
+                _update(n.left);
+            }
+            if (!stack.empty())
+            {
+                _nodes[stack.back()].right = node;
+            }
+            stack.push_back(node);
+        }
+        int32_t out = -1;
+        while (!stack.empty())
+        {
+            out = stack.back();
+            stack.pop_back();
+            _update(out);
+        }
+        return out;
+    }
+
+    template<typename T, typename S>
+    inline void ImplicitTreap<T, S>::_split(int32_t node, size_t index, int32_t& left, int32_t& right)
+    {
+        if (node < 0)
+        {
+            left = -1;
+            right = -1;
+            return;
+        }
+        Node& n = _nodes[node];
+        const uint32_t leftSize = _getSize(n.left);
+        if (index <= leftSize)
+        {
+            _split(n.left, index, left, n.left);
+            right = node;
+        }
+        else
+        {
+            _split(n.right, index - leftSize - 1, n.right, right);
+            left = node;
+        }
+        _update(node);
+    }
+
+    template<typename T, typename S>
+    inline int32_t ImplicitTreap<T, S>::_merge(int32_t left, int32_t right)
+    {
+        if (left < 0)
+            return right;
+        if (right < 0)
+            return left;
+        if (_nodes[left].priority > _nodes[right].priority)
+        {
+            const int32_t tmp = _merge(_nodes[left].right, right);
+            _nodes[left].right = tmp;
+            _update(left);
+            return left;
+        }
+        const int32_t tmp = _merge(left, _nodes[right].left);
+        _nodes[right].left = tmp;
+        _update(right);
+        return right;
+    }
+
+    template<typename T, typename S>
+    inline void ImplicitTreap<T, S>::_insert(size_t index, int32_t node)
+    {
+        if (node < 0)
+            return;
+        int32_t left = -1;
+        int32_t right = -1;
+        _split(_root, std::min(index, getSize()), left, right);
+        _root = _merge(_merge(left, node), right);
+    }
+
+    template<typename T, typename S>
+    inline void ImplicitTreap<T, S>::_free(int32_t node)
+    {
+        std::vector<int32_t> stack;
+        if (node >= 0)
+        {
+            stack.push_back(node);
+        }
+        while (!stack.empty())
+        {
+            const int32_t i = stack.back();
+            stack.pop_back();
+            _freeNodes.push_back(i);
+            if (_nodes[i].left >= 0)
+            {
+                stack.push_back(_nodes[i].left);
+            }
+            if (_nodes[i].right >= 0)
+            {
+                stack.push_back(_nodes[i].right);
+            }
+        }
+    }
+
+    template<typename T, typename S>
+    template<typename F>
+    inline size_t ImplicitTreap<T, S>::_find(
+        int32_t node,
+        size_t index,
+        S& summary,
+        const F& predicate) const
+    {
+        // Subtrees that are entirely after the index are skipped if the
+        // predicate is still false with their summary.
+        if (node < 0 || index >= _nodes[node].size)
+            return _getSize(node);
+        const Node& n = _nodes[node];
+        if (0 == index)
+        {
+            S tmp = summary;
+            tmp.merge(n.summary);
+            if (!predicate(tmp))
+            {
+                summary = tmp;
+                return n.size;
+            }
+        }
+        const uint32_t leftSize = _getSize(n.left);
+        if (index < leftSize)
+        {
+            const size_t out = _find(n.left, index, summary, predicate);
+            if (out < leftSize)
+                return out;
+        }
+        if (index <= leftSize)
+        {
+            summary.merge(S(n.value));
+            if (predicate(summary))
+                return leftSize;
+        }
+        return leftSize + 1 + _find(
+            n.right,
+            index > leftSize ? index - leftSize - 1 : 0,
+            summary,
+            predicate);
+    }
+}
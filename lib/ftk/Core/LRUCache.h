@@ -4,13 +4,20 @@
 #pragma once
 
 #include <cstdint>
-#include <map>
+#include <functional>
+#include <list>
+#include <unordered_map>
 #include <vector>
 
 namespace ftk
 {
     //! Least recently used (LRU) cache.
-    template<typename T, typename U>
+    //!
+    //! The items are stored in a list ordered from the most recently used
+    //! to the least recently used, and a hash map is used to look up the
+    //! list items by key. Lookups, insertions, and evictions are O(1), and
+    //! the total size of the items is kept as a running sum.
+    template<typename T, typename U, typename H = std::hash<T> >
     class LRUCache
     {
     public:
@@ -37,19 +44,56 @@ namespace ftk
         void remove(const T& key);
         void clear();
 
+        //! Get the keys, ordered from the least recently used to the most
+        //! recently used.
         std::vector<T> getKeys() const;
+
+        //! Get the values, ordered from the least recently used to the most
+        //! recently used.
         std::vector<U> getValues() const;
 
         ///@}
 
+        //! \name Statistics
+        ///@{
+
+        //! Get the number of calls to get() that found the key.
+        size_t getHits() const;
+
+        //! Get the number of calls to get() that did not find the key.
+        size_t getMisses() const;
+
+        //! Get the number of items that have been evicted.
+        size_t getEvictions() const;
+
+        //! Reset the statistics.
+        void resetStats();
+
+        ///@}
+
     private:
         void _maxUpdate();
 
+        struct Item
+        {
+            T key;
+            U value;
+            size_t size = 0;
+        };
+
         size_t _max = 10000;
-        std::map<T, std::pair<U, size_t> > _map;
-        std::map<T, int64_t> _counts;
-        int64_t _counter = 0;
+        size_t _size = 0;
+        std::list<Item> _list;
+        std::unordered_map<T, typename std::list<Item>::iterator, H> _map;
+        size_t _hits = 0;
+        size_t _misses = 0;
+        size_t _evictions = 0;
     };
+
+    //! Combine a hash with the hash of a value, for use in the hash
+    //! functions of cache keys.
+    template<typename T>
+    void hashCombine(std::size_t& hash, const T& value);
 }
 
 #include <ftk/Core/LRUCacheInline.h>
@@ -1,41 +1,34 @@
 // SPDX-License-Identifier: BSD-3-Clause
 // Copyright Contributors to the feather-tk project.
 
-#include <algorithm>
-
 namespace ftk
 {
-    template<typename T, typename U>
-    inline std::size_t LRUCache<T, U>::getMax() const
+    template<typename T, typename U, typename H>
+    inline std::size_t LRUCache<T, U, H>::getMax() const
     {
         return _max;
     }
 
-    template<typename T, typename U>
-    inline std::size_t LRUCache<T, U>::getSize() const
+    template<typename T, typename U, typename H>
+    inline std::size_t LRUCache<T, U, H>::getSize() const
     {
-        size_t out = 0;
-        for (const auto& i : _map)
-        {
-            out += i.second.second;
-        }
-        return out;
+        return _size;
     }
 
-    template<typename T, typename U>
-    inline std::size_t LRUCache<T, U>::getCount() const
+    template<typename T, typename U, typename H>
+    inline std::size_t LRUCache<T, U, H>::getCount() const
     {
         return _map.size();
     }
 
-    template<typename T, typename U>
-    inline float LRUCache<T, U>::getPercentage() const
+    template<typename T, typename U, typename H>
+    inline float LRUCache<T, U, H>::getPercentage() const
     {
-        return getSize() / static_cast<float>(_max) * 100.F;
+        return _size / static_cast<float>(_max) * 100.F;
     }
 
-    template<typename T, typename U>
-    inline void LRUCache<T, U>::setMax(std::size_t value)
+    template<typename T, typename U, typename H>
+    inline void LRUCache<T, U, H>::setMax(std::size_t value)
     {
         if (value == _max)
             return;
@@ -43,124 +36,145 @@ namespace ftk
         _maxUpdate();
     }
 
-    template<typename T, typename U>
-    inline bool LRUCache<T, U>::contains(const T& key) const
+    template<typename T, typename U, typename H>
+    inline bool LRUCache<T, U, H>::contains(const T& key) const
     {
         return _map.find(key) != _map.end();
     }
 
-    template<typename T, typename U>
-    inline bool LRUCache<T, U>::get(const T& key, U& value)
+    template<typename T, typename U, typename H>
+    inline bool LRUCache<T, U, H>::get(const T& key, U& value)
     {
         const auto i = _map.find(key);
         if (i != _map.end())
         {
-            value = i->second.first;
-            auto j = _counts.find(key);
-            if (j != _counts.end())
-            {
-                ++_counter;
-                j->second = _counter;
-            }
+            _list.splice(_list.begin(), _list, i->second);
+            value = i->second->value;
+            ++_hits;
+            return true;
         }
-        return i != _map.end();
+        ++_misses;
+        return false;
     }
 
-    template<typename T, typename U>
-    inline bool LRUCache<T, U>::touch(const T& key)
+    template<typename T, typename U, typename H>
+    inline bool LRUCache<T, U, H>::touch(const T& key)
     {
         const auto i = _map.find(key);
         if (i != _map.end())
         {
-            auto j = _counts.find(key);
-            if (j != _counts.end())
-            {
-                ++_counter;
-                j->second = _counter;
-            }
+            _list.splice(_list.begin(), _list, i->second);
+            return true;
         }
-        return i != _map.end();
+        return false;
     }
 
-    template<typename T, typename U>
-    inline void LRUCache<T, U>::add(const T& key, const U& value, size_t size)
+    template<typename T, typename U, typename H>
+    inline void LRUCache<T, U, H>::add(const T& key, const U& value, size_t size)
     {
-        _map[key] = std::make_pair(value, size);
-        ++_counter;
-        _counts[key] = _counter;
+        const auto i = _map.find(key);
+        if (i != _map.end())
+        {
+            _size -= i->second->size;
+            i->second->value = value;
+            i->second->size = size;
+            _list.splice(_list.begin(), _list, i->second);
+        }
+        else
+        {
+            _list.push_front(Item{ key, value, size });
+            _map[key] = _list.begin();
+        }
+        _size += size;
         _maxUpdate();
     }
 
-    template<typename T, typename U>
-    inline void LRUCache<T, U>::remove(const T& key)
+    template<typename T, typename U, typename H>
+    inline void LRUCache<T, U, H>::remove(const T& key)
     {
         const auto i = _map.find(key);
         if (i != _map.end())
         {
+            _size -= i->second->size;
+            _list.erase(i->second);
             _map.erase(i);
         }
-        const auto j = _counts.find(key);
-        if (j != _counts.end())
-        {
-            _counts.erase(j);
-        }
-        _maxUpdate();
     }
 
-    template<typename T, typename U>
-    inline void LRUCache<T, U>::clear()
+    template<typename T, typename U, typename H>
+    inline void LRUCache<T, U, H>::clear()
     {
         _map.clear();
+        _list.clear();
+        _size = 0;
     }
 
-    template<typename T, typename U>
-    inline std::vector<T> LRUCache<T, U>::getKeys() const
+    template<typename T, typename U, typename H>
+    inline std::vector<T> LRUCache<T, U, H>::getKeys() const
     {
         std::vector<T> out;
-        for (const auto& i : _map)
+        out.reserve(_list.size());
+        for (auto i = _list.rbegin(); i != _list.rend(); ++i)
         {
-            out.push_back(i.first);
+            out.push_back(i->key);
         }
         return out;
     }
 
-    template<typename T, typename U>
-    inline std::vector<U> LRUCache<T, U>::getValues() const
+    template<typename T, typename U, typename H>
+    inline std::vector<U> LRUCache<T, U, H>::getValues() const
     {
         std::vector<U> out;
-        for (const auto& i : _map)
+        out.reserve(_list.size());
+        for (auto i = _list.rbegin(); i != _list.rend(); ++i)
         {
-            out.push_back(i.second.first);
+            out.push_back(i->value);
         }
         return out;
     }
 
-    template<typename T, typename U>
-    inline void LRUCache<T, U>::_maxUpdate()
+    template<typename T, typename U, typename H>
+    inline size_t LRUCache<T, U, H>::getHits() const
+    {
+        return _hits;
+    }
+
+    template<typename T, typename U, typename H>
+    inline size_t LRUCache<T, U, H>::getMisses() const
+    {
+        return _misses;
+    }
+
+    template<typename T, typename U, typename H>
+    inline size_t LRUCache<T, U, H>::getEvictions() const
+    {
+        return _evictions;
+    }
+
+    template<typename T, typename U, typename H>
+    inline void LRUCache<T, U, H>::resetStats()
+    {
+        _hits = 0;
+        _misses = 0;
+        _evictions = 0;
+    }
+
+    template<typename T, typename U, typename H>
+    inline void LRUCache<T, U, H>::_maxUpdate()
     {
-        size_t size = getSize();
-        if (size > _max)
+        while (_size > _max && !_list.empty())
         {
-            std::map<int64_t, T> sorted;
-            for (const auto& i : _counts)
-            {
-                sorted[i.second] = i.first;
-            }
-            while (getSize() > _max)
-            {
-                auto begin = sorted.begin();
-                auto i = _map.find(begin->second);
-                if (i != _map.end())
-                {
-                    _map.erase(i);
-                }
-                auto j = _counts.find(begin->second);
-                if (j != _counts.end())
-                {
-                    _counts.erase(j);
-                }
-                sorted.erase(begin);
-            }
+            const Item& item = _list.back();
+            _size -= item.size;
+            _map.erase(item.key);
+            _list.pop_back();
+            ++_evictions;
         }
     }
+
+    template<typename T>
+    inline void hashCombine(std::size_t& hash, const T& value)
+    {
+        hash ^= std::hash<T>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
 }
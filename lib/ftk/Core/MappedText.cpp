@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/MappedText.h>
+
+#include <ftk/Core/FileIO.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ftk
+{
+    namespace
+    {
+        const size_t chunkSize = 1024 * 1024;
+
+        //! Find the line endings in the given range. This uses memchr()
+        //! which is vectorized by the C library.
+        void findLineEnds(
+            const uint8_t* start,
+            size_t begin,
+            size_t end,
+            std::vector<size_t>& out)
+        {
+            const uint8_t* p = start + begin;
+            const uint8_t* const pEnd = start + end;
+            while (p < pEnd)
+            {
+                const void* r = memchr(p, '\n', pEnd - p);
+                if (!r)
+                    break;
+                p = reinterpret_cast<const uint8_t*>(r);
+                out.push_back(p - start);
+                ++p;
+            }
+        }
+    }
+
+    struct MappedText::Private
+    {
+        std::filesystem::path path;
+        std::shared_ptr<FileIO> io;
+        const uint8_t* start = nullptr;
+        size_t size = 0;
+
+        struct Mutex
+        {
+            //! The offsets of the line endings.
+            std::vector<size_t> lineEnds;
+            bool indexed = false;
+            //! Set when the indexing stops, whether or not it completed.
+            bool finished = false;
+            std::mutex mutex;
+        };
+        Mutex mutex;
+
+        struct Thread
+        {
+            size_t pos = 0;
+            std::condition_variable cv;
+            std::thread thread;
+            std::atomic<bool> running;
+        };
+        Thread thread;
+    };
+
+    void MappedText::_init(const std::filesystem::path& path)
+    {
+        FTK_P();
+        p.path = path;
+        p.io = FileIO::create(path, FileMode::Read, FileRead::MemoryMapped);
+        p.start = p.io->getMemoryStart();
+        p.size = p.start ? p.io->getSize() : 0;
+
+        // Index the first chunk so that the beginning of the file is
+        // available immediately, and then index the rest of the file on a
+        // background thread.
+        std::vector<size_t> lineEnds;
+        while (p.thread.pos < p.size && lineEnds.empty())
+        {
+            const size_t end = std::min(p.thread.pos + chunkSize, p.size);
+            findLineEnds(p.start, p.thread.pos, end, lineEnds);
+            p.thread.pos = end;
+        }
+        p.mutex.lineEnds = std::move(lineEnds);
+        p.thread.running = p.thread.pos < p.size;
+        if (p.thread.running)
+        {
+            p.thread.thread = std::thread(
+                [this]
+                {
+                    _run();
+                });
+        }
+        else
+        {
+            _run();
+        }
+    }
+
+    MappedText::MappedText() :
+        _p(new Private)
+    {}
+
+    MappedText::~MappedText()
+    {
+        FTK_P();
+        p.thread.running = false;
+        if (p.thread.thread.joinable())
+        {
+            p.thread.thread.join();
+        }
+    }
+
+    std::shared_ptr<MappedText> MappedText::create(const std::filesystem::path& path)
+    {
+        auto out = std::shared_ptr<MappedText>(new MappedText);
+        out->_init(path);
+        return out;
+    }
+
+    const std::filesystem::path& MappedText::getPath() const
+    {
+        return _p->path;
+    }
+
+    size_t MappedText::getByteCount() const
+    {
+        return _p->size;
+    }
+
+    bool MappedText::isIndexed() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.indexed;
+    }
+
+    void MappedText::wait()
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        p.thread.cv.wait(
+            lock,
+            [this]
+            {
+                return _p->mutex.finished;
+            });
+    }
+
+    size_t MappedText::getLineCount() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.lineEnds.size();
+    }
+
+    std::string MappedText::getLine(size_t value) const
+    {
+        FTK_P();
+        size_t begin = 0;
+        size_t end = 0;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            if (value >= p.mutex.lineEnds.size())
+                return std::string();
+            begin = value > 0 ? p.mutex.lineEnds[value - 1] + 1 : 0;
+            end = p.mutex.lineEnds[value];
+        }
+        if (end > begin && '\r' == p.start[end - 1])
+        {
+            --end;
+        }
+        return std::string(reinterpret_cast<const char*>(p.start + begin), end - begin);
+    }
+
+    void MappedText::_run()
+    {
+        FTK_P();
+        try
+        {
+            std::vector<size_t> lineEnds;
+            while (p.thread.running && p.thread.pos < p.size)
+            {
+                lineEnds.clear();
+                const size_t end = std::min(p.thread.pos + chunkSize, p.size);
+                findLineEnds(p.start, p.thread.pos, end, lineEnds);
+                p.thread.pos = end;
+                std::unique_lock<std::mutex> lock(p.mutex.mutex);
+                p.mutex.lineEnds.insert(p.mutex.lineEnds.end(), lineEnds.begin(), lineEnds.end());
+            }
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            if (p.thread.pos >= p.size)
+            {
+                // The last line does not need a line ending.
+                if (p.size > 0 && '\n' != p.start[p.size - 1])
+                {
+                    p.mutex.lineEnds.push_back(p.size);
+                }
+                p.mutex.indexed = true;
+            }
+        }
+        catch (const std::exception&)
+        {
+            // The lines indexed so far are still available, but the file
+            // is not marked as indexed.
+        }
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            p.mutex.finished = true;
+        }
+        p.thread.cv.notify_all();
+    }
+}
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/Util.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace ftk
+{
+    //! \name Memory Mapped Text
+    ///@{
+
+    //! Memory mapped text.
+    //!
+    //! The text file is memory mapped and the line offsets are indexed on a
+    //! background thread, so opening a file does not depend on its size.
+    //! Lines are copied from the file when they are requested. Lines are
+    //! separated by "\n" or "\r\n".
+    //!
+    //! The memory mapped text functions are thread safe.
+    class MappedText : public std::enable_shared_from_this<MappedText>
+    {
+        FTK_NON_COPYABLE(MappedText);
+
+    protected:
+        void _init(const std::filesystem::path&);
+
+        MappedText();
+
+    public:
+        ~MappedText();
+
+        //! Create new memory mapped text.
+        static std::shared_ptr<MappedText> create(const std::filesystem::path&);
+
+        //! Get the file path.
+        const std::filesystem::path& getPath() const;
+
+        //! Get the file size in bytes.
+        size_t getByteCount() const;
+
+        //! Get whether all of the lines have been indexed.
+        bool isIndexed() const;
+
+        //! Wait until the indexing has finished. Use isIndexed() to check
+        //! whether all of the lines were indexed, since the indexing may
+        //! stop early if there is an error.
+        void wait();
+
+        //! Get the number of lines that have been indexed.
+        size_t getLineCount() const;
+
+        //! Get a line.
+        std::string getLine(size_t) const;
+
+    private:
+        void _run();
+
+        FTK_PRIVATE();
+    };
+
+    ///@}
+}
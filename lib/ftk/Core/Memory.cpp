@@ -8,9 +8,14 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdlib>
 #include <cstring>
 #include <sstream>
 
+#if defined(_WINDOWS)
+#include <malloc.h>
+#endif // _WINDOWS
+
 namespace ftk
 {
     FTK_ENUM_IMPL(
@@ -18,6 +23,29 @@ namespace ftk
         "MSB",
         "LSB");
 
+    void* alignedAlloc(size_t size, size_t alignment)
+    {
+        void* out = nullptr;
+#if defined(_WINDOWS)
+        out = _aligned_malloc(size, alignment);
+#else // _WINDOWS
+        if (posix_memalign(&out, alignment, size) != 0)
+        {
+            out = nullptr;
+        }
+#endif // _WINDOWS
+        return out;
+    }
+
+    void alignedFree(void* p)
+    {
+#if defined(_WINDOWS)
+        _aligned_free(p);
+#else // _WINDOWS
+        free(p);
+#endif // _WINDOWS
+    }
+
     void endian(
         void* in,
         size_t size,
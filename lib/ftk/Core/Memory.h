@@ -22,6 +22,14 @@ namespace ftk
 
     //! Get the aligned byte count.
     size_t getAlignedByteCount(size_t, size_t alignment);
+
+    //! Allocate aligned memory. The alignment must be a power of two and
+    //! a multiple of the pointer size. The memory is not initialized and
+    //! must be released with alignedFree().
+    void* alignedAlloc(size_t, size_t alignment);
+
+    //! Release memory allocated with alignedAlloc().
+    void alignedFree(void*);
         
     //! Endian type.
     enum class Endian
@@ -21,6 +21,19 @@ namespace ftk
     //! Invalid index.
     static const size_t ObservableListInvalidIndex = static_cast<size_t>(-1);
 
+    //! Observable list change. The items in the range [index, index +
+    //! removed) were replaced with the items in the range [index, index +
+    //! added).
+    struct ObservableListChange
+    {
+        size_t index   = 0;
+        size_t removed = 0;
+        size_t added   = 0;
+
+        bool operator == (const ObservableListChange&) const;
+        bool operator != (const ObservableListChange&) const;
+    };
+
     //! List observer.
     template<typename T>
     class ListObserver : public std::enable_shared_from_this<ListObserver<T> >
@@ -77,6 +90,10 @@ namespace ftk
         //! Get the index of the given item.
         virtual size_t indexOf(const T&) const = 0;
 
+        //! Get the last change. Observers can use the change to update
+        //! incrementally instead of processing the whole list.
+        virtual const ObservableListChange& getChange() const = 0;
+
         //! Get the number of observers.
         size_t getObserversCount() const;
 
@@ -148,9 +165,13 @@ namespace ftk
         T getItem(size_t) const override;
         bool contains(const T&) const override;
         size_t indexOf(const T&) const override;
+        const ObservableListChange& getChange() const override;
 
     private:
+        void _notify(size_t index, size_t removed, size_t added);
+
         std::vector<T> _value;
+        ObservableListChange _change;
     };
         
     ///@}
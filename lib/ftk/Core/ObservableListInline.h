@@ -102,14 +102,9 @@ namespace ftk
     template<typename T>
     inline void ObservableList<T>::setAlways(const std::vector<T>& value)
     {
+        const size_t size = _value.size();
         _value = value;
-        for (const auto& i : IObservableList<T>::_observers)
-        {
-            if (auto observer = i.lock())
-            {
-                observer->doCallback(_value);
-            }
-        }
+        _notify(0, size, _value.size());
     }
 
     template<typename T>
@@ -117,14 +112,9 @@ namespace ftk
     {
         if (value == _value)
             return false;
+        const size_t size = _value.size();
         _value = value;
-        for (const auto& i : IObservableList<T>::_observers)
-        {
-            if (auto observer = i.lock())
-            {
-                observer->doCallback(_value);
-            }
-        }
+        _notify(0, size, _value.size());
         return true;
     }
 
@@ -133,14 +123,9 @@ namespace ftk
     {
         if (_value.size())
         {
+            const size_t size = _value.size();
             _value.clear();
-            for (const auto& i : IObservableList<T>::_observers)
-            {
-                if (auto observer = i.lock())
-                {
-                    observer->doCallback(_value);
-                }
-            }
+            _notify(0, size, 0);
         }
     }
 
@@ -148,13 +133,7 @@ namespace ftk
     inline void ObservableList<T>::setItem(size_t index, const T& value)
     {
         _value[index] = value;
-        for (const auto& i : IObservableList<T>::_observers)
-        {
-            if (auto observer = i.lock())
-            {
-                observer->doCallback(_value);
-            }
-        }
+        _notify(index, 1, 1);
     }
 
     template<typename T>
@@ -163,91 +142,49 @@ namespace ftk
         if (value == _value[index])
             return;
         _value[index] = value;
-        for (const auto& i : IObservableList<T>::_observers)
-        {
-            if (auto observer = i.lock())
-            {
-                observer->doCallback(_value);
-            }
-        }
+        _notify(index, 1, 1);
     }
 
     template<typename T>
     inline void ObservableList<T>::pushBack(const T& value)
     {
         _value.push_back(value);
-        for (const auto& i : IObservableList<T>::_observers)
-        {
-            if (auto observer = i.lock())
-            {
-                observer->doCallback(_value);
-            }
-        }
+        _notify(_value.size() - 1, 0, 1);
     }
 
     template<typename T>
     inline void ObservableList<T>::pushBack(const std::vector<T>& value)
     {
         _value.insert(_value.end(), value.begin(), value.end());
-        for (const auto& i : IObservableList<T>::_observers)
-        {
-            if (auto observer = i.lock())
-            {
-                observer->doCallback(_value);
-            }
-        }
+        _notify(_value.size() - value.size(), 0, value.size());
     }
 
     template<typename T>
     inline void ObservableList<T>::insertItem(size_t index, const T& value)
     {
         _value.insert(_value.begin() + index, value);
-        for (const auto& i : IObservableList<T>::_observers)
-        {
-            if (auto observer = i.lock())
-            {
-                observer->doCallback(_value);
-            }
-        }
+        _notify(index, 0, 1);
     }
 
     template<typename T>
     inline void ObservableList<T>::insertItems(size_t index, const std::vector<T>& value)
     {
         _value.insert(_value.begin() + index, value.begin(), value.end());
-        for (const auto& i : IObservableList<T>::_observers)
-        {
-            if (auto observer = i.lock())
-            {
-                observer->doCallback(_value);
-            }
-        }
+        _notify(index, 0, value.size());
     }
 
     template<typename T>
     inline void ObservableList<T>::removeItem(size_t index)
     {
         _value.erase(_value.begin() + index);
-        for (const auto& i : IObservableList<T>::_observers)
-        {
-            if (auto observer = i.lock())
-            {
-                observer->doCallback(_value);
-            }
-        }
+        _notify(index, 1, 0);
     }
 
     template<typename T>
     inline void ObservableList<T>::removeItems(size_t start, size_t end)
     {
         _value.erase(_value.begin() + start, _value.begin() + end);
-        for (const auto& i : IObservableList<T>::_observers)
-        {
-            if (auto observer = i.lock())
-            {
-                observer->doCallback(_value);
-            }
-        }
+        _notify(start, end - start, 0);
     }
 
     template<typename T>
@@ -258,13 +195,7 @@ namespace ftk
     {
         _value.erase(_value.begin() + start, _value.begin() + end);
         _value.insert(_value.begin() + start, items.begin(), items.end());
-        for (const auto& i : IObservableList<T>::_observers)
-        {
-            if (auto observer = i.lock())
-            {
-                observer->doCallback(_value);
-            }
-        }
+        _notify(start, end - start, items.size());
     }
 
     template<typename T>
@@ -316,4 +247,38 @@ namespace ftk
             });
         return i != _value.end() ? i - _value.begin() : ObservableListInvalidIndex;
     }
+
+    template<typename T>
+    inline const ObservableListChange& ObservableList<T>::getChange() const
+    {
+        return _change;
+    }
+
+    template<typename T>
+    inline void ObservableList<T>::_notify(size_t index, size_t removed, size_t added)
+    {
+        _change.index = index;
+        _change.removed = removed;
+        _change.added = added;
+        for (const auto& i : IObservableList<T>::_observers)
+        {
+            if (auto observer = i.lock())
+            {
+                observer->doCallback(_value);
+            }
+        }
+    }
+
+    inline bool ObservableListChange::operator == (const ObservableListChange& other) const
+    {
+        return
+            index == other.index &&
+            removed == other.removed &&
+            added == other.added;
+    }
+
+    inline bool ObservableListChange::operator != (const ObservableListChange& other) const
+    {
+        return !(*this == other);
+    }
 }
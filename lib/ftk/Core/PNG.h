@@ -12,7 +12,24 @@ namespace ftk
         //! \name PNG
         ///@{
 
+        //! PNG row filters.
+        enum class Filter
+        {
+            None,
+            Sub,
+            Up,
+            Average,
+            Paeth,
+            Adaptive, //!< Choose the filter for each row
+
+            Count,
+            First = None
+        };
+        FTK_ENUM(Filter);
+
         //! PNG image reader.
+        //!
+        //! The rows are decoded directly into the image memory.
         class ImageReader : public IImageReader
         {
         public:
@@ -25,12 +42,24 @@ namespace ftk
 
             const ImageInfo& getInfo() const override;
             std::shared_ptr<Image> read() override;
+            void readInto(const std::shared_ptr<Image>&) override;
 
         private:
             FTK_PRIVATE();
         };
 
         //! PNG image writer.
+        //!
+        //! The image is split into stripes of rows that are filtered and
+        //! compressed in parallel, and then joined into a single zlib
+        //! stream.
+        //!
+        //! Options:
+        //! * "PNG/Compression": zlib compression level from 0 to 9
+        //!   (default 6)
+        //! * "PNG/Filter": row filter (default Adaptive)
+        //! * "PNG/Threads": maximum number of threads, or 0 to use the
+        //!   number of cores (default 0)
         class ImageWriter : public IImageWriter
         {
         public:
@@ -128,23 +128,14 @@ namespace ftk
                 return true;
             }
 
-            bool scanline(png_structp png, uint8_t* out)
+            bool read(png_structp png, png_bytepp rows, png_infop pngInfoEnd)
             {
                 if (setjmp(png_jmpbuf(png)))
                 {
                     return false;
                 }
-                png_read_row(png, out, 0);
-                return true;
-            }
-
-            bool end(png_structp png, png_infop pngInfo)
-            {
-                if (setjmp(png_jmpbuf(png)))
-                {
-                    return false;
-                }
-                png_read_end(png, pngInfo);
+                png_read_image(png, rows);
+                png_read_end(png, pngInfoEnd);
                 return true;
             }
         }
@@ -286,16 +277,35 @@ namespace ftk
         {
             FTK_P();
             auto out = Image::create(p.info);
-            uint8_t* data = out->getData();
-            for (uint16_t y = 0; y < p.info.size.h; ++y, data += p.scanlineSize)
+            readInto(out);
+            return out;
+        }
+
+        void ImageReader::readInto(const std::shared_ptr<Image>& image)
+        {
+            FTK_P();
+            const ImageInfo& info = image->getInfo();
+            if (info.size != p.info.size || info.type != p.info.type)
             {
-                if (!scanline(p.png, data))
-                {
-                    break;
-                }
+                throw std::runtime_error(Format("Cannot read: \"{0}\"").arg(_path.u8string()));
+            }
+
+            // Decode the rows directly into the image, with the order and
+            // alignment of the image layout.
+            const size_t scanlineByteCount = getAlignedByteCount(
+                p.scanlineSize,
+                info.layout.alignment);
+            std::vector<png_bytep> rows(info.size.h);
+            uint8_t* data = image->getData();
+            for (int y = 0; y < info.size.h; ++y)
+            {
+                rows[info.layout.mirror.y ? y : (info.size.h - 1 - y)] =
+                    data + y * scanlineByteCount;
+            }
+            if (!ftk::png::read(p.png, rows.data(), p.pngInfoEnd))
+            {
+                throw std::runtime_error(Format("Cannot read: \"{0}\"").arg(_path.u8string()));
             }
-            end(p.png, p.pngInfoEnd);
-            return out;
         }
     }
 }
\ No newline at end of file
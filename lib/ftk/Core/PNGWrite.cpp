@@ -5,98 +5,243 @@
 
 #include <ftk/Core/Error.h>
 #include <ftk/Core/Format.h>
+#include <ftk/Core/Math.h>
 #include <ftk/Core/Memory.h>
 #include <ftk/Core/String.h>
 
+#include <zlib.h>
+
+#include <array>
+#include <cstring>
+#include <future>
+#include <thread>
+
 namespace ftk
 {
     namespace png
     {
+        FTK_ENUM_IMPL(
+            Filter,
+            "None",
+            "Sub",
+            "Up",
+            "Average",
+            "Paeth",
+            "Adaptive");
+
         namespace
         {
-            bool open(
-                FILE* f,
-                png_structp png,
-                png_infop* pngInfo,
-                const ImageInfo& info)
+            //! The minimum number of bytes in a stripe. Smaller images are
+            //! not split.
+            const size_t stripeByteCountMin = 256 * 1024;
+
+            //! The maximum size of an IDAT chunk.
+            const size_t chunkByteCountMax = 1024 * 1024;
+
+            //! The size of the zlib window, used to prime the compression of
+            //! each stripe with the end of the previous stripe.
+            const size_t windowByteCount = 32768;
+
+            const std::array<uint8_t, 8> signature =
+            {
+                0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'
+            };
+
+            void writeU32(uint8_t* out, uint32_t value)
             {
-                if (setjmp(png_jmpbuf(png)))
+                out[0] = (value >> 24) & 0xff;
+                out[1] = (value >> 16) & 0xff;
+                out[2] = (value >> 8) & 0xff;
+                out[3] = value & 0xff;
+            }
+
+            bool writeChunk(FILE* f, const char* type, const uint8_t* data, size_t size)
+            {
+                uint8_t header[8];
+                writeU32(header, static_cast<uint32_t>(size));
+                memcpy(header + 4, type, 4);
+                uLong crc = crc32(0, header + 4, 4);
+                if (size > 0)
                 {
-                    return false;
+                    crc = crc32(crc, data, static_cast<uInt>(size));
                 }
-                *pngInfo = png_create_info_struct(png);
-                if (!*pngInfo)
+                uint8_t footer[4];
+                writeU32(footer, static_cast<uint32_t>(crc));
+                return
+                    fwrite(header, 8, 1, f) == 1 &&
+                    (0 == size || fwrite(data, size, 1, f) == 1) &&
+                    fwrite(footer, 4, 1, f) == 1;
+            }
+
+            uint8_t getColorType(ImageType type)
+            {
+                uint8_t out = 0;
+                switch (type)
                 {
-                    return false;
+                case ImageType::L_U8:
+                case ImageType::L_U16: out = 0; break;
+                case ImageType::RGB_U8:
+                case ImageType::RGB_U16: out = 2; break;
+                case ImageType::LA_U8:
+                case ImageType::LA_U16: out = 4; break;
+                case ImageType::RGBA_U8:
+                case ImageType::RGBA_U16: out = 6; break;
+                default: break;
                 }
-                png_init_io(png, f);
+                return out;
+            }
+
+            uint8_t paeth(uint8_t a, uint8_t b, uint8_t c)
+            {
+                const int p = a + b - c;
+                const int pa = std::abs(p - a);
+                const int pb = std::abs(p - b);
+                const int pc = std::abs(p - c);
+                return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+            }
 
-                int colorType = 0;
-                switch (info.type)
+            //! Filter a row. The previous row is null for the first row.
+            void filterRow(
+                Filter filter,
+                const uint8_t* row,
+                const uint8_t* prev,
+                size_t size,
+                size_t bpp,
+                uint8_t* out)
+            {
+                out[0] = static_cast<uint8_t>(filter);
+                ++out;
+                switch (filter)
                 {
-                case ImageType::L_U8:
-                case ImageType::L_U16:
-                    colorType = PNG_COLOR_TYPE_GRAY;
+                case Filter::None:
+                    memcpy(out, row, size);
                     break;
-                case ImageType::LA_U8:
-                case ImageType::LA_U16:
-                    colorType = PNG_COLOR_TYPE_GRAY_ALPHA;
+                case Filter::Sub:
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        out[i] = row[i] - (i >= bpp ? row[i - bpp] : 0);
+                    }
                     break;
-                case ImageType::RGB_U8:
-                case ImageType::RGB_U16:
-                    colorType = PNG_COLOR_TYPE_RGB;
+                case Filter::Up:
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        out[i] = row[i] - (prev ? prev[i] : 0);
+                    }
                     break;
-                case ImageType::RGBA_U8:
-                case ImageType::RGBA_U16:
-                    colorType = PNG_COLOR_TYPE_RGB_ALPHA;
+                case Filter::Average:
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        const int a = i >= bpp ? row[i - bpp] : 0;
+                        const int b = prev ? prev[i] : 0;
+                        out[i] = row[i] - static_cast<uint8_t>((a + b) / 2);
+                    }
+                    break;
+                case Filter::Paeth:
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        const uint8_t a = i >= bpp ? row[i - bpp] : 0;
+                        const uint8_t b = prev ? prev[i] : 0;
+                        const uint8_t c = (prev && i >= bpp) ? prev[i - bpp] : 0;
+                        out[i] = row[i] - paeth(a, b, c);
+                    }
                     break;
-                default: return false;
+                default: break;
                 }
+            }
 
-                const int bitDepth = getBitDepth(info.type);
-                png_set_IHDR(
-                    png,
-                    *pngInfo,
-                    info.size.w,
-                    info.size.h,
-                    bitDepth,
-                    colorType,
-                    PNG_INTERLACE_NONE,
-                    PNG_COMPRESSION_TYPE_DEFAULT,
-                    PNG_FILTER_TYPE_DEFAULT);
-                png_write_info(png, *pngInfo);
-
-                if (bitDepth > 8 && Endian::LSB == getEndian())
+            //! Choose the filter with the smallest sum of absolute values,
+            //! the same heuristic as libpng.
+            void filterRowAdaptive(
+                const uint8_t* row,
+                const uint8_t* prev,
+                size_t size,
+                size_t bpp,
+                std::vector<uint8_t>& tmp,
+                uint8_t* out)
+            {
+                tmp.resize(size + 1);
+                uint64_t sumMin = std::numeric_limits<uint64_t>::max();
+                for (size_t i = 0; i < static_cast<size_t>(Filter::Adaptive); ++i)
                 {
-                    png_set_swap(png);
+                    const Filter filter = static_cast<Filter>(i);
+                    filterRow(filter, row, prev, size, bpp, tmp.data());
+                    uint64_t sum = 0;
+                    for (size_t j = 1; j <= size && sum < sumMin; ++j)
+                    {
+                        sum += std::abs(static_cast<int8_t>(tmp[j]));
+                    }
+                    if (sum < sumMin)
+                    {
+                        sumMin = sum;
+                        memcpy(out, tmp.data(), size + 1);
+                    }
                 }
-
-                return true;
             }
 
-            bool scanline(png_structp png, const uint8_t* in)
+            struct Stripe
             {
-                if (setjmp(png_jmpbuf(png)))
-                    return false;
-                png_write_row(png, reinterpret_cast<const png_byte*>(in));
-                return true;
-            }
+                int y0 = 0;
+                int y1 = 0;
+                std::vector<uint8_t> filtered;
+                std::vector<uint8_t> compressed;
+                uLong adler = 0;
+                bool valid = true;
+            };
 
-            bool end(png_structp png, png_infop pngInfo)
+            void compress(
+                Stripe& stripe,
+                const Stripe* prev,
+                int level,
+                int strategy,
+                bool last)
             {
-                if (setjmp(png_jmpbuf(png)))
-                    return false;
-                png_write_end(png, pngInfo);
-                return true;
+                z_stream z;
+                memset(&z, 0, sizeof(z_stream));
+                if (deflateInit2(&z, level, Z_DEFLATED, -15, 8, strategy) != Z_OK)
+                {
+                    stripe.valid = false;
+                    return;
+                }
+                if (prev && !prev->filtered.empty())
+                {
+                    const size_t size = std::min(prev->filtered.size(), windowByteCount);
+                    deflateSetDictionary(
+                        &z,
+                        prev->filtered.data() + prev->filtered.size() - size,
+                        static_cast<uInt>(size));
+                }
+                stripe.compressed.resize(deflateBound(&z, stripe.filtered.size()) + 16);
+                z.next_in = stripe.filtered.data();
+                z.avail_in = static_cast<uInt>(stripe.filtered.size());
+                size_t size = 0;
+                int r = Z_OK;
+                do
+                {
+                    if (size == stripe.compressed.size())
+                    {
+                        stripe.compressed.resize(stripe.compressed.size() * 2);
+                    }
+                    z.next_out = stripe.compressed.data() + size;
+                    z.avail_out = static_cast<uInt>(stripe.compressed.size() - size);
+                    r = deflate(&z, last ? Z_FINISH : Z_SYNC_FLUSH);
+                    size = stripe.compressed.size() - z.avail_out;
+                } while (0 == z.avail_out && (Z_OK == r || Z_BUF_ERROR == r));
+                deflateEnd(&z);
+                stripe.valid = last ? Z_STREAM_END == r : Z_OK == r || Z_BUF_ERROR == r;
+                stripe.compressed.resize(size);
+                stripe.adler = adler32(
+                    adler32(0, nullptr, 0),
+                    stripe.filtered.data(),
+                    static_cast<uInt>(stripe.filtered.size()));
             }
         }
 
         struct ImageWriter::Private
         {
-            png_structp png = nullptr;
-            png_infop   pngInfo = nullptr;
             FILE* f = nullptr;
-            ErrorStruct error;
+            int compression = 6;
+            Filter filter = Filter::Adaptive;
+            size_t threads = 0;
         };
 
         ImageWriter::ImageWriter(
@@ -107,14 +252,21 @@ namespace ftk
             _p(new Private)
         {
             FTK_P();
-            p.png = png_create_write_struct(
-                PNG_LIBPNG_VER_STRING,
-                &p.error,
-                pngErrorFunc,
-                pngWarningFunc);
-            if (!p.png)
+
+            auto i = options.find("PNG/Compression");
+            if (i != options.end())
             {
-                throw std::runtime_error(Format("Cannot open: \"{0}\"").arg(path.u8string()));
+                p.compression = clamp(std::atoi(i->second.c_str()), 0, 9);
+            }
+            i = options.find("PNG/Filter");
+            if (i != options.end())
+            {
+                from_string(i->second, p.filter);
+            }
+            i = options.find("PNG/Threads");
+            if (i != options.end())
+            {
+                p.threads = std::max(std::atoi(i->second.c_str()), 0);
             }
 
 #if defined(_WINDOWS)
@@ -135,34 +287,153 @@ namespace ftk
         {
             FTK_P();
             const ImageInfo& info = image->getInfo();
-            if (!open(p.f, p.png, &p.pngInfo, info))
+            const int bitDepth = getBitDepth(info.type);
+            const size_t channelCount = getChannelCount(info.type);
+            if (!info.isValid() || (bitDepth != 8 && bitDepth != 16))
             {
                 throw std::runtime_error(Format("Cannot open: \"{0}\"").arg(_path.u8string()));
             }
 
-            size_t scanlineByteCount = 0;
-            switch (info.type)
+            // Write the header.
+            uint8_t ihdr[13];
+            writeU32(ihdr, info.size.w);
+            writeU32(ihdr + 4, info.size.h);
+            ihdr[8] = bitDepth;
+            ihdr[9] = getColorType(info.type);
+            ihdr[10] = 0;
+            ihdr[11] = 0;
+            ihdr[12] = 0;
+            if (fwrite(signature.data(), signature.size(), 1, p.f) != 1 ||
+                !writeChunk(p.f, "IHDR", ihdr, 13))
+            {
+                throw std::runtime_error(Format("Cannot write: \"{0}\"").arg(_path.u8string()));
+            }
+
+            // Split the rows into stripes.
+            const size_t bpp = channelCount * bitDepth / 8;
+            const size_t rowByteCount = info.size.w * bpp;
+            const size_t scanlineByteCount = getAlignedByteCount(rowByteCount, info.layout.alignment);
+            const size_t threadCount = p.threads > 0 ?
+                p.threads :
+                std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(1));
+            const size_t stripeCount = std::max(std::min(
+                threadCount,
+                rowByteCount * info.size.h / stripeByteCountMin), size_t(1));
+            std::vector<Stripe> stripes(stripeCount);
+            for (size_t i = 0; i < stripeCount; ++i)
             {
-            case ImageType::L_U8: scanlineByteCount = info.size.w; break;
-            case ImageType::L_U16: scanlineByteCount = static_cast<size_t>(info.size.w) * 2; break;
-            case ImageType::LA_U8: scanlineByteCount = static_cast<size_t>(info.size.w) * 2; break;
-            case ImageType::LA_U16: scanlineByteCount = static_cast<size_t>(info.size.w) * 2 * 2; break;
-            case ImageType::RGB_U8: scanlineByteCount = static_cast<size_t>(info.size.w) * 3; break;
-            case ImageType::RGB_U16: scanlineByteCount = static_cast<size_t>(info.size.w) * 3 * 2; break;
-            case ImageType::RGBA_U8: scanlineByteCount = static_cast<size_t>(info.size.w) * 4; break;
-            case ImageType::RGBA_U16: scanlineByteCount = static_cast<size_t>(info.size.w) * 4 * 2; break;
-            default: break;
+                stripes[i].y0 = info.size.h * i / stripeCount;
+                stripes[i].y1 = info.size.h * (i + 1) / stripeCount;
             }
-            scanlineByteCount = getAlignedByteCount(scanlineByteCount, info.layout.alignment);
-            const uint8_t* data = image->getData() + (info.size.h - 1) * scanlineByteCount;
-            for (uint16_t y = 0; y < info.size.h; ++y, data -= scanlineByteCount)
+
+            // Get a row in PNG order. Sixteen bit data is stored as big
+            // endian.
+            const uint8_t* data = image->getData();
+            const bool swap = 16 == bitDepth && Endian::LSB == getEndian();
+            auto getRow = [&info, data, scanlineByteCount, rowByteCount, swap](
+                int y,
+                std::vector<uint8_t>& tmp)
+                {
+                    const uint8_t* out = data +
+                        (info.layout.mirror.y ? y : (info.size.h - 1 - y)) * scanlineByteCount;
+                    if (swap)
+                    {
+                        tmp.resize(rowByteCount);
+                        endian(out, tmp.data(), rowByteCount / 2, 2);
+                        out = tmp.data();
+                    }
+                    return out;
+                };
+
+            // Filter the stripes.
+            auto run = [&stripes](const std::function<void(size_t)>& func)
+                {
+                    std::vector<std::future<void> > futures;
+                    for (size_t i = 1; i < stripes.size(); ++i)
+                    {
+                        futures.push_back(std::async(std::launch::async, func, i));
+                    }
+                    func(0);
+                    for (auto& future : futures)
+                    {
+                        future.get();
+                    }
+                };
+            const Filter filter = p.filter;
+            run(
+                [&stripes, &getRow, filter, rowByteCount, bpp](size_t index)
+                {
+                    Stripe& stripe = stripes[index];
+                    stripe.filtered.resize((stripe.y1 - stripe.y0) * (rowByteCount + 1));
+                    uint8_t* out = stripe.filtered.data();
+                    std::vector<uint8_t> rowTmp;
+                    std::vector<uint8_t> prevTmp;
+                    std::vector<uint8_t> filterTmp;
+                    const uint8_t* prev = stripe.y0 > 0 ? getRow(stripe.y0 - 1, prevTmp) : nullptr;
+                    for (int y = stripe.y0; y < stripe.y1; ++y, out += rowByteCount + 1)
+                    {
+                        const uint8_t* row = getRow(y, rowTmp);
+                        if (Filter::Adaptive == filter)
+                        {
+                            filterRowAdaptive(row, prev, rowByteCount, bpp, filterTmp, out);
+                        }
+                        else
+                        {
+                            filterRow(filter, row, prev, rowByteCount, bpp, out);
+                        }
+                        std::swap(rowTmp, prevTmp);
+                        prev = row;
+                    }
+                });
+
+            // Compress the stripes. Each stripe is compressed as a part of
+            // a single deflate stream.
+            const int level = p.compression;
+            const int strategy = Filter::None == filter ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+            run(
+                [&stripes, level, strategy](size_t index)
+                {
+                    compress(
+                        stripes[index],
+                        index > 0 ? &stripes[index - 1] : nullptr,
+                        level,
+                        strategy,
+                        index == stripes.size() - 1);
+                });
+
+            // Join the stripes into a zlib stream.
+            std::vector<uint8_t> zlib;
+            const uint8_t cmf = 0x78;
+            uint8_t flg = (level < 2 ? 0 : (level < 6 ? 1 : (6 == level ? 2 : 3))) << 6;
+            flg += 31 - ((cmf * 256 + flg) % 31);
+            zlib.push_back(cmf);
+            zlib.push_back(flg);
+            uLong adler = adler32(0, nullptr, 0);
+            for (const auto& stripe : stripes)
             {
-                if (!scanline(p.png, data))
+                if (!stripe.valid)
                 {
-                    throw std::runtime_error(Format("Cannot write scanline: \"{0}\": {1}").arg(_path.u8string()).arg(y));
+                    throw std::runtime_error(Format("Cannot write: \"{0}\"").arg(_path.u8string()));
                 }
+                zlib.insert(zlib.end(), stripe.compressed.begin(), stripe.compressed.end());
+                adler = adler32_combine(adler, stripe.adler, static_cast<z_off_t>(stripe.filtered.size()));
             }
-            if (!end(p.png, p.pngInfo))
+            zlib.resize(zlib.size() + 4);
+            writeU32(zlib.data() + zlib.size() - 4, static_cast<uint32_t>(adler));
+
+            // Write the data.
+            for (size_t i = 0; i < zlib.size(); i += chunkByteCountMax)
+            {
+                if (!writeChunk(
+                    p.f,
+                    "IDAT",
+                    zlib.data() + i,
+                    std::min(chunkByteCountMax, zlib.size() - i)))
+                {
+                    throw std::runtime_error(Format("Cannot write: \"{0}\"").arg(_path.u8string()));
+                }
+            }
+            if (!writeChunk(p.f, "IEND", nullptr, 0))
             {
                 throw std::runtime_error(Format("Cannot close: \"{0}\"").arg(_path.u8string()));
             }
@@ -175,12 +446,6 @@ namespace ftk
             {
                 fclose(p.f);
             }
-            if (p.png || p.pngInfo)
-            {
-                png_destroy_write_struct(
-                    p.png ? &p.png : nullptr,
-                    p.pngInfo ? &p.pngInfo : nullptr);
-            }
         }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,395 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/RasterCache.h>
+
+#include <ftk/Core/FileIO.h>
+#include <ftk/Core/Format.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace ftk
+{
+    namespace
+    {
+        const uint32_t fileMagic = 0x524b5446; // "FTKR"
+        const uint32_t fileEndian = 0x01020304;
+
+        class Reader
+        {
+        public:
+            Reader(const uint8_t* start, const uint8_t* end) :
+                _p(start),
+                _end(end)
+            {}
+
+            bool isValid() const { return _valid; }
+
+            const uint8_t* read(size_t size)
+            {
+                const uint8_t* out = nullptr;
+                if (_valid && static_cast<size_t>(_end - _p) >= size)
+                {
+                    out = _p;
+                    _p += size;
+                }
+                else
+                {
+                    _valid = false;
+                }
+                return out;
+            }
+
+            uint32_t readU32()
+            {
+                uint32_t out = 0;
+                if (const uint8_t* p = read(sizeof(uint32_t)))
+                {
+                    memcpy(&out, p, sizeof(uint32_t));
+                }
+                return out;
+            }
+
+        private:
+            const uint8_t* _p = nullptr;
+            const uint8_t* _end = nullptr;
+            bool _valid = true;
+        };
+    }
+
+    uint64_t getRasterCacheHash(const void* data, size_t size)
+    {
+        // FNV-1a
+        uint64_t out = 14695981039346656037ULL;
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            out ^= p[i];
+            out *= 1099511628211ULL;
+        }
+        return out;
+    }
+
+    struct RasterCache::Private
+    {
+        std::filesystem::path path;
+
+        struct Item
+        {
+            ImageInfo info;
+            bool hasImage = false;
+            const uint8_t* mapped = nullptr;
+            std::shared_ptr<Image> image;
+            std::vector<int32_t> data;
+
+            //! When the item was last used. The items are written to the
+            //! file in the order they were used.
+            size_t use = 0;
+        };
+
+        struct Mutex
+        {
+            std::shared_ptr<FileIO> io;
+            std::unordered_map<std::string, Item> items;
+            size_t use = 0;
+            size_t max = rasterCacheMax;
+            bool changed = false;
+            std::mutex mutex;
+        };
+        Mutex mutex;
+    };
+
+    void RasterCache::_init(const std::filesystem::path& path)
+    {
+        FTK_P();
+        p.path = path;
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        _read();
+    }
+
+    RasterCache::RasterCache() :
+        _p(new Private)
+    {}
+
+    RasterCache::~RasterCache()
+    {}
+
+    std::shared_ptr<RasterCache> RasterCache::create(const std::filesystem::path& path)
+    {
+        auto out = std::shared_ptr<RasterCache>(new RasterCache);
+        out->_init(path);
+        return out;
+    }
+
+    const std::filesystem::path& RasterCache::getPath() const
+    {
+        return _p->path;
+    }
+
+    size_t RasterCache::getCount() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.items.size();
+    }
+
+    size_t RasterCache::getMax() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.max;
+    }
+
+    void RasterCache::setMax(size_t value)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        p.mutex.max = value;
+    }
+
+    bool RasterCache::get(
+        const std::string& key,
+        std::shared_ptr<Image>& image,
+        std::vector<int32_t>* data) const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        const auto i = p.mutex.items.find(key);
+        if (i == p.mutex.items.end())
+        {
+            return false;
+        }
+        Private::Item& item = i->second;
+        item.use = ++p.mutex.use;
+        if (item.image)
+        {
+            image = item.image;
+        }
+        else if (item.hasImage)
+        {
+            // Copy the image from the memory map, so that it does not
+            // depend on the lifetime of the cache. Empty images are not
+            // mapped.
+            image = Image::create(item.info);
+            if (item.mapped)
+            {
+                memcpy(image->getData(), item.mapped, image->getByteCount());
+            }
+        }
+        else
+        {
+            image.reset();
+        }
+        if (data)
+        {
+            *data = item.data;
+        }
+        return true;
+    }
+
+    void RasterCache::add(
+        const std::string& key,
+        const std::shared_ptr<Image>& image,
+        const std::vector<int32_t>& data)
+    {
+        FTK_P();
+        Private::Item item;
+        if (image)
+        {
+            // Only images with the default layout are stored.
+            if (image->getInfo().layout != ImageLayout())
+                return;
+            item.info = ImageInfo(image->getSize(), image->getType());
+            item.hasImage = true;
+            item.image = image;
+        }
+        item.data = data;
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        item.use = ++p.mutex.use;
+        p.mutex.items[key] = std::move(item);
+        p.mutex.changed = true;
+    }
+
+    void RasterCache::save()
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        if (!p.mutex.changed)
+            return;
+
+        // Find the most recently used items that fit in the maximum size.
+        std::vector<std::pair<const std::string*, const Private::Item*> > items;
+        items.reserve(p.mutex.items.size());
+        for (const auto& i : p.mutex.items)
+        {
+            items.push_back(std::make_pair(&i.first, &i.second));
+        }
+        std::sort(
+            items.begin(),
+            items.end(),
+            [](const std::pair<const std::string*, const Private::Item*>& a,
+                const std::pair<const std::string*, const Private::Item*>& b)
+            {
+                return a.second->use > b.second->use;
+            });
+        size_t byteCount = 4 * sizeof(uint32_t);
+        size_t count = 0;
+        for (; count < items.size(); ++count)
+        {
+            const std::string& key = *items[count].first;
+            const Private::Item& item = *items[count].second;
+            const size_t itemByteCount =
+                8 * sizeof(uint32_t) +
+                key.size() +
+                item.data.size() * sizeof(int32_t) +
+                (item.hasImage ? item.info.getByteCount() : 0);
+            if (byteCount + itemByteCount > p.mutex.max)
+                break;
+            byteCount += itemByteCount;
+        }
+        items.resize(count);
+
+        // Write a temporary file and then replace the cache file, since the
+        // cache file is memory mapped. The items are written from the least
+        // recently used.
+        std::filesystem::path tmp = p.path;
+        tmp += ".tmp";
+        try
+        {
+            std::error_code ec;
+            const auto parent = p.path.parent_path();
+            if (!parent.empty())
+            {
+                std::filesystem::create_directories(parent, ec);
+            }
+            auto io = FileIO::create(tmp, FileMode::Write);
+            io->writeU32(fileMagic);
+            io->writeU32(rasterCacheVersion);
+            io->writeU32(fileEndian);
+            io->writeU32(static_cast<uint32_t>(items.size()));
+            for (auto i = items.rbegin(); i != items.rend(); ++i)
+            {
+                const std::string& key = *i->first;
+                const Private::Item& item = *i->second;
+                io->writeU32(static_cast<uint32_t>(key.size()));
+                io->write(key.data(), key.size());
+                io->writeU32(item.info.size.w);
+                io->writeU32(item.info.size.h);
+                io->writeU32(static_cast<uint32_t>(item.info.type));
+                io->writeU32(static_cast<uint32_t>(item.data.size()));
+                io->write(item.data.data(), item.data.size() * sizeof(int32_t));
+                const uint8_t* pixels = item.image ? item.image->getData() : item.mapped;
+                const size_t itemByteCount = item.hasImage ? item.info.getByteCount() : 0;
+                io->writeU32(item.hasImage ? 1 : 0);
+                io->writeU32(static_cast<uint32_t>(itemByteCount));
+                io->write(pixels, itemByteCount);
+            }
+        }
+        catch (const std::exception&)
+        {
+            std::error_code ec;
+            std::filesystem::remove(tmp, ec);
+            throw;
+        }
+
+        // Keep the items that are not in the memory map, in case the cache
+        // file cannot be replaced.
+        std::unordered_map<std::string, Private::Item> unmapped;
+        for (const auto& i : p.mutex.items)
+        {
+            if (!i.second.mapped)
+            {
+                unmapped[i.first] = i.second;
+            }
+        }
+        p.mutex.io.reset();
+        p.mutex.items.clear();
+        std::error_code ec;
+        std::filesystem::rename(tmp, p.path, ec);
+        if (ec)
+        {
+            std::error_code ec2;
+            std::filesystem::remove(tmp, ec2);
+            _read();
+            for (auto& i : unmapped)
+            {
+                p.mutex.items[i.first] = std::move(i.second);
+            }
+            p.mutex.changed = true;
+            throw std::runtime_error(Format("Cannot replace the raster cache: \"{0}\": {1}").
+                arg(p.path.u8string()).
+                arg(ec.message()));
+        }
+        _read();
+    }
+
+    void RasterCache::_read()
+    {
+        FTK_P();
+        p.mutex.io.reset();
+        p.mutex.items.clear();
+        p.mutex.use = 0;
+        p.mutex.changed = false;
+        std::error_code ec;
+        if (!std::filesystem::exists(p.path, ec))
+            return;
+        try
+        {
+            auto io = FileIO::create(p.path, FileMode::Read, FileRead::MemoryMapped);
+            const uint8_t* start = io->getMemoryStart();
+            const uint8_t* end = io->getMemoryEnd();
+            if (!start || !end)
+                return;
+            Reader reader(start, end);
+            if (reader.readU32() != fileMagic ||
+                reader.readU32() != rasterCacheVersion ||
+                reader.readU32() != fileEndian)
+                return;
+            const uint32_t count = reader.readU32();
+            std::unordered_map<std::string, Private::Item> items;
+            for (uint32_t i = 0; i < count && reader.isValid(); ++i)
+            {
+                const uint32_t keySize = reader.readU32();
+                const uint8_t* key = reader.read(keySize);
+                Private::Item item;
+                const uint32_t w = reader.readU32();
+                const uint32_t h = reader.readU32();
+                const uint32_t type = reader.readU32();
+                item.info = ImageInfo(w, h, static_cast<ImageType>(type));
+                const uint32_t dataCount = reader.readU32();
+                if (const uint8_t* data = reader.read(dataCount * sizeof(int32_t)))
+                {
+                    item.data.resize(dataCount);
+                    memcpy(item.data.data(), data, dataCount * sizeof(int32_t));
+                }
+                item.hasImage = reader.readU32() != 0;
+                const uint32_t byteCount = reader.readU32();
+                item.mapped = reader.read(byteCount);
+                if (reader.isValid() &&
+                    type < static_cast<uint32_t>(ImageType::Count) &&
+                    byteCount == (item.hasImage ? item.info.getByteCount() : 0))
+                {
+                    if (0 == byteCount)
+                    {
+                        item.mapped = nullptr;
+                    }
+                    item.use = i + 1;
+                    items[std::string(reinterpret_cast<const char*>(key), keySize)] =
+                        std::move(item);
+                }
+            }
+            if (reader.isValid())
+            {
+                p.mutex.io = io;
+                p.mutex.items = std::move(items);
+                p.mutex.use = count;
+            }
+        }
+        catch (const std::exception&)
+        {}
+    }
+}
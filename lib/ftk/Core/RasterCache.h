@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/Image.h>
+#include <ftk/Core/Memory.h>
+
+#include <filesystem>
+
+namespace ftk
+{
+    //! \name Raster Cache
+    ///@{
+
+    //! Raster cache file version. Files with a different version are
+    //! ignored.
+    const uint32_t rasterCacheVersion = 2;
+
+    //! Default raster cache size in bytes.
+    const size_t rasterCacheMax = 64 * megabyte;
+
+    //! Get a hash of the given data for use in raster cache keys. The hash
+    //! is the same for every run of the application.
+    uint64_t getRasterCacheHash(const void*, size_t);
+
+    //! Raster cache.
+    //!
+    //! The raster cache stores rasterized images in a file so that they can
+    //! be reused when the application is restarted. The file is memory
+    //! mapped when the cache is created, and the images that are added are
+    //! written when the cache is saved. Only the most recently used items
+    //! that fit in the maximum size are written.
+    //!
+    //! The raster cache functions are thread safe.
+    class RasterCache : public std::enable_shared_from_this<RasterCache>
+    {
+        FTK_NON_COPYABLE(RasterCache);
+
+    protected:
+        void _init(const std::filesystem::path&);
+
+        RasterCache();
+
+    public:
+        ~RasterCache();
+
+        //! Create a new raster cache.
+        static std::shared_ptr<RasterCache> create(const std::filesystem::path&);
+
+        //! Get the file path.
+        const std::filesystem::path& getPath() const;
+
+        //! Get the number of items.
+        size_t getCount() const;
+
+        //! Get the maximum size of the file in bytes.
+        size_t getMax() const;
+
+        //! Set the maximum size of the file in bytes.
+        void setMax(size_t);
+
+        //! Get an item. The data contains the values that were stored with
+        //! the image. A null image is returned for items that were added
+        //! without an image, and an empty image for items that were added
+        //! with an empty image.
+        bool get(
+            const std::string& key,
+            std::shared_ptr<Image>&,
+            std::vector<int32_t>* data = nullptr) const;
+
+        //! Add an item.
+        void add(
+            const std::string& key,
+            const std::shared_ptr<Image>&,
+            const std::vector<int32_t>& data = {});
+
+        //! Write the items to the file if any have been added. An exception
+        //! is thrown if the file cannot be written, and the items are kept.
+        void save();
+
+    private:
+        void _read();
+
+        FTK_PRIVATE();
+    };
+
+    ///@}
+}
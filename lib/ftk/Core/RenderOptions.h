@@ -36,6 +36,10 @@ namespace ftk
             4096;
 #endif // FTK_API_GLES_2
 
+        //! Maximum number of glyph texture atlas pages. Pages are allocated
+        //! as needed.
+        int glyphAtlasPages = 4;
+
         //! Enable logging.
         bool log = true;
 
@@ -10,6 +10,7 @@ namespace ftk
             clearColor == other.clearColor &&
             textureCacheByteCount == other.textureCacheByteCount &&
             glyphAtlasSize == other.glyphAtlasSize &&
+            glyphAtlasPages == other.glyphAtlasPages &&
             log == other.log;
     }
 
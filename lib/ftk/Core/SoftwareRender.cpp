@@ -0,0 +1,347 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/SoftwareRenderPrivate.h>
+
+#include <ftk/Core/Format.h>
+#include <ftk/Core/ImageConvert.h>
+#include <ftk/Core/LogSystem.h>
+#include <ftk/Core/Math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ftk
+{
+    namespace
+    {
+        const size_t statsAverageCount = 10;
+        const size_t statsTimer = 600; // 60Hz * 10 seconds
+
+        inline uint8_t toU8(float value)
+        {
+            return static_cast<uint8_t>(clamp(value, 0.F, 1.F) * 255.F + .5F);
+        }
+    }
+
+    void SoftwareRender::_init(
+        const std::shared_ptr<LogSystem>& logSystem,
+        const std::shared_ptr<SoftwareImageCache>& imageCache)
+    {
+        IRender::_init(logSystem);
+        FTK_P();
+
+        p.logSystem = logSystem;
+
+        p.imageCache = imageCache;
+        if (!p.imageCache)
+        {
+            p.imageCache = std::make_shared<SoftwareImageCache>();
+        }
+    }
+
+    SoftwareRender::SoftwareRender() :
+        _p(new Private)
+    {}
+
+    SoftwareRender::~SoftwareRender()
+    {}
+
+    std::shared_ptr<SoftwareRender> SoftwareRender::create(
+        const std::shared_ptr<LogSystem>& logSystem,
+        const std::shared_ptr<SoftwareImageCache>& imageCache)
+    {
+        auto out = std::shared_ptr<SoftwareRender>(new SoftwareRender);
+        out->_init(logSystem, imageCache);
+        return out;
+    }
+
+    const std::shared_ptr<Image>& SoftwareRender::getImage() const
+    {
+        return _p->image;
+    }
+
+    const std::shared_ptr<SoftwareImageCache>& SoftwareRender::getImageCache() const
+    {
+        return _p->imageCache;
+    }
+
+    void SoftwareRender::begin(
+        const Size2I& size,
+        const RenderOptions& options)
+    {
+        FTK_P();
+
+        p.startTime = std::chrono::steady_clock::now();
+        p.stats = Private::Stats();
+
+        p.size = size;
+        p.options = options;
+        p.imageCache->setMax(options.textureCacheByteCount);
+
+        if (!p.image || p.image->getSize() != size)
+        {
+            p.image.reset();
+            if (size.isValid())
+            {
+                p.image = Image::create(size, ImageType::RGBA_U8);
+                p.image->zero();
+            }
+        }
+
+        p.clipRectEnabled = false;
+        setViewport(Box2I(0, 0, size.w, size.h));
+        if (options.clear)
+        {
+            clearViewport(options.clearColor);
+        }
+        setTransform(ortho(
+            0.F,
+            static_cast<float>(size.w),
+            static_cast<float>(size.h),
+            0.F,
+            -1.F,
+            1.F));
+    }
+
+    void SoftwareRender::end()
+    {
+        FTK_P();
+        const auto now = std::chrono::steady_clock::now();
+        const auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(now - p.startTime);
+        p.stats.renderTime = diff.count();
+        p.statsList.push_back(p.stats);
+        while (p.statsList.size() > statsAverageCount)
+        {
+            p.statsList.pop_front();
+        }
+        p.statsCounter = p.statsCounter + 1;
+        if (p.statsCounter > statsTimer)
+        {
+            p.statsCounter = 0;
+            if (p.options.log)
+            {
+                _log();
+            }
+        }
+    }
+
+    Size2I SoftwareRender::getRenderSize() const
+    {
+        return _p->size;
+    }
+
+    void SoftwareRender::setRenderSize(const Size2I& value)
+    {
+        FTK_P();
+        p.size = value;
+        p.updateClip();
+        p.updateAffine();
+    }
+
+    RenderOptions SoftwareRender::getRenderOptions() const
+    {
+        return _p->options;
+    }
+
+    Box2I SoftwareRender::getViewport() const
+    {
+        return _p->viewport;
+    }
+
+    void SoftwareRender::setViewport(const Box2I& value)
+    {
+        FTK_P();
+        p.viewport = value;
+        p.updateClip();
+        p.updateAffine();
+    }
+
+    void SoftwareRender::clearViewport(const Color4F& value)
+    {
+        FTK_P();
+        if (!p.image)
+            return;
+        // Like glClear() the viewport is cleared, limited by the clipping
+        // rectangle when it is enabled.
+        const Box2I& clip = p.clip;
+        if (!clip.isValid())
+            return;
+        const uint8_t c[4] =
+        {
+            toU8(value.r),
+            toU8(value.g),
+            toU8(value.b),
+            toU8(value.a)
+        };
+        uint32_t c32 = 0;
+        memcpy(&c32, c, 4);
+        const int w = clip.w();
+        for (int y = clip.min.y; y <= clip.max.y; ++y)
+        {
+            uint32_t* row = reinterpret_cast<uint32_t*>(p.getRow(y)) + clip.min.x;
+            std::fill(row, row + w, c32);
+        }
+    }
+
+    bool SoftwareRender::getClipRectEnabled() const
+    {
+        return _p->clipRectEnabled;
+    }
+
+    void SoftwareRender::setClipRectEnabled(bool value)
+    {
+        FTK_P();
+        p.clipRectEnabled = value;
+        p.updateClip();
+    }
+
+    Box2I SoftwareRender::getClipRect() const
+    {
+        return _p->clipRect;
+    }
+
+    void SoftwareRender::setClipRect(const Box2I& value)
+    {
+        FTK_P();
+        p.clipRect = value;
+        p.updateClip();
+    }
+
+    M44F SoftwareRender::getTransform() const
+    {
+        return _p->transform;
+    }
+
+    void SoftwareRender::setTransform(const M44F& value)
+    {
+        FTK_P();
+        p.transform = value;
+        p.updateAffine();
+    }
+
+    void SoftwareRender::_log()
+    {
+        FTK_P();
+        if (auto logSystem = p.logSystem.lock())
+        {
+            Private::Stats average;
+            const size_t size = p.statsList.size();
+            if (size)
+            {
+                for (auto i : p.statsList)
+                {
+                    average.renderTime   += i.renderTime;
+                    average.triCount     += i.triCount;
+                    average.textureCount += i.textureCount;
+                    average.glyphCount   += i.glyphCount;
+                }
+                average.renderTime   /= size;
+                average.triCount     /= size;
+                average.textureCount /= size;
+                average.glyphCount   /= size;
+            }
+            logSystem->print(
+                "ftk::SoftwareRender",
+                Format(
+                    "Averages:\n"
+                    "    Render time:    {0}ms\n"
+                    "    Triangle count: {1}\n"
+                    "    Texture count:  {2}\n"
+                    "    Glyph count:    {3}").
+                    arg(average.renderTime).
+                    arg(average.triCount).
+                    arg(average.textureCount).
+                    arg(average.glyphCount));
+        }
+    }
+
+    void SoftwareRender::Private::updateClip()
+    {
+        Box2I out(0, 0, 0, 0);
+        if (image)
+        {
+            out = intersect(viewport, Box2I(0, 0, image->getWidth(), image->getHeight()));
+            if (clipRectEnabled)
+            {
+                out = clipRect.isValid() ? intersect(out, clipRect) : Box2I(0, 0, 0, 0);
+            }
+        }
+        clip = out;
+    }
+
+    void SoftwareRender::Private::updateAffine()
+    {
+        // Map normalized device coordinates to pixels, with the Y axis
+        // pointing down.
+        const float sx = viewport.w() / 2.F;
+        const float sy = -viewport.h() / 2.F;
+        const float tx = viewport.min.x + sx;
+        const float ty = viewport.min.y - sy;
+        const M44F& m = transform;
+        affine[0] = m[0] * sx;
+        affine[1] = m[1] * sx;
+        affine[2] = m[3] * sx + tx;
+        affine[3] = m[4] * sy;
+        affine[4] = m[5] * sy;
+        affine[5] = m[7] * sy + ty;
+        const float e = .00001F;
+        translateOnly =
+            std::fabs(affine[0] - 1.F) < e &&
+            std::fabs(affine[1]) < e &&
+            std::fabs(affine[3]) < e &&
+            std::fabs(affine[4] - 1.F) < e;
+    }
+
+    V2F SoftwareRender::Private::toPixel(const V2F& value) const
+    {
+        return V2F(
+            value.x * affine[0] + value.y * affine[1] + affine[2],
+            value.x * affine[3] + value.y * affine[4] + affine[5]);
+    }
+
+    uint8_t* SoftwareRender::Private::getRow(int y)
+    {
+        // The image is stored from bottom to top.
+        const int w = image->getWidth();
+        const int h = image->getHeight();
+        return image->getData() + static_cast<size_t>(h - 1 - y) * w * 4;
+    }
+
+    std::shared_ptr<Image> SoftwareRender::Private::getTexture(
+        const std::shared_ptr<Image>& value,
+        const ImageOptions& imageOptions)
+    {
+        std::shared_ptr<Image> out;
+        //! \bug The cache is keyed on the image, so changing the input video
+        //! levels for a cached image requires clearing the cache.
+        if (imageOptions.cache && imageCache->get(value, out))
+        {
+            return out;
+        }
+
+        ImageInfo info = value->getInfo();
+        switch (imageOptions.videoLevels)
+        {
+        case InputVideoLevels::FullRange:
+            info.videoLevels = VideoLevels::FullRange;
+            break;
+        case InputVideoLevels::LegalRange:
+            info.videoLevels = VideoLevels::LegalRange;
+            break;
+        default: break;
+        }
+
+        // The texture rows are kept in the same order as the image rows.
+        ImageInfo outInfo(info.size, ImageType::RGBA_U8);
+        outInfo.layout.mirror = info.layout.mirror;
+        out = Image::create(outInfo);
+        convertImage(info, value->getData(), outInfo, out->getData());
+        if (imageOptions.cache)
+        {
+            imageCache->add(value, out, out->getByteCount());
+        }
+        return out;
+    }
+}
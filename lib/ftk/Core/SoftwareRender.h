@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/IRender.h>
+
+#include <ftk/Core/LRUCache.h>
+
+namespace ftk
+{
+    //! \name Rendering
+    ///@{
+
+    //! Software renderer image cache. The cache maps source images to the
+    //! converted RGBA_U8 images that are used for sampling.
+    typedef LRUCache<std::shared_ptr<Image>, std::shared_ptr<Image> > SoftwareImageCache;
+
+    //! Software renderer.
+    //!
+    //! The software renderer rasterizes into an image in system memory, so
+    //! it can be used on machines without a GPU (for example continuous
+    //! integration and render farm nodes). The render target is an image of
+    //! type ImageType::RGBA_U8, and like OpenGL the rows are stored from
+    //! bottom to top.
+    //!
+    //! Primitives are rasterized with scanline spans clipped to the
+    //! viewport and clipping rectangle, so the inner loops operate on
+    //! contiguous pixels.
+    //!
+    //! Textures are not supported since they are OpenGL objects, so
+    //! drawTexture() does not draw anything and logs a warning.
+    class SoftwareRender : public IRender
+    {
+    protected:
+        void _init(
+            const std::shared_ptr<LogSystem>&,
+            const std::shared_ptr<SoftwareImageCache>&);
+
+        SoftwareRender();
+
+    public:
+        virtual ~SoftwareRender();
+
+        //! Create a new renderer.
+        static std::shared_ptr<SoftwareRender> create(
+            const std::shared_ptr<LogSystem>& = nullptr,
+            const std::shared_ptr<SoftwareImageCache>& = nullptr);
+
+        //! Get the render target image.
+        const std::shared_ptr<Image>& getImage() const;
+
+        //! Get the image cache.
+        const std::shared_ptr<SoftwareImageCache>& getImageCache() const;
+
+        void begin(
+            const Size2I&,
+            const RenderOptions& = RenderOptions()) override;
+        void end() override;
+        Size2I getRenderSize() const override;
+        void setRenderSize(const Size2I&) override;
+        RenderOptions getRenderOptions() const override;
+        Box2I getViewport() const override;
+        void setViewport(const Box2I&) override;
+        void clearViewport(const Color4F&) override;
+        bool getClipRectEnabled() const override;
+        void setClipRectEnabled(bool) override;
+        Box2I getClipRect() const override;
+        void setClipRect(const Box2I&) override;
+        M44F getTransform() const override;
+        void setTransform(const M44F&) override;
+        void drawRect(
+            const Box2F&,
+            const Color4F&) override;
+        void drawRects(
+            const std::vector<Box2F>&,
+            const Color4F&) override;
+        void drawLine(
+            const V2F&,
+            const V2F&,
+            const Color4F&,
+            const LineOptions& = LineOptions()) override;
+        void drawLines(
+            const std::vector<std::pair<V2F, V2F> >&,
+            const Color4F&,
+            const LineOptions& = LineOptions()) override;
+        void drawMesh(
+            const TriMesh2F&,
+            const Color4F& = Color4F(1.F, 1.F, 1.F, 1.F),
+            const V2F& pos = V2F()) override;
+        void drawColorMesh(
+            const TriMesh2F&,
+            const Color4F& = Color4F(1.F, 1.F, 1.F, 1.F),
+            const V2F& pos = V2F()) override;
+        void drawTexture(
+            unsigned int,
+            const Box2I&,
+            bool flipV = false,
+            const Color4F& = Color4F(1.F, 1.F, 1.F),
+            AlphaBlend = AlphaBlend::Straight) override;
+        void drawText(
+            const std::vector<std::shared_ptr<Glyph> >&,
+            const FontMetrics&,
+            const V2F& position,
+            const Color4F& = Color4F(1.F, 1.F, 1.F, 1.F)) override;
+        void drawImage(
+            const std::shared_ptr<Image>&,
+            const TriMesh2F&,
+            const Color4F& = Color4F(1.F, 1.F, 1.F, 1.F),
+            const ImageOptions& = ImageOptions()) override;
+        void drawImage(
+            const std::shared_ptr<Image>&,
+            const Box2F&,
+            const Color4F& = Color4F(1.F, 1.F, 1.F, 1.F),
+            const ImageOptions& = ImageOptions()) override;
+
+    private:
+        void _log();
+
+        FTK_PRIVATE();
+    };
+
+    ///@}
+}
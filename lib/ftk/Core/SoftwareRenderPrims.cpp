@@ -0,0 +1,733 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/SoftwareRenderPrivate.h>
+
+#include <ftk/Core/LogSystem.h>
+#include <ftk/Core/Math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ftk
+{
+    namespace
+    {
+        inline uint32_t div255(uint32_t value)
+        {
+            value += 128;
+            return (value + (value >> 8)) >> 8;
+        }
+
+        inline uint8_t toU8(float value)
+        {
+            return static_cast<uint8_t>(clamp(value, 0.F, 1.F) * 255.F + .5F);
+        }
+
+        //! Blend a span of pixels with a constant color using the default
+        //! blending mode.
+        void blendSpan(uint8_t* p, int count, const uint8_t c[4])
+        {
+            const uint32_t a = c[3];
+            if (0 == a)
+            {
+                return;
+            }
+            if (255 == a)
+            {
+                uint32_t c32 = 0;
+                memcpy(&c32, c, 4);
+                uint32_t* p32 = reinterpret_cast<uint32_t*>(p);
+                std::fill(p32, p32 + count, c32);
+                return;
+            }
+            const uint32_t ia = 255 - a;
+            const uint32_t r = c[0] * a;
+            const uint32_t g = c[1] * a;
+            const uint32_t b = c[2] * a;
+            const uint32_t aa = a * a;
+            for (int i = 0; i < count; ++i, p += 4)
+            {
+                p[0] = div255(r + p[0] * ia);
+                p[1] = div255(g + p[1] * ia);
+                p[2] = div255(b + p[2] * ia);
+                p[3] = div255(aa + p[3] * ia);
+            }
+        }
+
+        //! Blend a pixel. The source values are in the range [0, 1].
+        inline void blendPixel(uint8_t* p, const float s[4], SoftwareBlend blend)
+        {
+            const float a = clamp(s[3], 0.F, 1.F);
+            const float ia = 1.F - a;
+            const float d[4] =
+            {
+                p[0] / 255.F,
+                p[1] / 255.F,
+                p[2] / 255.F,
+                p[3] / 255.F
+            };
+            switch (blend)
+            {
+            case SoftwareBlend::Default:
+                p[0] = toU8(s[0] * a + d[0] * ia);
+                p[1] = toU8(s[1] * a + d[1] * ia);
+                p[2] = toU8(s[2] * a + d[2] * ia);
+                p[3] = toU8(a * a + d[3] * ia);
+                break;
+            case SoftwareBlend::None:
+                p[0] = toU8(s[0]);
+                p[1] = toU8(s[1]);
+                p[2] = toU8(s[2]);
+                p[3] = toU8(s[3]);
+                break;
+            case SoftwareBlend::Straight:
+                p[0] = toU8(s[0] * a + d[0] * ia);
+                p[1] = toU8(s[1] * a + d[1] * ia);
+                p[2] = toU8(s[2] * a + d[2] * ia);
+                p[3] = toU8(a + d[3] * ia);
+                break;
+            case SoftwareBlend::Premultiplied:
+                p[0] = toU8(s[0] + d[0] * ia);
+                p[1] = toU8(s[1] + d[1] * ia);
+                p[2] = toU8(s[2] + d[2] * ia);
+                p[3] = toU8(a + d[3] * ia);
+                break;
+            default: break;
+            }
+        }
+
+        //! Sample a texture. The output values are in the range [0, 1].
+        inline void sample(
+            const SoftwareTexture& texture,
+            float u,
+            float v,
+            ImageFilter filter,
+            float out[4])
+        {
+            if (texture.mirrorX)
+            {
+                u = 1.F - u;
+            }
+            if (!texture.mirrorY)
+            {
+                v = 1.F - v;
+            }
+            const int w = texture.w;
+            const int h = texture.h;
+            if (ImageFilter::Nearest == filter)
+            {
+                const int x = clamp(static_cast<int>(std::floor(u * w)), 0, w - 1);
+                const int y = clamp(static_cast<int>(std::floor(v * h)), 0, h - 1);
+                const uint8_t* p = texture.data + (static_cast<size_t>(y) * w + x) * 4;
+                out[0] = p[0] / 255.F;
+                out[1] = p[1] / 255.F;
+                out[2] = p[2] / 255.F;
+                out[3] = p[3] / 255.F;
+            }
+            else
+            {
+                const float fx = u * w - .5F;
+                const float fy = v * h - .5F;
+                const float x0f = std::floor(fx);
+                const float y0f = std::floor(fy);
+                const float tx = fx - x0f;
+                const float ty = fy - y0f;
+                const int x0 = clamp(static_cast<int>(x0f), 0, w - 1);
+                const int x1 = clamp(static_cast<int>(x0f) + 1, 0, w - 1);
+                const int y0 = clamp(static_cast<int>(y0f), 0, h - 1);
+                const int y1 = clamp(static_cast<int>(y0f) + 1, 0, h - 1);
+                const uint8_t* p00 = texture.data + (static_cast<size_t>(y0) * w + x0) * 4;
+                const uint8_t* p10 = texture.data + (static_cast<size_t>(y0) * w + x1) * 4;
+                const uint8_t* p01 = texture.data + (static_cast<size_t>(y1) * w + x0) * 4;
+                const uint8_t* p11 = texture.data + (static_cast<size_t>(y1) * w + x1) * 4;
+                for (int i = 0; i < 4; ++i)
+                {
+                    const float a = p00[i] + (p10[i] - p00[i]) * tx;
+                    const float b = p01[i] + (p11[i] - p01[i]) * tx;
+                    out[i] = (a + (b - a) * ty) / 255.F;
+                }
+            }
+        }
+
+        //! Compute the X and Y gradients of a value across a triangle.
+        inline void gradient(
+            const V2F& p0,
+            const V2F& p1,
+            const V2F& p2,
+            float f0,
+            float f1,
+            float f2,
+            float invArea,
+            float& dx,
+            float& dy)
+        {
+            dx = ((f1 - f0) * (p2.y - p0.y) - (f2 - f0) * (p1.y - p0.y)) * invArea;
+            dy = ((f2 - f0) * (p1.x - p0.x) - (f1 - f0) * (p2.x - p0.x)) * invArea;
+        }
+    }
+
+    void SoftwareRender::Private::fillRect(
+        const Box2F& rect,
+        const Color4F& color)
+    {
+        if (!image || !clip.isValid())
+            return;
+
+        // Pixels are covered when their centers are inside the rectangle.
+        const V2F a = toPixel(rect.min);
+        const V2F b = toPixel(rect.max);
+        const int x0 = std::max(
+            static_cast<int>(std::ceil(std::min(a.x, b.x) - .5F)),
+            clip.min.x);
+        const int x1 = std::min(
+            static_cast<int>(std::ceil(std::max(a.x, b.x) - .5F)),
+            clip.max.x + 1);
+        const int y0 = std::max(
+            static_cast<int>(std::ceil(std::min(a.y, b.y) - .5F)),
+            clip.min.y);
+        const int y1 = std::min(
+            static_cast<int>(std::ceil(std::max(a.y, b.y) - .5F)),
+            clip.max.y + 1);
+        if (x0 >= x1 || y0 >= y1)
+            return;
+
+        const uint8_t c[4] =
+        {
+            toU8(color.r),
+            toU8(color.g),
+            toU8(color.b),
+            toU8(color.a)
+        };
+        for (int y = y0; y < y1; ++y)
+        {
+            blendSpan(getRow(y) + x0 * 4, x1 - x0, c);
+        }
+        stats.triCount += 2;
+    }
+
+    void SoftwareRender::Private::fillTriangle(
+        const SoftwareVertex& v0,
+        const SoftwareVertex& v1,
+        const SoftwareVertex& v2,
+        bool colors,
+        const SoftwareTexture* texture,
+        const Color4F& color,
+        SoftwareBlend blend,
+        ChannelDisplay channelDisplay)
+    {
+        const V2F& p0 = v0.pos;
+        const V2F& p1 = v1.pos;
+        const V2F& p2 = v2.pos;
+        const float area = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+        if (std::fabs(area) < 1.e-6F)
+            return;
+
+        const float yMin = std::min(p0.y, std::min(p1.y, p2.y));
+        const float yMax = std::max(p0.y, std::max(p1.y, p2.y));
+        const int y0 = std::max(static_cast<int>(std::ceil(yMin - .5F)), clip.min.y);
+        const int y1 = std::min(static_cast<int>(std::ceil(yMax - .5F)), clip.max.y + 1);
+        if (y0 >= y1)
+            return;
+
+        // Edges are ordered from top to bottom so that the edges shared
+        // between triangles produce the same coverage.
+        struct Edge
+        {
+            V2F a;
+            V2F b;
+        };
+        Edge edges[3] =
+        {
+            { p0, p1 },
+            { p1, p2 },
+            { p2, p0 }
+        };
+        for (auto& edge : edges)
+        {
+            if (edge.a.y > edge.b.y)
+            {
+                std::swap(edge.a, edge.b);
+            }
+        }
+
+        // Gradients for the interpolated values.
+        const bool interpolate = colors || texture;
+        const float invArea = 1.F / area;
+        float attr0[6] = { 0.F, 0.F, 0.F, 0.F, 0.F, 0.F };
+        float dx[6] = { 0.F, 0.F, 0.F, 0.F, 0.F, 0.F };
+        float dy[6] = { 0.F, 0.F, 0.F, 0.F, 0.F, 0.F };
+        ImageFilter filter = ImageFilter::Linear;
+        if (colors)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                attr0[i] = v0.color[i];
+                gradient(p0, p1, p2, v0.color[i], v1.color[i], v2.color[i], invArea, dx[i], dy[i]);
+            }
+        }
+        if (texture)
+        {
+            attr0[4] = v0.uv.x;
+            attr0[5] = v0.uv.y;
+            gradient(p0, p1, p2, v0.uv.x, v1.uv.x, v2.uv.x, invArea, dx[4], dy[4]);
+            gradient(p0, p1, p2, v0.uv.y, v1.uv.y, v2.uv.y, invArea, dx[5], dy[5]);
+
+            // Use the minify filter when more than one texel covers a pixel.
+            const float sx = std::hypot(dx[4] * texture->w, dx[5] * texture->h);
+            const float sy = std::hypot(dy[4] * texture->w, dy[5] * texture->h);
+            filter = std::max(sx, sy) > 1.F ?
+                texture->filters.minify :
+                texture->filters.magnify;
+        }
+
+        const uint8_t c[4] =
+        {
+            toU8(color.r),
+            toU8(color.g),
+            toU8(color.b),
+            toU8(color.a)
+        };
+        for (int y = y0; y < y1; ++y)
+        {
+            // Find the span covered by the triangle at the pixel centers.
+            const float yc = y + .5F;
+            float xl = 0.F;
+            float xr = 0.F;
+            int hits = 0;
+            for (const auto& edge : edges)
+            {
+                if (yc >= edge.a.y && yc < edge.b.y)
+                {
+                    const float x = edge.a.x +
+                        (yc - edge.a.y) * (edge.b.x - edge.a.x) / (edge.b.y - edge.a.y);
+                    if (0 == hits)
+                    {
+                        xl = xr = x;
+                    }
+                    else
+                    {
+                        xl = std::min(xl, x);
+                        xr = std::max(xr, x);
+                    }
+                    ++hits;
+                }
+            }
+            if (hits < 2)
+                continue;
+            const int x0 = std::max(static_cast<int>(std::ceil(xl - .5F)), clip.min.x);
+            const int x1 = std::min(static_cast<int>(std::ceil(xr - .5F)), clip.max.x + 1);
+            if (x0 >= x1)
+                continue;
+
+            uint8_t* p = getRow(y) + x0 * 4;
+            if (!interpolate)
+            {
+                blendSpan(p, x1 - x0, c);
+                continue;
+            }
+
+            float attr[6];
+            const float ox = x0 + .5F - p0.x;
+            const float oy = yc - p0.y;
+            for (int i = 0; i < 6; ++i)
+            {
+                attr[i] = attr0[i] + dx[i] * ox + dy[i] * oy;
+            }
+            for (int x = x0; x < x1; ++x, p += 4)
+            {
+                float s[4] = { color.r, color.g, color.b, color.a };
+                if (colors)
+                {
+                    s[0] *= attr[0];
+                    s[1] *= attr[1];
+                    s[2] *= attr[2];
+                    s[3] *= attr[3];
+                }
+                if (texture)
+                {
+                    float t[4];
+                    sample(*texture, attr[4], attr[5], filter, t);
+                    s[0] *= t[0];
+                    s[1] *= t[1];
+                    s[2] *= t[2];
+                    s[3] *= t[3];
+                    switch (channelDisplay)
+                    {
+                    case ChannelDisplay::Red: s[1] = s[2] = s[0]; break;
+                    case ChannelDisplay::Green: s[0] = s[2] = s[1]; break;
+                    case ChannelDisplay::Blue: s[0] = s[1] = s[2]; break;
+                    case ChannelDisplay::Alpha: s[0] = s[1] = s[2] = s[3]; break;
+                    default: break;
+                    }
+                }
+                blendPixel(p, s, blend);
+                for (int i = 0; i < 6; ++i)
+                {
+                    attr[i] += dx[i];
+                }
+            }
+        }
+    }
+
+    void SoftwareRender::Private::fillMesh(
+        const TriMesh2F& mesh,
+        const V2F& pos,
+        bool colors,
+        const SoftwareTexture* texture,
+        const Color4F& color,
+        SoftwareBlend blend,
+        ChannelDisplay channelDisplay)
+    {
+        if (!image || !clip.isValid())
+            return;
+
+        const size_t vSize = mesh.v.size();
+        const size_t tSize = mesh.t.size();
+        const size_t cSize = mesh.c.size();
+        for (const auto& triangle : mesh.triangles)
+        {
+            SoftwareVertex vertices[3];
+            bool valid = true;
+            for (int k = 0; k < 3; ++k)
+            {
+                const Vertex2& vertex = triangle.v[k];
+                if (vertex.v < 1 || vertex.v > vSize)
+                {
+                    valid = false;
+                    break;
+                }
+                vertices[k].pos = toPixel(mesh.v[vertex.v - 1] + pos);
+                if (vertex.t && vertex.t <= tSize)
+                {
+                    vertices[k].uv = mesh.t[vertex.t - 1];
+                }
+                if (vertex.c && vertex.c <= cSize)
+                {
+                    vertices[k].color = mesh.c[vertex.c - 1];
+                }
+                else
+                {
+                    vertices[k].color = V4F(1.F, 1.F, 1.F, 1.F);
+                }
+            }
+            if (valid)
+            {
+                fillTriangle(
+                    vertices[0],
+                    vertices[1],
+                    vertices[2],
+                    colors,
+                    texture,
+                    color,
+                    blend,
+                    channelDisplay);
+            }
+        }
+        stats.triCount += mesh.triangles.size();
+    }
+
+    void SoftwareRender::drawRect(
+        const Box2F& rect,
+        const Color4F& color)
+    {
+        FTK_P();
+        if (p.translateOnly)
+        {
+            p.fillRect(rect, color);
+        }
+        else
+        {
+            p.fillMesh(mesh(rect), V2F(), false, nullptr, color, SoftwareBlend::Default);
+        }
+    }
+
+    void SoftwareRender::drawRects(
+        const std::vector<Box2F>& rects,
+        const Color4F& color)
+    {
+        for (const auto& rect : rects)
+        {
+            drawRect(rect, color);
+        }
+    }
+
+    void SoftwareRender::drawLine(
+        const V2F& v0,
+        const V2F& v1,
+        const Color4F& color,
+        const LineOptions& options)
+    {
+        drawLines({ { v0, v1 } }, color, options);
+    }
+
+    void SoftwareRender::drawLines(
+        const std::vector<std::pair<V2F, V2F> >& lines,
+        const Color4F& color,
+        const LineOptions& options)
+    {
+        TriMesh2F mesh;
+        mesh.v.resize(lines.size() * 4);
+        mesh.triangles.resize(lines.size() * 2);
+        size_t v = 0;
+        size_t t = 0;
+        for (const auto& i : lines)
+        {
+            const V2F v2 = normalize(i.second - i.first);
+            const V2F v2CW = perpCW(v2) * options.width / 2.F;
+            const V2F v2CCW = perpCCW(v2) * options.width / 2.F;
+            mesh.v[v + 0] = i.first + v2CCW;
+            mesh.v[v + 1] = i.first + v2CW;
+            mesh.v[v + 2] = i.second + v2CW;
+            mesh.v[v + 3] = i.second + v2CCW;
+            mesh.triangles[t + 0] = { v + 1, v + 3, v + 2 };
+            mesh.triangles[t + 1] = { v + 3, v + 1, v + 4 };
+            v += 4;
+            t += 2;
+        }
+        drawMesh(mesh, color);
+    }
+
+    void SoftwareRender::drawMesh(
+        const TriMesh2F& mesh,
+        const Color4F& color,
+        const V2F& pos)
+    {
+        _p->fillMesh(mesh, pos, false, nullptr, color, SoftwareBlend::Default);
+    }
+
+    void SoftwareRender::drawColorMesh(
+        const TriMesh2F& mesh,
+        const Color4F& color,
+        const V2F& pos)
+    {
+        _p->fillMesh(mesh, pos, true, nullptr, color, SoftwareBlend::Default);
+    }
+
+    void SoftwareRender::drawTexture(
+        unsigned int,
+        const Box2I&,
+        bool,
+        const Color4F&,
+        AlphaBlend)
+    {
+        FTK_P();
+        if (!p.textureWarning)
+        {
+            p.textureWarning = true;
+            if (auto logSystem = p.logSystem.lock())
+            {
+                logSystem->print(
+                    "ftk::SoftwareRender",
+                    "Textures are not supported by the software renderer",
+                    LogType::Warning);
+            }
+        }
+    }
+
+    void SoftwareRender::drawText(
+        const std::vector<std::shared_ptr<Glyph> >& glyphs,
+        const FontMetrics& fontMetrics,
+        const V2F& pos,
+        const Color4F& color)
+    {
+        FTK_P();
+        if (!p.image || !p.clip.isValid())
+            return;
+
+        const Box2I& clip = p.clip;
+        const uint32_t r = toU8(color.r);
+        const uint32_t g = toU8(color.g);
+        const uint32_t b = toU8(color.b);
+        const uint32_t a = toU8(color.a);
+        const V2F offset = p.toPixel(V2F());
+        const int ox = static_cast<int>(std::floor(offset.x + .5F));
+        const int oy = static_cast<int>(std::floor(offset.y + .5F));
+
+        int x = 0;
+        int y = 0;
+        int32_t rsbDeltaPrev = 0;
+        Box2I lineRect(p.clipRect.min.x, pos.y, p.clipRect.w(), fontMetrics.lineHeight);
+        for (auto glyphIt = glyphs.begin(); glyphIt != glyphs.end(); ++glyphIt)
+        {
+            if (*glyphIt)
+            {
+                if ('\n' == (*glyphIt)->info.code)
+                {
+                    auto crIt = glyphIt + 1;
+                    if (crIt != glyphs.end() && *crIt && '\r' == (*crIt)->info.code)
+                    {
+                        ++glyphIt;
+                    }
+                    x = 0;
+                    y += fontMetrics.lineHeight;
+                    rsbDeltaPrev = 0;
+                    lineRect = Box2I(p.clipRect.min.x, pos.y + y, p.clipRect.w(), fontMetrics.lineHeight);
+                }
+                else if (!p.clipRectEnabled || intersects(p.clipRect, lineRect))
+                {
+                    if (rsbDeltaPrev - (*glyphIt)->lsbDelta > 32)
+                    {
+                        x -= 1;
+                    }
+                    else if (rsbDeltaPrev - (*glyphIt)->lsbDelta < -31)
+                    {
+                        x += 1;
+                    }
+                    rsbDeltaPrev = (*glyphIt)->rsbDelta;
+
+                    const auto& glyphImage = (*glyphIt)->image;
+                    if (glyphImage && glyphImage->isValid())
+                    {
+                        p.stats.glyphCount += 1;
+                        p.stats.triCount += 2;
+
+                        const V2I& glyphOffset = (*glyphIt)->offset;
+                        //! \bug Off by one?
+                        const int extraOffset = 1;
+                        const Box2I box(
+                            pos.x + x + glyphOffset.x,
+                            pos.y + y + fontMetrics.ascender - glyphOffset.y - extraOffset,
+                            glyphImage->getWidth(),
+                            glyphImage->getHeight());
+                        const int channelCount = getChannelCount(glyphImage->getType());
+                        const int glyphW = glyphImage->getWidth();
+                        const int glyphH = glyphImage->getHeight();
+                        const size_t glyphRowBytes = getAlignedByteCount(
+                            glyphW * channelCount,
+                            glyphImage->getInfo().layout.alignment);
+                        const bool sdf = (*glyphIt)->sdf;
+                        if (p.translateOnly && !sdf)
+                        {
+                            // Copy the glyph coverage directly.
+                            const int bx = box.min.x + ox;
+                            const int by = box.min.y + oy;
+                            const int x0 = std::max(bx, clip.min.x);
+                            const int x1 = std::min(bx + glyphW, clip.max.x + 1);
+                            const int y0 = std::max(by, clip.min.y);
+                            const int y1 = std::min(by + glyphH, clip.max.y + 1);
+                            for (int gy = y0; gy < y1; ++gy)
+                            {
+                                const uint8_t* src =
+                                    glyphImage->getData() +
+                                    (gy - by) * glyphRowBytes +
+                                    (x0 - bx) * channelCount;
+                                uint8_t* dst = p.getRow(gy) + x0 * 4;
+                                for (int gx = x0; gx < x1; ++gx, src += channelCount, dst += 4)
+                                {
+                                    const uint32_t sa = div255(src[0] * a);
+                                    if (sa)
+                                    {
+                                        const uint32_t ia = 255 - sa;
+                                        dst[0] = div255(r * sa + dst[0] * ia);
+                                        dst[1] = div255(g * sa + dst[1] * ia);
+                                        dst[2] = div255(b * sa + dst[2] * ia);
+                                        dst[3] = div255(sa * sa + dst[3] * ia);
+                                    }
+                                }
+                            }
+                        }
+                        else
+                        {
+                            // Draw the glyph as a textured quad. SDF glyphs are
+                            // converted to coverage with a one pixel edge at
+                            // the scaled size.
+                            const float scale = sdf ? (*glyphIt)->imageScale : 1.F;
+                            const float sdfEdge = 128.F / std::max(sdfGlyphSpread * scale, 1.F);
+                            std::vector<uint8_t> data(glyphW * glyphH * 4);
+                            for (int gy = 0; gy < glyphH; ++gy)
+                            {
+                                const uint8_t* src = glyphImage->getData() + gy * glyphRowBytes;
+                                uint8_t* dst = data.data() + gy * glyphW * 4;
+                                for (int gx = 0; gx < glyphW; ++gx, src += channelCount, dst += 4)
+                                {
+                                    dst[0] = dst[1] = dst[2] = 255;
+                                    dst[3] = sdf ?
+                                        toU8((src[0] - 128.F) / sdfEdge + .5F) :
+                                        src[0];
+                                }
+                            }
+                            V2F min(box.min.x, box.min.y);
+                            V2F max(box.max.x + 1, box.max.y + 1);
+                            if (sdf)
+                            {
+                                min.x = pos.x + x + glyphOffset.x * scale;
+                                min.y = pos.y + y + fontMetrics.ascender - glyphOffset.y * scale - extraOffset;
+                                max.x = min.x + glyphW * scale;
+                                max.y = min.y + glyphH * scale;
+                            }
+                            SoftwareTexture texture;
+                            texture.w = glyphW;
+                            texture.h = glyphH;
+                            texture.data = data.data();
+                            texture.mirrorY = true;
+                            TriMesh2F mesh;
+                            mesh.v.push_back(V2F(min.x, min.y));
+                            mesh.v.push_back(V2F(max.x, min.y));
+                            mesh.v.push_back(V2F(max.x, max.y));
+                            mesh.v.push_back(V2F(min.x, max.y));
+                            mesh.t.push_back(V2F(0.F, 0.F));
+                            mesh.t.push_back(V2F(1.F, 0.F));
+                            mesh.t.push_back(V2F(1.F, 1.F));
+                            mesh.t.push_back(V2F(0.F, 1.F));
+                            mesh.triangles.resize(2);
+                            mesh.triangles[0].v[0] = { 1, 1 };
+                            mesh.triangles[0].v[1] = { 3, 3 };
+                            mesh.triangles[0].v[2] = { 2, 2 };
+                            mesh.triangles[1].v[0] = { 3, 3 };
+                            mesh.triangles[1].v[1] = { 1, 1 };
+                            mesh.triangles[1].v[2] = { 4, 4 };
+                            p.fillMesh(mesh, V2F(), false, &texture, color, SoftwareBlend::Default);
+                        }
+                    }
+
+                    x += (*glyphIt)->advance;
+                }
+            }
+        }
+    }
+
+    void SoftwareRender::drawImage(
+        const std::shared_ptr<Image>& image,
+        const TriMesh2F& mesh,
+        const Color4F& color,
+        const ImageOptions& imageOptions)
+    {
+        FTK_P();
+
+        const auto& info = image->getInfo();
+        if (!info.isValid())
+            return;
+
+        const auto rgba = p.getTexture(image, imageOptions);
+        p.stats.textureCount += 1;
+
+        SoftwareTexture texture;
+        texture.w = info.size.w;
+        texture.h = info.size.h;
+        texture.data = rgba->getData();
+        texture.filters = imageOptions.imageFilters;
+        texture.mirrorX = info.layout.mirror.x;
+        texture.mirrorY = info.layout.mirror.y;
+
+        SoftwareBlend blend = SoftwareBlend::Straight;
+        switch (imageOptions.alphaBlend)
+        {
+        case AlphaBlend::None: blend = SoftwareBlend::None; break;
+        case AlphaBlend::Premultiplied: blend = SoftwareBlend::Premultiplied; break;
+        default: break;
+        }
+
+        p.fillMesh(mesh, V2F(), false, &texture, color, blend, imageOptions.channelDisplay);
+    }
+
+    void SoftwareRender::drawImage(
+        const std::shared_ptr<Image>& image,
+        const Box2F& box,
+        const Color4F& color,
+        const ImageOptions& imageOptions)
+    {
+        drawImage(image, mesh(box), color, imageOptions);
+    }
+}
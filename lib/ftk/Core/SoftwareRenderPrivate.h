@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/SoftwareRender.h>
+
+#include <chrono>
+#include <list>
+
+namespace ftk
+{
+    //! Software renderer texture. Textures are stored as RGBA_U8 with the
+    //! same row order as the source image.
+    struct SoftwareTexture
+    {
+        int w = 0;
+        int h = 0;
+        const uint8_t* data = nullptr;
+        ImageFilters filters;
+        bool mirrorX = false;
+        bool mirrorY = false;
+    };
+
+    //! Software renderer vertex.
+    struct SoftwareVertex
+    {
+        V2F pos;
+        V2F uv;
+        V4F color;
+    };
+
+    //! Software renderer blending. The default mode matches the OpenGL
+    //! renderer's glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) that is
+    //! used for rectangles, meshes, and text. The other modes match the
+    //! AlphaBlend values.
+    enum class SoftwareBlend
+    {
+        Default,
+        None,
+        Straight,
+        Premultiplied
+    };
+
+    struct SoftwareRender::Private
+    {
+        std::weak_ptr<LogSystem> logSystem;
+        bool textureWarning = false;
+
+        Size2I size;
+        RenderOptions options;
+        Box2I viewport;
+        bool clipRectEnabled = false;
+        Box2I clipRect;
+        M44F transform;
+
+        std::shared_ptr<Image> image;
+        std::shared_ptr<SoftwareImageCache> imageCache;
+
+        //! The clipping rectangle combined with the viewport and the image
+        //! bounds.
+        Box2I clip;
+        void updateClip();
+
+        //! The transform combined with the viewport mapping. Since all of
+        //! the primitives are two-dimensional the matrix is reduced to an
+        //! affine transform.
+        float affine[6] = { 1.F, 0.F, 0.F, 0.F, 1.F, 0.F };
+        bool translateOnly = true;
+        void updateAffine();
+        V2F toPixel(const V2F&) const;
+
+        uint8_t* getRow(int y);
+
+        void fillRect(
+            const Box2F&,
+            const Color4F&);
+        void fillTriangle(
+            const SoftwareVertex&,
+            const SoftwareVertex&,
+            const SoftwareVertex&,
+            bool colors,
+            const SoftwareTexture*,
+            const Color4F&,
+            SoftwareBlend,
+            ChannelDisplay = ChannelDisplay::Color);
+        void fillMesh(
+            const TriMesh2F&,
+            const V2F& pos,
+            bool colors,
+            const SoftwareTexture*,
+            const Color4F&,
+            SoftwareBlend,
+            ChannelDisplay = ChannelDisplay::Color);
+
+        std::shared_ptr<Image> getTexture(
+            const std::shared_ptr<Image>&,
+            const ImageOptions&);
+
+        std::chrono::time_point<std::chrono::steady_clock> startTime;
+        struct Stats
+        {
+            int renderTime = 0;
+            size_t triCount = 0;
+            size_t textureCount = 0;
+            size_t glyphCount = 0;
+        };
+        Stats stats;
+        std::list<Stats> statsList;
+        size_t statsCounter = 0;
+    };
+}
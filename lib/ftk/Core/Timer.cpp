@@ -5,6 +5,7 @@
 
 #include <ftk/Core/Context.h>
 
+#include <algorithm>
 #include <vector>
 
 namespace ftk
@@ -94,6 +95,12 @@ namespace ftk
         return _p->timeout;
     }
 
+    std::chrono::steady_clock::time_point Timer::getDeadline() const
+    {
+        FTK_P();
+        return p.start + p.timeout;
+    }
+
     void Timer::tick()
     {
         FTK_P();
@@ -153,6 +160,29 @@ namespace ftk
         _p->timers.push_back(timer);
     }
 
+    std::chrono::microseconds TimerSystem::getNextTimeout() const
+    {
+        FTK_P();
+        auto out = std::chrono::microseconds::max();
+        const auto now = std::chrono::steady_clock::now();
+        for (const auto& i : p.timers)
+        {
+            if (auto timer = i.lock())
+            {
+                if (timer->isActive())
+                {
+                    const auto deadline = timer->getDeadline();
+                    out = std::min(
+                        out,
+                        deadline > now ?
+                        std::chrono::duration_cast<std::chrono::microseconds>(deadline - now) :
+                        std::chrono::microseconds(0));
+                }
+            }
+        }
+        return out;
+    }
+
     void TimerSystem::tick()
     {
         FTK_P();
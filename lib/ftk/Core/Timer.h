@@ -56,6 +56,9 @@ namespace ftk
         //! Get the timeout.
         const std::chrono::microseconds& getTimeout() const;
 
+        //! Get the time when the timer is due.
+        std::chrono::steady_clock::time_point getDeadline() const;
+
         void tick();
 
     private:
@@ -76,6 +79,10 @@ namespace ftk
 
         void addTimer(const std::shared_ptr<Timer>&);
 
+        //! Get the time until the next active timer is due. If there are
+        //! no active timers then the maximum duration is returned.
+        std::chrono::microseconds getNextTimeout() const;
+
         void tick() override;
         std::chrono::milliseconds getTickTime() const override;
 
@@ -4,6 +4,7 @@
 #include <ftk/GL/OffscreenBuffer.h>
 
 #include <ftk/GL/GL.h>
+#include <ftk/GL/Render.h>
 #include <ftk/GL/Texture.h>
 
 #include <ftk/Core/Error.h>
@@ -359,6 +360,7 @@ namespace ftk
 
         void OffscreenBuffer::bind()
         {
+            flushRender();
             glBindFramebuffer(GL_FRAMEBUFFER, _p->id);
         }
 
@@ -391,6 +393,7 @@ namespace ftk
 
         OffscreenBufferBinding::~OffscreenBufferBinding()
         {
+            flushRender();
             glBindFramebuffer(GL_FRAMEBUFFER, _p->previous);
         }
     }
@@ -131,6 +131,9 @@ namespace ftk
             const OffscreenBufferOptions&);
 
         //! Offscreen buffer binding.
+        //!
+        //! Binding an offscreen buffer, and restoring the previous binding,
+        //! flushes the draw commands of the active renderer.
         class OffscreenBufferBinding
         {
         public:
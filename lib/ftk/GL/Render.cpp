@@ -3,19 +3,255 @@
 
 #include <ftk/GL/RenderPrivate.h>
 
+#include <ftk/GL/Util.h>
+
 #include <ftk/Core/Context.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/LogSystem.h>
 
+#include <algorithm>
+
 namespace ftk
 {
     namespace gl
     {
         namespace
         {
+            const float glyphAtlasDefragmentPercentage = .25F;
+            const size_t glyphIDsPruneMin = 1024;
             const int pboSizeMin = 1024;
             const size_t statsAverageCount = 10;
             const size_t statsTimer = 600; // 60Hz * 10 seconds
+            const size_t vboSizeMin = 1024;
+
+            thread_local Render* activeRender = nullptr;
+
+            void setState(const DrawState& state)
+            {
+                glViewport(
+                    state.viewport.x(),
+                    state.viewport.y(),
+                    state.viewport.w(),
+                    state.viewport.h());
+                if (state.clipRectEnabled)
+                {
+                    glEnable(GL_SCISSOR_TEST);
+                    const Size2I size = state.clipRect.size();
+                    if (size.isValid())
+                    {
+                        glScissor(
+                            state.clipRect.x(),
+                            state.clipRect.y(),
+                            size.w,
+                            size.h);
+                    }
+                    else
+                    {
+                        glScissor(0, 0, 0, 0);
+                    }
+                }
+                else
+                {
+                    glDisable(GL_SCISSOR_TEST);
+                }
+            }
+
+            bool canMerge(const DrawCommand& a, const DrawCommand& b)
+            {
+                bool out =
+                    a.type == b.type &&
+                    a.state == b.state &&
+                    a.offset + a.count == b.offset;
+                if (out)
+                {
+                    switch (a.type)
+                    {
+                    case DrawCommandType::Text:
+                    case DrawCommandType::TextSDF:
+                        out =
+                            a.textureID == b.textureID &&
+                            a.color == b.color;
+                        break;
+                    case DrawCommandType::Texture:
+                        out =
+                            a.textureID == b.textureID &&
+                            a.color == b.color &&
+                            a.alphaBlend == b.alphaBlend;
+                        break;
+                    case DrawCommandType::Image:
+                        out =
+                            a.textures == b.textures &&
+                            a.color == b.color &&
+                            a.imageInfo == b.imageInfo &&
+                            a.imageOptions == b.imageOptions;
+                        break;
+                    default: break;
+                    }
+                }
+                return out;
+            }
+
+            void copyVertices(
+                const std::vector<uint8_t>& data,
+                VBOType type,
+                std::shared_ptr<VBO>& vbo,
+                std::shared_ptr<VAO>& vao)
+            {
+                const size_t size = data.size() / getByteCount(type);
+                if (size > 0)
+                {
+                    if (!vbo || vbo->getSize() < size)
+                    {
+                        size_t vboSize = vbo ? vbo->getSize() : vboSizeMin;
+                        while (vboSize < size)
+                        {
+                            vboSize *= 2;
+                        }
+                        vbo = VBO::create(vboSize, type);
+                        vao.reset();
+                    }
+                    vbo->copy(data, 0, data.size());
+                    if (!vao)
+                    {
+                        vao = VAO::create(type, vbo->getID());
+                    }
+                }
+            }
+        }
+
+        DrawState Render::Private::getCurrentState() const
+        {
+            DrawState out;
+            out.viewport = Box2I(
+                viewport.x(),
+                size.h - viewport.h() - viewport.y(),
+                viewport.w(),
+                viewport.h());
+            out.clipRectEnabled = clipRectEnabled;
+            out.clipRect = Box2I(
+                clipRect.x(),
+                size.h - clipRect.h() - clipRect.y(),
+                clipRect.w(),
+                clipRect.h());
+            out.transform = transform;
+            return out;
+        }
+
+        size_t Render::Private::getState()
+        {
+            if (stateChanged || states.empty())
+            {
+                states.push_back(getCurrentState());
+                stateChanged = false;
+            }
+            return states.size() - 1;
+        }
+
+        void Render::Private::addCommand(const DrawCommand& command)
+        {
+            if (!commands.empty() && canMerge(commands.back(), command))
+            {
+                commands.back().count += command.count;
+            }
+            else
+            {
+                commands.push_back(command);
+            }
+            if (DrawCommandType::Text == command.type ||
+                DrawCommandType::TextSDF == command.type)
+            {
+                textPending = true;
+            }
+        }
+
+        size_t Render::Private::addMeshVertices(
+            const TriMesh2F& mesh,
+            const Color4F& color,
+            const V2F& pos,
+            bool colors)
+        {
+            const size_t byteCount = getByteCount(VBOType::Pos2_F32_Color_F32);
+            const size_t out = meshVertices.size() / byteCount;
+            meshVertices.resize(meshVertices.size() + mesh.triangles.size() * 3 * byteCount);
+            float* pf = reinterpret_cast<float*>(meshVertices.data() + out * byteCount);
+            const size_t vSize = mesh.v.size();
+            const size_t cSize = colors ? mesh.c.size() : 0;
+            for (const auto& tri : mesh.triangles)
+            {
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    const size_t v = tri.v[k].v;
+                    if (v && v <= vSize)
+                    {
+                        pf[0] = mesh.v[v - 1].x + pos.x;
+                        pf[1] = mesh.v[v - 1].y + pos.y;
+                    }
+                    else
+                    {
+                        pf[0] = 0.F;
+                        pf[1] = 0.F;
+                    }
+                    const size_t c = tri.v[k].c;
+                    if (c && c <= cSize)
+                    {
+                        pf[2] = mesh.c[c - 1].x * color.r;
+                        pf[3] = mesh.c[c - 1].y * color.g;
+                        pf[4] = mesh.c[c - 1].z * color.b;
+                        pf[5] = mesh.c[c - 1].w * color.a;
+                    }
+                    else
+                    {
+                        pf[2] = color.r;
+                        pf[3] = color.g;
+                        pf[4] = color.b;
+                        pf[5] = color.a;
+                    }
+                    pf += 6;
+                }
+            }
+            return out;
+        }
+
+        size_t Render::Private::addTextureVertices(const TriMesh2F& mesh)
+        {
+            const size_t byteCount = getByteCount(VBOType::Pos2_F32_UV_U16);
+            const size_t out = textureVertices.size() / byteCount;
+            textureVertices.resize(textureVertices.size() + mesh.triangles.size() * 3 * byteCount);
+            uint8_t* p = textureVertices.data() + out * byteCount;
+            const size_t vSize = mesh.v.size();
+            const size_t tSize = mesh.t.size();
+            for (const auto& tri : mesh.triangles)
+            {
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    const size_t v = tri.v[k].v;
+                    float* pf = reinterpret_cast<float*>(p);
+                    if (v && v <= vSize)
+                    {
+                        pf[0] = mesh.v[v - 1].x;
+                        pf[1] = mesh.v[v - 1].y;
+                    }
+                    else
+                    {
+                        pf[0] = 0.F;
+                        pf[1] = 0.F;
+                    }
+                    const size_t t = tri.v[k].t;
+                    uint16_t* pu16 = reinterpret_cast<uint16_t*>(p + 2 * sizeof(float));
+                    if (t && t <= tSize)
+                    {
+                        pu16[0] = clamp(static_cast<int>(mesh.t[t - 1].x * 65535.F), 0, 65535);
+                        pu16[1] = clamp(static_cast<int>(mesh.t[t - 1].y * 65535.F), 0, 65535);
+                    }
+                    else
+                    {
+                        pu16[0] = 0;
+                        pu16[1] = 0;
+                    }
+                    p += byteCount;
+                }
+            }
+            return out;
         }
 
         void Render::_init(
@@ -39,7 +275,12 @@ namespace ftk
         {}
 
         Render::~Render()
-        {}
+        {
+            if (this == activeRender)
+            {
+                activeRender = _p->prevActiveRender;
+            }
+        }
 
         std::shared_ptr<Render> Render::create(
             const std::shared_ptr<LogSystem>& logSystem,
@@ -52,7 +293,15 @@ namespace ftk
 
         std::shared_ptr<Shader> Render::getShader(const std::string& value)
         {
-            return _p->shaders[value];
+            FTK_P();
+            flush();
+            auto out = p.shaders[value];
+            if (out)
+            {
+                out->bind();
+                out->setUniform("transform.mvp", p.transform);
+            }
+            return out;
         }
 
         const std::shared_ptr<TextureCache>& Render::getTextureCache() const
@@ -60,6 +309,166 @@ namespace ftk
             return _p->textureCache;
         }
 
+        void Render::flush()
+        {
+            FTK_P();
+            if (p.commands.empty())
+                return;
+
+            copyVertices(
+                p.meshVertices,
+                VBOType::Pos2_F32_Color_F32,
+                p.vbos["mesh"],
+                p.vaos["mesh"]);
+            copyVertices(
+                p.textureVertices,
+                VBOType::Pos2_F32_UV_U16,
+                p.vbos["texture"],
+                p.vaos["texture"]);
+
+            const std::shared_ptr<Shader> shaders[] =
+            {
+                p.shaders["colorMesh"],
+                p.shaders["text"],
+                p.shaders["textSDF"],
+                p.shaders["texture"],
+                p.shaders["image"]
+            };
+            const std::shared_ptr<VAO>& meshVAO = p.vaos["mesh"];
+            const std::shared_ptr<VAO>& textureVAO = p.vaos["texture"];
+
+            size_t state = p.states.size();
+            Shader* shader = nullptr;
+            VAO* vao = nullptr;
+            int blend = -2;
+            for (const auto& command : p.commands)
+            {
+                const bool stateChanged = command.state != state;
+                if (stateChanged)
+                {
+                    state = command.state;
+                    setState(p.states[state]);
+                }
+
+                const auto& commandShader = shaders[static_cast<size_t>(command.type)];
+                const bool shaderChanged = commandShader.get() != shader;
+                if (shaderChanged)
+                {
+                    shader = commandShader.get();
+                    shader->bind();
+                }
+                if (stateChanged || shaderChanged)
+                {
+                    shader->setUniform("transform.mvp", p.states[state].transform);
+                }
+
+                // The default blend function (-1) is used for meshes and
+                // text, otherwise the blend function is the alpha blend.
+                int commandBlend = -1;
+                switch (command.type)
+                {
+                case DrawCommandType::Mesh:
+                    if (shaderChanged)
+                    {
+                        shader->setUniform("color", Color4F(1.F, 1.F, 1.F, 1.F));
+                    }
+                    break;
+                case DrawCommandType::Text:
+                case DrawCommandType::TextSDF:
+                    shader->setUniform("color", command.color);
+                    shader->setUniform("textureSampler", 0);
+                    glActiveTexture(static_cast<GLenum>(GL_TEXTURE0));
+                    glBindTexture(GL_TEXTURE_2D, command.textureID);
+                    break;
+                case DrawCommandType::Texture:
+                    shader->setUniform("color", command.color);
+                    shader->setUniform("textureSampler", 0);
+                    glActiveTexture(static_cast<GLenum>(GL_TEXTURE0));
+                    glBindTexture(GL_TEXTURE_2D, command.textureID);
+                    commandBlend = static_cast<int>(command.alphaBlend);
+                    break;
+                case DrawCommandType::Image:
+                {
+                    const auto& info = command.imageInfo;
+                    const auto& imageOptions = command.imageOptions;
+                    _setActiveTextures(info, command.textures);
+                    shader->setUniform("color", command.color);
+                    shader->setUniform("imageType", static_cast<int>(info.type));
+                    shader->setUniform("channelCount", getChannelCount(info.type));
+                    shader->setUniform("channelDisplay", static_cast<int>(imageOptions.channelDisplay));
+                    VideoLevels videoLevels = info.videoLevels;
+                    switch (imageOptions.videoLevels)
+                    {
+                    case InputVideoLevels::FullRange:
+                        videoLevels = VideoLevels::FullRange;
+                        break;
+                    case InputVideoLevels::LegalRange:
+                        videoLevels = VideoLevels::LegalRange;
+                        break;
+                    default: break;
+                    }
+                    shader->setUniform("videoLevels", static_cast<int>(videoLevels));
+                    shader->setUniform("yuvCoefficients", getYUVCoefficients(info.yuvCoefficients));
+                    shader->setUniform("mirrorX", info.layout.mirror.x);
+                    shader->setUniform("mirrorY", info.layout.mirror.y);
+                    switch (info.type)
+                    {
+                    case ImageType::YUV_420P_U8:
+                    case ImageType::YUV_422P_U8:
+                    case ImageType::YUV_444P_U8:
+                    case ImageType::YUV_420P_U16:
+                    case ImageType::YUV_422P_U16:
+                    case ImageType::YUV_444P_U16:
+                        shader->setUniform("textureSampler1", 1);
+                        shader->setUniform("textureSampler2", 2);
+                    default:
+                        shader->setUniform("textureSampler0", 0);
+                        break;
+                    }
+                    commandBlend = static_cast<int>(imageOptions.alphaBlend);
+                    break;
+                }
+                default: break;
+                }
+                if (commandBlend != blend)
+                {
+                    blend = commandBlend;
+                    if (-1 == blend)
+                    {
+                        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                    }
+                    else
+                    {
+                        setAlphaBlend(static_cast<AlphaBlend>(blend));
+                    }
+                }
+
+                VAO* commandVAO = DrawCommandType::Mesh == command.type ?
+                    meshVAO.get() :
+                    textureVAO.get();
+                if (commandVAO != vao)
+                {
+                    vao = commandVAO;
+                    vao->bind();
+                }
+                vao->draw(GL_TRIANGLES, command.offset, command.count);
+                ++p.stats.drawCount;
+            }
+
+            setState(p.getCurrentState());
+            p.states.clear();
+            p.stateChanged = true;
+            p.commands.clear();
+            p.meshVertices.clear();
+            p.textureVertices.clear();
+            p.textPending = false;
+        }
+
+        size_t Render::getDrawCount() const
+        {
+            return _p->stats.drawCount;
+        }
+
         void Render::begin(
             const Size2I& size,
             const RenderOptions& options)
@@ -68,13 +477,29 @@ namespace ftk
 
             p.startTime = std::chrono::steady_clock::now();
             p.stats = Private::Stats();
+            if (activeRender != this)
+            {
+                // Draw the pending commands of the outer render first, so
+                // that they are not drawn over the nested render.
+                if (activeRender)
+                {
+                    activeRender->flush();
+                }
+                p.prevActiveRender = activeRender;
+                activeRender = this;
+            }
             
             p.size = size;
             p.options = options;
             p.textureCache->setMax(options.textureCacheByteCount);
 
+            const size_t glyphAtlasPages = std::min(
+                static_cast<size_t>(std::max(options.glyphAtlasPages, 1)),
+                textureAtlasPagesMax);
             if (!p.glyphAtlas ||
-                (p.glyphAtlas && options.glyphAtlasSize != p.glyphAtlas->getSize()))
+                (p.glyphAtlas &&
+                    (options.glyphAtlasSize != p.glyphAtlas->getSize() ||
+                        glyphAtlasPages != p.glyphAtlas->getMaxPages())))
             {
                 ImageType imageType = ImageType::L_U8;
 #if defined(FTK_API_GLES_2)
@@ -84,7 +509,11 @@ namespace ftk
                 p.glyphAtlas = TextureAtlas::create(
                     options.glyphAtlasSize,
                     imageType,
-                    ImageFilter::Linear);
+                    ImageFilter::Linear,
+                    1,
+                    glyphAtlasPages);
+                p.glyphIDs.clear();
+                p.glyphEvictionCount = 0;
             }
 
             glEnable(GL_CULL_FACE);
@@ -134,12 +563,12 @@ namespace ftk
                     imageFragmentSource());
             }
 
-            p.vbos["rect"] = VBO::create(2 * 3, VBOType::Pos2_F32);
-            p.vaos["rect"] = VAO::create(p.vbos["rect"]->getType(), p.vbos["rect"]->getID());
-            p.vbos["line"] = VBO::create(2 * 3, VBOType::Pos2_F32);
-            p.vaos["line"] = VAO::create(p.vbos["line"]->getType(), p.vbos["line"]->getID());
-            p.vbos["texture"] = gl::VBO::create(2 * 3, gl::VBOType::Pos2_F32_UV_U16);
-            p.vaos["texture"] = gl::VAO::create(p.vbos["texture"]->getType(), p.vbos["texture"]->getID());
+            p.states.clear();
+            p.stateChanged = true;
+            p.commands.clear();
+            p.meshVertices.clear();
+            p.textureVertices.clear();
+            p.textPending = false;
 
             setViewport(Box2I(0, 0, size.w, size.h));
             if (options.clear)
@@ -158,6 +587,43 @@ namespace ftk
         void Render::end()
         {
             FTK_P();
+            flush();
+            if (this == activeRender)
+            {
+                activeRender = p.prevActiveRender;
+                p.prevActiveRender = nullptr;
+            }
+
+            if (p.glyphAtlas)
+            {
+                p.glyphAtlas->defragment(glyphAtlasDefragmentPercentage);
+
+                // Remove the IDs of evicted glyphs.
+                if (p.glyphIDs.size() > p.glyphAtlas->getCount() * 2 + glyphIDsPruneMin)
+                {
+                    for (auto i = p.glyphIDs.begin(); i != p.glyphIDs.end();)
+                    {
+                        if (!p.glyphAtlas->hasItem(i->second))
+                        {
+                            i = p.glyphIDs.erase(i);
+                        }
+                        else
+                        {
+                            ++i;
+                        }
+                    }
+                }
+
+                const size_t evictionCount = p.glyphAtlas->getEvictionCount();
+                p.stats.glyphEvictions = evictionCount - p.glyphEvictionCount;
+                p.glyphEvictionCount = evictionCount;
+                p.stats.glyphAtlasPercentage = p.glyphAtlas->getPercentageUsed() * 100.F;
+                p.stats.glyphAtlasPages = p.glyphAtlas->getPageCount();
+            }
+            if (p.stats.drawCount > 0)
+            {
+                p.stats.batchTriCount = p.stats.triCount / p.stats.drawCount;
+            }
             const auto now = std::chrono::steady_clock::now();
             const auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(now - p.startTime);
             p.stats.renderTime = diff.count();
@@ -184,7 +650,9 @@ namespace ftk
 
         void Render::setRenderSize(const Size2I& value)
         {
-            _p->size = value;
+            FTK_P();
+            p.size = value;
+            p.stateChanged = true;
         }
 
         RenderOptions Render::getRenderOptions() const
@@ -201,6 +669,7 @@ namespace ftk
         {
             FTK_P();
             p.viewport = value;
+            p.stateChanged = true;
             glViewport(
                 value.x(),
                 p.size.h - value.h() - value.y(),
@@ -210,6 +679,7 @@ namespace ftk
 
         void Render::clearViewport(const Color4F& value)
         {
+            flush();
             glClearColor(value.r, value.g, value.b, value.a);
             glClear(GL_COLOR_BUFFER_BIT);
         }
@@ -223,6 +693,7 @@ namespace ftk
         {
             FTK_P();
             p.clipRectEnabled = value;
+            p.stateChanged = true;
             if (p.clipRectEnabled)
             {
                 glEnable(GL_SCISSOR_TEST);
@@ -242,6 +713,7 @@ namespace ftk
         {
             FTK_P();
             p.clipRect = value;
+            p.stateChanged = true;
             const Size2I size = value.size();
             if (size.isValid())
             {
@@ -262,11 +734,7 @@ namespace ftk
         {
             FTK_P();
             p.transform = value;
-            for (auto i : p.shaders)
-            {
-                i.second->bind();
-                i.second->setUniform("transform.mvp", value);
-            }
+            p.stateChanged = true;
         }
 
         std::vector<std::shared_ptr<Texture> > Render::_getTextures(
@@ -284,7 +752,7 @@ namespace ftk
             {
                 auto infoTmp = ImageInfo(info.size, ImageType::L_U8);
                 out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size.w / 2, info.size.h / 2, ImageType::L_U8);
+                infoTmp = ImageInfo((info.size.w + 1) / 2, (info.size.h + 1) / 2, ImageType::L_U8);
                 out.push_back(Texture::create(infoTmp, options));
                 out.push_back(Texture::create(infoTmp, options));
                 break;
@@ -293,7 +761,7 @@ namespace ftk
             {
                 auto infoTmp = ImageInfo(info.size, ImageType::L_U8);
                 out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size.w / 2, info.size.h, ImageType::L_U8);
+                infoTmp = ImageInfo((info.size.w + 1) / 2, info.size.h, ImageType::L_U8);
                 out.push_back(Texture::create(infoTmp, options));
                 out.push_back(Texture::create(infoTmp, options));
                 break;
@@ -311,7 +779,7 @@ namespace ftk
             {
                 auto infoTmp = ImageInfo(info.size, ImageType::L_U16);
                 out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size.w / 2, info.size.h / 2, ImageType::L_U16);
+                infoTmp = ImageInfo((info.size.w + 1) / 2, (info.size.h + 1) / 2, ImageType::L_U16);
                 out.push_back(Texture::create(infoTmp, options));
                 out.push_back(Texture::create(infoTmp, options));
                 break;
@@ -320,7 +788,7 @@ namespace ftk
             {
                 auto infoTmp = ImageInfo(info.size, ImageType::L_U16);
                 out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size.w / 2, info.size.h, ImageType::L_U16);
+                infoTmp = ImageInfo((info.size.w + 1) / 2, info.size.h, ImageType::L_U16);
                 out.push_back(Texture::create(infoTmp, options));
                 out.push_back(Texture::create(infoTmp, options));
                 break;
@@ -359,8 +827,8 @@ namespace ftk
                     textures[0]->copy(image->getData(), textures[0]->getInfo());
                     const std::size_t w = info.size.w;
                     const std::size_t h = info.size.h;
-                    const std::size_t w2 = w / 2;
-                    const std::size_t h2 = h / 2;
+                    const std::size_t w2 = (w + 1) / 2;
+                    const std::size_t h2 = (h + 1) / 2;
                     textures[1]->copy(image->getData() + (w * h), textures[1]->getInfo());
                     textures[2]->copy(image->getData() + (w * h) + (w2 * h2), textures[2]->getInfo());
                 }
@@ -373,7 +841,7 @@ namespace ftk
                     textures[0]->copy(image->getData(), textures[0]->getInfo());
                     const std::size_t w = info.size.w;
                     const std::size_t h = info.size.h;
-                    const std::size_t w2 = w / 2;
+                    const std::size_t w2 = (w + 1) / 2;
                     textures[1]->copy(image->getData() + (w * h), textures[1]->getInfo());
                     textures[2]->copy(image->getData() + (w * h) + (w2 * h), textures[2]->getInfo());
                 }
@@ -398,8 +866,8 @@ namespace ftk
                     textures[0]->copy(image->getData(), textures[0]->getInfo());
                     const std::size_t w = info.size.w;
                     const std::size_t h = info.size.h;
-                    const std::size_t w2 = w / 2;
-                    const std::size_t h2 = h / 2;
+                    const std::size_t w2 = (w + 1) / 2;
+                    const std::size_t h2 = (h + 1) / 2;
                     textures[1]->copy(image->getData() + (w * h) * 2, textures[1]->getInfo());
                     textures[2]->copy(image->getData() + (w * h) * 2 + (w2 * h2) * 2, textures[2]->getInfo());
                 }
@@ -412,7 +880,7 @@ namespace ftk
                     textures[0]->copy(image->getData(), textures[0]->getInfo());
                     const std::size_t w = info.size.w;
                     const std::size_t h = info.size.h;
-                    const std::size_t w2 = w / 2;
+                    const std::size_t w2 = (w + 1) / 2;
                     textures[1]->copy(image->getData() + (w * h) * 2, textures[1]->getInfo());
                     textures[2]->copy(image->getData() + (w * h) * 2 + (w2 * h) * 2, textures[2]->getInfo());
                 }
@@ -534,15 +1002,27 @@ namespace ftk
                 {
                     for (auto i : p.statsList)
                     {
-                        average.renderTime   += i.renderTime;
-                        average.triCount     += i.triCount;
-                        average.textureCount += i.textureCount;
-                        average.glyphCount   += i.glyphCount;
+                        average.renderTime    += i.renderTime;
+                        average.triCount      += i.triCount;
+                        average.textureCount  += i.textureCount;
+                        average.glyphCount    += i.glyphCount;
+                        average.drawCount     += i.drawCount;
+                        average.batchTriCount += i.batchTriCount;
+                        average.glyphAtlasPercentage += i.glyphAtlasPercentage;
+                        average.glyphAtlasPages += i.glyphAtlasPages;
+                        average.glyphEvictions += i.glyphEvictions;
+                        average.glyphReuploads += i.glyphReuploads;
                     }
-                    average.renderTime   /= size;
-                    average.triCount     /= size;
-                    average.textureCount /= size;
-                    average.glyphCount   /= size;
+                    average.renderTime    /= size;
+                    average.triCount      /= size;
+                    average.textureCount  /= size;
+                    average.glyphCount    /= size;
+                    average.drawCount     /= size;
+                    average.batchTriCount /= size;
+                    average.glyphAtlasPercentage /= size;
+                    average.glyphAtlasPages /= size;
+                    average.glyphEvictions /= size;
+                    average.glyphReuploads /= size;
                 }
                 logSystem->print(
                     "ftk::gl::Render",
@@ -551,11 +1031,31 @@ namespace ftk
                         "    Render time:    {0}ms\n"
                         "    Triangle count: {1}\n"
                         "    Texture count:  {2}\n"
-                        "    Glyph count:    {3}").
+                        "    Glyph count:    {3}\n"
+                        "    Draw calls:     {4}\n"
+                        "    Tris per batch: {5}\n"
+                        "    Glyph atlas:    {6}%\n"
+                        "    Atlas pages:    {7}\n"
+                        "    Evictions:      {8}\n"
+                        "    Re-uploads:     {9}").
                         arg(average.renderTime).
                         arg(average.triCount).
                         arg(average.textureCount).
-                        arg(average.glyphCount));
+                        arg(average.glyphCount).
+                        arg(average.drawCount).
+                        arg(average.batchTriCount).
+                        arg(average.glyphAtlasPercentage).
+                        arg(average.glyphAtlasPages).
+                        arg(average.glyphEvictions).
+                        arg(average.glyphReuploads));
+            }
+        }
+
+        void flushRender()
+        {
+            if (activeRender)
+            {
+                activeRender->flush();
             }
         }
     }
@@ -23,6 +23,14 @@ namespace ftk
             std::vector<std::shared_ptr<Texture> > > TextureCache;
         
         //! OpenGL renderer.
+        //!
+        //! Draw calls between begin() and end() are recorded into a command
+        //! list. Consecutive commands that share the same shader, textures,
+        //! and render state are merged, and the list is flushed with one
+        //! streaming vertex buffer per vertex format. The commands are
+        //! flushed by end(), clearViewport(), getShader(), and when an
+        //! offscreen buffer is bound. Call flush() before issuing other
+        //! OpenGL draw calls between begin() and end().
         class Render : public IRender
         {
         protected:
@@ -46,6 +54,12 @@ namespace ftk
             //! Get the texture cache.
             const std::shared_ptr<TextureCache>& getTextureCache() const;
 
+            //! Flush the recorded draw commands.
+            void flush();
+
+            //! Get the number of OpenGL draw calls since begin().
+            size_t getDrawCount() const;
+
             void begin(
                 const Size2I&,
                 const RenderOptions& = RenderOptions()) override;
@@ -120,13 +134,15 @@ namespace ftk
                 const ImageInfo& info,
                 const std::vector<std::shared_ptr<Texture> >&,
                 size_t offset = 0);
-
-            void _drawTextMesh(const TriMesh2F&);
             
             void _log();
 
             FTK_PRIVATE();
         };
+
+        //! Flush the renderer that is currently between begin() and end()
+        //! on this thread, if there is one.
+        void flushRender();
         
         ///@}
     }
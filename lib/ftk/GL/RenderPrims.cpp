@@ -3,8 +3,6 @@
 
 #include <ftk/GL/RenderPrivate.h>
 
-#include <ftk/GL/Util.h>
-
 namespace ftk
 {
     namespace gl
@@ -13,24 +11,7 @@ namespace ftk
             const Box2F& rect,
             const Color4F& color)
         {
-            FTK_P();
-
-            p.shaders["rect"]->bind();
-            p.shaders["rect"]->setUniform("color", color);
-
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-            if (p.vbos["rect"])
-            {
-                const auto mesh = ftk::mesh(rect);
-                p.vbos["rect"]->copy(convert(mesh, p.vbos["rect"]->getType()));
-                p.stats.triCount += mesh.triangles.size();
-            }
-            if (p.vaos["rect"])
-            {
-                p.vaos["rect"]->bind();
-                p.vaos["rect"]->draw(GL_TRIANGLES, 0, p.vbos["rect"]->getSize());
-            }
+            drawMesh(ftk::mesh(rect), color);
         }
 
         void Render::drawRects(
@@ -64,13 +45,6 @@ namespace ftk
             const Color4F& color,
             const LineOptions& options)
         {
-            FTK_P();
-
-            p.shaders["line"]->bind();
-            p.shaders["line"]->setUniform("color", color);
-
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
             const V2F v2 = normalize(v1 - v0);
             const V2F v2CW = perpCW(v2) * options.width / 2.F;
             const V2F v2CCW = perpCCW(v2) * options.width / 2.F;
@@ -81,17 +55,7 @@ namespace ftk
             mesh.v.push_back(v1 + v2CCW);
             mesh.triangles.push_back({ 1, 3, 2 });
             mesh.triangles.push_back({ 3, 1, 4 });
-
-            if (p.vbos["line"])
-            {
-                p.vbos["line"]->copy(convert(mesh, p.vbos["line"]->getType()));
-                p.stats.triCount += mesh.triangles.size();
-            }
-            if (p.vaos["line"])
-            {
-                p.vaos["line"]->bind();
-                p.vaos["line"]->draw(GL_TRIANGLES, 0, p.vbos["line"]->getSize());
-            }
+            drawMesh(mesh, color);
         }
 
         void Render::drawLines(
@@ -131,35 +95,13 @@ namespace ftk
             const size_t size = mesh.triangles.size();
             if (size > 0)
             {
-                p.shaders["mesh"]->bind();
-                const auto transform =
-                    p.transform *
-                    translate(V3F(pos.x, pos.y, 0.F));
-                p.shaders["mesh"]->setUniform("transform.mvp", transform);
-                p.shaders["mesh"]->setUniform("color", color);
-
-                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-                if (!p.vbos["mesh"] || (p.vbos["mesh"] && p.vbos["mesh"]->getSize() < size * 3))
-                {
-                    p.vbos["mesh"] = VBO::create(size * 3, VBOType::Pos2_F32);
-                    p.vaos["mesh"].reset();
-                }
-                if (p.vbos["mesh"])
-                {
-                    p.vbos["mesh"]->copy(convert(mesh, VBOType::Pos2_F32));
-                    p.stats.triCount += mesh.triangles.size();
-                }
-
-                if (!p.vaos["mesh"] && p.vbos["mesh"])
-                {
-                    p.vaos["mesh"] = VAO::create(p.vbos["mesh"]->getType(), p.vbos["mesh"]->getID());
-                }
-                if (p.vaos["mesh"] && p.vbos["mesh"])
-                {
-                    p.vaos["mesh"]->bind();
-                    p.vaos["mesh"]->draw(GL_TRIANGLES, 0, size * 3);
-                }
+                DrawCommand command;
+                command.type = DrawCommandType::Mesh;
+                command.state = p.getState();
+                command.offset = p.addMeshVertices(mesh, color, pos, false);
+                command.count = size * 3;
+                p.addCommand(command);
+                p.stats.triCount += size;
             }
         }
         
@@ -172,35 +114,13 @@ namespace ftk
             const size_t size = mesh.triangles.size();
             if (size > 0)
             {
-                p.shaders["colorMesh"]->bind();
-                const auto transform =
-                    p.transform *
-                    translate(V3F(pos.x, pos.y, 0.F));
-                p.shaders["colorMesh"]->setUniform("transform.mvp", transform);
-                p.shaders["colorMesh"]->setUniform("color", color);
-
-                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-                if (!p.vbos["colorMesh"] || (p.vbos["colorMesh"] && p.vbos["colorMesh"]->getSize() < size * 3))
-                {
-                    p.vbos["colorMesh"] = VBO::create(size * 3, VBOType::Pos2_F32_Color_F32);
-                    p.vaos["colorMesh"].reset();
-                }
-                if (p.vbos["colorMesh"])
-                {
-                    p.vbos["colorMesh"]->copy(convert(mesh, VBOType::Pos2_F32_Color_F32));
-                    p.stats.triCount += mesh.triangles.size();
-                }
-
-                if (!p.vaos["colorMesh"] && p.vbos["colorMesh"])
-                {
-                    p.vaos["colorMesh"] = VAO::create(p.vbos["colorMesh"]->getType(), p.vbos["colorMesh"]->getID());
-                }
-                if (p.vaos["colorMesh"] && p.vbos["colorMesh"])
-                {
-                    p.vaos["colorMesh"]->bind();
-                    p.vaos["colorMesh"]->draw(GL_TRIANGLES, 0, size * 3);
-                }
+                DrawCommand command;
+                command.type = DrawCommandType::Mesh;
+                command.state = p.getState();
+                command.offset = p.addMeshVertices(mesh, color, pos, true);
+                command.count = size * 3;
+                p.addCommand(command);
+                p.stats.triCount += size;
             }
         }
 
@@ -212,24 +132,17 @@ namespace ftk
             AlphaBlend alphaBlend)
         {
             FTK_P();
-            p.shaders["texture"]->bind();
-            p.shaders["texture"]->setUniform("color", color);
-            p.shaders["texture"]->setUniform("textureSampler", 0);
-
-            setAlphaBlend(alphaBlend);
-
-            glActiveTexture(static_cast<GLenum>(GL_TEXTURE0));
-            glBindTexture(GL_TEXTURE_2D, id);
-
-            if (p.vbos["texture"])
-            {
-                p.vbos["texture"]->copy(convert(mesh(rect, flipV), p.vbos["texture"]->getType()));
-            }
-            if (p.vaos["texture"])
-            {
-                p.vaos["texture"]->bind();
-                p.vaos["texture"]->draw(GL_TRIANGLES, 0, p.vbos["texture"]->getSize());
-            }
+            const auto mesh = ftk::mesh(rect, flipV);
+            DrawCommand command;
+            command.type = DrawCommandType::Texture;
+            command.state = p.getState();
+            command.offset = p.addTextureVertices(mesh);
+            command.count = mesh.triangles.size() * 3;
+            command.color = color;
+            command.alphaBlend = alphaBlend;
+            command.textureID = id;
+            p.addCommand(command);
+            p.stats.triCount += mesh.triangles.size();
         }
 
         void Render::drawText(
@@ -240,33 +153,61 @@ namespace ftk
         {
             FTK_P();
 
-            p.shaders["text"]->bind();
-            p.shaders["text"]->setUniform("color", color);
-            p.shaders["text"]->setUniform("textureSampler", 0);
-
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-            glActiveTexture(static_cast<GLenum>(GL_TEXTURE0));
-            glBindTexture(GL_TEXTURE_2D, p.glyphAtlas->getTexture());
-
             size_t glyphCount = 0;
+            size_t sdfGlyphCount = 0;
             for (const auto& glyph : glyphs)
             {
                 if (glyph && glyph->image && glyph->image->isValid())
                 {
-                    ++glyphCount;
+                    ++(glyph->sdf ? sdfGlyphCount : glyphCount);
                 }
             }
-            p.stats.glyphCount += glyphCount;
+            p.stats.glyphCount += glyphCount + sdfGlyphCount;
+            if (sdfGlyphCount > 0 && !p.shaders["textSDF"])
+            {
+                // The SDF shader is only created when it is needed, since
+                // it requires derivatives which are an extension on GLES 2.
+                p.shaders["textSDF"] = Shader::create(
+                    vertexSource(),
+                    textSDFFragmentSource());
+            }
+
+            // Add draw commands for the text meshes and clear them.
+            const size_t pageCount = p.glyphAtlas->getMaxPages();
+            for (auto& meshes : p.textMeshes)
+            {
+                meshes.resize(pageCount);
+            }
+            auto addTextCommands = [&p, pageCount, &color]
+            {
+                const DrawCommandType types[] = { DrawCommandType::Text, DrawCommandType::TextSDF };
+                for (size_t i = 0; i < 2; ++i)
+                {
+                    for (size_t page = 0; page < pageCount; ++page)
+                    {
+                        TriMesh2F& mesh = p.textMeshes[i][page];
+                        if (!mesh.triangles.empty())
+                        {
+                            DrawCommand command;
+                            command.type = types[i];
+                            command.state = p.getState();
+                            command.offset = p.addTextureVertices(mesh);
+                            command.count = mesh.triangles.size() * 3;
+                            command.color = color;
+                            command.textureID = p.glyphAtlas->getTexture(page);
+                            p.addCommand(command);
+                            p.stats.triCount += mesh.triangles.size();
+                        }
+                        mesh.v.clear();
+                        mesh.t.clear();
+                        mesh.triangles.clear();
+                    }
+                }
+            };
 
             int x = 0;
             int y = 0;
             int32_t rsbDeltaPrev = 0;
-            p.textMesh.v.resize(glyphCount * 4);
-            p.textMesh.t.resize(glyphCount * 4);
-            p.textMesh.triangles.resize(glyphCount * 2);
-            size_t v = 0;
-            size_t t = 0;
             Box2I lineRect(p.clipRect.min.x, pos.y, p.clipRect.w(), fontMetrics.lineHeight);
             for (auto glyphIt = glyphs.begin(); glyphIt != glyphs.end(); ++glyphIt)
             {
@@ -275,7 +216,7 @@ namespace ftk
                     if ('\n' == (*glyphIt)->info.code)
                     {
                         auto crIt = glyphIt + 1;
-                        if (crIt != glyphs.end() && '\r' == (*glyphIt)->info.code)
+                        if (crIt != glyphs.end() && *crIt && '\r' == (*crIt)->info.code)
                         {
                             ++glyphIt;
                         }
@@ -284,8 +225,7 @@ namespace ftk
                         rsbDeltaPrev = 0;
                         lineRect = Box2I(p.clipRect.min.x, pos.y + y, p.clipRect.w(), fontMetrics.lineHeight);
                     }
-                    else if (!p.clipRectEnabled ||
-                        p.clipRectEnabled && intersects(p.clipRect, lineRect))
+                    else if (!p.clipRectEnabled || intersects(p.clipRect, lineRect))
                     {
                         if (rsbDeltaPrev - (*glyphIt)->lsbDelta > 32)
                         {
@@ -299,8 +239,15 @@ namespace ftk
 
                         if ((*glyphIt)->image && (*glyphIt)->image->isValid())
                         {
+                            // SDF glyphs of all sizes share the atlas item of
+                            // the size independent glyph.
+                            const GlyphInfo& info = (*glyphIt)->info;
+                            const bool sdf = (*glyphIt)->sdf;
+                            const uint64_t key = sdf ?
+                                GlyphInfo(info.code, info.fontID, 0).getKey() :
+                                info.getKey();
                             BoxPackID id = boxPackInvalidID;
-                            const auto j = p.glyphIDs.find((*glyphIt)->info);
+                            const auto j = p.glyphIDs.find(key);
                             if (j != p.glyphIDs.end())
                             {
                                 id = j->second;
@@ -309,54 +256,89 @@ namespace ftk
                             if (boxPackInvalidID == id ||
                                 !p.glyphAtlas->getItem(id, item))
                             {
-                                p.glyphAtlas->addItem((*glyphIt)->image, item);
-                                p.glyphIDs[(*glyphIt)->info] = item.id;
+                                if (id != boxPackInvalidID)
+                                {
+                                    ++p.stats.glyphReuploads;
+                                }
+                                if (!p.glyphAtlas->addItem((*glyphIt)->image, item, false))
+                                {
+                                    // Adding the glyph evicts other glyphs,
+                                    // which may be used by the pending text
+                                    // commands or by the glyphs of this
+                                    // string that have already been added,
+                                    // so draw them first.
+                                    addTextCommands();
+                                    if (p.textPending)
+                                    {
+                                        flush();
+                                    }
+                                    p.glyphAtlas->addItem((*glyphIt)->image, item);
+                                }
+                                p.glyphIDs[key] = item.id;
                             }
 
                             const V2I& offset = (*glyphIt)->offset;
                             //! \bug Off by one?
                             const int extraOffset = 1;
-                            const Box2I box(
-                                pos.x + x + offset.x,
-                                pos.y + y + fontMetrics.ascender - offset.y - extraOffset,
-                                (*glyphIt)->image->getWidth(),
-                                (*glyphIt)->image->getHeight());
-                            const V2I& min = box.min;
-                            const V2I& max = box.max;
-
-                            p.textMesh.v[v + 0].x = min.x;
-                            p.textMesh.v[v + 0].y = min.y;
-                            p.textMesh.v[v + 1].x = max.x + 1;
-                            p.textMesh.v[v + 1].y = min.y;
-                            p.textMesh.v[v + 2].x = max.x + 1;
-                            p.textMesh.v[v + 2].y = max.y + 1;
-                            p.textMesh.v[v + 3].x = min.x;
-                            p.textMesh.v[v + 3].y = max.y + 1;
-                            p.textMesh.t[v + 0].x = item.u.min();
-                            p.textMesh.t[v + 0].y = item.v.min();
-                            p.textMesh.t[v + 1].x = item.u.max();
-                            p.textMesh.t[v + 1].y = item.v.min();
-                            p.textMesh.t[v + 2].x = item.u.max();
-                            p.textMesh.t[v + 2].y = item.v.max();
-                            p.textMesh.t[v + 3].x = item.u.min();
-                            p.textMesh.t[v + 3].y = item.v.max();
-
-                            p.textMesh.triangles[t + 0].v[0] = { v + 1, v + 1 };
-                            p.textMesh.triangles[t + 0].v[1] = { v + 3, v + 3 };
-                            p.textMesh.triangles[t + 0].v[2] = { v + 2, v + 2 };
-                            p.textMesh.triangles[t + 1].v[0] = { v + 3, v + 3 };
-                            p.textMesh.triangles[t + 1].v[1] = { v + 1, v + 1 };
-                            p.textMesh.triangles[t + 1].v[2] = { v + 4, v + 4 };
+                            V2F min;
+                            V2F max;
+                            if (sdf)
+                            {
+                                const float scale = (*glyphIt)->imageScale;
+                                min.x = pos.x + x + offset.x * scale;
+                                min.y = pos.y + y + fontMetrics.ascender - offset.y * scale - extraOffset;
+                                max.x = min.x + (*glyphIt)->image->getWidth() * scale;
+                                max.y = min.y + (*glyphIt)->image->getHeight() * scale;
+                            }
+                            else
+                            {
+                                const Box2I box(
+                                    pos.x + x + offset.x,
+                                    pos.y + y + fontMetrics.ascender - offset.y - extraOffset,
+                                    (*glyphIt)->image->getWidth(),
+                                    (*glyphIt)->image->getHeight());
+                                min.x = box.min.x;
+                                min.y = box.min.y;
+                                max.x = box.max.x + 1;
+                                max.y = box.max.y + 1;
+                            }
 
-                            v += 4;
-                            t += 2;
+                            TriMesh2F& mesh = p.textMeshes[sdf][item.page];
+                            const size_t mv = mesh.v.size();
+                            const size_t mt = mesh.triangles.size();
+                            mesh.v.resize(mv + 4);
+                            mesh.t.resize(mv + 4);
+                            mesh.triangles.resize(mt + 2);
+                            mesh.v[mv + 0].x = min.x;
+                            mesh.v[mv + 0].y = min.y;
+                            mesh.v[mv + 1].x = max.x;
+                            mesh.v[mv + 1].y = min.y;
+                            mesh.v[mv + 2].x = max.x;
+                            mesh.v[mv + 2].y = max.y;
+                            mesh.v[mv + 3].x = min.x;
+                            mesh.v[mv + 3].y = max.y;
+                            mesh.t[mv + 0].x = item.u.min();
+                            mesh.t[mv + 0].y = item.v.min();
+                            mesh.t[mv + 1].x = item.u.max();
+                            mesh.t[mv + 1].y = item.v.min();
+                            mesh.t[mv + 2].x = item.u.max();
+                            mesh.t[mv + 2].y = item.v.max();
+                            mesh.t[mv + 3].x = item.u.min();
+                            mesh.t[mv + 3].y = item.v.max();
+
+                            mesh.triangles[mt + 0].v[0] = { mv + 1, mv + 1 };
+                            mesh.triangles[mt + 0].v[1] = { mv + 3, mv + 3 };
+                            mesh.triangles[mt + 0].v[2] = { mv + 2, mv + 2 };
+                            mesh.triangles[mt + 1].v[0] = { mv + 3, mv + 3 };
+                            mesh.triangles[mt + 1].v[1] = { mv + 1, mv + 1 };
+                            mesh.triangles[mt + 1].v[2] = { mv + 4, mv + 4 };
                         }
 
                         x += (*glyphIt)->advance;
                     }
                 }
             }
-            _drawTextMesh(p.textMesh);
+            addTextCommands();
         }
 
         void Render::drawImage(
@@ -383,66 +365,30 @@ namespace ftk
                 _copyTextures(image, textures);
                 p.textureCache->add(image, textures, image->getByteCount());
             }
-            _setActiveTextures(info, textures);
             p.stats.textureCount += textures.size();
 
-            p.shaders["image"]->bind();
-            p.shaders["image"]->setUniform("color", color);
-            p.shaders["image"]->setUniform("imageType", static_cast<int>(info.type));
-            p.shaders["image"]->setUniform("channelCount", getChannelCount(info.type));
-            p.shaders["image"]->setUniform("channelDisplay", static_cast<int>(imageOptions.channelDisplay));
-            VideoLevels videoLevels = info.videoLevels;
-            switch (imageOptions.videoLevels)
-            {
-            case InputVideoLevels::FullRange:
-                videoLevels = VideoLevels::FullRange;
-                break;
-            case InputVideoLevels::LegalRange:
-                videoLevels = VideoLevels::LegalRange;
-                break;
-            default: break;
-            }
-            p.shaders["image"]->setUniform("videoLevels", static_cast<int>(videoLevels));
-            p.shaders["image"]->setUniform("yuvCoefficients", getYUVCoefficients(info.yuvCoefficients));
-            p.shaders["image"]->setUniform("mirrorX", info.layout.mirror.x);
-            p.shaders["image"]->setUniform("mirrorY", info.layout.mirror.y);
-            switch (info.type)
-            {
-            case ImageType::YUV_420P_U8:
-            case ImageType::YUV_422P_U8:
-            case ImageType::YUV_444P_U8:
-            case ImageType::YUV_420P_U16:
-            case ImageType::YUV_422P_U16:
-            case ImageType::YUV_444P_U16:
-                p.shaders["image"]->setUniform("textureSampler1", 1);
-                p.shaders["image"]->setUniform("textureSampler2", 2);
-            default:
-                p.shaders["image"]->setUniform("textureSampler0", 0);
-                break;
-            }
-
-            setAlphaBlend(imageOptions.alphaBlend);
-
             const size_t size = mesh.triangles.size();
-            if (!p.vbos["image"] || (p.vbos["image"] && p.vbos["image"]->getSize() < size * 3))
-            {
-                p.vbos["image"] = VBO::create(size * 3, VBOType::Pos2_F32_UV_U16);
-                p.vaos["image"].reset();
-            }
-            if (p.vbos["image"])
+            if (size > 0)
             {
-                p.vbos["image"]->copy(convert(mesh, VBOType::Pos2_F32_UV_U16));
-                p.stats.triCount += mesh.triangles.size();
+                DrawCommand command;
+                command.type = DrawCommandType::Image;
+                command.state = p.getState();
+                command.offset = p.addTextureVertices(mesh);
+                command.count = size * 3;
+                command.color = color;
+                command.alphaBlend = imageOptions.alphaBlend;
+                command.textures = textures;
+                command.imageInfo = info;
+                command.imageOptions = imageOptions;
+                p.addCommand(command);
+                p.stats.triCount += size;
             }
 
-            if (!p.vaos["image"] && p.vbos["image"])
-            {
-                p.vaos["image"] = VAO::create(p.vbos["image"]->getType(), p.vbos["image"]->getID());
-            }
-            if (p.vaos["image"] && p.vbos["image"])
+            // Textures that are not cached are flushed immediately so they
+            // are not kept alive until the end of the frame.
+            if (!imageOptions.cache)
             {
-                p.vaos["image"]->bind();
-                p.vaos["image"]->draw(GL_TRIANGLES, 0, size * 3);
+                flush();
             }
         }
 
@@ -454,34 +400,5 @@ namespace ftk
         {
             drawImage(image, mesh(box), color, imageOptions);
         }
-
-        void Render::_drawTextMesh(const TriMesh2F& mesh)
-        {
-            FTK_P();
-            const size_t size = mesh.triangles.size();
-            if (size > 0)
-            {
-                if (!p.vbos["text"] || (p.vbos["text"] && p.vbos["text"]->getSize() < size * 3))
-                {
-                    p.vbos["text"] = VBO::create(size * 3, VBOType::Pos2_F32_UV_U16);
-                    p.vaos["text"].reset();
-                }
-                if (p.vbos["text"])
-                {
-                    p.vbos["text"]->copy(convert(mesh, p.vbos["text"]->getType()));
-                    p.stats.triCount += mesh.triangles.size();
-                }
-                if (!p.vaos["text"] && p.vbos["text"])
-                {
-                    p.vaos["text"] = VAO::create(p.vbos["text"]->getType(), p.vbos["text"]->getID());
-                }
-                if (p.vaos["text"] && p.vbos["text"])
-                {
-                    p.vaos["text"]->bind();
-                    p.vaos["text"]->draw(GL_TRIANGLES, 0, size * 3);
-                }
-            }
-        }
     }
 }
-
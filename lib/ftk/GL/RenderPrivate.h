@@ -8,9 +8,12 @@
 #include <ftk/GL/Shader.h>
 #include <ftk/GL/TextureAtlas.h>
 
+#include <array>
 #include <chrono>
 #include <list>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace ftk
 {
@@ -22,8 +25,45 @@ namespace ftk
         std::string colorMeshFragmentSource();
         std::string textureFragmentSource();
         std::string textFragmentSource();
+        std::string textSDFFragmentSource();
         std::string imageFragmentSource();
 
+        //! Draw command types.
+        enum class DrawCommandType
+        {
+            Mesh,
+            Text,
+            TextSDF,
+            Texture,
+            Image
+        };
+
+        //! Draw state. The viewport and clipping rectangle are stored in
+        //! OpenGL window coordinates.
+        struct DrawState
+        {
+            Box2I viewport;
+            bool clipRectEnabled = false;
+            Box2I clipRect;
+            M44F transform;
+        };
+
+        //! Draw command. Consecutive primitives that share the same shader,
+        //! textures, and state are merged into a single command.
+        struct DrawCommand
+        {
+            DrawCommandType type = DrawCommandType::Mesh;
+            size_t state = 0;
+            size_t offset = 0;
+            size_t count = 0;
+            Color4F color;
+            AlphaBlend alphaBlend = AlphaBlend::Straight;
+            unsigned int textureID = 0;
+            std::vector<std::shared_ptr<Texture> > textures;
+            ImageInfo imageInfo;
+            ImageOptions imageOptions;
+        };
+
         struct Render::Private
         {
             std::weak_ptr<LogSystem> logSystem;
@@ -38,11 +78,39 @@ namespace ftk
             std::map<std::string, std::shared_ptr<gl::Shader> > shaders;
             std::shared_ptr<TextureCache> textureCache;
             std::shared_ptr<gl::TextureAtlas> glyphAtlas;
-            std::map<GlyphInfo, BoxPackID> glyphIDs;
-            TriMesh2F textMesh;
+            std::unordered_map<uint64_t, BoxPackID> glyphIDs;
+            size_t glyphEvictionCount = 0;
+
+            //! Text meshes for each glyph atlas page, indexed by whether
+            //! the glyphs are SDF.
+            std::array<std::vector<TriMesh2F>, 2> textMeshes;
             std::map<std::string, std::shared_ptr<gl::VBO> > vbos;
             std::map<std::string, std::shared_ptr<gl::VAO> > vaos;
 
+            //! Recorded draw commands. Mesh commands use the vertex format
+            //! VBOType::Pos2_F32_Color_F32, and text, texture, and image
+            //! commands use the vertex format VBOType::Pos2_F32_UV_U16.
+            std::vector<DrawState> states;
+            bool stateChanged = true;
+            //! The renderer that was active when begin() was called, so that
+            //! nested renders can restore it.
+            Render* prevActiveRender = nullptr;
+
+            std::vector<DrawCommand> commands;
+            std::vector<uint8_t> meshVertices;
+            std::vector<uint8_t> textureVertices;
+            bool textPending = false;
+
+            DrawState getCurrentState() const;
+            size_t getState();
+            void addCommand(const DrawCommand&);
+            size_t addMeshVertices(
+                const TriMesh2F&,
+                const Color4F&,
+                const V2F& pos,
+                bool colors);
+            size_t addTextureVertices(const TriMesh2F&);
+
             std::chrono::time_point<std::chrono::steady_clock> startTime;
             struct Stats
             {
@@ -50,6 +118,12 @@ namespace ftk
                 size_t triCount = 0;
                 size_t textureCount = 0;
                 size_t glyphCount = 0;
+                size_t drawCount = 0;
+                size_t batchTriCount = 0;
+                float glyphAtlasPercentage = 0.F;
+                size_t glyphAtlasPages = 0;
+                size_t glyphEvictions = 0;
+                size_t glyphReuploads = 0;
             };
             Stats stats;
             std::list<Stats> statsList;
@@ -57,4 +131,3 @@ namespace ftk
         };
     }
 }
-
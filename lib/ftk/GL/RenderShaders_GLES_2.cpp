@@ -122,6 +122,29 @@ namespace ftk
                 "}\n";
         }
 
+        std::string textSDFFragmentSource()
+        {
+            return
+                "#extension GL_OES_standard_derivatives : enable\n"
+                "\n"
+                "precision mediump float;\n"
+                "\n"
+                "varying vec2 fTexture;\n"
+                "\n"
+                "uniform vec4 color;\n"
+                "uniform sampler2D textureSampler;\n"
+                "\n"
+                "void main()\n"
+                "{\n"
+                "    float d = texture2D(textureSampler, fTexture).r;\n"
+                "    float w = max(fwidth(d) * 0.7, 0.001);\n"
+                "    gl_FragColor.r = color.r;\n"
+                "    gl_FragColor.g = color.g;\n"
+                "    gl_FragColor.b = color.b;\n"
+                "    gl_FragColor.a = color.a * smoothstep(0.5 - w, 0.5 + w, d);\n"
+                "}\n";
+        }
+
         namespace
         {
             const std::string imageType =
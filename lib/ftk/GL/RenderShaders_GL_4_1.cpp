@@ -126,6 +126,28 @@ namespace ftk
                 "}\n";
         }
 
+        std::string textSDFFragmentSource()
+        {
+            return
+                "#version 410\n"
+                "\n"
+                "in vec2 fTexture;\n"
+                "out vec4 outColor;\n"
+                "\n"
+                "uniform vec4 color;\n"
+                "uniform sampler2D textureSampler;\n"
+                "\n"
+                "void main()\n"
+                "{\n"
+                "    float d = texture(textureSampler, fTexture).r;\n"
+                "    float w = max(fwidth(d) * 0.7, 0.001);\n"
+                "    outColor.r = color.r;\n"
+                "    outColor.g = color.g;\n"
+                "    outColor.b = color.b;\n"
+                "    outColor.a = color.a * smoothstep(0.5 - w, 0.5 + w, d);\n"
+                "}\n";
+        }
+
         namespace
         {
             const std::string imageType =
@@ -8,37 +8,71 @@
 #include <ftk/Core/Assert.h>
 #include <ftk/Core/BoxPack.h>
 
-#include <map>
+#include <algorithm>
 
 namespace ftk
 {
     namespace gl
     {
+        namespace
+        {
+            const int pageBits = 8;
+
+            BoxPackID toID(size_t page, BoxPackID id)
+            {
+                return (id << pageBits) | static_cast<BoxPackID>(page);
+            }
+
+            size_t toPage(BoxPackID id)
+            {
+                return static_cast<size_t>(id & ((1 << pageBits) - 1));
+            }
+
+            BoxPackID toNodeID(BoxPackID id)
+            {
+                return id >> pageBits;
+            }
+        }
+
         struct TextureAtlas::Private
         {
             int size = 0;
             ImageType type = ImageType::None;
+            ImageFilter filter = ImageFilter::Linear;
             int border = 0;
-            std::shared_ptr<Texture> texture;
-            std::shared_ptr<BoxPack> boxPack;
+
+            //! The box packs are kept when a page is released so that the
+            //! IDs are not reused.
+            struct Page
+            {
+                std::shared_ptr<Texture> texture;
+                std::shared_ptr<BoxPack> boxPack;
+                uint64_t timestamp = 0;
+            };
+            std::vector<Page> pages;
+            uint64_t timestamp = 0;
+            size_t evictionCount = 0;
         };
 
         void TextureAtlas::_init(
             int size,
             ImageType type,
             ImageFilter filter,
-            int border)
+            int border,
+            size_t maxPages)
         {
             FTK_P();
 
             p.size = size;
             p.type = type;
+            p.filter = filter;
             p.border = border;
-            TextureOptions textureOptions;
-            textureOptions.filters.minify = filter;
-            textureOptions.filters.magnify = filter;
-            p.texture = Texture::create(ImageInfo(size, size, type), textureOptions);
-            p.boxPack = BoxPack::create(Size2I(size, size), border);
+            p.pages.resize(std::min(std::max(maxPages, size_t(1)), textureAtlasPagesMax));
+            for (auto& page : p.pages)
+            {
+                page.boxPack = BoxPack::create(Size2I(size, size), border);
+            }
+            _addPage(0);
         }
 
         TextureAtlas::TextureAtlas() :
@@ -52,10 +86,11 @@ namespace ftk
             int textureSize,
             ImageType textureType,
             ImageFilter filter,
-            int border)
+            int border,
+            size_t maxPages)
         {
             auto out = std::shared_ptr<TextureAtlas>(new TextureAtlas);
-            out->_init(textureSize, textureType, filter, border);
+            out->_init(textureSize, textureType, filter, border, maxPages);
             return out;
         }
 
@@ -69,48 +104,153 @@ namespace ftk
             return _p->type;
         }
 
-        unsigned int TextureAtlas::getTexture() const
+        size_t TextureAtlas::getMaxPages() const
         {
-            return _p->texture->getID();
+            return _p->pages.size();
+        }
+
+        size_t TextureAtlas::getPageCount() const
+        {
+            FTK_P();
+            size_t out = 0;
+            for (const auto& page : p.pages)
+            {
+                out += page.texture ? 1 : 0;
+            }
+            return out;
+        }
+
+        unsigned int TextureAtlas::getTexture(size_t page) const
+        {
+            FTK_P();
+            return page < p.pages.size() && p.pages[page].texture ?
+                p.pages[page].texture->getID() :
+                0;
         }
 
         bool TextureAtlas::getItem(BoxPackID id, TextureAtlasItem& item)
         {
             FTK_P();
             bool out = false;
-            if (auto node = p.boxPack->getNode(id))
+            const size_t page = toPage(id);
+            if (page < p.pages.size())
             {
-                _toItem(node, item);
-                out = true;
+                if (auto node = p.pages[page].boxPack->getNode(toNodeID(id)))
+                {
+                    p.pages[page].timestamp = ++p.timestamp;
+                    _toItem(page, node, item);
+                    out = true;
+                }
             }
             return out;
         }
 
+        bool TextureAtlas::hasItem(BoxPackID id) const
+        {
+            FTK_P();
+            const size_t page = toPage(id);
+            return page < p.pages.size() &&
+                p.pages[page].boxPack->hasNode(toNodeID(id));
+        }
+
         bool TextureAtlas::addItem(
             const std::shared_ptr<Image>& image,
-            TextureAtlasItem& item)
+            TextureAtlasItem& item,
+            bool evict)
         {
             FTK_P();
             bool out = false;
-            if (auto node = p.boxPack->insert(image->getSize() + p.border * 2))
+            const Size2I size = image->getSize() + p.border * 2;
+
+            // Try the allocated pages from the most recently used without
+            // evicting any items.
+            std::vector<size_t> pages;
+            for (size_t i = 0; i < p.pages.size(); ++i)
+            {
+                if (p.pages[i].texture)
+                {
+                    pages.push_back(i);
+                }
+            }
+            std::sort(
+                pages.begin(),
+                pages.end(),
+                [&p](size_t a, size_t b)
+                {
+                    return p.pages[a].timestamp > p.pages[b].timestamp;
+                });
+            std::shared_ptr<BoxPackNode> node;
+            size_t page = 0;
+            for (size_t i = 0; i < pages.size() && !node; ++i)
+            {
+                page = pages[i];
+                node = p.pages[page].boxPack->insert(size, false);
+            }
+
+            // Allocate a new page.
+            if (!node)
+            {
+                for (size_t i = 0; i < p.pages.size(); ++i)
+                {
+                    if (!p.pages[i].texture)
+                    {
+                        page = i;
+                        _addPage(page);
+                        node = p.pages[page].boxPack->insert(size, false);
+                        break;
+                    }
+                }
+            }
+
+            // Evict the least recently used items of the least recently
+            // used page. If the page is too fragmented, all of the items
+            // are evicted.
+            if (!node && evict && !pages.empty())
+            {
+                page = pages.back();
+                const auto& boxPack = p.pages[page].boxPack;
+                const size_t count = boxPack->getCount();
+                node = boxPack->insert(size, true);
+                if (!node)
+                {
+                    boxPack->clear();
+                    node = boxPack->insert(size, false);
+                }
+                p.evictionCount += count + (node ? 1 : 0) - boxPack->getCount();
+            }
+
+            if (node)
             {
                 out = true;
 
+                auto& texture = p.pages[page].texture;
                 auto zero = Image::create(
                     node->box.size(),
                     p.type);
                 zero->zero();
-                p.texture->copy(
+                texture->copy(
                     zero,
                     node->box.min.x,
                     node->box.min.y);
 
-                p.texture->copy(
+                texture->copy(
                     image,
                     node->box.min.x + p.border,
                     node->box.min.y + p.border);
 
-                _toItem(node, item);
+                p.pages[page].timestamp = ++p.timestamp;
+                _toItem(page, node, item);
+            }
+            return out;
+        }
+
+        size_t TextureAtlas::getCount() const
+        {
+            FTK_P();
+            size_t out = 0;
+            for (const auto& page : p.pages)
+            {
+                out += page.boxPack->getCount();
             }
             return out;
         }
@@ -118,23 +258,67 @@ namespace ftk
         float TextureAtlas::getPercentageUsed() const
         {
             FTK_P();
-            float area = 0.F;
-            for (const auto node : p.boxPack->getNodes())
+            int64_t area = 0;
+            size_t count = 0;
+            for (const auto& page : p.pages)
             {
-                if (node->id != boxPackInvalidID)
+                if (page.texture)
                 {
-                    area += ftk::area(node->box.size());
+                    area += page.boxPack->getUsedArea();
+                    ++count;
                 }
             }
-            return area / static_cast<float>(p.size * p.size);
+            return count > 0 ?
+                (area / static_cast<float>(count * p.size * p.size)) :
+                0.F;
+        }
+
+        size_t TextureAtlas::getEvictionCount() const
+        {
+            return _p->evictionCount;
+        }
+
+        void TextureAtlas::defragment(float percentage)
+        {
+            FTK_P();
+            if (getPageCount() > 1 && getPercentageUsed() < percentage)
+            {
+                size_t page = p.pages.size();
+                for (size_t i = 0; i < p.pages.size(); ++i)
+                {
+                    if (p.pages[i].texture &&
+                        (page == p.pages.size() ||
+                            p.pages[i].timestamp < p.pages[page].timestamp))
+                    {
+                        page = i;
+                    }
+                }
+                p.evictionCount += p.pages[page].boxPack->getCount();
+                p.pages[page].boxPack->clear();
+                p.pages[page].texture.reset();
+            }
+        }
+
+        void TextureAtlas::_addPage(size_t page)
+        {
+            FTK_P();
+            TextureOptions textureOptions;
+            textureOptions.filters.minify = p.filter;
+            textureOptions.filters.magnify = p.filter;
+            p.pages[page].texture = Texture::create(
+                ImageInfo(p.size, p.size, p.type),
+                textureOptions);
+            p.pages[page].timestamp = ++p.timestamp;
         }
 
         void TextureAtlas::_toItem(
+            size_t page,
             const std::shared_ptr<BoxPackNode>& node,
             TextureAtlasItem& out)
         {
             FTK_P();
-            out.id = node->id;
+            out.id = toID(page, node->id);
+            out.page = page;
             out.u = RangeF(
                 (node->box.min.x + p.border) / static_cast<float>(p.size),
                 (node->box.max.x - 1 - p.border) / static_cast<float>(p.size));
@@ -21,11 +21,19 @@ namespace ftk
         {
             BoxPackID id = boxPackInvalidID;
             Size2I size;
+            size_t page = 0;
             RangeF u;
             RangeF v;
         };
 
+        //! Maximum number of texture atlas pages.
+        const size_t textureAtlasPagesMax = 256;
+
         //! Texture atlas.
+        //!
+        //! The atlas is made of pages, each page is a texture. Pages are
+        //! added as needed up to the maximum page count. When all of the
+        //! pages are full, items on the least recently used page are evicted.
         class TextureAtlas : public std::enable_shared_from_this<TextureAtlas>
         {
             FTK_NON_COPYABLE(TextureAtlas);
@@ -35,7 +43,8 @@ namespace ftk
                 int size,
                 ImageType,
                 ImageFilter,
-                int border);
+                int border,
+                size_t maxPages);
 
             TextureAtlas();
 
@@ -47,28 +56,59 @@ namespace ftk
                 int size,
                 ImageType,
                 ImageFilter = ImageFilter::Linear,
-                int border = 1);
+                int border = 1,
+                size_t maxPages = 1);
 
-            //! Get the texture atlas size.
+            //! Get the texture atlas page size.
             int getSize() const;
 
             //! Get the texture atlas type.
             ImageType getType() const;
 
-            //! Get the texture atlas ID.
-            unsigned int getTexture() const;
+            //! Get the maximum number of pages.
+            size_t getMaxPages() const;
+
+            //! Get the number of pages that are allocated.
+            size_t getPageCount() const;
+
+            //! Get the texture ID of a page. Zero is returned for pages
+            //! that are not allocated.
+            unsigned int getTexture(size_t page = 0) const;
 
             //! Get a texture atlas item.
             bool getItem(BoxPackID, TextureAtlasItem&);
 
-            //! Add a texture atlas item.
-            bool addItem(const std::shared_ptr<Image>&, TextureAtlasItem&);
+            //! Get whether a texture atlas item exists.
+            bool hasItem(BoxPackID) const;
+
+            //! Add a texture atlas item. If evict is false and there is no
+            //! room for the item without evicting other items, false is
+            //! returned and the atlas is not changed.
+            bool addItem(
+                const std::shared_ptr<Image>&,
+                TextureAtlasItem&,
+                bool evict = true);
 
-            //! Get the percentage of the texture atlas that is in use.
+            //! Get the number of items.
+            size_t getCount() const;
+
+            //! Get the percentage of the allocated pages that is in use.
             float getPercentageUsed() const;
 
+            //! Get the total number of items that have been evicted.
+            size_t getEvictionCount() const;
+
+            //! Release the least recently used page if more than one page is
+            //! allocated and the percentage in use is less than the given
+            //! value. The items on the page are evicted.
+            void defragment(float percentage);
+
         private:
-            void _toItem(const std::shared_ptr<BoxPackNode>&, TextureAtlasItem&);
+            void _addPage(size_t);
+            void _toItem(
+                size_t page,
+                const std::shared_ptr<BoxPackNode>&,
+                TextureAtlasItem&);
 
             FTK_PRIVATE();
         };
@@ -164,6 +164,20 @@ namespace ftk
         //! Set whether tooltips are enabled.
         void setTooltipsEnabled(bool);
 
+        //! Get whether idle mode is enabled.
+        bool isIdleEnabled() const;
+
+        //! Set whether idle mode is enabled. In idle mode the event loop
+        //! blocks until an event arrives, a timer is due, or wakeup() is
+        //! called, instead of polling. The event loop does not block while
+        //! there are size or draw updates pending, or visible widgets with
+        //! tick events enabled, and it polls the systems while they have
+        //! asynchronous work in progress (see ISystem::hasPendingWork()).
+        void setIdleEnabled(bool);
+
+        //! Wake up the event loop. This function is thread safe.
+        void wakeup();
+
         //! Exit the application.
         virtual void exit();
 
@@ -176,11 +190,7 @@ namespace ftk
         virtual void _tick() {}
 
     private:
-        void _tickRecursive(
-            const std::shared_ptr<IWidget>&,
-            bool visible,
-            bool enabled,
-            const TickEvent&);
+        int _getIdleTimeout() const;
 
         void _monitorsUpdate();
         void _styleUpdate();
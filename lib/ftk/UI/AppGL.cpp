@@ -15,6 +15,7 @@
 #include <ftk/Core/Error.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/LogSystem.h>
+#include <ftk/Core/RasterCache.h>
 #include <ftk/Core/String.h>
 #include <ftk/Core/Time.h>
 #include <ftk/Core/Timer.h>
@@ -29,6 +30,8 @@ namespace ftk
     namespace
     {
         const std::chrono::milliseconds timeout(5);
+        const std::chrono::milliseconds idleTimeoutMax(1000);
+        const std::chrono::milliseconds idlePollTimeout(5);
     }
 
     bool MonitorInfo::operator == (const MonitorInfo& other) const
@@ -90,9 +93,12 @@ namespace ftk
             std::shared_ptr<CmdLineFlagOption> exit;
             std::shared_ptr<CmdLineValueOption<float> > displayScale;
             std::shared_ptr<CmdLineValueOption<ColorStyle> > colorStyle;
+            std::shared_ptr<CmdLineValueOption<std::string> > rasterCache;
         };
         CmdLine cmdLine;
 
+        std::shared_ptr<RasterCache> rasterCache;
+
         std::shared_ptr<ObservableList<MonitorInfo> > monitors;
         std::shared_ptr<FontSystem> fontSystem;
         std::shared_ptr<IconSystem> iconSystem;
@@ -103,11 +109,13 @@ namespace ftk
         std::shared_ptr<ObservableValue<float> > displayScale;
         std::shared_ptr<ObservableValue<bool> > tooltipsEnabled;
         bool running = true;
+        bool idle = false;
         std::list<std::shared_ptr<Window> > windows;
         std::weak_ptr<Window> activeWindow;
         std::vector<std::string> dropFiles;
         std::list<int> tickTimes;
         std::shared_ptr<Timer> logTimer;
+        std::shared_ptr<ValueObserver<size_t> > glyphsLoadedObserver;
     };
 
     void App::_init(
@@ -138,6 +146,12 @@ namespace ftk
             std::optional<ColorStyle>(),
             quotes(getColorStyleLabels()));
         cmdLineOptionsTmp.push_back(p.cmdLine.colorStyle);
+        p.cmdLine.rasterCache = CmdLineValueOption<std::string>::create(
+            { "-rasterCache" },
+            "Set the raster cache file. Rasterized glyphs and icons are stored "
+            "in the file to speed up the next startup.",
+            "Performance");
+        cmdLineOptionsTmp.push_back(p.cmdLine.rasterCache);
 
         IApp::_init(
             context,
@@ -152,6 +166,12 @@ namespace ftk
         p.monitors = ObservableList<MonitorInfo>::create();
         p.fontSystem = context->getSystem<FontSystem>();
         p.iconSystem = context->getSystem<IconSystem>();
+        if (p.cmdLine.rasterCache->hasValue())
+        {
+            p.rasterCache = RasterCache::create(p.cmdLine.rasterCache->getValue());
+            p.fontSystem->setRasterCache(p.rasterCache);
+            p.iconSystem->setRasterCache(p.rasterCache);
+        }
         p.style = Style::create(context);
         p.colorStyle = ObservableValue<ColorStyle>::create(ColorStyle::Dark);
         if (p.cmdLine.colorStyle->hasValue())
@@ -186,6 +206,19 @@ namespace ftk
 
         p.tooltipsEnabled = ObservableValue<bool>::create(true);
 
+        p.glyphsLoadedObserver = ValueObserver<size_t>::create(
+            p.fontSystem->observeGlyphsLoaded(),
+            [this](size_t)
+            {
+                // Redraw the windows when glyphs have been rasterized
+                // asynchronously.
+                for (const auto& window : _p->windows)
+                {
+                    window->setDrawUpdate();
+                }
+            },
+            ObserverAction::Suppress);
+
         _monitorsUpdate();
         _styleUpdate();
 
@@ -394,6 +427,23 @@ namespace ftk
         }
     }
 
+    bool App::isIdleEnabled() const
+    {
+        return _p->idle;
+    }
+
+    void App::setIdleEnabled(bool value)
+    {
+        _p->idle = value;
+    }
+
+    void App::wakeup()
+    {
+        SDL_Event event = {};
+        event.type = SDL_USEREVENT;
+        SDL_PushEvent(&event);
+    }
+
     void App::exit()
     {
         _p->running = false;
@@ -408,12 +458,7 @@ namespace ftk
 
         for (const auto& window : p.windows)
         {
-            TickEvent tickEvent;
-            _tickRecursive(
-                window,
-                window->isVisible(false),
-                window->isEnabled(false),
-                tickEvent);
+            window->_tickUpdate(TickEvent());
 
             if (window->isVisible(false))
             {
@@ -599,8 +644,13 @@ namespace ftk
         {
             auto logSystem = _context->getSystem<LogSystem>();
             SDL_Event event;
-            while (SDL_PollEvent(&event))
+            const int idleTimeout = p.idle ? _getIdleTimeout() : 0;
+            int waitTimeout = idleTimeout;
+            while (waitTimeout > 0 ?
+                SDL_WaitEventTimeout(&event, waitTimeout) :
+                SDL_PollEvent(&event))
             {
+                waitTimeout = 0;
                 switch (event.type)
                 {
                 case SDL_DISPLAYEVENT:
@@ -796,9 +846,14 @@ namespace ftk
 
             tick();
 
+            // The sleep limits the rate of the loop when it polls for
+            // events. It is not needed when the loop has already waited.
             auto t1 = std::chrono::steady_clock::now();
-            sleep(timeout, t0, t1);
-            t1 = std::chrono::steady_clock::now();
+            if (0 == idleTimeout)
+            {
+                sleep(timeout, t0, t1);
+                t1 = std::chrono::steady_clock::now();
+            }
             const auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
             p.tickTimes.push_back(diff.count());
             while (p.tickTimes.size() > 10)
@@ -820,26 +875,59 @@ namespace ftk
                 break;
             }
         }
+
+        if (p.rasterCache)
+        {
+            try
+            {
+                p.rasterCache->save();
+            }
+            catch (const std::exception& e)
+            {
+                auto logSystem = _context->getSystem<LogSystem>();
+                logSystem->print("ftk::App", e.what(), LogType::Error);
+            }
+        }
     }
 
-    void App::_tickRecursive(
-        const std::shared_ptr<IWidget>& widget,
-        bool visible,
-        bool enabled,
-        const TickEvent& event)
+    int App::_getIdleTimeout() const
     {
         FTK_P();
-        const bool parentsVisible = visible && widget->isVisible(false);
-        const bool parentsEnabled = enabled && widget->isEnabled(false);
-        for (const auto& child : widget->getChildren())
+
+        // Don't wait if there are updates pending or widgets that need
+        // to be ticked.
+        for (const auto& window : p.windows)
+        {
+            if (window->isVisible(false) &&
+                (window->hasSizeUpdate(true) ||
+                    window->hasDrawUpdate(true) ||
+                    window->_hasTickWidgets()))
+            {
+                return 0;
+            }
+        }
+
+        // Wait for the next timer.
+        std::chrono::microseconds out = idleTimeoutMax;
+        if (auto timerSystem = _context->getSystem<TimerSystem>())
         {
-            _tickRecursive(
-                child,
-                parentsVisible,
-                parentsEnabled,
-                event);
+            out = std::min(out, timerSystem->getNextTimeout());
+        }
+
+        // Poll the systems that have asynchronous work in progress, for
+        // example glyphs that are being rasterized or images that are
+        // being read.
+        for (const auto& system : _context->getSystems())
+        {
+            if (system->hasPendingWork())
+            {
+                const std::chrono::milliseconds tickTime = system->getTickTime();
+                out = std::min<std::chrono::microseconds>(
+                    out,
+                    tickTime > std::chrono::milliseconds(0) ? tickTime : idlePollTimeout);
+            }
         }
-        widget->tickEvent(visible, enabled, event);
+        return static_cast<int>((out.count() + 999) / 1000);
     }
 
     void App::_monitorsUpdate()
@@ -5,6 +5,8 @@
 
 #include <ftk/UI/DrawUtil.h>
 
+#include <ftk/Core/Timer.h>
+
 namespace ftk
 {
     struct IButton::Private
@@ -12,8 +14,8 @@ namespace ftk
         bool checkable = false;
         float iconScale = 1.F;
         bool repeatClick = false;
-        bool repeatClickInit = false;
-        std::chrono::steady_clock::time_point repeatClickTimer;
+        std::chrono::steady_clock::time_point repeatClickStart;
+        std::shared_ptr<Timer> repeatClickTimer;
     };
 
     void IButton::_init(
@@ -22,8 +24,12 @@ namespace ftk
         const std::shared_ptr<IWidget>& parent)
     {
         IMouseWidget::_init(context, objectName, parent);
+        FTK_P();
         _setMouseHoverEnabled(true);
         _setMousePressEnabled(true);
+
+        p.repeatClickTimer = Timer::create(context);
+        p.repeatClickTimer->setRepeating(true);
     }
 
     IButton::IButton() :
@@ -199,27 +205,6 @@ namespace ftk
         }
     }
 
-    void IButton::tickEvent(
-        bool parentsVisible,
-        bool parentsEnabled,
-        const TickEvent& event)
-    {
-        IMouseWidget::tickEvent(parentsVisible, parentsEnabled, event);
-        FTK_P();
-        if (_isMousePressed() && p.repeatClick)
-        {
-            const float duration = p.repeatClickInit ? .4F : .02F;
-            const auto now = std::chrono::steady_clock::now();
-            const std::chrono::duration<float> diff = now - p.repeatClickTimer;
-            if (diff.count() > duration)
-            {
-                click();
-                p.repeatClickInit = false;
-                p.repeatClickTimer = now;
-            }
-        }
-    }
-
     void IButton::sizeHintEvent(const SizeHintEvent& event)
     {
         IMouseWidget::sizeHintEvent(event);
@@ -276,14 +261,31 @@ namespace ftk
         }
         if (p.repeatClick)
         {
-            p.repeatClickInit = true;
-            p.repeatClickTimer = std::chrono::steady_clock::now();
+            p.repeatClickStart = std::chrono::steady_clock::now();
+            p.repeatClickTimer->start(
+                std::chrono::milliseconds(20),
+                [this]
+                {
+                    FTK_P();
+                    const std::chrono::duration<float> diff =
+                        std::chrono::steady_clock::now() - p.repeatClickStart;
+                    if (!_isMousePressed())
+                    {
+                        p.repeatClickTimer->stop();
+                    }
+                    else if (diff.count() > .4F)
+                    {
+                        click();
+                    }
+                });
         }
     }
 
     void IButton::mouseReleaseEvent(MouseClickEvent& event)
     {
         IMouseWidget::mouseReleaseEvent(event);
+        FTK_P();
+        p.repeatClickTimer->stop();
         setDrawUpdate();
         if (contains(getGeometry(), _getMousePos()))
         {
@@ -93,10 +93,6 @@ namespace ftk
         //! Click the button.
         void click();
 
-        void tickEvent(
-            bool,
-            bool,
-            const TickEvent&) override;
         void sizeHintEvent(const SizeHintEvent&) override;
         void mouseEnterEvent(MouseEnterEvent&) override;
         void mouseLeaveEvent() override;
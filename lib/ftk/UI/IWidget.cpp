@@ -19,6 +19,9 @@ namespace ftk
         _parent = parent;
         if (parent)
         {
+            _parentsVisible = parent->isVisible(true);
+            _parentsEnabled = parent->isEnabled(true);
+
             parent->_children.push_back(
                 std::static_pointer_cast<IWidget>(shared_from_this()));
 
@@ -55,6 +58,7 @@ namespace ftk
             releaseKeyFocus();
         }
         auto widget = shared_from_this();
+        const auto window = getWindow();
         if (auto parent = _parent.lock())
         {
             auto i = parent->_children.begin();
@@ -85,6 +89,14 @@ namespace ftk
             value->setSizeUpdate();
             value->setDrawUpdate();
         }
+        _setParentsState(
+            value ? value->isVisible(true) : true,
+            value ? value->isEnabled(true) : true);
+        const auto newWindow = getWindow();
+        if (newWindow != window)
+        {
+            _tickWindowUpdate(newWindow);
+        }
     }
 
     int IWidget::getChildIndex(const std::shared_ptr<IWidget>& value) const
@@ -225,6 +237,22 @@ namespace ftk
         setDrawUpdate();
     }
 
+    void IWidget::setSizeUpdate(bool value)
+    {
+        _sizeUpdate = value;
+        if (value)
+        {
+            // Mark the parents so the window can find the widgets that need
+            // a size update without searching the whole tree.
+            auto parent = _parent.lock();
+            while (parent && !parent->_childSizeUpdate)
+            {
+                parent->_childSizeUpdate = true;
+                parent = parent->_parent.lock();
+            }
+        }
+    }
+
     void IWidget::setGeometry(const Box2I& value)
     {
         if (value == _geometry)
@@ -249,6 +277,7 @@ namespace ftk
         if (value == _visible)
             return;
         _visible = value;
+        _childrenStateUpdate();
         if (!_visible)
         {
             releaseKeyFocus();
@@ -277,11 +306,27 @@ namespace ftk
         return _geometry;
     }
 
+    V2I IWidget::getChildrenOffset() const
+    {
+        return V2I();
+    }
+
+    V2I IWidget::getWindowOffset() const
+    {
+        V2I out;
+        for (auto parent = _parent.lock(); parent; parent = parent->_parent.lock())
+        {
+            out = out + parent->getChildrenOffset();
+        }
+        return out;
+    }
+
     void IWidget::setEnabled(bool value)
     {
         if (value == _enabled)
             return;
         _enabled = value;
+        _childrenStateUpdate();
         if (!_enabled)
         {
             releaseKeyFocus();
@@ -290,6 +335,20 @@ namespace ftk
         setDrawUpdate();
     }
 
+    void IWidget::setDrawUpdate(bool value)
+    {
+        _drawUpdate = value;
+        if (value)
+        {
+            auto parent = _parent.lock();
+            while (parent && !parent->_childDrawUpdate)
+            {
+                parent->_childDrawUpdate = true;
+                parent = parent->_parent.lock();
+            }
+        }
+    }
+
     void IWidget::setBackgroundRole(ColorRole value)
     {
         if (value == _backgroundRole)
@@ -422,4 +481,94 @@ namespace ftk
 
     void IWidget::dropEvent(DragAndDropEvent&)
     {}
-}
\ No newline at end of file
+
+    void IWidget::_clipEventRecursive(
+        const std::shared_ptr<IWidget>& widget,
+        const Box2I& clipRect,
+        bool clipped)
+    {
+        const Box2I& g = widget->getGeometry();
+        clipped |= !intersects(g, clipRect);
+        clipped |= !widget->isVisible(false);
+        const Box2I intersectedClipRect = intersect(g, clipRect);
+        widget->clipEvent(intersectedClipRect, clipped);
+        const Box2I childrenClipRect = intersect(
+            widget->getChildrenClipRect(), intersectedClipRect) -
+            widget->getChildrenOffset();
+        for (const auto& child : widget->getChildren())
+        {
+            const Box2I& childGeometry = child->getGeometry();
+            _clipEventRecursive(
+                child,
+                intersect(childGeometry, childrenClipRect),
+                clipped);
+        }
+    }
+
+    void IWidget::_setTickEnabled(bool value)
+    {
+        if (value == _tickEnabled)
+            return;
+        _tickEnabled = value;
+        if (_tickEnabled)
+        {
+            auto window = getWindow();
+            if (window)
+            {
+                window->_addTickWidget(shared_from_this());
+            }
+            _tickWindow = window;
+        }
+        else
+        {
+            if (auto window = _tickWindow.lock())
+            {
+                window->_removeTickWidget(shared_from_this());
+            }
+            _tickWindow.reset();
+        }
+    }
+
+    void IWidget::_setParentsState(bool visible, bool enabled)
+    {
+        if (visible == _parentsVisible && enabled == _parentsEnabled)
+            return;
+        _parentsVisible = visible;
+        _parentsEnabled = enabled;
+        _childrenStateUpdate();
+    }
+
+    void IWidget::_childrenStateUpdate()
+    {
+        const bool visible = isVisible(true);
+        const bool enabled = isEnabled(true);
+        for (const auto& child : _children)
+        {
+            child->_setParentsState(visible, enabled);
+        }
+    }
+
+    void IWidget::_tickWindowUpdate(const std::shared_ptr<IWindow>& window)
+    {
+        if (_tickEnabled)
+        {
+            auto prev = _tickWindow.lock();
+            if (prev != window)
+            {
+                if (prev)
+                {
+                    prev->_removeTickWidget(shared_from_this());
+                }
+                if (window)
+                {
+                    window->_addTickWidget(shared_from_this());
+                }
+                _tickWindow = window;
+            }
+        }
+        for (const auto& child : _children)
+        {
+            child->_tickWindowUpdate(window);
+        }
+    }
+}
@@ -76,8 +76,10 @@ namespace ftk
         //! Geometry
         ///@{
 
-        //! Get whether the widget needs a size update.
-        bool hasSizeUpdate() const;
+        //! Get whether the widget needs a size update. If andChildren is
+        //! true then also check whether any of the child widgets need a size
+        //! update.
+        bool hasSizeUpdate(bool andChildren = false) const;
 
         //! Set a size update. The sizeHintEvent() and setGeometry() methods
         //! will be called the next tick of the event loop.
@@ -157,6 +159,17 @@ namespace ftk
         //! default this is the same as the widget geometry.
         virtual Box2I getChildrenClipRect() const;
 
+        //! Get the offset applied to the child widgets. The offset
+        //! translates the child widgets when they are drawn, and the
+        //! positions of the events sent to them, without changing their
+        //! geometry. By default this is zero.
+        virtual V2I getChildrenOffset() const;
+
+        //! Get the offset from the widget coordinates to the window
+        //! coordinates. This is the sum of the children offsets of the
+        //! parent widgets.
+        V2I getWindowOffset() const;
+
         ///@}
 
         //! Enabled
@@ -174,8 +187,10 @@ namespace ftk
         //! Drawing
         ///@{
 
-        //! Get whether the widget needs a draw update.
-        bool hasDrawUpdate() const;
+        //! Get whether the widget needs a draw update. If andChildren is
+        //! true then also check whether any of the child widgets need a draw
+        //! update.
+        bool hasDrawUpdate(bool andChildren = false) const;
 
         //! Set a draw update. The drawEvent() method will be called the next
         //! tick of the event loop.
@@ -231,8 +246,9 @@ namespace ftk
         //! Child remove event.
         virtual void childRemoveEvent(const ChildRemoveEvent&);
 
-        //! Tick event. If this method is overridden the base method
-        //! should be called.
+        //! Tick event. Tick events are only sent to widgets that have
+        //! enabled them with _setTickEnabled(). If this method is
+        //! overridden the base method should be called.
         virtual void tickEvent(
             bool parentsVisible,
             bool parentsEnabled,
@@ -299,7 +315,24 @@ namespace ftk
     protected:
         void _setSizeHint(const Size2I&);
 
+        //! Get whether tick events are enabled.
+        bool _isTickEnabled() const;
+
+        //! Set whether tick events are enabled. Widgets with tick events
+        //! enabled are registered with their window, so that only those
+        //! widgets are visited each tick.
+        void _setTickEnabled(bool);
+
+        static void _clipEventRecursive(
+            const std::shared_ptr<IWidget>&,
+            const Box2I&,
+            bool clipped);
+
     private:
+        void _setParentsState(bool visible, bool enabled);
+        void _childrenStateUpdate();
+        void _tickWindowUpdate(const std::shared_ptr<IWindow>&);
+
         std::weak_ptr<Context> _context;
 
         std::string _objectName;
@@ -309,6 +342,9 @@ namespace ftk
         std::list<std::shared_ptr<IWidget> > _children;
 
         bool _sizeUpdate = false;
+        bool _childSizeUpdate = false;
+        bool _sizeHintChanged = false;
+        bool _layoutUpdate = false;
         Size2I _sizeHint;
         Stretch _hStretch = Stretch::Fixed;
         Stretch _vStretch = Stretch::Fixed;
@@ -317,17 +353,22 @@ namespace ftk
         Box2I _geometry;
 
         bool _drawUpdate = false;
+        bool _childDrawUpdate = false;
         bool _visible = true;
         bool _parentsVisible = true;
         bool _clipped = false;
         bool _enabled = true;
-
         bool _parentsEnabled = true;
 
+        bool _tickEnabled = false;
+        std::weak_ptr<IWindow> _tickWindow;
+
         bool _acceptsKeyFocus = false;
         bool _keyFocus = false;
 
         std::string _tooltip;
+
+        friend class IWindow;
     };
 }
 
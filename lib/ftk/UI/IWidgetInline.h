@@ -40,14 +40,14 @@ namespace ftk
         return out;
     }
 
-    inline bool IWidget::hasSizeUpdate() const
+    inline bool IWidget::hasSizeUpdate(bool andChildren) const
     {
-        return _sizeUpdate;
-    }
-
-    inline void IWidget::setSizeUpdate(bool value)
-    {
-        _sizeUpdate = value;
+        bool out = _sizeUpdate;
+        if (andChildren)
+        {
+            out |= _childSizeUpdate;
+        }
+        return out;
     }
 
     inline const Size2I& IWidget::getSizeHint() const
@@ -105,14 +105,14 @@ namespace ftk
         return out;
     }
 
-    inline bool IWidget::hasDrawUpdate() const
+    inline bool IWidget::hasDrawUpdate(bool andChildren) const
     {
-        return _drawUpdate;
-    }
-
-    inline void IWidget::setDrawUpdate(bool value)
-    {
-        _drawUpdate = value;
+        bool out = _drawUpdate;
+        if (andChildren)
+        {
+            out |= _childDrawUpdate;
+        }
+        return out;
     }
 
     inline ColorRole IWidget::getBackgroundRole() const
@@ -139,4 +139,9 @@ namespace ftk
     {
         _sizeHint = value;
     }
+
+    inline bool IWidget::_isTickEnabled() const
+    {
+        return _tickEnabled;
+    }
 }
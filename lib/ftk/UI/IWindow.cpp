@@ -7,8 +7,17 @@
 #include <ftk/UI/IPopup.h>
 #include <ftk/UI/Tooltip.h>
 
+#include <ftk/Core/Timer.h>
+
+#include <algorithm>
+
 namespace ftk
 {
+    namespace
+    {
+        const size_t damageRectMax = 16;
+    }
+
     struct IWindow::Private
     {
         std::function<void(void)> closeCallback;
@@ -34,13 +43,17 @@ namespace ftk
         bool tooltipsEnabled = true;
         std::shared_ptr<Tooltip> tooltip;
         V2I tooltipPos;
-        std::chrono::steady_clock::time_point tooltipTimer;
+        std::shared_ptr<Timer> tooltipTimer;
 
         struct SizeData
         {
             int dl = 0;
         };
         SizeData size;
+
+        bool layoutAll = false;
+
+        std::vector<std::weak_ptr<IWidget> > tickWidgets;
     };
 
     void IWindow::_init(
@@ -49,7 +62,9 @@ namespace ftk
         const std::shared_ptr<IWidget>& parent)
     {
         IWidget::_init(context, objectName, parent);
+        FTK_P();
         setBackgroundRole(ColorRole::Window);
+        p.tooltipTimer = Timer::create(context);
     }
 
     IWindow::IWindow() :
@@ -199,7 +214,7 @@ namespace ftk
             if (auto pressed = p.mousePress.lock())
             {
                 p.mousePress.reset();
-                p.mouseClickEvent.pos = p.cursorPos;
+                p.mouseClickEvent.pos = _getEventPos(pressed, p.cursorPos);
                 p.mouseClickEvent.accept = false;
                 pressed->mouseReleaseEvent(p.mouseClickEvent);
             }
@@ -211,7 +226,7 @@ namespace ftk
             if (auto keyPress = p.keyPress.lock())
             {
                 p.keyPress.reset();
-                p.keyEvent.pos = p.cursorPos;
+                p.keyEvent.pos = _getEventPos(keyPress, p.cursorPos);
                 p.keyEvent.accept = false;
                 keyPress->keyReleaseEvent(p.keyEvent);
             }
@@ -219,8 +234,8 @@ namespace ftk
             {
                 p.dndHover.reset();
                 DragAndDropEvent event(
-                    p.cursorPos,
-                    p.cursorPosPrev,
+                    _getEventPos(dragAndDrop, p.cursorPos),
+                    _getEventPos(dragAndDrop, p.cursorPosPrev),
                     p.dndData);
                 dragAndDrop->dragLeaveEvent(event);
             }
@@ -244,37 +259,6 @@ namespace ftk
                 MouseMoveEvent mouseMoveEvent(p.cursorPos, p.cursorPos);
                 _hoverUpdate(mouseMoveEvent);
             }
-
-            if (p.tooltipsEnabled)
-            {
-                const auto tooltipTime = std::chrono::steady_clock::now();
-                const auto tooltipDiff = std::chrono::duration_cast<std::chrono::milliseconds>(tooltipTime - p.tooltipTimer);
-                if (tooltipDiff > tooltipTimeout && !p.tooltip && !p.mousePress.lock())
-                {
-                    if (auto context = getContext())
-                    {
-                        std::string text;
-                        const auto widgets = _getUnderCursor(UnderCursor::Tooltip, p.cursorPos);
-                        for (const auto& widget : widgets)
-                        {
-                            text = widget->getTooltip();
-                            if (!text.empty())
-                            {
-                                break;
-                            }
-                        }
-                        if (!text.empty())
-                        {
-                            p.tooltip = Tooltip::create(
-                                context,
-                                text,
-                                p.cursorPos,
-                                shared_from_this());
-                            p.tooltipPos = p.cursorPos;
-                        }
-                    }
-                }
-            }
         }
     }
 
@@ -302,68 +286,178 @@ namespace ftk
 
     bool IWindow::_hasSizeUpdate(const std::shared_ptr<IWidget>& widget) const
     {
-        bool out = widget->hasSizeUpdate();
-        if (out)
+        return widget->hasSizeUpdate(true);
+    }
+
+    void IWindow::_sizeHintEventRecursive(
+        const std::shared_ptr<IWidget>& widget,
+        const SizeHintEvent& event)
+    {
+        // Only descend into the child widgets that need a size update. If
+        // this widget needs a size update then all of the child widgets are
+        // updated.
+        FTK_P();
+        widget->_childSizeUpdate = false;
+        const bool sizeUpdate = widget->_sizeUpdate;
+        if (widget.get() == this)
         {
-            //std::cout << "Size update: " << widget->getObjectName() << std::endl;
+            p.layoutAll = sizeUpdate;
         }
-        else
+        for (const auto& child : widget->getChildren())
         {
-            for (const auto& child : widget->getChildren())
+            if (sizeUpdate)
+            {
+                child->_sizeUpdate = true;
+            }
+            if (child->_sizeUpdate || child->_childSizeUpdate)
             {
-                out |= _hasSizeUpdate(child);
+                _sizeHintEventRecursive(child, event);
             }
         }
-        return out;
+
+        // Keep track of whether the size hint changed so that the layout
+        // can be skipped when it is the same.
+        const Size2I sizeHint = widget->_sizeHint;
+        widget->sizeHintEvent(event);
+        widget->_sizeUpdate = false;
+        widget->_sizeHintChanged = sizeUpdate || widget->_sizeHint != sizeHint;
+        widget->_layoutUpdate = true;
     }
 
-    void IWindow::_sizeHintEventRecursive(
-        const std::shared_ptr<IWidget>& widget,
-        const SizeHintEvent& event)
+    void IWindow::_layoutUpdate(const Box2I& value)
     {
-        for (const auto& child : widget->getChildren())
+        FTK_P();
+        auto window = shared_from_this();
+        if (p.layoutAll || value != getGeometry())
         {
-            _sizeHintEventRecursive(child, event);
+            setGeometry(value);
+            _clipEventRecursive(window, getGeometry(), !isVisible(false));
+            _resetLayoutUpdate(window);
         }
-        widget->sizeHintEvent(event);
-        widget->setSizeUpdate(false);
+        else
+        {
+            _layoutUpdateRecursive(window);
+        }
+        p.layoutAll = false;
     }
 
     bool IWindow::_hasDrawUpdate(const std::shared_ptr<IWidget>& widget) const
     {
-        bool out = false;
-        if (!widget->isClipped())
+        return widget->hasDrawUpdate(true);
+    }
+
+    std::vector<Box2I> IWindow::_getDrawDamage(const std::shared_ptr<IWidget>& widget) const
+    {
+        std::vector<Box2I> rects;
+        _getDrawDamage(widget, V2I(), false, rects);
+
+        // Clip the rectangles to the widget.
+        std::vector<Box2I> out;
+        const Box2I& g = widget->getGeometry();
+        for (const auto& rect : rects)
         {
-            out = widget->hasDrawUpdate();
-            if (out)
+            if (rect.w() > 0 && rect.h() > 0 && intersects(rect, g))
             {
-                //std::cout << "Draw update: " << widget->getObjectName() << std::endl;
+                out.push_back(intersect(rect, g));
             }
-            else
+        }
+
+        // Merge the overlapping rectangles, if there are too many then
+        // merge them all into a single rectangle.
+        if (out.size() <= damageRectMax * 4)
+        {
+            bool merged = true;
+            while (merged)
             {
-                for (const auto& child : widget->getChildren())
+                merged = false;
+                for (size_t i = 0; i < out.size() && !merged; ++i)
                 {
-                    out |= _hasDrawUpdate(child);
+                    for (size_t j = i + 1; j < out.size(); ++j)
+                    {
+                        if (intersects(out[i], out[j]))
+                        {
+                            out[i] = expand(out[i], out[j]);
+                            out.erase(out.begin() + j);
+                            merged = true;
+                            break;
+                        }
+                    }
                 }
             }
         }
+        if (out.size() > damageRectMax)
+        {
+            Box2I rect = out.front();
+            for (size_t i = 1; i < out.size(); ++i)
+            {
+                rect = expand(rect, out[i]);
+            }
+            out.clear();
+            out.push_back(rect);
+        }
         return out;
     }
 
+    void IWindow::_getDrawDamage(
+        const std::shared_ptr<IWidget>& widget,
+        const V2I& offset,
+        bool damaged,
+        std::vector<Box2I>& out) const
+    {
+        // Only descend into the child widgets that need a draw update. The
+        // child widgets of a damaged widget are still visited to reset
+        // their flags, but they are already covered by the damage.
+        widget->_childDrawUpdate = false;
+        if (!damaged && widget->_drawUpdate && !widget->isClipped())
+        {
+            out.push_back(widget->getGeometry() + offset);
+            damaged = true;
+        }
+        const V2I childrenOffset = offset + widget->getChildrenOffset();
+        for (const auto& child : widget->getChildren())
+        {
+            if (child->_childDrawUpdate || (!damaged && child->_drawUpdate))
+            {
+                _getDrawDamage(child, childrenOffset, damaged, out);
+            }
+        }
+    }
+
+    void IWindow::_drawEventRecursive(
+        const std::shared_ptr<IWidget>& widget,
+        const Box2I& drawRect,
+        const DrawEvent& event)
+    {
+        _drawEventRecursive(widget, V2I(), drawRect, event);
+    }
+
     void IWindow::_drawEventRecursive(
         const std::shared_ptr<IWidget>& widget,
+        const V2I& offset,
         const Box2I& drawRect,
         const DrawEvent& event)
     {
+        // The draw rectangle is in the coordinates of the widget, and the
+        // offset converts it to window coordinates for clipping.
         const Box2I& g = widget->getGeometry();
         if (!widget->isClipped() && g.w() > 0 && g.h() > 0)
         {
-            event.render->setClipRect(drawRect);
+            event.render->setClipRect(drawRect + offset);
             widget->drawEvent(drawRect, event);
             widget->setDrawUpdate(false);
+            const V2I childrenOffset = widget->getChildrenOffset();
             const Box2I childrenClipRect = intersect(
                 widget->getChildrenClipRect(),
-                drawRect);
+                drawRect) - childrenOffset;
+            M44F transform;
+            if (childrenOffset != V2I())
+            {
+                transform = event.render->getTransform();
+                event.render->setTransform(transform * translate(V3F(
+                    static_cast<float>(childrenOffset.x),
+                    static_cast<float>(childrenOffset.y),
+                    0.F)));
+            }
             for (const auto& child : widget->getChildren())
             {
                 const Box2I& childGeometry = child->getGeometry();
@@ -371,11 +465,16 @@ namespace ftk
                 {
                     _drawEventRecursive(
                         child,
+                        offset + childrenOffset,
                         intersect(childGeometry, childrenClipRect),
                         event);
                 }
             }
-            event.render->setClipRect(drawRect);
+            if (childrenOffset != V2I())
+            {
+                event.render->setTransform(transform);
+            }
+            event.render->setClipRect(drawRect + offset);
             widget->drawOverlayEvent(drawRect, event);
         }
     }
@@ -395,6 +494,7 @@ namespace ftk
             {
                 while (widget)
                 {
+                    p.keyEvent.pos = _getEventPos(widget, p.cursorPos);
                     widget->keyPressEvent(p.keyEvent);
                     if (p.keyEvent.accept)
                     {
@@ -415,6 +515,7 @@ namespace ftk
                 auto widgets = _getUnderCursor(UnderCursor::Hover, p.cursorPos);
                 for (auto i = widgets.begin(); i != widgets.end(); ++i)
                 {
+                    p.keyEvent.pos = _getEventPos(*i, p.cursorPos);
                     (*i)->keyPressEvent(p.keyEvent);
                     if (p.keyEvent.accept)
                     {
@@ -441,6 +542,7 @@ namespace ftk
         }
         else if (auto widget = p.keyPress.lock())
         {
+            p.keyEvent.pos = _getEventPos(widget, p.cursorPos);
             widget->keyReleaseEvent(p.keyEvent);
         }
         return p.keyEvent.accept;
@@ -469,7 +571,14 @@ namespace ftk
     {
         FTK_P();
         p.inside = enter;
-        if (!p.inside)
+        if (p.inside)
+        {
+            if (!p.tooltipTimer->isActive())
+            {
+                _closeTooltip();
+            }
+        }
+        else
         {
             if (auto hover = p.hover.lock())
             {
@@ -506,6 +615,8 @@ namespace ftk
                     {
                         break;
                     }
+                    event.pos = _getEventPos(widgets.front(), p.cursorPos);
+                    event.prev = _getEventPos(widgets.front(), p.cursorPosPrev);
                     widgets.front()->dragEnterEvent(event);
                     if (event.accept)
                     {
@@ -518,6 +629,8 @@ namespace ftk
                 {
                     if (hover)
                     {
+                        event.pos = _getEventPos(hover, p.cursorPos);
+                        event.prev = _getEventPos(hover, p.cursorPosPrev);
                         hover->dragLeaveEvent(event);
                     }
                     p.dndHover = widget;
@@ -525,20 +638,24 @@ namespace ftk
                 else if (widgets.empty() && hover)
                 {
                     p.dndHover.reset();
+                    event.pos = _getEventPos(hover, p.cursorPos);
+                    event.prev = _getEventPos(hover, p.cursorPosPrev);
                     hover->dragLeaveEvent(event);
                 }
                 hover = p.dndHover.lock();
                 if (hover)
                 {
                     DragAndDropEvent event(
-                        p.cursorPos,
-                        p.cursorPosPrev,
+                        _getEventPos(hover, p.cursorPos),
+                        _getEventPos(hover, p.cursorPosPrev),
                         p.dndData);
                     hover->dragMoveEvent(event);
                 }
             }
             else
             {
+                event.pos = _getEventPos(widget, p.cursorPos);
+                event.prev = _getEventPos(widget, p.cursorPosPrev);
                 widget->mouseMoveEvent(event);
 
                 p.dndData = event.dndData;
@@ -547,6 +664,7 @@ namespace ftk
                 if (p.dndData)
                 {
                     // Start a drag and drop.
+                    p.mouseClickEvent.pos = event.pos;
                     widget->mouseReleaseEvent(p.mouseClickEvent);
                     widget->mouseLeaveEvent();
                 }
@@ -579,6 +697,7 @@ namespace ftk
             auto i = widgets.begin();
             for (; i != widgets.end(); ++i)
             {
+                p.mouseClickEvent.pos = _getEventPos(*i, p.cursorPos);
                 (*i)->mousePressEvent(p.mouseClickEvent);
                 if (p.mouseClickEvent.accept)
                 {
@@ -605,14 +724,15 @@ namespace ftk
                     // Finish a drag and drop.
                     p.dndHover.reset();
                     DragAndDropEvent event(
-                        p.cursorPos,
-                        p.cursorPosPrev,
+                        _getEventPos(hover, p.cursorPos),
+                        _getEventPos(hover, p.cursorPosPrev),
                         p.dndData);
                     hover->dropEvent(event);
                     hover->dragLeaveEvent(event);
                 }
                 else
                 {
+                    p.mouseClickEvent.pos = _getEventPos(widget, p.cursorPos);
                     widget->mouseReleaseEvent(p.mouseClickEvent);
                 }
                 p.dndData.reset();
@@ -635,6 +755,7 @@ namespace ftk
         auto widgets = _getUnderCursor(UnderCursor::Hover, p.cursorPos);
         for (auto i = widgets.begin(); i != widgets.end(); ++i)
         {
+            event.pos = _getEventPos(*i, p.cursorPos);
             (*i)->scrollEvent(event);
             if (event.accept)
             {
@@ -643,25 +764,148 @@ namespace ftk
         }
     }
 
-    void IWindow::_clipEventRecursive(
-        const std::shared_ptr<IWidget>& widget,
-        const Box2I& clipRect,
-        bool clipped)
+    void IWindow::_addTickWidget(const std::shared_ptr<IWidget>& widget)
     {
-        const Box2I& g = widget->getGeometry();
-        clipped |= !intersects(g, clipRect);
-        clipped |= !widget->isVisible(false);
-        const Box2I intersectedClipRect = intersect(g, clipRect);
-        widget->clipEvent(intersectedClipRect, clipped);
-        const Box2I childrenClipRect = intersect(
-            widget->getChildrenClipRect(), intersectedClipRect);
+        FTK_P();
+        if (widget.get() != this)
+        {
+            p.tickWidgets.push_back(widget);
+        }
+    }
+
+    void IWindow::_removeTickWidget(const std::shared_ptr<IWidget>& widget)
+    {
+        FTK_P();
+        auto i = std::find_if(
+            p.tickWidgets.begin(),
+            p.tickWidgets.end(),
+            [widget](const std::weak_ptr<IWidget>& value)
+            {
+                return value.lock() == widget;
+            });
+        if (i != p.tickWidgets.end())
+        {
+            p.tickWidgets.erase(i);
+        }
+    }
+
+    bool IWindow::_hasTickWidgets() const
+    {
+        FTK_P();
+        for (const auto& i : p.tickWidgets)
+        {
+            if (auto widget = i.lock())
+            {
+                if (widget->isVisible(true))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void IWindow::_tickUpdate(const TickEvent& event)
+    {
+        FTK_P();
+        tickEvent(_parentsVisible, _parentsEnabled, event);
+
+        // Copy the widgets since they may be added or removed during the
+        // tick.
+        std::vector<std::shared_ptr<IWidget> > widgets;
+        widgets.reserve(p.tickWidgets.size());
+        auto i = p.tickWidgets.begin();
+        while (i != p.tickWidgets.end())
+        {
+            if (auto widget = i->lock())
+            {
+                widgets.push_back(widget);
+                ++i;
+            }
+            else
+            {
+                i = p.tickWidgets.erase(i);
+            }
+        }
+        for (const auto& widget : widgets)
+        {
+            widget->tickEvent(
+                widget->_parentsVisible,
+                widget->_parentsEnabled,
+                event);
+        }
+    }
+
+    void IWindow::_layoutUpdateRecursive(const std::shared_ptr<IWidget>& widget)
+    {
+        // If the size hint of a child widget has changed then the layout of
+        // this widget is updated, otherwise the geometry is unchanged and
+        // only the child widgets that were visited by the size hint event
+        // are checked.
+        bool layout = false;
         for (const auto& child : widget->getChildren())
         {
-            const Box2I& childGeometry = child->getGeometry();
-            _clipEventRecursive(
-                child,
-                intersect(childGeometry, childrenClipRect),
-                clipped);
+            if (child->_sizeHintChanged)
+            {
+                layout = true;
+                break;
+            }
+        }
+        if (layout)
+        {
+            widget->setGeometry(widget->getGeometry());
+            _layoutClipEvent(widget);
+            _resetLayoutUpdate(widget);
+        }
+        else
+        {
+            widget->_sizeHintChanged = false;
+            widget->_layoutUpdate = false;
+            for (const auto& child : widget->getChildren())
+            {
+                if (child->_layoutUpdate)
+                {
+                    _layoutUpdateRecursive(child);
+                }
+            }
+        }
+    }
+
+    void IWindow::_layoutClipEvent(const std::shared_ptr<IWidget>& widget)
+    {
+        // Get the clipping state from the ancestors of the widget.
+        std::vector<std::shared_ptr<IWidget> > widgets;
+        for (auto i = widget; i; i = i->getParent().lock())
+        {
+            widgets.push_back(i);
+        }
+        auto i = widgets.rbegin();
+        Box2I clipRect = (*i)->getGeometry();
+        bool clipped = !(*i)->isVisible(false);
+        for (; *i != widget; ++i)
+        {
+            const Box2I& g = (*i)->getGeometry();
+            clipped |= !intersects(g, clipRect);
+            clipped |= !(*i)->isVisible(false);
+            const Box2I intersectedClipRect = intersect(g, clipRect);
+            const Box2I childrenClipRect = intersect(
+                (*i)->getChildrenClipRect(), intersectedClipRect) -
+                (*i)->getChildrenOffset();
+            clipRect = intersect((*(i + 1))->getGeometry(), childrenClipRect);
+        }
+        _clipEventRecursive(widget, clipRect, clipped);
+    }
+
+    void IWindow::_resetLayoutUpdate(const std::shared_ptr<IWidget>& widget)
+    {
+        widget->_sizeHintChanged = false;
+        widget->_layoutUpdate = false;
+        for (const auto& child : widget->getChildren())
+        {
+            if (child->_layoutUpdate)
+            {
+                _resetLayoutUpdate(child);
+            }
         }
     }
 
@@ -698,31 +942,45 @@ namespace ftk
             (UnderCursor::Tooltip == type ? true : widget->isEnabled()) &&
             contains(widget->getGeometry(), pos))
         {
+            const V2I childrenPos = pos - widget->getChildrenOffset();
             for (auto i = widget->getChildren().rbegin();
                 i != widget->getChildren().rend();
                 ++i)
             {
-                _getUnderCursor(type, *i, pos, out);
+                _getUnderCursor(type, *i, childrenPos, out);
             }
             out.push_back(widget);
         }
     }
 
+    V2I IWindow::_getEventPos(
+        const std::shared_ptr<IWidget>& widget,
+        const V2I& pos) const
+    {
+        // Convert the position from window coordinates to the coordinates
+        // of the widget.
+        return widget ? pos - widget->getWindowOffset() : pos;
+    }
+
     void IWindow::_hoverUpdate(MouseMoveEvent& event)
     {
         FTK_P();
         const auto widgets = _getUnderCursor(UnderCursor::Hover, p.cursorPos);
         std::shared_ptr<IWidget> hover;
         auto prev = p.hover.lock();
+        const V2I pos = event.pos;
+        const V2I posPrev = event.prev;
         for (const auto& widget : widgets)
         {
+            event.pos = _getEventPos(widget, pos);
+            event.prev = _getEventPos(widget, posPrev);
             if (widget == prev)
             {
                 widget->mouseMoveEvent(event);
                 hover = widget;
                 break;
             }
-            MouseEnterEvent enterEvent(p.cursorPos);
+            MouseEnterEvent enterEvent(event.pos);
             widget->mouseEnterEvent(enterEvent);
             if (enterEvent.accept)
             {
@@ -759,6 +1017,36 @@ namespace ftk
         }
     }
 
+    void IWindow::_openTooltip()
+    {
+        FTK_P();
+        if (p.inside && !p.tooltip && !p.mousePress.lock())
+        {
+            if (auto context = getContext())
+            {
+                std::string text;
+                const auto widgets = _getUnderCursor(UnderCursor::Tooltip, p.cursorPos);
+                for (const auto& widget : widgets)
+                {
+                    text = widget->getTooltip();
+                    if (!text.empty())
+                    {
+                        break;
+                    }
+                }
+                if (!text.empty())
+                {
+                    p.tooltip = Tooltip::create(
+                        context,
+                        text,
+                        p.cursorPos,
+                        shared_from_this());
+                    p.tooltipPos = p.cursorPos;
+                }
+            }
+        }
+    }
+
     void IWindow::_closeTooltip()
     {
         FTK_P();
@@ -767,7 +1055,19 @@ namespace ftk
             p.tooltip->close();
             p.tooltip.reset();
         }
-        p.tooltipTimer = std::chrono::steady_clock::now();
         p.tooltipPos = p.cursorPos;
+        if (p.tooltipsEnabled)
+        {
+            p.tooltipTimer->start(
+                tooltipTimeout,
+                [this]
+                {
+                    _openTooltip();
+                });
+        }
+        else
+        {
+            p.tooltipTimer->stop();
+        }
     }
 }
\ No newline at end of file
@@ -69,8 +69,10 @@ namespace ftk
         void _sizeHintEventRecursive(
             const std::shared_ptr<IWidget>&,
             const SizeHintEvent&);
+        void _layoutUpdate(const Box2I&);
 
         bool _hasDrawUpdate(const std::shared_ptr<IWidget>&) const;
+        std::vector<Box2I> _getDrawDamage(const std::shared_ptr<IWidget>&) const;
         void _drawEventRecursive(
             const std::shared_ptr<IWidget>&,
             const Box2I&,
@@ -83,11 +85,6 @@ namespace ftk
         void _mouseButton(int button, bool press, int modifiers);
         void _scroll(const V2F&, int modifiers);
 
-        void _clipEventRecursive(
-            const std::shared_ptr<IWidget>&,
-            const Box2I&,
-            bool clipped);
-
         virtual void _drop(const std::vector<std::string>&);
 
     private:
@@ -99,6 +96,9 @@ namespace ftk
         std::list<std::shared_ptr<IWidget> > _getUnderCursor(
             UnderCursor,
             const V2I&);
+        V2I _getEventPos(
+            const std::shared_ptr<IWidget>&,
+            const V2I&) const;
         void _getUnderCursor(
             UnderCursor,
             const std::shared_ptr<IWidget>&,
@@ -107,13 +107,36 @@ namespace ftk
 
         void _hoverUpdate(MouseMoveEvent&);
 
+        void _addTickWidget(const std::shared_ptr<IWidget>&);
+        void _removeTickWidget(const std::shared_ptr<IWidget>&);
+        bool _hasTickWidgets() const;
+        void _tickUpdate(const TickEvent&);
+
+        void _layoutUpdateRecursive(const std::shared_ptr<IWidget>&);
+        void _layoutClipEvent(const std::shared_ptr<IWidget>&);
+        void _resetLayoutUpdate(const std::shared_ptr<IWidget>&);
+
+        void _getDrawDamage(
+            const std::shared_ptr<IWidget>&,
+            const V2I& offset,
+            bool damaged,
+            std::vector<Box2I>&) const;
+
+        void _drawEventRecursive(
+            const std::shared_ptr<IWidget>&,
+            const V2I& offset,
+            const Box2I&,
+            const DrawEvent&);
+
         void _getKeyFocus(
             const std::shared_ptr<IWidget>&,
             std::list<std::shared_ptr<IWidget> >&);
 
+        void _openTooltip();
         void _closeTooltip();
 
         friend class App;
+        friend class IWidget;
 
         FTK_PRIVATE();
     };
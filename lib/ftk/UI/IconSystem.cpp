@@ -7,7 +7,9 @@
 
 #include <ftk/Core/Assert.h>
 #include <ftk/Core/Format.h>
+#include <ftk/Core/ImageConvert.h>
 #include <ftk/Core/LRUCache.h>
+#include <ftk/Core/RasterCache.h>
 
 #include <lunasvg/lunasvg.h>
 
@@ -109,10 +111,22 @@ namespace ftk
 
         typedef std::pair<std::string, float> CacheKey;
 
+        struct CacheKeyHash
+        {
+            std::size_t operator() (const CacheKey& value) const noexcept
+            {
+                std::size_t out = std::hash<std::string>()(value.first);
+                hashCombine(out, value.second);
+                return out;
+            }
+        };
+
         struct Mutex
         {
             std::list<std::shared_ptr<Request> > requests;
-            LRUCache<CacheKey, std::shared_ptr<Image> > cache;
+            LRUCache<CacheKey, std::shared_ptr<Image>, CacheKeyHash> cache;
+            std::shared_ptr<RasterCache> rasterCache;
+            size_t running = 0;
             bool stopped = false;
             std::mutex mutex;
         };
@@ -224,6 +238,7 @@ namespace ftk
                                 requests.push_back(p.mutex.requests.front());
                                 p.mutex.requests.pop_front();
                             }
+                            p.mutex.running = requests.size();
                         }
                     }
 
@@ -232,11 +247,13 @@ namespace ftk
                         //std::cout << "icon request: " << request->name << " " << request->displayScale << std::endl;
                         std::shared_ptr<Image> image;
                         bool cached = false;
+                        std::shared_ptr<RasterCache> rasterCache;
                         {
                             std::unique_lock<std::mutex> lock(p.mutex.mutex);
                             cached = p.mutex.cache.get(
                                 std::make_pair(request->name, request->displayScale),
                                 image);
+                            rasterCache = p.mutex.rasterCache;
                         }
                         if (!cached)
                         {
@@ -249,6 +266,18 @@ namespace ftk
                                     resource = i->second;
                                 }
                             }
+                            std::string rasterKey;
+                            if (rasterCache && !resource.empty())
+                            {
+                                rasterKey = Format("icon:{0}:{1}:{2}").
+                                    arg(request->name).
+                                    arg(getRasterCacheHash(resource.data(), resource.size())).
+                                    arg(request->displayScale);
+                                if (rasterCache->get(rasterKey, image))
+                                {
+                                    resource.clear();
+                                }
+                            }
                             if (!resource.empty())
                             {
                                 if (auto context = p.context.lock())
@@ -261,22 +290,26 @@ namespace ftk
                                         auto bitmap = doc->renderToBitmap(w, h, 0x00000000);
                                         if (!bitmap.isNull())
                                         {
+                                            // The bitmap is BGRA with the first row
+                                            // at the top.
+                                            ImageInfo bitmapInfo(w, h, ImageType::RGBA_U8);
+                                            bitmapInfo.layout.mirror.y = true;
                                             image = Image::create(w, h, ImageType::RGBA_U8);
-                                            for (int y = 0; y < h; ++y)
-                                            {
-                                                uint8_t* imageP = image->getData() + y * w * 4;
-                                                const uint8_t* bitmapP = bitmap.data() + (h - 1 - y) * w * 4;
-                                                for (int x = 0; x < w; ++x, imageP += 4, bitmapP += 4)
-                                                {
-                                                    imageP[0] = bitmapP[2];
-                                                    imageP[1] = bitmapP[1];
-                                                    imageP[2] = bitmapP[0];
-                                                    imageP[3] = bitmapP[3];
-                                                }
-                                            }
+                                            ImageConvertOptions convertOptions;
+                                            convertOptions.bgr = true;
+                                            convertImage(
+                                                bitmapInfo,
+                                                bitmap.data(),
+                                                image->getInfo(),
+                                                image->getData(),
+                                                convertOptions);
                                         }
                                     }
                                 }
+                                if (rasterCache)
+                                {
+                                    rasterCache->add(rasterKey, image);
+                                }
                             }
                         }
                         request->promise.set_value(image);
@@ -285,6 +318,7 @@ namespace ftk
                             p.mutex.cache.add(
                                 std::make_pair(request->name, request->displayScale),
                                 image);
+                            --p.mutex.running;
                         }
                     }
                 }
@@ -412,6 +446,32 @@ namespace ftk
         }
     }
 
+    size_t IconSystem::getRequestCount() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.requests.size() + p.mutex.running;
+    }
+
+    bool IconSystem::hasPendingWork() const
+    {
+        return getRequestCount() > 0;
+    }
+
+    std::shared_ptr<RasterCache> IconSystem::getRasterCache() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.rasterCache;
+    }
+
+    void IconSystem::setRasterCache(const std::shared_ptr<RasterCache>& value)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        p.mutex.rasterCache = value;
+    }
+
     void IconSystem::Private::_cancelRequests()
     {
         std::list<std::shared_ptr<Private::Request> > requests;
@@ -11,6 +11,8 @@
 
 namespace ftk
 {
+    class RasterCache;
+
     //! \name Icons
     ///@{
 
@@ -56,6 +58,18 @@ namespace ftk
         //! Cancel async requests.
         void cancelRequests(const std::vector<uint64_t>&);
 
+        //! Get the number of async requests that have not finished.
+        size_t getRequestCount() const;
+
+        //! Get the raster cache.
+        std::shared_ptr<RasterCache> getRasterCache() const;
+
+        //! Set the raster cache. Rendered icons are read from and added to
+        //! the raster cache.
+        void setRasterCache(const std::shared_ptr<RasterCache>&);
+
+        bool hasPendingWork() const override;
+
     private:
         FTK_PRIVATE();
     };
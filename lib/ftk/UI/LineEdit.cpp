@@ -10,6 +10,7 @@
 #include <ftk/UI/LayoutUtil.h>
 
 #include <ftk/Core/RenderUtil.h>
+#include <ftk/Core/Timer.h>
 
 #include <optional>
 
@@ -107,7 +108,7 @@ namespace ftk
         ColorRole borderRole = ColorRole::Border;
         int cursorPos = 0;
         bool cursorVisible = false;
-        std::chrono::steady_clock::time_point cursorTimer;
+        std::shared_ptr<Timer> cursorTimer;
         Selection selection;
 
         struct SizeData
@@ -146,6 +147,9 @@ namespace ftk
         _setMouseHoverEnabled(true);
         _setMousePressEnabled(true);
         _textUpdate();
+
+        p.cursorTimer = Timer::create(context);
+        p.cursorTimer->setRepeating(true);
     }
 
     LineEdit::LineEdit() :
@@ -283,6 +287,7 @@ namespace ftk
         IMouseWidget::setVisible(value);
         if (changed && !isVisible(false))
         {
+            p.cursorTimer->stop();
             if (p.cursorVisible)
             {
                 p.cursorVisible = false;
@@ -298,6 +303,7 @@ namespace ftk
         IMouseWidget::setEnabled(value);
         if (changed && !isEnabled(false))
         {
+            p.cursorTimer->stop();
             if (p.cursorVisible)
             {
                 p.cursorVisible = false;
@@ -306,31 +312,6 @@ namespace ftk
         }
     }
 
-    void LineEdit::tickEvent(
-        bool parentsVisible,
-        bool parentsEnabled,
-        const TickEvent& event)
-    {
-        IMouseWidget::tickEvent(parentsVisible, parentsEnabled, event);
-        FTK_P();
-        if (hasKeyFocus())
-        {
-            const auto now = std::chrono::steady_clock::now();
-            const std::chrono::duration<float> diff = now - p.cursorTimer;
-            if (diff.count() > .5F)
-            {
-                p.cursorVisible = !p.cursorVisible;
-                setDrawUpdate();
-                p.cursorTimer = now;
-            }
-        }
-        else if (p.cursorVisible)
-        {
-            p.cursorVisible = false;
-            setDrawUpdate();
-        }
-    }
-
     void LineEdit::sizeHintEvent(const SizeHintEvent& event)
     {
         IMouseWidget::sizeHintEvent(event);
@@ -402,11 +383,12 @@ namespace ftk
             p.draw->g2,
             event.style->getColorRole(ColorRole::Base));
 
-        // Enable clipping.
+        // Enable clipping. The clipping rectangle is in window coordinates,
+        // which can be offset from the widget coordinates by a scroll area.
         const ClipRectEnabledState clipRectEnabledState(event.render);
         const ClipRectState clipRectState(event.render);
         event.render->setClipRectEnabled(true);
-        event.render->setClipRect(intersect(p.draw->g2, drawRect));
+        event.render->setClipRect(intersect(p.draw->g2, drawRect) + getWindowOffset());
 
         // Draw the selection.
         if (p.selection.isValid())
@@ -463,8 +445,7 @@ namespace ftk
             if (cursorPos != p.cursorPos)
             {
                 p.cursorPos = cursorPos;
-                p.cursorVisible = true;
-                p.cursorTimer = std::chrono::steady_clock::now();
+                _cursorReset();
                 setDrawUpdate();
             }
             if (cursorPos != p.selection.get().second)
@@ -483,8 +464,7 @@ namespace ftk
         if (cursorPos != p.cursorPos)
         {
             p.cursorPos = cursorPos;
-            p.cursorVisible = true;
-            p.cursorTimer = std::chrono::steady_clock::now();
+            _cursorReset();
             setDrawUpdate();
         }
         const SelectionPair selection(cursorPos, cursorPos);
@@ -500,8 +480,14 @@ namespace ftk
     {
         IMouseWidget::keyFocusEvent(value);
         FTK_P();
-        if (!value)
+        if (value)
+        {
+            _cursorReset();
+        }
+        else
         {
+            p.cursorTimer->stop();
+            p.cursorVisible = false;
             p.selection.clear();
             setDrawUpdate();
         }
@@ -617,8 +603,7 @@ namespace ftk
                     }
 
                     p.cursorPos--;
-                    p.cursorVisible = true;
-                    p.cursorTimer = std::chrono::steady_clock::now();
+                    _cursorReset();
 
                     setDrawUpdate();
                 }
@@ -637,8 +622,7 @@ namespace ftk
                     }
 
                     p.cursorPos++;
-                    p.cursorVisible = true;
-                    p.cursorTimer = std::chrono::steady_clock::now();
+                    _cursorReset();
 
                     setDrawUpdate();
                 }
@@ -657,8 +641,7 @@ namespace ftk
                     }
 
                     p.cursorPos = 0;
-                    p.cursorVisible = true;
-                    p.cursorTimer = std::chrono::steady_clock::now();
+                    _cursorReset();
 
                     setDrawUpdate();
                 }
@@ -677,8 +660,7 @@ namespace ftk
                     }
 
                     p.cursorPos = p.text.size();
-                    p.cursorVisible = true;
-                    p.cursorTimer = std::chrono::steady_clock::now();
+                    _cursorReset();
 
                     setDrawUpdate();
                 }
@@ -826,4 +808,20 @@ namespace ftk
         setSizeUpdate();
         setDrawUpdate();
     }
-}
\ No newline at end of file
+
+    void LineEdit::_cursorReset()
+    {
+        FTK_P();
+        if (!hasKeyFocus())
+            return;
+        p.cursorVisible = true;
+        p.cursorTimer->start(
+            std::chrono::milliseconds(500),
+            [this]
+            {
+                _p->cursorVisible = !_p->cursorVisible;
+                setDrawUpdate();
+            });
+        setDrawUpdate();
+    }
+}
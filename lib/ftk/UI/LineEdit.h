@@ -76,10 +76,6 @@ namespace ftk
         void setGeometry(const Box2I&) override;
         void setVisible(bool) override;
         void setEnabled(bool) override;
-        void tickEvent(
-            bool,
-            bool,
-            const TickEvent&) override;
         void clipEvent(const Box2I&, bool) override;
         void sizeHintEvent(const SizeHintEvent&) override;
         void drawEvent(const Box2I&, const DrawEvent&) override;
@@ -94,6 +90,7 @@ namespace ftk
         int _getCursorPos(const V2I&) const;
 
         void _textUpdate();
+        void _cursorReset();
 
         FTK_PRIVATE();
     };
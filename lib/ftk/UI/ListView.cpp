@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/UI/ListViewPrivate.h>
+
+#include <ftk/UI/ScrollWidget.h>
+
+namespace ftk
+{
+    struct ListView::Private
+    {
+        std::shared_ptr<ListViewWidget> widget;
+        std::shared_ptr<ScrollWidget> scrollWidget;
+        std::shared_ptr<ValueObserver<int> > scrollToObserver;
+    };
+
+    void ListView::_init(
+        const std::shared_ptr<Context>& context,
+        const std::shared_ptr<IObservableList<ListItem> >& items,
+        const std::shared_ptr<IWidget>& parent)
+    {
+        IWidget::_init(context, "ftk::ListView", parent);
+        FTK_P();
+
+        p.widget = ListViewWidget::create(context);
+        p.widget->setItems(items);
+
+        p.scrollWidget = ScrollWidget::create(context, ScrollType::Vertical, shared_from_this());
+        p.scrollWidget->setScrollTransform(true);
+        p.scrollWidget->setWidget(p.widget);
+
+        p.scrollWidget->setScrollPosCallback(
+            [this](const V2I&)
+            {
+                _viewportUpdate();
+            });
+
+        p.scrollToObserver = ValueObserver<int>::create(
+            p.widget->observeScrollTo(),
+            [this](int value)
+            {
+                if (value >= 0)
+                {
+                    _scrollUpdate(value);
+                }
+            });
+    }
+
+    ListView::ListView() :
+        _p(new Private)
+    {}
+
+    ListView::~ListView()
+    {}
+
+    std::shared_ptr<ListView> ListView::create(
+        const std::shared_ptr<Context>& context,
+        const std::shared_ptr<IObservableList<ListItem> >& items,
+        const std::shared_ptr<IWidget>& parent)
+    {
+        auto out = std::shared_ptr<ListView>(new ListView);
+        out->_init(context, items, parent);
+        return out;
+    }
+
+    const std::shared_ptr<IObservableList<ListItem> >& ListView::getItems() const
+    {
+        return _p->widget->getItems();
+    }
+
+    void ListView::setItems(const std::shared_ptr<IObservableList<ListItem> >& value)
+    {
+        _p->widget->setItems(value);
+    }
+
+    bool ListView::hasUniformRowHeights() const
+    {
+        return _p->widget->hasUniformRowHeights();
+    }
+
+    void ListView::setUniformRowHeights(bool value)
+    {
+        _p->widget->setUniformRowHeights(value);
+    }
+
+    void ListView::setCallback(const std::function<void(int)>& value)
+    {
+        _p->widget->setCallback(value);
+    }
+
+    int ListView::getCurrent() const
+    {
+        return _p->widget->getCurrent();
+    }
+
+    void ListView::setCurrent(int value)
+    {
+        _p->widget->setCurrent(value);
+    }
+
+    Box2I ListView::getRect(int value) const
+    {
+        return _p->widget->getRect(value);
+    }
+
+    void ListView::setGeometry(const Box2I& value)
+    {
+        IWidget::setGeometry(value);
+        _p->scrollWidget->setGeometry(value);
+        _viewportUpdate();
+    }
+
+    void ListView::sizeHintEvent(const SizeHintEvent&)
+    {
+        _setSizeHint(_p->scrollWidget->getSizeHint());
+    }
+
+    void ListView::_viewportUpdate()
+    {
+        FTK_P();
+        const V2I& pos = p.scrollWidget->getScrollPos();
+        const Box2I vp = p.scrollWidget->getViewport();
+        p.widget->setViewport(Box2I(pos.x, pos.y, vp.w(), vp.h()));
+    }
+
+    void ListView::_scrollUpdate(int value)
+    {
+        FTK_P();
+        const V2I& pos = p.scrollWidget->getScrollPos();
+        const Box2I vp = p.scrollWidget->getViewport();
+        const Box2I r = p.widget->getRect(value);
+        if (r.min.y < pos.y || r.max.y > pos.y + vp.h())
+        {
+            p.scrollWidget->scrollTo(r);
+        }
+    }
+}
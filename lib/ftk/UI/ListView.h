@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/UI/ListItemsWidget.h>
+
+#include <ftk/Core/ObservableList.h>
+
+namespace ftk
+{
+    //! \name List Widgets
+    ///@{
+
+    //! List view.
+    //!
+    //! The list view displays the items of an observable list. Unlike
+    //! ListWidget, widgets are only created for the rows that are visible
+    //! in the scroll area (plus a few rows of overscan), and they are
+    //! recycled as the view scrolls. This allows lists with a very large
+    //! number of items.
+    //!
+    //! Rows can have uniform heights, or variable heights that are
+    //! measured as the rows become visible. The offset of each row is kept
+    //! in an index that supports O(log n) queries and updates.
+    class ListView : public IWidget
+    {
+    protected:
+        void _init(
+            const std::shared_ptr<Context>&,
+            const std::shared_ptr<IObservableList<ListItem> >&,
+            const std::shared_ptr<IWidget>& parent);
+
+        ListView();
+
+    public:
+        virtual ~ListView();
+
+        //! Create a new widget.
+        static std::shared_ptr<ListView> create(
+            const std::shared_ptr<Context>&,
+            const std::shared_ptr<IObservableList<ListItem> >& = nullptr,
+            const std::shared_ptr<IWidget>& parent = nullptr);
+
+        //! Get the items.
+        const std::shared_ptr<IObservableList<ListItem> >& getItems() const;
+
+        //! Set the items.
+        void setItems(const std::shared_ptr<IObservableList<ListItem> >&);
+
+        //! Get whether the rows have uniform heights.
+        bool hasUniformRowHeights() const;
+
+        //! Set whether the rows have uniform heights.
+        void setUniformRowHeights(bool);
+
+        //! Set the callback.
+        void setCallback(const std::function<void(int)>&);
+
+        //! Get the current item.
+        int getCurrent() const;
+
+        //! Set the current item.
+        void setCurrent(int);
+
+        //! Get the rectangle of an item relative to the top of the list.
+        Box2I getRect(int) const;
+
+        void setGeometry(const Box2I&) override;
+        void sizeHintEvent(const SizeHintEvent&) override;
+
+    private:
+        void _viewportUpdate();
+        void _scrollUpdate(int);
+
+        FTK_PRIVATE();
+    };
+
+    ///@}
+}
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/UI/ListView.h>
+
+#include <ftk/Core/ImplicitTreap.h>
+#include <ftk/Core/ObservableValue.h>
+
+namespace ftk
+{
+    //! Sum of list view row heights.
+    struct ListViewHeightSum
+    {
+        ListViewHeightSum() = default;
+        explicit ListViewHeightSum(int);
+
+        int sum = 0;
+
+        void merge(const ListViewHeightSum&);
+    };
+
+    //! List view row index. The index stores the height of each row and
+    //! provides the row offsets. Uniform heights are computed directly,
+    //! variable heights are stored in an implicit treap with the sum of
+    //! the heights in each subtree, so that queries, updates, insertions,
+    //! and removals are O(log n).
+    class ListViewIndex
+    {
+    public:
+        //! Set the rows with a uniform height.
+        void setUniform(size_t count, int height);
+
+        //! Set the rows with variable heights, initialized to the given
+        //! height.
+        void setVariable(size_t count, int height);
+
+        //! Get whether the rows have a uniform height.
+        bool isUniform() const;
+
+        //! Get the number of rows.
+        size_t getCount() const;
+
+        //! Insert rows. Variable height rows are initialized to the
+        //! height given to setVariable().
+        void insert(size_t index, size_t count);
+
+        //! Remove rows.
+        void remove(size_t index, size_t count);
+
+        //! Get the height of a row.
+        int getHeight(size_t) const;
+
+        //! Set the height of a row. This has no effect for uniform heights.
+        void setHeight(size_t, int);
+
+        //! Get the offset of a row.
+        int getOffset(size_t) const;
+
+        //! Get the total height of the rows.
+        int getTotal() const;
+
+        //! Find the row at the given offset.
+        size_t find(int) const;
+
+    private:
+        size_t _count = 0;
+        int _height = 0;
+        bool _uniform = true;
+        ImplicitTreap<int, ListViewHeightSum> _heights;
+    };
+
+    class ListViewWidget : public IWidget
+    {
+    protected:
+        void _init(
+            const std::shared_ptr<Context>&,
+            const std::shared_ptr<IWidget>& parent);
+
+        ListViewWidget();
+
+    public:
+        virtual ~ListViewWidget();
+
+        static std::shared_ptr<ListViewWidget> create(
+            const std::shared_ptr<Context>&,
+            const std::shared_ptr<IWidget>& parent = nullptr);
+
+        const std::shared_ptr<IObservableList<ListItem> >& getItems() const;
+        void setItems(const std::shared_ptr<IObservableList<ListItem> >&);
+
+        bool hasUniformRowHeights() const;
+        void setUniformRowHeights(bool);
+
+        void setCallback(const std::function<void(int)>&);
+
+        int getCurrent() const;
+        void setCurrent(int);
+
+        std::shared_ptr<IObservableValue<int> > observeScrollTo() const;
+
+        Box2I getRect(int) const;
+
+        void setViewport(const Box2I&);
+
+        void setGeometry(const Box2I&) override;
+        void sizeHintEvent(const SizeHintEvent&) override;
+        void keyFocusEvent(bool) override;
+        void keyPressEvent(KeyEvent&) override;
+        void keyReleaseEvent(KeyEvent&) override;
+
+    private:
+        void _itemsUpdate(const ObservableListChange&);
+        void _indexUpdate();
+        void _rowsUpdate();
+        void _currentUpdate();
+
+        FTK_PRIVATE();
+    };
+}
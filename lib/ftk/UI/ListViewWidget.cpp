@@ -0,0 +1,556 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/UI/ListViewPrivate.h>
+
+#include <ftk/UI/ListItemsWidgetPrivate.h>
+
+#include <map>
+
+namespace ftk
+{
+    namespace
+    {
+        //! The number of rows created above and below the viewport.
+        const int overscan = 4;
+    }
+
+    ListViewHeightSum::ListViewHeightSum(int height) :
+        sum(height)
+    {}
+
+    void ListViewHeightSum::merge(const ListViewHeightSum& other)
+    {
+        sum += other.sum;
+    }
+
+    void ListViewIndex::setUniform(size_t count, int height)
+    {
+        _count = count;
+        _height = height;
+        _uniform = true;
+        _heights.clear();
+    }
+
+    void ListViewIndex::setVariable(size_t count, int height)
+    {
+        _count = count;
+        _height = height;
+        _uniform = false;
+        _heights.clear();
+        _heights.insert(0, count, height);
+    }
+
+    bool ListViewIndex::isUniform() const
+    {
+        return _uniform;
+    }
+
+    size_t ListViewIndex::getCount() const
+    {
+        return _count;
+    }
+
+    void ListViewIndex::insert(size_t index, size_t count)
+    {
+        if (0 == count)
+            return;
+        index = std::min(index, _count);
+        _count += count;
+        if (!_uniform)
+        {
+            _heights.insert(index, count, _height);
+        }
+    }
+
+    void ListViewIndex::remove(size_t index, size_t count)
+    {
+        index = std::min(index, _count);
+        count = std::min(count, _count - index);
+        if (0 == count)
+            return;
+        _count -= count;
+        if (!_uniform)
+        {
+            _heights.remove(index, count);
+        }
+    }
+
+    int ListViewIndex::getHeight(size_t index) const
+    {
+        return _uniform ? _height : _heights.get(index);
+    }
+
+    void ListViewIndex::setHeight(size_t index, int value)
+    {
+        if (_uniform || index >= _count || value == _heights.get(index))
+            return;
+        _heights.set(index, value);
+    }
+
+    int ListViewIndex::getOffset(size_t index) const
+    {
+        index = std::min(index, _count);
+        return _uniform ?
+            static_cast<int>(index) * _height :
+            _heights.getPrefix(index).sum;
+    }
+
+    int ListViewIndex::getTotal() const
+    {
+        return _uniform ? static_cast<int>(_count) * _height : _heights.getSummary().sum;
+    }
+
+    size_t ListViewIndex::find(int offset) const
+    {
+        size_t out = 0;
+        if (_count > 0)
+        {
+            if (_uniform)
+            {
+                out = _height > 0 ? std::max(0, offset) / _height : 0;
+            }
+            else
+            {
+                // Find the first row that ends after the offset.
+                out = _heights.find(
+                    0,
+                    [offset](const ListViewHeightSum& value)
+                    {
+                        return value.sum > offset;
+                    });
+            }
+            out = std::min(out, _count - 1);
+        }
+        return out;
+    }
+
+    struct ListViewWidget::Private
+    {
+        std::shared_ptr<IObservableList<ListItem> > items;
+        bool uniformRowHeights = true;
+        int rowHeight = 0;
+        ListViewIndex index;
+        Box2I viewport;
+        std::map<int, std::shared_ptr<ListItemButton> > rows;
+        std::vector<std::shared_ptr<ListItemButton> > pool;
+        std::function<void(int)> callback;
+        std::shared_ptr<ObservableValue<int> > current;
+        std::shared_ptr<ObservableValue<int> > scrollTo;
+
+        std::shared_ptr<ListObserver<ListItem> > itemsObserver;
+    };
+
+    void ListViewWidget::_init(
+        const std::shared_ptr<Context>& context,
+        const std::shared_ptr<IWidget>& parent)
+    {
+        IWidget::_init(context, "ftk::ListViewWidget", parent);
+        FTK_P();
+        setAcceptsKeyFocus(true);
+        p.current = ObservableValue<int>::create(-1);
+        p.scrollTo = ObservableValue<int>::create(-1);
+    }
+
+    ListViewWidget::ListViewWidget() :
+        _p(new Private)
+    {}
+
+    ListViewWidget::~ListViewWidget()
+    {}
+
+    std::shared_ptr<ListViewWidget> ListViewWidget::create(
+        const std::shared_ptr<Context>& context,
+        const std::shared_ptr<IWidget>& parent)
+    {
+        auto out = std::shared_ptr<ListViewWidget>(new ListViewWidget);
+        out->_init(context, parent);
+        return out;
+    }
+
+    const std::shared_ptr<IObservableList<ListItem> >& ListViewWidget::getItems() const
+    {
+        return _p->items;
+    }
+
+    void ListViewWidget::setItems(const std::shared_ptr<IObservableList<ListItem> >& value)
+    {
+        FTK_P();
+        if (value == p.items)
+            return;
+        p.items = value;
+        p.itemsObserver.reset();
+        if (p.items)
+        {
+            p.itemsObserver = ListObserver<ListItem>::create(
+                p.items,
+                [this](const std::vector<ListItem>&)
+                {
+                    _itemsUpdate(_p->items->getChange());
+                },
+                ObserverAction::Suppress);
+        }
+        ObservableListChange change;
+        change.removed = p.index.getCount();
+        change.added = p.items ? p.items->getSize() : 0;
+        _itemsUpdate(change);
+    }
+
+    bool ListViewWidget::hasUniformRowHeights() const
+    {
+        return _p->uniformRowHeights;
+    }
+
+    void ListViewWidget::setUniformRowHeights(bool value)
+    {
+        FTK_P();
+        if (value == p.uniformRowHeights)
+            return;
+        p.uniformRowHeights = value;
+        _indexUpdate();
+        _rowsUpdate();
+        setSizeUpdate();
+        setDrawUpdate();
+    }
+
+    void ListViewWidget::setCallback(const std::function<void(int)>& value)
+    {
+        _p->callback = value;
+    }
+
+    int ListViewWidget::getCurrent() const
+    {
+        return _p->current->get();
+    }
+
+    void ListViewWidget::setCurrent(int value)
+    {
+        FTK_P();
+        const int count = static_cast<int>(p.index.getCount());
+        const int tmp = count > 0 ? clamp(value, 0, count - 1) : -1;
+        if (p.current->setIfChanged(tmp))
+        {
+            _currentUpdate();
+            p.scrollTo->setIfChanged(p.current->get());
+        }
+    }
+
+    std::shared_ptr<IObservableValue<int> > ListViewWidget::observeScrollTo() const
+    {
+        return _p->scrollTo;
+    }
+
+    Box2I ListViewWidget::getRect(int index) const
+    {
+        FTK_P();
+        Box2I out;
+        if (index >= 0 && index < static_cast<int>(p.index.getCount()))
+        {
+            out = Box2I(
+                0,
+                p.index.getOffset(index),
+                getGeometry().w(),
+                p.index.getHeight(index));
+        }
+        return out;
+    }
+
+    void ListViewWidget::setViewport(const Box2I& value)
+    {
+        FTK_P();
+        if (value == p.viewport)
+            return;
+        p.viewport = value;
+        _rowsUpdate();
+    }
+
+    void ListViewWidget::setGeometry(const Box2I& value)
+    {
+        IWidget::setGeometry(value);
+        _rowsUpdate();
+    }
+
+    void ListViewWidget::sizeHintEvent(const SizeHintEvent&)
+    {
+        FTK_P();
+
+        // Measure the row heights from the visible rows. With variable
+        // heights the first measurement is only used as the height of the
+        // rows that have not been measured, so the measured heights are
+        // kept.
+        if (!p.rows.empty() && (p.uniformRowHeights || 0 == p.rowHeight))
+        {
+            const int rowHeight = p.rows.begin()->second->getSizeHint().h;
+            if (rowHeight != p.rowHeight)
+            {
+                p.rowHeight = rowHeight;
+                _indexUpdate();
+            }
+        }
+        Size2I sizeHint;
+        for (const auto& row : p.rows)
+        {
+            const Size2I& rowSizeHint = row.second->getSizeHint();
+            sizeHint.w = std::max(sizeHint.w, rowSizeHint.w);
+            p.index.setHeight(row.first, rowSizeHint.h);
+        }
+        sizeHint.h = p.index.getTotal();
+        _setSizeHint(sizeHint);
+    }
+
+    void ListViewWidget::keyFocusEvent(bool value)
+    {
+        IWidget::keyFocusEvent(value);
+        FTK_P();
+        _currentUpdate();
+        if (value)
+        {
+            p.scrollTo->setAlways(p.current->get());
+        }
+    }
+
+    void ListViewWidget::keyPressEvent(KeyEvent& event)
+    {
+        FTK_P();
+        if (0 == event.modifiers)
+        {
+            switch (event.key)
+            {
+            case Key::Return:
+            {
+                event.accept = true;
+                takeKeyFocus();
+                const int current = p.current->get();
+                if (current >= 0 && p.callback)
+                {
+                    p.callback(current);
+                }
+                break;
+            }
+            case Key::Up:
+                event.accept = true;
+                takeKeyFocus();
+                setCurrent(p.current->get() - 1);
+                break;
+            case Key::Down:
+                event.accept = true;
+                takeKeyFocus();
+                setCurrent(p.current->get() + 1);
+                break;
+            case Key::PageUp:
+                event.accept = true;
+                takeKeyFocus();
+                setCurrent(static_cast<int>(p.index.find(
+                    p.index.getOffset(std::max(p.current->get(), 0)) - p.viewport.h())));
+                break;
+            case Key::PageDown:
+                event.accept = true;
+                takeKeyFocus();
+                setCurrent(static_cast<int>(p.index.find(
+                    p.index.getOffset(std::max(p.current->get(), 0)) + p.viewport.h())));
+                break;
+            case Key::Home:
+                event.accept = true;
+                takeKeyFocus();
+                setCurrent(0);
+                break;
+            case Key::End:
+                event.accept = true;
+                takeKeyFocus();
+                setCurrent(static_cast<int>(p.index.getCount()) - 1);
+                break;
+            case Key::Escape:
+                event.accept = true;
+                releaseKeyFocus();
+                break;
+            default: break;
+            }
+        }
+        if (!event.accept)
+        {
+            IWidget::keyPressEvent(event);
+        }
+    }
+
+    void ListViewWidget::keyReleaseEvent(KeyEvent& event)
+    {
+        IWidget::keyReleaseEvent(event);
+        event.accept = true;
+    }
+
+    void ListViewWidget::_itemsUpdate(const ObservableListChange& change)
+    {
+        FTK_P();
+        const size_t count = p.items ? p.items->getSize() : 0;
+        const size_t indexCount = p.index.getCount();
+        if (0 == change.index &&
+            change.removed >= indexCount &&
+            change.added == count)
+        {
+            // All of the items have changed.
+            for (const auto& row : p.rows)
+            {
+                row.second->setVisible(false);
+                p.pool.push_back(row.second);
+            }
+            p.rows.clear();
+            _indexUpdate();
+        }
+        else if (change.index + change.removed <= indexCount &&
+            indexCount - change.removed + change.added == count)
+        {
+            // Apply the change to the index so that the measured row
+            // heights are kept.
+            p.index.remove(change.index, change.removed);
+            p.index.insert(change.index, change.added);
+
+            // Return the rows starting at the change to the pool since
+            // their items have changed or moved.
+            for (auto i = p.rows.begin(); i != p.rows.end();)
+            {
+                if (i->first >= static_cast<int>(change.index))
+                {
+                    i->second->setVisible(false);
+                    p.pool.push_back(i->second);
+                    i = p.rows.erase(i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+        else
+        {
+            // The change does not match the index, so rebuild it.
+            ObservableListChange reset;
+            reset.removed = indexCount;
+            reset.added = count;
+            _itemsUpdate(reset);
+            return;
+        }
+
+        const int current = count > 0 ?
+            clamp(p.current->get(), 0, static_cast<int>(count) - 1) :
+            -1;
+        if (p.current->setIfChanged(current))
+        {
+            p.scrollTo->setIfChanged(p.current->get());
+        }
+        _rowsUpdate();
+
+        setSizeUpdate();
+        setDrawUpdate();
+    }
+
+    void ListViewWidget::_indexUpdate()
+    {
+        FTK_P();
+        const size_t count = p.items ? p.items->getSize() : 0;
+        const int rowHeight = std::max(1, p.rowHeight);
+        if (p.uniformRowHeights)
+        {
+            p.index.setUniform(count, rowHeight);
+        }
+        else
+        {
+            p.index.setVariable(count, rowHeight);
+        }
+    }
+
+    void ListViewWidget::_rowsUpdate()
+    {
+        FTK_P();
+
+        // Get the range of visible rows.
+        int first = 0;
+        int last = -1;
+        const size_t count = p.index.getCount();
+        if (count > 0)
+        {
+            first = std::max(
+                static_cast<int>(p.index.find(p.viewport.min.y)) - overscan,
+                0);
+            last = std::min(
+                static_cast<int>(p.index.find(p.viewport.max.y)) + overscan,
+                static_cast<int>(count) - 1);
+        }
+
+        // Return the rows outside of the range to the pool.
+        for (auto i = p.rows.begin(); i != p.rows.end();)
+        {
+            if (i->first < first || i->first > last)
+            {
+                i->second->setVisible(false);
+                p.pool.push_back(i->second);
+                i = p.rows.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        // Add the rows that are in the range.
+        auto context = getContext();
+        const Box2I& g = getGeometry();
+        for (int i = first; i <= last; ++i)
+        {
+            std::shared_ptr<ListItemButton> row;
+            const auto j = p.rows.find(i);
+            if (j != p.rows.end())
+            {
+                row = j->second;
+            }
+            else
+            {
+                if (!p.pool.empty())
+                {
+                    row = p.pool.back();
+                    p.pool.pop_back();
+                    row->setVisible(true);
+                }
+                else if (context)
+                {
+                    row = ListItemButton::create(context, std::string(), shared_from_this());
+                }
+                if (!row)
+                {
+                    break;
+                }
+                const ListItem& item = p.items->get()[i];
+                row->setText(item.text);
+                row->setTooltip(item.tooltip);
+                row->setClickedCallback(
+                    [this, i]
+                    {
+                        setCurrent(i);
+                        takeKeyFocus();
+                        if (_p->callback)
+                        {
+                            _p->callback(i);
+                        }
+                    });
+                p.rows[i] = row;
+            }
+            row->setGeometry(Box2I(
+                g.min.x,
+                g.min.y + p.index.getOffset(i),
+                g.w(),
+                p.index.getHeight(i)));
+        }
+
+        _currentUpdate();
+    }
+
+    void ListViewWidget::_currentUpdate()
+    {
+        FTK_P();
+        const int current = p.current->get();
+        const bool focus = hasKeyFocus();
+        for (const auto& row : p.rows)
+        {
+            row.second->setCurrent(current == row.first && focus);
+        }
+    }
+}
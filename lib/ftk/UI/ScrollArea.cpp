@@ -25,6 +25,9 @@ namespace ftk
         ScrollType scrollType = ScrollType::Both;
         Size2I scrollSize;
         V2I scrollPos;
+        bool scrollTransform = false;
+        Box2I clipRect;
+        bool clipped = false;
         std::function<void(const Size2I&)> scrollSizeCallback;
         std::function<void(const V2I&)> scrollPosCallback;
         SizeRole sizeHintRole = SizeRole::ScrollArea;
@@ -110,7 +113,14 @@ namespace ftk
         if (tmp == p.scrollPos)
             return;
         p.scrollPos = tmp;
-        setSizeUpdate();
+        if (p.scrollTransform)
+        {
+            _clipEventRecursive(shared_from_this(), p.clipRect, p.clipped);
+        }
+        else
+        {
+            setSizeUpdate();
+        }
         setDrawUpdate();
         if (p.scrollPosCallback)
         {
@@ -142,6 +152,21 @@ namespace ftk
         setScrollPos(scrollPos, false);
     }
 
+    bool ScrollArea::isScrollTransform() const
+    {
+        return _p->scrollTransform;
+    }
+
+    void ScrollArea::setScrollTransform(bool value)
+    {
+        FTK_P();
+        if (value == p.scrollTransform)
+            return;
+        p.scrollTransform = value;
+        setSizeUpdate();
+        setDrawUpdate();
+    }
+
     void ScrollArea::setScrollPosCallback(const std::function<void(const V2I&)>& value)
     {
         _p->scrollPosCallback = value;
@@ -163,6 +188,12 @@ namespace ftk
         setDrawUpdate();
     }
 
+    V2I ScrollArea::getChildrenOffset() const
+    {
+        FTK_P();
+        return p.scrollTransform ? -p.scrollPos : V2I();
+    }
+
     void ScrollArea::setGeometry(const Box2I& value)
     {
         IWidget::setGeometry(value);
@@ -189,9 +220,10 @@ namespace ftk
             }
             scrollSize.w = std::max(scrollSize.w, childSizeHint.w);
             scrollSize.h = std::max(scrollSize.h, childSizeHint.h);
+            const V2I offset = p.scrollTransform ? V2I() : p.scrollPos;
             const Box2I g2(
-                value.min.x - p.scrollPos.x,
-                value.min.y - p.scrollPos.y,
+                value.min.x - offset.x,
+                value.min.y - offset.y,
                 childSizeHint.w,
                 childSizeHint.h);
             child->setGeometry(g2);
@@ -213,7 +245,10 @@ namespace ftk
         if (scrollPos != p.scrollPos)
         {
             p.scrollPos = scrollPos;
-            setSizeUpdate();
+            if (!p.scrollTransform)
+            {
+                setSizeUpdate();
+            }
             setDrawUpdate();
             if (p.scrollPosCallback)
             {
@@ -255,4 +290,12 @@ namespace ftk
         }
         _setSizeHint(sizeHint);
     }
-}
\ No newline at end of file
+
+    void ScrollArea::clipEvent(const Box2I& clipRect, bool clipped)
+    {
+        IWidget::clipEvent(clipRect, clipped);
+        FTK_P();
+        p.clipRect = clipRect;
+        p.clipped = clipped;
+    }
+}
@@ -64,6 +64,16 @@ namespace ftk
         //! Scroll to make the given box visible.
         void scrollTo(const Box2I&);
 
+        //! Get whether the scroll position is applied as a transform.
+        bool isScrollTransform() const;
+
+        //! Set whether the scroll position is applied as a transform. When
+        //! enabled the child widgets keep their layout and are translated
+        //! when they are drawn and receive events, so changing the scroll
+        //! position does not cause a size update. Widgets that position
+        //! popups from their geometry should not be used with a transform.
+        void setScrollTransform(bool);
+
         //! Set the scroll position callback.
         void setScrollPosCallback(const std::function<void(const V2I&)>&);
 
@@ -73,8 +83,10 @@ namespace ftk
         //! Set the size hint role.
         void setSizeHintRole(SizeRole);
 
+        V2I getChildrenOffset() const override;
         void setGeometry(const Box2I&) override;
         void sizeHintEvent(const SizeHintEvent&) override;
+        void clipEvent(const Box2I&, bool) override;
 
     private:
         FTK_PRIVATE();
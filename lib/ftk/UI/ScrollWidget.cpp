@@ -176,6 +176,16 @@ namespace ftk
         _p->scrollArea->scrollTo(value);
     }
 
+    bool ScrollWidget::isScrollTransform() const
+    {
+        return _p->scrollArea->isScrollTransform();
+    }
+
+    void ScrollWidget::setScrollTransform(bool value)
+    {
+        _p->scrollArea->setScrollTransform(value);
+    }
+
     void ScrollWidget::setScrollPosCallback(const std::function<void(const V2I&)>& value)
     {
         _p->scrollPosCallback = value;
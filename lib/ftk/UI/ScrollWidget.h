@@ -57,6 +57,12 @@ namespace ftk
         //! Scroll to make the given box visible.
         void scrollTo(const Box2I&);
 
+        //! Get whether the scroll position is applied as a transform.
+        bool isScrollTransform() const;
+
+        //! Set whether the scroll position is applied as a transform.
+        void setScrollTransform(bool);
+
         //! Set the scroll position callback.
         void setScrollPosCallback(const std::function<void(const V2I&)>&);
 
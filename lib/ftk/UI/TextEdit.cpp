@@ -71,6 +71,7 @@ namespace ftk
 
         p.scrollWidget = ScrollWidget::create(context, ScrollType::Both, shared_from_this());
         p.scrollWidget->setBorder(false);
+        p.scrollWidget->setScrollTransform(true);
         p.scrollWidget->setWidget(p.widget);
 
         p.widget->setFocusCallback(
@@ -129,6 +130,11 @@ namespace ftk
         _p->widget->setTextCallback(value);
     }
 
+    void TextEdit::setLinesCallback(const std::function<void(const ObservableListChange&)>& value)
+    {
+        _p->widget->setLinesCallback(value);
+    }
+
     void TextEdit::selectAll()
     {
         _p->widget->selectAll();
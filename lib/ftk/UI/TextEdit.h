@@ -56,9 +56,14 @@ namespace ftk
         //! Clear the text.
         void clearText();
 
-        //! Set the text callback.
+        //! Set the text callback. For memory mapped files this copies all
+        //! of the lines on every change, use setLinesCallback() instead.
         void setTextCallback(const std::function<void(const std::vector<std::string>&)>&);
 
+        //! Set the lines callback. The callback is given the changed
+        //! range of lines instead of the text.
+        void setLinesCallback(const std::function<void(const ObservableListChange&)>&);
+
         //! Select all.
         void selectAll();
 
@@ -6,13 +6,420 @@
 #include <ftk/UI/ClipboardSystem.h>
 
 #include <ftk/Core/Assert.h>
+#include <ftk/Core/Command.h>
 #include <ftk/Core/String.h>
+#include <ftk/Core/Timer.h>
+
+#include <algorithm>
 
 namespace ftk
 {
     namespace
     {
         const std::vector<std::string> textEditClear({ "" });
+        const std::chrono::milliseconds fileTimeout(100);
+
+        //! Text edit segment. A segment is either a range of lines in a
+        //! memory mapped file, or lines in memory.
+        struct TextEditSegment
+        {
+            size_t fileLine = 0;
+            size_t count = 0;
+            std::vector<std::string> lines;
+
+            bool isFile() const { return lines.empty(); }
+        };
+
+        size_t getCount(const std::vector<TextEditSegment>& segments)
+        {
+            size_t out = 0;
+            for (const auto& segment : segments)
+            {
+                out += segment.count;
+            }
+            return out;
+        }
+
+        TextEditSegment getSlice(const TextEditSegment& segment, size_t index, size_t count)
+        {
+            TextEditSegment out;
+            out.count = count;
+            if (segment.isFile())
+            {
+                out.fileLine = segment.fileLine + index;
+            }
+            else
+            {
+                out.lines = std::vector<std::string>(
+                    segment.lines.begin() + index,
+                    segment.lines.begin() + index + count);
+            }
+            return out;
+        }
+
+        //! Text edit storage.
+        //!
+        //! Text is stored in the observable list. Memory mapped files are
+        //! stored as a list of segments instead, so that only the edited
+        //! lines are in memory, and the observable list is only filled
+        //! when the text is requested.
+        class TextEditStorage
+        {
+        public:
+            explicit TextEditStorage(const std::vector<std::string>& value) :
+                text(ObservableList<std::string>::create(!value.empty() ? value : textEditClear)),
+                change(ObservableValue<ObservableListChange>::create())
+            {}
+
+            explicit TextEditStorage(const std::shared_ptr<MappedText>& file) :
+                text(ObservableList<std::string>::create()),
+                file(file),
+                change(ObservableValue<ObservableListChange>::create())
+            {
+                _indexed = file->isIndexed();
+                _fileLines = file->getLineCount();
+                TextEditSegment segment;
+                if (_fileLines > 0)
+                {
+                    segment.count = _fileLines;
+                }
+                else
+                {
+                    segment.count = 1;
+                    segment.lines = textEditClear;
+                }
+                _segments.push_back(segment);
+                _update();
+            }
+
+            std::shared_ptr<ObservableList<std::string> > text;
+            std::shared_ptr<MappedText> file;
+            std::shared_ptr<ObservableValue<ObservableListChange> > change;
+
+            bool isIndexed() const
+            {
+                return !file || _indexed;
+            }
+
+            size_t size() const
+            {
+                return file ? _count : text->getSize();
+            }
+
+            std::string operator [] (size_t index) const
+            {
+                std::string out;
+                if (!file)
+                {
+                    out = text->getItem(index);
+                }
+                else if (index < _count)
+                {
+                    const auto i = std::upper_bound(_starts.begin(), _starts.end(), index) - 1;
+                    const TextEditSegment& segment = _segments[i - _starts.begin()];
+                    out = segment.isFile() ?
+                        file->getLine(segment.fileLine + index - *i) :
+                        segment.lines[index - *i];
+                }
+                return out;
+            }
+
+            bool empty() const
+            {
+                return 0 == size();
+            }
+
+            std::string back() const
+            {
+                return (*this)[size() - 1];
+            }
+
+            const std::vector<std::string>& getText()
+            {
+                if (file && !_textValid)
+                {
+                    std::vector<std::string> lines;
+                    lines.reserve(_count);
+                    for (size_t i = 0; i < _count; ++i)
+                    {
+                        lines.push_back((*this)[i]);
+                    }
+                    text->setIfChanged(lines);
+                    _textValid = true;
+                }
+                return text->get();
+            }
+
+            bool setText(const std::vector<std::string>& value)
+            {
+                const size_t count = size();
+                const bool mapped = file.get();
+                file.reset();
+                _segments.clear();
+                _starts.clear();
+                const bool out =
+                    text->setIfChanged(!value.empty() ? value : textEditClear) ||
+                    mapped;
+                if (out)
+                {
+                    change->setAlways({ 0, count, text->getSize() });
+                }
+                return out;
+            }
+
+            std::vector<TextEditSegment> get(size_t index, size_t count) const
+            {
+                std::vector<TextEditSegment> out;
+                if (!file)
+                {
+                    const auto& lines = text->get();
+                    TextEditSegment segment;
+                    segment.count = count;
+                    segment.lines = std::vector<std::string>(
+                        lines.begin() + index,
+                        lines.begin() + index + count);
+                    out.push_back(segment);
+                }
+                else
+                {
+                    for (size_t i = 0; i < _segments.size() && count > 0; ++i)
+                    {
+                        const size_t start = _starts[i];
+                        const size_t end = start + _segments[i].count;
+                        if (index < end)
+                        {
+                            const size_t j = index - start;
+                            const size_t k = std::min(end - index, count);
+                            out.push_back(getSlice(_segments[i], j, k));
+                            index += k;
+                            count -= k;
+                        }
+                    }
+                }
+                return out;
+            }
+
+            void replace(
+                size_t index,
+                size_t count,
+                const std::vector<TextEditSegment>& value)
+            {
+                const size_t added = getCount(value);
+                if (!file)
+                {
+                    std::vector<std::string> lines;
+                    for (const auto& segment : value)
+                    {
+                        lines.insert(lines.end(), segment.lines.begin(), segment.lines.end());
+                    }
+                    text->replaceItems(index, index + count, lines);
+                }
+                else
+                {
+                    // Keep the segments before and after the range, and split
+                    // the segments that overlap it.
+                    std::vector<TextEditSegment> segments;
+                    bool inserted = false;
+                    for (size_t i = 0; i < _segments.size(); ++i)
+                    {
+                        TextEditSegment& segment = _segments[i];
+                        const size_t start = _starts[i];
+                        const size_t end = start + segment.count;
+                        if (end <= index)
+                        {
+                            _add(segments, std::move(segment));
+                        }
+                        else if (start >= index + count)
+                        {
+                            if (!inserted)
+                            {
+                                _add(segments, value);
+                                inserted = true;
+                            }
+                            _add(segments, std::move(segment));
+                        }
+                        else
+                        {
+                            if (start < index)
+                            {
+                                _add(segments, getSlice(segment, 0, index - start));
+                            }
+                            if (!inserted)
+                            {
+                                _add(segments, value);
+                                inserted = true;
+                            }
+                            if (end > index + count)
+                            {
+                                _add(segments, getSlice(
+                                    segment,
+                                    index + count - start,
+                                    end - index - count));
+                            }
+                        }
+                    }
+                    if (!inserted)
+                    {
+                        _add(segments, value);
+                    }
+                    _segments = std::move(segments);
+                    _update();
+                }
+                change->setAlways({ index, count, added });
+            }
+
+            //! Add the lines of the memory mapped file that have been
+            //! indexed. The text is read only until all of the lines have
+            //! been indexed, so new lines are always added at the end.
+            void updateFile()
+            {
+                if (!file || _indexed)
+                    return;
+                const bool indexed = file->isIndexed();
+                const size_t fileLines = file->getLineCount();
+                if (fileLines > _fileLines)
+                {
+                    const size_t index = _count;
+                    const size_t added = fileLines - _fileLines;
+                    TextEditSegment segment;
+                    segment.fileLine = _fileLines;
+                    segment.count = added;
+                    _add(_segments, std::move(segment));
+                    _fileLines = fileLines;
+                    _update();
+                    change->setAlways({ index, 0, added });
+                }
+                _indexed = indexed;
+            }
+
+        private:
+            static void _add(std::vector<TextEditSegment>& segments, TextEditSegment&& value)
+            {
+                if (value.count > 0)
+                {
+                    if (!segments.empty() &&
+                        segments.back().isFile() &&
+                        value.isFile() &&
+                        segments.back().fileLine + segments.back().count == value.fileLine)
+                    {
+                        segments.back().count += value.count;
+                    }
+                    else
+                    {
+                        segments.push_back(std::move(value));
+                    }
+                }
+            }
+
+            static void _add(
+                std::vector<TextEditSegment>& segments,
+                const std::vector<TextEditSegment>& value)
+            {
+                for (auto segment : value)
+                {
+                    _add(segments, std::move(segment));
+                }
+            }
+
+            void _update()
+            {
+                _starts.resize(_segments.size());
+                _count = 0;
+                for (size_t i = 0; i < _segments.size(); ++i)
+                {
+                    _starts[i] = _count;
+                    _count += _segments[i].count;
+                }
+                _textValid = false;
+            }
+
+            std::vector<TextEditSegment> _segments;
+            std::vector<size_t> _starts;
+            size_t _count = 0;
+            size_t _fileLines = 0;
+            bool _indexed = false;
+            bool _textValid = false;
+        };
+
+        //! Text edit command. The command stores the lines that were
+        //! replaced and the lines that replaced them, and the cursor and
+        //! selection before and after the edit. Lines of memory mapped files
+        //! are stored as file segments.
+        class TextEditCommand : public ICommand
+        {
+        public:
+            TextEditCommand(
+                const std::shared_ptr<TextEditStorage>& storage,
+                const std::shared_ptr<ObservableValue<TextEditPos> >& cursor,
+                const std::shared_ptr<ObservableValue<TextEditSelection> >& selection,
+                size_t index,
+                std::vector<TextEditSegment>&& removed,
+                const std::vector<std::string>& added) :
+                _storage(storage),
+                _cursor(cursor),
+                _selection(selection),
+                _index(index),
+                _removed(std::move(removed)),
+                _cursorPrev(cursor->get()),
+                _selectionPrev(selection->get())
+            {
+                _added.count = added.size();
+                _added.lines = added;
+            }
+
+            virtual ~TextEditCommand() {}
+
+            void setNext(const TextEditPos& cursor, const TextEditSelection& selection)
+            {
+                _cursorNext = cursor;
+                _selectionNext = selection;
+            }
+
+            //! Merge text input into a single line edit.
+            bool merge(size_t index, const std::string& line, const TextEditPos& cursor)
+            {
+                bool out = false;
+                if (index == _index &&
+                    1 == getCount(_removed) &&
+                    1 == _added.count &&
+                    _cursorNext == _cursor->get() &&
+                    !_selection->get().isValid())
+                {
+                    _added.lines.front() = line;
+                    _cursorNext = cursor;
+                    _storage->replace(_index, 1, { _added });
+                    _cursor->setIfChanged(_cursorNext);
+                    out = true;
+                }
+                return out;
+            }
+
+            void exec() override
+            {
+                _storage->replace(_index, getCount(_removed), { _added });
+                _cursor->setIfChanged(_cursorNext);
+                _selection->setIfChanged(_selectionNext);
+            }
+
+            void undo() override
+            {
+                _storage->replace(_index, _added.count, _removed);
+                _cursor->setIfChanged(_cursorPrev);
+                _selection->setIfChanged(_selectionPrev);
+            }
+
+        private:
+            std::shared_ptr<TextEditStorage> _storage;
+            std::shared_ptr<ObservableValue<TextEditPos> > _cursor;
+            std::shared_ptr<ObservableValue<TextEditSelection> > _selection;
+            size_t _index = 0;
+            std::vector<TextEditSegment> _removed;
+            TextEditSegment _added;
+            TextEditPos _cursorPrev;
+            TextEditPos _cursorNext;
+            TextEditSelection _selectionPrev;
+            TextEditSelection _selectionNext;
+        };
     }
 
     TextEditPos::TextEditPos(int line, int chr) :
@@ -99,23 +506,53 @@ namespace ftk
     struct TextEditModel::Private
     {
         std::weak_ptr<Context> context;
-        std::shared_ptr<ObservableList<std::string> > text;
+        std::shared_ptr<TextEditStorage> storage;
+        std::shared_ptr<Timer> fileTimer;
         std::shared_ptr<ObservableValue<TextEditPos> > cursor;
         std::shared_ptr<ObservableValue<TextEditSelection> > selection;
         int pageRows = 0;
         std::shared_ptr<ObservableValue<TextEditModelOptions> > options;
+        std::shared_ptr<CommandStack> commandStack;
+        std::shared_ptr<TextEditCommand> edit;
+        std::shared_ptr<TextEditCommand> input;
     };
 
     void TextEditModel::_init(
         const std::shared_ptr<Context>& context,
-        const std::vector<std::string>& text)
+        const std::vector<std::string>& text,
+        const std::shared_ptr<MappedText>& file)
     {
         FTK_P();
         p.context = context;
-        p.text = ObservableList<std::string>::create(!text.empty() ? text : textEditClear);
+        if (file)
+        {
+            p.storage = std::make_shared<TextEditStorage>(file);
+            if (!p.storage->isIndexed())
+            {
+                p.fileTimer = Timer::create(context);
+                p.fileTimer->setRepeating(true);
+                p.fileTimer->start(
+                    fileTimeout,
+                    [this]
+                    {
+                        FTK_P();
+                        p.storage->updateFile();
+                        if (p.storage->isIndexed())
+                        {
+                            p.fileTimer->stop();
+                        }
+                    });
+            }
+        }
+        else
+        {
+            p.storage = std::make_shared<TextEditStorage>(text);
+        }
         p.cursor = ObservableValue<TextEditPos>::create(TextEditPos(0, 0));
         p.selection = ObservableValue<TextEditSelection>::create();
         p.options = ObservableValue<TextEditModelOptions>::create();
+        p.commandStack = CommandStack::create();
+        p.commandStack->setMax(textEditUndoMax);
     }
 
     TextEditModel::TextEditModel() :
@@ -134,24 +571,35 @@ namespace ftk
         return out;
     }
 
+    std::shared_ptr<TextEditModel> TextEditModel::create(
+        const std::shared_ptr<Context>& context,
+        const std::shared_ptr<MappedText>& file)
+    {
+        auto out = std::shared_ptr<TextEditModel>(new TextEditModel);
+        out->_init(context, {}, file);
+        return out;
+    }
+
     const std::vector<std::string>& TextEditModel::getText() const
     {
-        return _p->text->get();
+        return _p->storage->getText();
     }
 
     std::shared_ptr<IObservableList<std::string> > TextEditModel::observeText() const
     {
-        return _p->text;
+        return _p->storage->text;
     }
 
     void TextEditModel::setText(const std::vector<std::string>& value)
     {
         FTK_P();
-        if (p.text->setIfChanged(!value.empty() ? value : textEditClear))
+        p.fileTimer.reset();
+        if (p.storage->setText(value))
         {
             p.cursor->setIfChanged(TextEditPos(0, 0));
             p.selection->setIfChanged(TextEditSelection());
         }
+        clearUndo();
     }
 
     void TextEditModel::clearText()
@@ -159,6 +607,31 @@ namespace ftk
         setText({});
     }
 
+    size_t TextEditModel::getLineCount() const
+    {
+        return _p->storage->size();
+    }
+
+    std::string TextEditModel::getLine(size_t index) const
+    {
+        return (*_p->storage)[index];
+    }
+
+    std::shared_ptr<IObservableValue<ObservableListChange> > TextEditModel::observeLines() const
+    {
+        return _p->storage->change;
+    }
+
+    bool TextEditModel::isReadOnly() const
+    {
+        return !_p->storage->isIndexed();
+    }
+
+    bool TextEditModel::isMapped() const
+    {
+        return _p->storage->file != nullptr;
+    }
+
     const TextEditPos& TextEditModel::getCursor() const
     {
         return _p->cursor->get();
@@ -172,7 +645,7 @@ namespace ftk
     void TextEditModel::setCursor(const TextEditPos& value)
     {
         FTK_P();
-        const auto& text = p.text->get();
+        const auto& text = *p.storage;
         TextEditPos tmp = value;
         tmp.line = clamp(tmp.line, 0, static_cast<int>(text.size()) - 1);
         tmp.chr = tmp.line < text.size() ?
@@ -197,7 +670,7 @@ namespace ftk
     void TextEditModel::setSelection(const TextEditSelection& value)
     {
         FTK_P();
-        const auto& text = p.text->get();
+        const auto& text = *p.storage;
         TextEditSelection tmp = value;
         tmp.first.line = clamp(tmp.first.line, 0, static_cast<int>(text.size()) - 1);
         tmp.first.chr =  tmp.first.line < text.size() ?
@@ -223,10 +696,35 @@ namespace ftk
     }
 
     void TextEditModel::undo()
-    {}
+    {
+        FTK_P();
+        p.input.reset();
+        p.commandStack->undo();
+    }
 
     void TextEditModel::redo()
-    {}
+    {
+        FTK_P();
+        p.input.reset();
+        p.commandStack->redo();
+    }
+
+    void TextEditModel::clearUndo()
+    {
+        FTK_P();
+        p.input.reset();
+        p.commandStack->clear();
+    }
+
+    std::shared_ptr<IObservableValue<bool> > TextEditModel::observeHasUndo() const
+    {
+        return _p->commandStack->observeHasUndo();
+    }
+
+    std::shared_ptr<IObservableValue<bool> > TextEditModel::observeHasRedo() const
+    {
+        return _p->commandStack->observeHasRedo();
+    }
 
     void TextEditModel::cut()
     {
@@ -237,17 +735,20 @@ namespace ftk
             std::string clipboardText;
             TextEditPos cursor = p.cursor->get();
             TextEditSelection selection = p.selection->get();
+            bool changed = false;
             if (selection.isValid())
             {
                 const auto lines = _getSelection(selection);
                 clipboardText = join(lines, '\n');
-                _replace(selection, {});
+                changed = _replace(selection, {});
                 cursor = selection.min();
                 selection = TextEditSelection();
             }
             clipboard->setText(clipboardText);
-            p.cursor->setIfChanged(cursor);
-            p.selection->setIfChanged(selection);
+            if (changed)
+            {
+                _commit(cursor, selection);
+            }
         }
     }
 
@@ -280,16 +781,19 @@ namespace ftk
                 const auto lines = splitLines(clipboardText);
                 TextEditPos cursor = p.cursor->get();
                 TextEditSelection selection = p.selection->get();
+                bool changed = false;
                 if (selection.isValid())
                 {
-                    _replace(selection, lines);
+                    changed = _replace(selection, lines);
                     cursor = selection.min();
                     selection = TextEditSelection();
                 }
                 else
                 {
-                    _replace(TextEditSelection(cursor, cursor), lines);
+                    changed = _replace(TextEditSelection(cursor, cursor), lines);
                 }
+                if (!changed)
+                    return;
                 if (1 == lines.size())
                 {
                     cursor.chr += static_cast<int>(lines.front().size());
@@ -299,8 +803,7 @@ namespace ftk
                     cursor.line += static_cast<int>(lines.size()) - 1;
                     cursor.chr = static_cast<int>(lines.back().size());
                 }
-                p.cursor->setIfChanged(cursor);
-                p.selection->setIfChanged(selection);
+                _commit(cursor, selection);
             }
         }
     }
@@ -308,14 +811,14 @@ namespace ftk
     void TextEditModel::input(const std::string& value)
     {
         FTK_P();
-        const auto& text = p.text->get();
+        const auto& text = *p.storage;
         TextEditPos cursor = p.cursor->get();
         TextEditSelection selection = p.selection->get();
-
+        bool changed = false;
         if (selection.isValid())
         {
             // Replace the selection.
-            _replace(selection, { value });
+            changed = _replace(selection, { value });
             cursor = selection.min();
             cursor.chr += value.size();
             selection = TextEditSelection();
@@ -328,19 +831,26 @@ namespace ftk
                 std::string line = text[cursor.line];
                 line.insert(cursor.chr, value);
                 cursor.chr += value.size();
-                p.text->setItem(cursor.line, line);
+                if (p.input && p.input->merge(cursor.line, line, cursor))
+                {
+                    return;
+                }
+                changed = _replaceLines(cursor.line, 1, { line });
             }
             else
             {
                 // Add a line.
                 std::string line = value;
                 cursor.chr = line.size();
-                p.text->pushBack(line);
+                changed = _replaceLines(text.size(), 0, { line });
             }
         }
+        if (!changed)
+            return;
 
-        p.cursor->setIfChanged(cursor);
-        p.selection->setIfChanged(selection);
+        const auto edit = p.edit;
+        _commit(cursor, selection);
+        p.input = edit;
     }
 
     bool TextEditModel::key(Key key, int modifiers)
@@ -458,7 +968,7 @@ namespace ftk
     {
         FTK_P();
         TextEditPos out = value;
-        const auto& text = p.text->get();
+        const auto& text = *p.storage;
         if (out.line >= 0 &&
             out.line < static_cast<int>(text.size()))
         {
@@ -479,7 +989,7 @@ namespace ftk
     {
         FTK_P();
         TextEditPos out = value;
-        const auto& text = p.text->get();
+        const auto& text = *p.storage;
         if (out.line >= 0 &&
             out.line < static_cast<int>(text.size()))
         {
@@ -499,7 +1009,7 @@ namespace ftk
     TextEditSelection TextEditModel::_getSelectAll() const
     {
         FTK_P();
-        const auto& text = p.text->get();
+        const auto& text = *p.storage;
         return !text.empty() ?
             TextEditSelection(
                 TextEditPos(0, 0),
@@ -513,7 +1023,7 @@ namespace ftk
     {
         FTK_P();
         std::vector<std::string> out;
-        const auto& text = p.text->get();
+        const auto& text = *p.storage;
         const TextEditPos min = selection.min();
         const TextEditPos max = selection.max();
         if (min.line == max.line)
@@ -543,7 +1053,7 @@ namespace ftk
     void TextEditModel::_move(Key key, int modifiers)
     {
         FTK_P();
-        const auto& text = p.text->get();
+        const auto& text = *p.storage;
         TextEditPos cursor = p.cursor->get();
         TextEditSelection selection = p.selection->get();
         if (static_cast<int>(KeyModifier::Shift) == modifiers)
@@ -620,8 +1130,7 @@ namespace ftk
         {
             selection.second = cursor;
         }
-        p.cursor->setIfChanged(cursor);
-        p.selection->setIfChanged(selection);
+        _commit(cursor, selection);
     }
 
     void TextEditModel::_backspace()
@@ -629,10 +1138,11 @@ namespace ftk
         FTK_P();
         TextEditPos cursor = p.cursor->get();
         TextEditSelection selection = p.selection->get();
+        bool changed = false;
         if (selection.isValid())
         {
             // Remove the selection.
-            _replace(selection, {});
+            changed = _replace(selection, {});
             cursor = selection.min();
             selection = TextEditSelection();
         }
@@ -641,12 +1151,14 @@ namespace ftk
             const TextEditPos prev = _getPrev(cursor);
             if (cursor != prev)
             {
-                _replace(TextEditSelection(cursor, prev), {});
+                changed = _replace(TextEditSelection(cursor, prev), {});
                 cursor = prev;
             }
         }
-        p.cursor->setIfChanged(cursor);
-        p.selection->setIfChanged(selection);
+        if (changed)
+        {
+            _commit(cursor, selection);
+        }
     }
 
     void TextEditModel::_delete()
@@ -654,10 +1166,11 @@ namespace ftk
         FTK_P();
         TextEditPos cursor = p.cursor->get();
         TextEditSelection selection = p.selection->get();
+        bool changed = false;
         if (selection.isValid())
         {
             // Remove the selection.
-            _replace(selection, {});
+            changed = _replace(selection, {});
             cursor = selection.min();
             selection = TextEditSelection();
         }
@@ -666,53 +1179,59 @@ namespace ftk
             const TextEditPos next = _getNext(cursor);
             if (cursor != next)
             {
-                _replace(TextEditSelection(cursor, next), {});
+                changed = _replace(TextEditSelection(cursor, next), {});
             }
         }
-        p.cursor->setIfChanged(cursor);
-        p.selection->setIfChanged(selection);
+        if (changed)
+        {
+            _commit(cursor, selection);
+        }
     }
 
     void TextEditModel::_return()
     {
         FTK_P();
-        const auto& text = p.text->get();
+        const auto& text = *p.storage;
         TextEditPos cursor = p.cursor->get();
         TextEditSelection selection = p.selection->get();
+        bool changed = false;
         if (selection.isValid())
         {
             // Remove the selection.
-            _replace(selection, {});
+            changed = _replace(selection, {});
             cursor = selection.second;
             selection = TextEditSelection();
         }
         else if (0 == cursor.chr)
         {
             // Insert a line.
-            p.text->insertItem(cursor.line, std::string());
+            changed = _replaceLines(cursor.line, 0, { std::string() });
             ++cursor.line;
         }
         else
         {
             // Break the line.
             const std::string& line = text[cursor.line];
-            p.text->replaceItems(
+            changed = _replaceLines(
                 cursor.line,
-                cursor.line + 1,
+                1,
                 { line.substr(0, cursor.chr), line.substr(cursor.chr) });
             ++cursor.line;
             cursor.chr = 0;
         }
-        p.cursor->setIfChanged(cursor);
-        p.selection->setIfChanged(selection);
+        if (changed)
+        {
+            _commit(cursor, selection);
+        }
     }
 
     void TextEditModel::_tab(int modifiers)
     {
         FTK_P();
-        const auto& text = p.text->get();
+        const auto& text = *p.storage;
         TextEditPos cursor = p.cursor->get();
         TextEditSelection selection = p.selection->get();
+        bool changed = false;
         if (0 == modifiers &&
             selection.isValid())
         {
@@ -728,7 +1247,7 @@ namespace ftk
             {
                 line.insert(0, indent);
             }
-            _replace(tmp, lines);
+            changed = _replace(tmp, lines);
             const int tabSpaces = p.options->get().tabSpaces;
             cursor.chr += tabSpaces;
             selection.first.chr += tabSpaces;
@@ -762,7 +1281,7 @@ namespace ftk
                 }
                 lastSpacesRemoved = j;
             }
-            _replace(tmp, lines);
+            changed = _replace(tmp, lines);
             cursor.chr = std::max(0, cursor.chr - lastSpacesRemoved);
             selection.first.chr = std::max(0, selection.first.chr - lastSpacesRemoved);
             selection.second.chr = std::max(0, selection.second.chr - lastSpacesRemoved);
@@ -777,23 +1296,25 @@ namespace ftk
             std::string line = text[cursor.line];
             line.insert(cursor.chr, _getTabSpaces());
             cursor.chr += p.options->get().tabSpaces;
-            p.text->setItem(cursor.line, line);
+            changed = _replaceLines(cursor.line, 1, { line });
+        }
+        if (changed)
+        {
+            _commit(cursor, selection);
         }
-        p.cursor->setIfChanged(cursor);
-        p.selection->setIfChanged(selection);
     }
 
-    void TextEditModel::_replace(
+    bool TextEditModel::_replace(
         const TextEditSelection& selection,
         const std::vector<std::string>& value)
     {
         FTK_P();
         const TextEditPos min = selection.min();
         const TextEditPos max = selection.max();
-        const auto& text = p.text->get();
+        const auto& text = *p.storage;
         if (selection == _getSelectAll())
         {
-            p.text->setIfChanged(!value.empty() ? value : textEditClear);
+            return _replaceLines(0, text.size(), !value.empty() ? value : textEditClear);
         }
         else if (min.line == max.line && value.size() <= 1)
         {
@@ -802,7 +1323,7 @@ namespace ftk
                 line.substr(0, min.chr) +
                 (!value.empty() ? value.front() : std::string()) +
                 line.substr(max.chr);
-            p.text->setItemOnlyIfChanged(min.line, tmp);
+            return _replaceLines(min.line, 1, { tmp });
         }
         else if (min.line == max.line)
         {
@@ -814,7 +1335,7 @@ namespace ftk
                 tmp.push_back(value[i]);
             }
             tmp.push_back(line.substr(max.chr) + value.back());
-            p.text->replaceItems(min.line, min.line + 1, tmp);
+            return _replaceLines(min.line, 1, tmp);
         }
         else if (value.size() <= 1)
         {
@@ -824,7 +1345,7 @@ namespace ftk
                 tmp += value.front();
             }
             tmp += text[max.line].substr(max.chr);
-            p.text->replaceItems(min.line, max.line + 1, { tmp });
+            return _replaceLines(min.line, max.line - min.line + 1, { tmp });
         }
         else
         {
@@ -835,7 +1356,55 @@ namespace ftk
                 tmp.push_back(value[i]);
             }
             tmp.push_back(value.back() + text[max.line].substr(max.chr));
-            p.text->replaceItems(min.line, max.line + 1, tmp);
+            return _replaceLines(min.line, max.line - min.line + 1, tmp);
+        }
+    }
+
+    bool TextEditModel::_replaceLines(
+        size_t index,
+        size_t count,
+        const std::vector<std::string>& value)
+    {
+        FTK_P();
+        if (!p.storage->isIndexed())
+            return false;
+        const auto& text = *p.storage;
+        bool changed = count != value.size();
+        for (size_t i = 0; i < value.size() && !changed; ++i)
+        {
+            changed = text[index + i] != value[i];
+        }
+        if (changed)
+        {
+            // The edit is applied when it is committed.
+            p.edit = std::make_shared<TextEditCommand>(
+                p.storage,
+                p.cursor,
+                p.selection,
+                index,
+                text.get(index, count),
+                value);
+        }
+        return changed;
+    }
+
+    void TextEditModel::_commit(
+        const TextEditPos& cursor,
+        const TextEditSelection& selection)
+    {
+        FTK_P();
+        p.input.reset();
+        if (p.edit)
+        {
+            const auto edit = p.edit;
+            p.edit.reset();
+            edit->setNext(cursor, selection);
+            p.commandStack->push(edit);
+        }
+        else
+        {
+            p.cursor->setIfChanged(cursor);
+            p.selection->setIfChanged(selection);
         }
     }
 
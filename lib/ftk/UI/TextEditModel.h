@@ -5,6 +5,7 @@
 
 #include <ftk/UI/Event.h>
 
+#include <ftk/Core/MappedText.h>
 #include <ftk/Core/ObservableList.h>
 #include <ftk/Core/ObservableValue.h>
 
@@ -62,15 +63,27 @@ namespace ftk
         bool operator != (const TextEditModelOptions&) const;
     };
 
+    //! Maximum number of edits in the text edit undo history.
+    const size_t textEditUndoMax = 1000;
+
     //! Text edit model.
-    //! 
-    //! \todo Implement undo/redo.
+    //!
+    //! Edits are stored in an undo history as the range of lines that was
+    //! replaced and the lines that replaced it, so the history does not
+    //! keep copies of the whole text. Consecutive text input on a line is
+    //! merged into a single edit. The oldest edits are removed when the
+    //! history is larger than textEditUndoMax.
+    //!
+    //! Memory mapped files are not copied into memory, only the lines that
+    //! are edited. The model is read only until all of the lines in the
+    //! file have been indexed, and lines are added as they are indexed.
     class TextEditModel : public std::enable_shared_from_this<TextEditModel>
     {
     protected:
         void _init(
             const std::shared_ptr<Context>&,
-            const std::vector<std::string>&);
+            const std::vector<std::string>&,
+            const std::shared_ptr<MappedText>& = nullptr);
 
         TextEditModel();
 
@@ -82,18 +95,43 @@ namespace ftk
             const std::shared_ptr<Context>&,
             const std::vector<std::string>& = {});
 
+        //! Create a new text edit model for a memory mapped file.
+        static std::shared_ptr<TextEditModel> create(
+            const std::shared_ptr<Context>&,
+            const std::shared_ptr<MappedText>&);
+
         //! \name Text
         ///@{
 
+        //! Get the text. For memory mapped files this copies all of the
+        //! lines, use getLine() instead.
         const std::vector<std::string>& getText() const;
+
+        //! Observe the text. For memory mapped files the list is only
+        //! updated when getText() is called, use observeLines() instead.
         std::shared_ptr<IObservableList<std::string> > observeText() const;
 
         //! Set the text. Setting the text will also set the cursor to the
-        //! beginning and clear the selection.
+        //! beginning, clear the selection, and clear the undo history.
         void setText(const std::vector<std::string>&);
 
         void clearText();
 
+        //! Get the number of lines.
+        size_t getLineCount() const;
+
+        //! Get a line.
+        std::string getLine(size_t) const;
+
+        //! Observe changes to the lines.
+        std::shared_ptr<IObservableValue<ObservableListChange> > observeLines() const;
+
+        //! Get whether the text is read only.
+        bool isReadOnly() const;
+
+        //! Get whether the text is a memory mapped file.
+        bool isMapped() const;
+
         ///@}
 
         //! \name Cursor
@@ -124,6 +162,12 @@ namespace ftk
         void undo();
         void redo();
 
+        //! Clear the undo history.
+        void clearUndo();
+
+        std::shared_ptr<IObservableValue<bool> > observeHasUndo() const;
+        std::shared_ptr<IObservableValue<bool> > observeHasRedo() const;
+
         ///@}
 
         //! \name Clipboard
@@ -173,9 +217,14 @@ namespace ftk
         void _return();
         void _tab(int modifiers);
 
-        void _replace(
+        bool _replace(
             const TextEditSelection&,
             const std::vector<std::string>&);
+        bool _replaceLines(
+            size_t index,
+            size_t count,
+            const std::vector<std::string>&);
+        void _commit(const TextEditPos&, const TextEditSelection&);
 
         FTK_PRIVATE();
     };
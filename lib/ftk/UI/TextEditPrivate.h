@@ -6,8 +6,64 @@
 #include <ftk/UI/IMouseWidget.h>
 #include <ftk/UI/TextEdit.h>
 
+#include <ftk/Core/ImplicitTreap.h>
+
+#include <limits>
+
 namespace ftk
 {
+    //! Range of text edit line widths.
+    struct TextEditWidthRange
+    {
+        TextEditWidthRange() = default;
+        explicit TextEditWidthRange(int);
+
+        int min = std::numeric_limits<int>::max();
+        int max = std::numeric_limits<int>::min();
+
+        void merge(const TextEditWidthRange&);
+    };
+
+    //! Text edit line index. The index caches the width of each line so
+    //! that edits only measure the lines that have changed. A negative
+    //! width marks a line that has not been measured.
+    //!
+    //! The widths are stored in an implicit treap with the minimum and
+    //! maximum width of each subtree. Getting and setting a width,
+    //! replacing lines, and finding the next line that has not been
+    //! measured are O(log n) plus the number of lines that are added or
+    //! removed.
+    class TextEditLineIndex
+    {
+    public:
+        //! Get the number of lines.
+        size_t getSize() const;
+
+        //! Get the width of a line.
+        int getWidth(size_t) const;
+
+        //! Get the maximum line width.
+        int getMaxWidth() const;
+
+        //! Set the width of a line.
+        void setWidth(size_t, int);
+
+        //! Replace the lines in the range [index, index + removed) with
+        //! lines of the given widths.
+        void replace(size_t index, size_t removed, const std::vector<int>&);
+
+        //! Find the first line at or after the given index that has not
+        //! been measured. The number of lines is returned if all of the
+        //! lines have been measured.
+        size_t findUnmeasured(size_t) const;
+
+        //! Remove all of the lines.
+        void clear();
+
+    private:
+        ImplicitTreap<int, TextEditWidthRange> _widths;
+    };
+
     class TextEditWidget : public IMouseWidget
     {
     protected:
@@ -31,6 +87,7 @@ namespace ftk
         void clearText();
 
         void setTextCallback(const std::function<void(const std::vector<std::string>&)>&);
+        void setLinesCallback(const std::function<void(const ObservableListChange&)>&);
         void setFocusCallback(const std::function<void(bool)>&);
 
         void selectAll();
@@ -43,10 +100,6 @@ namespace ftk
         void setGeometry(const Box2I&) override;
         void setVisible(bool) override;
         void setEnabled(bool) override;
-        void tickEvent(
-            bool,
-            bool,
-            const TickEvent&) override;
         void sizeHintEvent(const SizeHintEvent&) override;
         void drawEvent(const Box2I&, const DrawEvent&) override;
         void mouseMoveEvent(MouseMoveEvent&) override;
@@ -60,6 +113,7 @@ namespace ftk
     private:
         TextEditPos _getCursorPos(const V2I&) const;
         void _cursorReset();
+        void _autoScrollUpdate(const V2I&);
 
         FTK_PRIVATE();
     };
@@ -12,22 +12,100 @@
 
 #include <ftk/Core/Format.h>
 #include <ftk/Core/RenderUtil.h>
+#include <ftk/Core/Timer.h>
 
 #include <optional>
 
 namespace ftk
 {
+    namespace
+    {
+        const std::chrono::milliseconds measureTimeout(4);
+    }
+
+    TextEditWidthRange::TextEditWidthRange(int width) :
+        min(width),
+        max(width)
+    {}
+
+    void TextEditWidthRange::merge(const TextEditWidthRange& other)
+    {
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    size_t TextEditLineIndex::getSize() const
+    {
+        return _widths.getSize();
+    }
+
+    int TextEditLineIndex::getWidth(size_t index) const
+    {
+        return index < _widths.getSize() ? _widths.get(index) : 0;
+    }
+
+    int TextEditLineIndex::getMaxWidth() const
+    {
+        return _widths.getSize() > 0 ? _widths.getSummary().max : 0;
+    }
+
+    void TextEditLineIndex::setWidth(size_t index, int value)
+    {
+        if (index >= _widths.getSize() || value == _widths.get(index))
+            return;
+        _widths.set(index, value);
+    }
+
+    void TextEditLineIndex::replace(
+        size_t index,
+        size_t removed,
+        const std::vector<int>& widths)
+    {
+        const size_t size = getSize();
+        index = std::min(index, size);
+        removed = std::min(removed, size - index);
+        if (removed == widths.size())
+        {
+            for (size_t i = 0; i < widths.size(); ++i)
+            {
+                setWidth(index + i, widths[i]);
+            }
+        }
+        else
+        {
+            _widths.remove(index, removed);
+            _widths.insert(index, widths);
+        }
+    }
+
+    size_t TextEditLineIndex::findUnmeasured(size_t index) const
+    {
+        return _widths.find(
+            index,
+            [](const TextEditWidthRange& value)
+            {
+                return value.min < 0;
+            });
+    }
+
+    void TextEditLineIndex::clear()
+    {
+        _widths.clear();
+    }
+
     struct TextEditWidget::Private
     {
         TextEditOptions options;
         std::shared_ptr<TextEditModel> model;
         std::function<void(const std::vector<std::string>&)> textCallback;
+        std::function<void(const ObservableListChange&)> linesCallback;
         std::function<void(bool)> focusCallback;
         TextEditPos cursorStart;
         bool cursorVisible = false;
-        std::chrono::steady_clock::time_point cursorTimer;
+        std::shared_ptr<Timer> cursorTimer;
         V2I autoScroll;
-        std::chrono::steady_clock::time_point autoScrollTimer;
+        std::shared_ptr<Timer> autoScrollTimer;
+        std::shared_ptr<Timer> measureTimer;
         TextEditSelection selection;
         std::shared_ptr<FontSystem> fontSystem;
         int mousePress = 0;
@@ -40,14 +118,33 @@ namespace ftk
             FontInfo fontInfo;
             FontMetrics fontMetrics;
             std::optional<Size2I> textSize;
+
+            //! The line index is built when the size is computed, and then
+            //! updated with the changes to the text.
+            TextEditLineIndex lineIndex;
+            bool lineIndexValid = false;
+            std::vector<ObservableListChange> lineChanges;
         };
         SizeData size;
 
-        std::shared_ptr<ListObserver<std::string> > textObserver;
+        //! Get the range of lines that intersect the vertical range.
+        std::pair<int, int> getLineRange(int y0, int y1) const;
+
+        std::shared_ptr<ValueObserver<ObservableListChange> > linesObserver;
         std::shared_ptr<ValueObserver<TextEditPos> > cursorObserver;
         std::shared_ptr<ValueObserver<TextEditSelection> > selectionObserver;
     };
 
+    std::pair<int, int> TextEditWidget::Private::getLineRange(int y0, int y1) const
+    {
+        // Lines have a uniform height, so the range is computed directly.
+        const int lineHeight = std::max(size.fontMetrics.lineHeight, 1);
+        const int lineCount = static_cast<int>(model->getLineCount());
+        return std::make_pair(
+            clamp(y0 / lineHeight, 0, lineCount),
+            clamp(y1 / lineHeight + 1, 0, lineCount));
+    }
+
     void TextEditWidget::_init(
         const std::shared_ptr<Context>& context,
         const std::shared_ptr<TextEditModel>& model,
@@ -63,14 +160,30 @@ namespace ftk
         
         p.fontSystem = context->getSystem<FontSystem>();
 
-        p.textObserver = ListObserver<std::string>::create(
-            p.model->observeText(),
-            [this](const std::vector<std::string>& value)
+        p.cursorTimer = Timer::create(context);
+        p.cursorTimer->setRepeating(true);
+
+        p.autoScrollTimer = Timer::create(context);
+        p.autoScrollTimer->setRepeating(true);
+
+        p.measureTimer = Timer::create(context);
+
+        p.linesObserver = ValueObserver<ObservableListChange>::create(
+            p.model->observeLines(),
+            [this](const ObservableListChange& value)
             {
                 FTK_P();
                 if (p.textCallback)
                 {
-                    p.textCallback(value);
+                    p.textCallback(p.model->getText());
+                }
+                if (p.linesCallback)
+                {
+                    p.linesCallback(value);
+                }
+                if (p.size.lineIndexValid)
+                {
+                    p.size.lineChanges.push_back(value);
                 }
                 p.size.textSize.reset();
                 setSizeUpdate();
@@ -131,6 +244,11 @@ namespace ftk
         _p->textCallback = value;
     }
 
+    void TextEditWidget::setLinesCallback(const std::function<void(const ObservableListChange&)>& value)
+    {
+        _p->linesCallback = value;
+    }
+
     void TextEditWidget::setFocusCallback(const std::function<void(bool)>& value)
     {
         _p->focusCallback = value;
@@ -154,6 +272,7 @@ namespace ftk
         p.options = value;
         p.size.displayScale.reset();
         p.size.textSize.reset();
+        p.size.lineIndexValid = false;
         setSizeUpdate();
         setDrawUpdate();
     }
@@ -161,14 +280,13 @@ namespace ftk
     Box2I TextEditWidget::getCursorBox(bool margin) const
     {
         FTK_P();
-        const auto& text = p.model->getText();
         const TextEditPos& cursor = p.model->getCursor();
         V2I pos(p.size.margin, p.size.margin);
-        if (cursor.line >= 0 && cursor.line < text.size())
+        if (cursor.line >= 0 && cursor.line < static_cast<int>(p.model->getLineCount()))
         {
             pos.y += p.size.fontMetrics.lineHeight * cursor.line;
-            const std::string& line = text[cursor.line];
-            pos.x += p.fontSystem->getSize(line.substr(0, cursor.chr), p.size.fontInfo).w;
+            const std::string line = p.model->getLine(cursor.line);
+            pos.x += p.fontSystem->getRun(line, p.size.fontInfo)->getPrefixWidth(cursor.chr);
         }
 
         Box2I out = Box2I(pos.x, pos.y, p.size.border, p.size.fontMetrics.lineHeight);
@@ -197,6 +315,7 @@ namespace ftk
         IMouseWidget::setVisible(value);
         if (changed && !isVisible(false))
         {
+            p.cursorTimer->stop();
             if (p.cursorVisible)
             {
                 p.cursorVisible = false;
@@ -212,6 +331,7 @@ namespace ftk
         IMouseWidget::setEnabled(value);
         if (changed && !isEnabled(false))
         {
+            p.cursorTimer->stop();
             if (p.cursorVisible)
             {
                 p.cursorVisible = false;
@@ -220,47 +340,6 @@ namespace ftk
         }
     }
 
-    void TextEditWidget::tickEvent(
-        bool parentsVisible,
-        bool parentsEnabled,
-        const TickEvent& event)
-    {
-        IMouseWidget::tickEvent(parentsVisible, parentsEnabled, event);
-        FTK_P();
-
-        if (hasKeyFocus())
-        {
-            const auto now = std::chrono::steady_clock::now();
-            const std::chrono::duration<float> diff = now - p.cursorTimer;
-            if (diff.count() > p.options.cursorBlink)
-            {
-                p.cursorVisible = !p.cursorVisible;
-                setDrawUpdate();
-                p.cursorTimer = now;
-            }
-        }
-        else if (p.cursorVisible)
-        {
-            p.cursorVisible = false;
-            setDrawUpdate();
-        }
-
-        if (p.autoScroll.x != 0 || p.autoScroll.y != 0)
-        {
-            const auto now = std::chrono::steady_clock::now();
-            const std::chrono::duration<float> diff = now - p.autoScrollTimer;
-            if (diff.count() > p.options.autoScrollTimeout)
-            {
-                auto cursor = p.model->getCursor();
-                cursor.line += p.autoScroll.y;
-                cursor.chr += p.autoScroll.x;
-                p.model->setCursor(cursor);
-                p.model->setSelection(TextEditSelection(p.cursorStart, cursor));
-                p.autoScrollTimer = now;
-            }
-        }
-    }
-
     void TextEditWidget::sizeHintEvent(const SizeHintEvent& event)
     {
         IMouseWidget::sizeHintEvent(event);
@@ -280,15 +359,63 @@ namespace ftk
         
         if (!p.size.textSize.has_value())
         {
-            p.size.textSize = Size2I();
-            const auto& text = p.model->getText();
-            for (size_t i = 0; i < text.size(); ++i)
+            // Apply the changes to the line index, and then measure the
+            // lines that have changed.
+            const size_t lineCount = p.model->getLineCount();
+            for (const auto& change : p.size.lineChanges)
+            {
+                if (!p.size.lineIndexValid ||
+                    change.index + change.removed > p.size.lineIndex.getSize())
+                {
+                    p.size.lineIndexValid = false;
+                    break;
+                }
+                p.size.lineIndex.replace(
+                    change.index,
+                    change.removed,
+                    std::vector<int>(change.added, -1));
+            }
+            p.size.lineChanges.clear();
+            if (!p.size.lineIndexValid || p.size.lineIndex.getSize() != lineCount)
+            {
+                p.size.lineIndex.clear();
+                p.size.lineIndex.replace(0, 0, std::vector<int>(lineCount, -1));
+                p.size.lineIndexValid = true;
+            }
+
+            // Large documents are measured over multiple updates so that
+            // the first lines are shown immediately.
+            const auto t0 = std::chrono::steady_clock::now();
+            size_t measured = 0;
+            size_t i = p.size.lineIndex.findUnmeasured(0);
+            while (i < lineCount)
             {
-                p.size.textSize->w = std::max(
-                    event.fontSystem->getSize(text[i], p.size.fontInfo).w,
-                    p.size.textSize->w);
-                p.size.textSize->h += p.size.fontMetrics.lineHeight;
+                p.size.lineIndex.setWidth(
+                    i,
+                    event.fontSystem->getSize(p.model->getLine(i), p.size.fontInfo).w);
+                i = p.size.lineIndex.findUnmeasured(i + 1);
+                ++measured;
+                if (0 == measured % 256 &&
+                    std::chrono::steady_clock::now() - t0 > measureTimeout)
+                {
+                    break;
+                }
             }
+            if (i < lineCount)
+            {
+                p.measureTimer->start(
+                    std::chrono::microseconds(0),
+                    [this]
+                    {
+                        _p->size.textSize.reset();
+                        setSizeUpdate();
+                        setDrawUpdate();
+                    });
+            }
+
+            p.size.textSize = Size2I(
+                std::max(p.size.lineIndex.getMaxWidth(), 0),
+                p.size.fontMetrics.lineHeight * static_cast<int>(lineCount));
         }
 
         _setSizeHint(margin(p.size.textSize.value(), p.size.margin));
@@ -304,7 +431,7 @@ namespace ftk
         const Box2I& g = getGeometry();
 
         // Draw the selection.
-        const auto& text = p.model->getText();
+        const int lineCount = static_cast<int>(p.model->getLineCount());
         const Box2I g2(
             g.min.x + p.size.margin,
             g.min.y + p.size.margin,
@@ -312,18 +439,21 @@ namespace ftk
             g.h() - p.size.margin * 2);
         if (p.selection.isValid() &&
             p.selection.first.line >= 0 &&
-            p.selection.first.line < static_cast<int>(text.size()) &&
+            p.selection.first.line < lineCount &&
             p.selection.second.line >= 0 &&
-            p.selection.second.line < static_cast<int>(text.size()))
+            p.selection.second.line < lineCount)
         {
             std::vector<Box2I> boxes;
             const TextEditPos min = p.selection.min();
             const TextEditPos max = p.selection.max();
+            const auto lineRange = p.getLineRange(
+                drawRect.min.y - g2.min.y,
+                drawRect.max.y - g2.min.y);
             if (min.line == max.line)
             {
-                const std::string& line = text[min.line];
-                const int w0 = event.fontSystem->getSize(line.substr(0, min.chr), p.size.fontInfo).w;
-                const int w1 = event.fontSystem->getSize(line.substr(0, max.chr), p.size.fontInfo).w;
+                const auto run = event.fontSystem->getRun(p.model->getLine(min.line), p.size.fontInfo);
+                const int w0 = run->getPrefixWidth(min.chr);
+                const int w1 = run->getPrefixWidth(max.chr);
                 boxes.push_back(Box2I(
                     g2.min.x + w0,
                     g2.min.y + min.line * p.size.fontMetrics.lineHeight,
@@ -332,23 +462,32 @@ namespace ftk
             }
             else
             {
-                int w0 = event.fontSystem->getSize(text[min.line].substr(0, min.chr), p.size.fontInfo).w;
-                int w1 = event.fontSystem->getSize(text[min.line], p.size.fontInfo).w;
+                const auto run = event.fontSystem->getRun(p.model->getLine(min.line), p.size.fontInfo);
+                int w0 = run->getPrefixWidth(min.chr);
+                int w1 = run->size.w;
                 boxes.push_back(Box2I(
                     g2.min.x + w0,
                     g2.min.y + min.line * p.size.fontMetrics.lineHeight,
                     std::max(w1 - w0, p.size.border * 2),
                     p.size.fontMetrics.lineHeight));
-                for (int i = min.line + 1; i < max.line; ++i)
+                const int i0 = std::max(min.line + 1, lineRange.first);
+                const int i1 = std::min(max.line, lineRange.second);
+                for (int i = i0; i < i1; ++i)
                 {
-                    w0 = event.fontSystem->getSize(text[i], p.size.fontInfo).w;
+                    w0 = p.size.lineIndex.getWidth(i);
+                    if (w0 < 0)
+                    {
+                        w0 = event.fontSystem->getSize(p.model->getLine(i), p.size.fontInfo).w;
+                    }
                     boxes.push_back(Box2I(
                         g2.min.x,
                         g2.min.y + i * p.size.fontMetrics.lineHeight,
                         std::max(w0, p.size.border * 2),
                         p.size.fontMetrics.lineHeight));
                 }
-                w0 = event.fontSystem->getSize(text[max.line].substr(0, max.chr), p.size.fontInfo).w;
+                w0 = event.fontSystem->getRun(
+                    p.model->getLine(max.line),
+                    p.size.fontInfo)->getPrefixWidth(max.chr);
                 boxes.push_back(Box2I(
                     g2.min.x,
                     g2.min.y + max.line * p.size.fontMetrics.lineHeight,
@@ -364,24 +503,26 @@ namespace ftk
             }
         }
 
-        // Draw the text.
-        V2I pos(g2.min);
+        // Draw the visible text.
         const bool enabled = isEnabled();
         const Color4F textColor = event.style->getColorRole(enabled ?
             ColorRole::Text :
             ColorRole::TextDisabled);
-        for (const auto& line : text)
+        const auto lineRange = p.getLineRange(
+            drawRect.min.y - g2.min.y,
+            drawRect.max.y - g2.min.y);
+        for (int i = lineRange.first; i < lineRange.second; ++i)
         {
+            const V2I pos(g2.min.x, g2.min.y + i * p.size.fontMetrics.lineHeight);
             const Box2I g3(pos.x, pos.y, p.size.textSize->w, p.size.fontMetrics.lineHeight);
             if (intersects(g3, drawRect))
             {
                 event.render->drawText(
-                    event.fontSystem->getGlyphs(line, p.size.fontInfo),
+                    event.fontSystem->getGlyphs(p.model->getLine(i), p.size.fontInfo),
                     p.size.fontMetrics,
                     pos,
                     textColor);
             }
-            pos.y += p.size.fontMetrics.lineHeight;
         }
 
         // Draw the cursor.
@@ -408,7 +549,7 @@ namespace ftk
             V2I autoScroll;
             if (auto parent = getParentT<ScrollArea>())
             {
-                const Box2I& g = parent->getGeometry();
+                const Box2I g = parent->getGeometry() - parent->getChildrenOffset();
                 if (event.pos.x > g.max.x)
                 {
                     autoScroll.x = 1;
@@ -426,14 +567,7 @@ namespace ftk
                     autoScroll.y = -1;
                 }
             }
-            if (autoScroll.x != 0 || autoScroll.y != 0)
-            {
-                if (autoScroll != p.autoScroll)
-                {
-                    p.autoScrollTimer = std::chrono::steady_clock::now();
-                }
-            }
-            p.autoScroll = autoScroll;
+            _autoScrollUpdate(autoScroll);
 
             const TextEditPos cursor = _getCursorPos(event.pos);
             p.model->setCursor(cursor);
@@ -460,7 +594,7 @@ namespace ftk
         IMouseWidget::mouseReleaseEvent(event);
         FTK_P();
         event.accept = true;
-        p.autoScroll = V2I();
+        _autoScrollUpdate(V2I());
         p.mousePress = 0;
     }
 
@@ -468,6 +602,19 @@ namespace ftk
     {
         IMouseWidget::keyFocusEvent(value);
         FTK_P();
+        if (value)
+        {
+            _cursorReset();
+        }
+        else
+        {
+            p.cursorTimer->stop();
+            if (p.cursorVisible)
+            {
+                p.cursorVisible = false;
+                setDrawUpdate();
+            }
+        }
         if (p.focusCallback)
         {
             p.focusCallback(value);
@@ -517,19 +664,15 @@ namespace ftk
         FTK_P();
         TextEditPos out(0, 0);
         const Box2I& g = getGeometry();
-        const auto& text = p.model->getText();
+        const int lineCount = static_cast<int>(p.model->getLineCount());
         out.line = clamp(
             (value.y - g.min.y - p.size.margin) / p.size.fontMetrics.lineHeight,
             0,
-            static_cast<int>(text.size()) - 1);
-        if (out.line >= 0 && out.line < text.size())
+            lineCount - 1);
+        if (out.line >= 0 && out.line < lineCount)
         {
-            const auto boxes = p.fontSystem->getBoxes(text[out.line], p.size.fontInfo);
-            int end = value.x - g.min.x - p.size.margin;
-            for (;
-                out.chr < boxes.size() && boxes[out.chr].max.x < end;
-                ++out.chr)
-                ;
+            const auto run = p.fontSystem->getRun(p.model->getLine(out.line), p.size.fontInfo);
+            out.chr = run->getIndex(value.x - g.min.x - p.size.margin);
         }
         return out;
     }
@@ -537,7 +680,42 @@ namespace ftk
     void TextEditWidget::_cursorReset()
     {
         FTK_P();
+        if (!hasKeyFocus())
+            return;
         p.cursorVisible = true;
-        p.cursorTimer = std::chrono::steady_clock::now();
+        p.cursorTimer->start(
+            std::chrono::microseconds(static_cast<int64_t>(p.options.cursorBlink * 1000000.F)),
+            [this]
+            {
+                _p->cursorVisible = !_p->cursorVisible;
+                setDrawUpdate();
+            });
+        setDrawUpdate();
+    }
+
+    void TextEditWidget::_autoScrollUpdate(const V2I& value)
+    {
+        FTK_P();
+        if (value == p.autoScroll)
+            return;
+        p.autoScroll = value;
+        if (p.autoScroll.x != 0 || p.autoScroll.y != 0)
+        {
+            p.autoScrollTimer->start(
+                std::chrono::microseconds(static_cast<int64_t>(p.options.autoScrollTimeout * 1000000.F)),
+                [this]
+                {
+                    FTK_P();
+                    auto cursor = p.model->getCursor();
+                    cursor.line += p.autoScroll.y;
+                    cursor.chr += p.autoScroll.x;
+                    p.model->setCursor(cursor);
+                    p.model->setSelection(TextEditSelection(p.cursorStart, cursor));
+                });
+        }
+        else
+        {
+            p.autoScrollTimer->stop();
+        }
     }
 }
\ No newline at end of file
@@ -94,6 +94,12 @@ namespace ftk
         //! automatically.
         void setDisplayScale(float);
 
+        //! Get the number of pixels that were redrawn by the last update.
+        //! Only the regions of the widgets that need a draw update are
+        //! redrawn, the rest of the frame buffer is kept from the previous
+        //! update.
+        size_t getDamagedPixelCount() const;
+
         void setIcon(const std::shared_ptr<Image>&) override;
         std::shared_ptr<Image> screenshot(const Box2I& = Box2I(0, 0, -1, -1)) override;
 
@@ -20,6 +20,7 @@
 #include <ftk/Core/Format.h>
 #include <ftk/Core/LogSystem.h>
 #include <ftk/Core/FontSystem.h>
+#include <ftk/Core/SoftwareRender.h>
 
 #include <SDL2/SDL.h>
 
@@ -39,6 +40,7 @@ namespace ftk
         std::shared_ptr<ObservableValue<ImageType> > bufferType;
         std::shared_ptr<ObservableValue<float> > displayScale;
         bool refresh = true;
+        size_t damagedPixelCount = 0;
         int modifiers = 0;
         std::shared_ptr<gl::Window> window;
 
@@ -229,6 +231,11 @@ namespace ftk
         }
     }
 
+    size_t Window::getDamagedPixelCount() const
+    {
+        return _p->damagedPixelCount;
+    }
+
     void Window::setIcon(const std::shared_ptr<Image>& icon)
     {
         _p->window->setIcon(icon);
@@ -347,30 +354,53 @@ namespace ftk
                 style);
             _sizeHintEventRecursive(shared_from_this(), sizeHintEvent);
 
-            setGeometry(Box2I(V2I(), p.frameBufferSize));
-
-            _clipEventRecursive(
-                shared_from_this(),
-                getGeometry(),
-                !isVisible(false));
+            _layoutUpdate(Box2I(V2I(), p.frameBufferSize));
         }
 
-        const bool drawUpdate = _hasDrawUpdate(shared_from_this());
+        std::vector<Box2I> damage = _getDrawDamage(shared_from_this());
+        const bool drawUpdate = !damage.empty();
+        p.damagedPixelCount = 0;
         if (p.refresh || drawUpdate || sizeUpdate)
         {
             p.window->makeCurrent();
 
+            bool fullUpdate = sizeUpdate;
             gl::OffscreenBufferOptions bufferOptions;
             bufferOptions.color = p.bufferType->get();
             if (gl::doCreate(p.buffer, p.frameBufferSize, bufferOptions))
             {
                 p.buffer = gl::OffscreenBuffer::create(p.frameBufferSize, bufferOptions);
+                fullUpdate = true;
             }
 
             if (p.buffer && (drawUpdate || sizeUpdate))
             {
-                gl::OffscreenBufferBinding bufferBinding(p.buffer);
-                p.render->begin(p.frameBufferSize);
+                // Only the damaged regions are drawn, the rest of the
+                // offscreen buffer is kept from the previous update.
+                const Box2I bounds(V2I(), p.frameBufferSize);
+                if (fullUpdate)
+                {
+                    damage.clear();
+                    damage.push_back(bounds);
+                }
+                Box2I damageBounds = damage.front();
+                for (const auto& rect : damage)
+                {
+                    damageBounds = expand(damageBounds, rect);
+                    p.damagedPixelCount += static_cast<size_t>(rect.w()) * rect.h();
+                }
+                RenderOptions renderOptions;
+                renderOptions.clear = 1 == damage.size() && bounds == damage.front();
+
+                // The software renderer draws into an image that is uploaded
+                // to the offscreen buffer afterwards.
+                auto softwareRender = std::dynamic_pointer_cast<SoftwareRender>(p.render);
+                std::unique_ptr<gl::OffscreenBufferBinding> bufferBinding;
+                if (!softwareRender)
+                {
+                    bufferBinding.reset(new gl::OffscreenBufferBinding(p.buffer));
+                }
+                p.render->begin(p.frameBufferSize, renderOptions);
                 p.render->setClipRectEnabled(true);
                 DrawEvent drawEvent(
                     fontSystem,
@@ -378,12 +408,46 @@ namespace ftk
                     p.displayScale->get(),
                     style,
                     p.render);
-                _drawEventRecursive(
-                    shared_from_this(),
-                    Box2I(V2I(), p.frameBufferSize),
-                    drawEvent);
+                for (const auto& rect : damage)
+                {
+                    if (!renderOptions.clear)
+                    {
+                        p.render->setClipRect(rect);
+                        p.render->clearViewport(renderOptions.clearColor);
+                    }
+                    _drawEventRecursive(
+                        shared_from_this(),
+                        rect,
+                        drawEvent);
+                }
                 p.render->setClipRectEnabled(false);
                 p.render->end();
+
+                if (softwareRender && softwareRender->getImage())
+                {
+                    // Upload the rows that contain the damaged regions. The
+                    // image rows are stored from bottom to top.
+                    const auto& image = softwareRender->getImage();
+                    const int w = image->getWidth();
+                    const int h = image->getHeight();
+                    const int y = clamp(h - 1 - damageBounds.max.y, 0, h - 1);
+                    const int rows = clamp(damageBounds.h(), 0, h - y);
+                    glBindTexture(GL_TEXTURE_2D, p.buffer->getColorID());
+                    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+#if defined(FTK_API_GL_4_1)
+                    glPixelStorei(GL_UNPACK_SWAP_BYTES, 0);
+#endif // FTK_API_GL_4_1
+                    glTexSubImage2D(
+                        GL_TEXTURE_2D,
+                        0,
+                        0,
+                        y,
+                        w,
+                        rows,
+                        GL_RGBA,
+                        GL_UNSIGNED_BYTE,
+                        image->getData() + static_cast<size_t>(y) * w * 4);
+                }
             }
 
 #if defined(FTK_API_GL_4_1)
@@ -16,6 +16,10 @@ namespace ftk
 {
     void fontSystem(py::module_& m)
     {
+        py::enum_<GlyphMode>(m, "GlyphMode")
+            .value("Bitmap", GlyphMode::Bitmap)
+            .value("SDF", GlyphMode::SDF);
+
         py::class_<FontInfo>(m, "FontInfo")
             .def(py::init<>())
             .def(py::init<const std::string&, int>())
@@ -33,8 +37,12 @@ namespace ftk
         py::class_<GlyphInfo>(m, "GlyphInfo")
             .def(py::init<>())
             .def(py::init<uint32_t, const FontInfo&>())
+            .def(py::init<uint32_t, FontID, uint16_t>())
             .def_readwrite("code", &GlyphInfo::code)
-            .def_readwrite("fontInfo", &GlyphInfo::fontInfo)
+            .def_readwrite("fontID", &GlyphInfo::fontID)
+            .def_readwrite("size", &GlyphInfo::size)
+            .def_property_readonly("key", &GlyphInfo::getKey)
+            .def_property_readonly("fontInfo", &GlyphInfo::getFontInfo)
             .def(py::self == py::self)
             .def(py::self != py::self)
             .def(py::self < py::self);
@@ -45,7 +53,9 @@ namespace ftk
             .def_readwrite("offset", &Glyph::offset)
             .def_readwrite("advance", &Glyph::advance)
             .def_readwrite("lsbDelta", &Glyph::lsbDelta)
-            .def_readwrite("rsbDelta", &Glyph::rsbDelta);
+            .def_readwrite("rsbDelta", &Glyph::rsbDelta)
+            .def_readwrite("sdf", &Glyph::sdf)
+            .def_readwrite("imageScale", &Glyph::imageScale);
 
         py::class_<FontSystem, ISystem, std::shared_ptr<FontSystem> >(m, "FontSystem")
             .def(
@@ -70,6 +80,7 @@ namespace ftk
                 "getGlyphs",
                 &FontSystem::getGlyphs,
                 py::arg("text"),
-                py::arg("fontInfo"));
+                py::arg("fontInfo"))
+            .def_property("glyphMode", &FontSystem::getGlyphMode, &FontSystem::setGlyphMode);
     }
 }
\ No newline at end of file
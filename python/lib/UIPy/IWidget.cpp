@@ -16,6 +16,23 @@ namespace ftk
     class PyIWidget : public IWidget
     {
     public:
+        using IWidget::_isTickEnabled;
+        using IWidget::_setTickEnabled;
+
+        virtual void tickEvent(
+            bool parentsVisible,
+            bool parentsEnabled,
+            const TickEvent& event) override
+        {
+            PYBIND11_OVERRIDE(
+                void,
+                IWidget,
+                tickEvent,
+                parentsVisible,
+                parentsEnabled,
+                event);
+        }
+
         virtual void drawEvent(const Box2I& drawRect, const DrawEvent& event) override
         {
             PYBIND11_OVERRIDE(
@@ -80,6 +97,9 @@ namespace ftk
 
             .def_property("tooltip", &IWidget::getTooltip, &IWidget::setTooltip)
 
+            .def("_isTickEnabled", &PyIWidget::_isTickEnabled)
+            .def("_setTickEnabled", &PyIWidget::_setTickEnabled, py::arg("value"))
+
             .def("childAddEvent", &IWidget::childAddEvent, py::arg("event"))
             .def("childRemoveEvent", &IWidget::childRemoveEvent, py::arg("event"))
             .def(
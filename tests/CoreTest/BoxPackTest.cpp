@@ -61,6 +61,34 @@ namespace ftk
                 }
                 _printPack(pack);
             }
+            {
+                auto pack = BoxPack::create(Size2I(100, 100));
+                std::vector<BoxPackID> ids;
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    auto node = pack->insert(Size2I(50, 50));
+                    FTK_ASSERT(node);
+                    ids.push_back(node->id);
+                }
+                FTK_ASSERT(4 == pack->getCount());
+                FTK_ASSERT(100 * 100 == pack->getUsedArea());
+                FTK_ASSERT(pack->hasNode(ids[0]));
+                FTK_ASSERT(!pack->insert(Size2I(50, 50), false));
+                FTK_ASSERT(pack->getNode(ids[0]));
+                auto node = pack->insert(Size2I(50, 50));
+                FTK_ASSERT(node);
+                FTK_ASSERT(!pack->hasNode(ids[1]));
+                FTK_ASSERT(pack->hasNode(ids[0]));
+                FTK_ASSERT(4 == pack->getCount());
+                pack->clear();
+                FTK_ASSERT(0 == pack->getCount());
+                FTK_ASSERT(0 == pack->getUsedArea());
+                FTK_ASSERT(!pack->hasNode(ids[0]));
+                node = pack->insert(Size2I(50, 50));
+                FTK_ASSERT(node);
+                FTK_ASSERT(node->id > ids[3]);
+                FTK_ASSERT(50 * 50 == pack->getUsedArea());
+            }
         }
 
         void BoxPackTest::_printPack(const std::shared_ptr<BoxPack>& pack)
@@ -107,8 +107,47 @@ namespace ftk
                 commandStack->redo();
                 FTK_ASSERT(6 == data->value);
 
+                commandStack->undo();
+                FTK_ASSERT(3 == data->value);
+                FTK_ASSERT(hasRedo);
+                commandStack->push(std::make_shared<AddCommand>(4, data));
+                FTK_ASSERT(7 == data->value);
+                FTK_ASSERT(!hasRedo);
+                commandStack->redo();
+                FTK_ASSERT(7 == data->value);
+
                 commandStack->clear();
                 FTK_ASSERT(!hasUndo);
+                FTK_ASSERT(0 == commandStack->getMax());
+
+                // The oldest commands are removed when the stack is larger
+                // than the maximum.
+                data->value = 0;
+                commandStack->setMax(2);
+                FTK_ASSERT(2 == commandStack->getMax());
+                commandStack->push(std::make_shared<AddCommand>(1, data));
+                commandStack->push(std::make_shared<AddCommand>(2, data));
+                commandStack->push(std::make_shared<AddCommand>(3, data));
+                FTK_ASSERT(6 == data->value);
+                commandStack->undo();
+                commandStack->undo();
+                FTK_ASSERT(1 == data->value);
+                FTK_ASSERT(!hasUndo);
+                commandStack->undo();
+                FTK_ASSERT(1 == data->value);
+                commandStack->redo();
+                FTK_ASSERT(3 == data->value);
+
+                // Commands that can be redone are removed first.
+                commandStack->setMax(1);
+                FTK_ASSERT(!hasRedo);
+                FTK_ASSERT(hasUndo);
+                commandStack->redo();
+                FTK_ASSERT(3 == data->value);
+                commandStack->undo();
+                FTK_ASSERT(1 == data->value);
+                FTK_ASSERT(!hasUndo);
+                commandStack->clear();
                 FTK_ASSERT(!hasRedo);
             }
         }
@@ -8,6 +8,13 @@
 #include <ftk/Core/FontSystem.h>
 #include <ftk/Core/Format.h>
 
+#include <thread>
+
+namespace ftk_resource
+{
+    extern std::vector<uint8_t> NotoSansRegular;
+}
+
 namespace ftk
 {
     namespace core_test
@@ -29,7 +36,11 @@ namespace ftk
         {
             _info();
             _size();
+            _run();
+            _kerning();
             _add();
+            _async();
+            _sdf();
         }
 
         void FontSystemTest::_info()
@@ -47,6 +58,20 @@ namespace ftk
                 FTK_ASSERT(a == a);
                 FTK_ASSERT(a != b);
                 FTK_ASSERT(a < b);
+                FTK_ASSERT(b.getFontInfo() == fontInfo);
+                FTK_ASSERT(b == GlyphInfo(1, getFontID(getFont(Font::Bold)), 16));
+                FTK_ASSERT(b.getKey() != GlyphInfo(1, FontInfo(getFont(Font::Bold), 17)).getKey());
+                FTK_ASSERT(b.getKey() != GlyphInfo(1, FontInfo(getFont(Font::Mono), 16)).getKey());
+                FTK_ASSERT(b.getKey() != GlyphInfo(2, fontInfo).getKey());
+            }
+            {
+                FTK_ASSERT(0 == getFontID(std::string()));
+                const FontID a = getFontID(getFont(Font::Regular));
+                const FontID b = getFontID(getFont(Font::Bold));
+                FTK_ASSERT(a != b);
+                FTK_ASSERT(a == getFontID(getFont(Font::Regular)));
+                FTK_ASSERT(getFontFamily(a) == getFont(Font::Regular));
+                FTK_ASSERT(getFontFamily(b) == getFont(Font::Bold));
             }
         }
 
@@ -94,6 +119,84 @@ namespace ftk
             }
         }
 
+        void FontSystemTest::_run()
+        {
+            if (auto context = _context.lock())
+            {
+                auto fontSystem = context->getSystem<FontSystem>();
+                const FontInfo info(getFont(Font::Regular), 14);
+                const std::string s = "The quick brown fox";
+                const auto run = fontSystem->getRun(s, info);
+                FTK_ASSERT(run == fontSystem->getRun(s, info));
+                FTK_ASSERT(getFontID(info.family) == run->fontID);
+                FTK_ASSERT(run != fontSystem->getRun(s, info, 10));
+                FTK_ASSERT(run->codes.size() == s.size());
+                FTK_ASSERT(run->size == fontSystem->getSize(s, info));
+                FTK_ASSERT(fontSystem->getRunCacheSize() > 0);
+                for (size_t i = 0; i <= s.size(); ++i)
+                {
+                    const int w = fontSystem->getSize(s.substr(0, i), info).w;
+                    FTK_ASSERT(run->getPrefixWidth(i) == w);
+                    if (i < s.size())
+                    {
+                        FTK_ASSERT(run->getIndex(w + 1) == i);
+                    }
+                }
+                FTK_ASSERT(0 == run->getIndex(-1));
+                FTK_ASSERT(s.size() == run->getIndex(run->size.w + 1));
+
+                const std::string u = "\xc3\xa9t\xc3\xa9";
+                const auto run2 = fontSystem->getRun(u, info);
+                FTK_ASSERT(3 == run2->codes.size());
+                FTK_ASSERT(run2->getPrefixWidth(3) ==
+                    fontSystem->getSize(u.substr(0, 3), info).w);
+            }
+        }
+
+        void FontSystemTest::_kerning()
+        {
+            if (auto context = _context.lock())
+            {
+                auto fontSystem = context->getSystem<FontSystem>();
+                const FontInfo info(getFont(Font::Regular), 48);
+                const Size2I a = fontSystem->getSize("A", info);
+                const Size2I v = fontSystem->getSize("V", info);
+                const Size2I av = fontSystem->getSize("AV", info);
+                _print(Format("AV kerning: {0}").arg(av.w - (a.w + v.w)));
+                FTK_ASSERT(av.w < a.w + v.w);
+
+                const auto run = fontSystem->getRun("AVATAR", info);
+                FTK_ASSERT(run->kerning.size() == run->codes.size());
+                FTK_ASSERT(0 == run->kerning[0]);
+                FTK_ASSERT(run->kerning[1] < 0);
+                const auto glyphs = fontSystem->getGlyphs("AVATAR", info);
+                int w = 0;
+                int32_t rsbDeltaPrev = 0;
+                for (const auto& glyph : glyphs)
+                {
+                    w += glyph->advance;
+                    if (rsbDeltaPrev - glyph->lsbDelta > 32)
+                    {
+                        w -= 1;
+                    }
+                    else if (rsbDeltaPrev - glyph->lsbDelta < -31)
+                    {
+                        w += 1;
+                    }
+                    rsbDeltaPrev = glyph->rsbDelta;
+                }
+                FTK_ASSERT(w == run->size.w);
+
+                // The kerned glyphs are reused.
+                FTK_ASSERT(glyphs[0]->advance != fontSystem->getGlyphs("A", info)[0]->advance);
+                FTK_ASSERT(glyphs == fontSystem->getGlyphs("AVATAR", info));
+
+                const auto run2 = fontSystem->getRun("AV\nAV", info);
+                FTK_ASSERT(run2->kerning[3] == 0);
+                FTK_ASSERT(run2->kerning[4] == run->kerning[1]);
+            }
+        }
+
         void FontSystemTest::_add()
         {
             if (auto context = _context.lock())
@@ -106,8 +209,133 @@ namespace ftk
                 }
                 catch (const std::exception&)
                 {}
+
+                // Adding a font clears the cached glyphs.
+                const FontInfo info("FontSystemTest", 16);
+                fontSystem->getGlyphs("abc", info);
+                FTK_ASSERT(fontSystem->getGlyphCacheSize() > 0);
+                fontSystem->addFont(
+                    "FontSystemTest",
+                    ftk_resource::NotoSansRegular.data(),
+                    ftk_resource::NotoSansRegular.size());
+                FTK_ASSERT(0 == fontSystem->getGlyphCacheSize());
+                const auto glyphs = fontSystem->getGlyphs("abc", info);
+                FTK_ASSERT(3 == glyphs.size());
+                FTK_ASSERT(glyphs[0] && glyphs[0]->image);
+            }
+        }
+
+        void FontSystemTest::_async()
+        {
+            if (auto context = _context.lock())
+            {
+                auto fontSystem = context->getSystem<FontSystem>();
+                fontSystem->setAsync(true);
+                FTK_ASSERT(fontSystem->isAsync());
+
+                const FontInfo info(getFont(Font::Regular), 31);
+                const std::string s = "The quick brown fox";
+                const Size2I size = fontSystem->getSize(s, info);
+                auto glyphs = fontSystem->getGlyphs(s, info);
+                FTK_ASSERT(glyphs.size() == s.size());
+                const auto t0 = std::chrono::steady_clock::now();
+                while (fontSystem->hasPendingGlyphs())
+                {
+                    context->tick();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    const auto t1 = std::chrono::steady_clock::now();
+                    FTK_ASSERT(t1 - t0 < std::chrono::seconds(10));
+                }
+                FTK_ASSERT(fontSystem->observeGlyphsLoaded()->get() > 0);
+                auto glyphs2 = fontSystem->getGlyphs(s, info);
+                FTK_ASSERT(glyphs2.size() == glyphs.size());
+                for (size_t i = 0; i < glyphs.size(); ++i)
+                {
+                    FTK_ASSERT(glyphs2[i]->image);
+                    FTK_ASSERT(glyphs2[i]->advance == glyphs[i]->advance);
+                    FTK_ASSERT(glyphs2[i]->offset == glyphs[i]->offset);
+                }
+                FTK_ASSERT(size == fontSystem->getSize(s, info));
+
+                fontSystem->prefetchGlyphs("0123456789", info);
+                fontSystem->setAsync(false);
+                glyphs = fontSystem->getGlyphs("0123456789", info);
+                for (const auto& glyph : glyphs)
+                {
+                    FTK_ASSERT(glyph->image);
+                }
+
+                // Wait for the prefetched glyphs so that they are not counted
+                // in the statistics of the following tests.
+                while (fontSystem->hasPendingGlyphs())
+                {
+                    context->tick();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        }
+
+        void FontSystemTest::_sdf()
+        {
+            if (auto context = _context.lock())
+            {
+                auto fontSystem = context->getSystem<FontSystem>();
+                FTK_ASSERT(GlyphMode::Bitmap == fontSystem->getGlyphMode());
+                const std::string s = "ftk";
+                const std::vector<int> sizes = { 11, 23, 35, 47, 59, 71 };
+
+                const GlyphStats bitmapStart = fontSystem->getGlyphStats(GlyphMode::Bitmap);
+                std::vector<Size2I> textSizes;
+                for (const int size : sizes)
+                {
+                    const FontInfo info(getFont(Font::Regular), size);
+                    textSizes.push_back(fontSystem->getSize(s, info));
+                    for (const auto& glyph : fontSystem->getGlyphs(s, info))
+                    {
+                        FTK_ASSERT(!glyph->sdf);
+                    }
+                }
+                const GlyphStats bitmapStats = fontSystem->getGlyphStats(GlyphMode::Bitmap);
+                FTK_ASSERT(bitmapStats.glyphCount - bitmapStart.glyphCount == s.size() * sizes.size());
+
+                fontSystem->setGlyphMode(GlyphMode::SDF);
+                FTK_ASSERT(GlyphMode::SDF == fontSystem->getGlyphMode());
+                const GlyphStats sdfStart = fontSystem->getGlyphStats(GlyphMode::SDF);
+                std::vector<std::shared_ptr<Image> > images;
+                for (size_t i = 0; i < sizes.size(); ++i)
+                {
+                    const FontInfo info(getFont(Font::Regular), sizes[i]);
+                    FTK_ASSERT(textSizes[i] == fontSystem->getSize(s, info));
+                    const auto glyphs = fontSystem->getGlyphs(s, info);
+                    FTK_ASSERT(glyphs.size() == s.size());
+                    for (size_t j = 0; j < glyphs.size(); ++j)
+                    {
+                        FTK_ASSERT(glyphs[j]->sdf);
+                        FTK_ASSERT(glyphs[j]->image);
+                        FTK_ASSERT(glyphs[j]->imageScale == sizes[i] / static_cast<float>(sdfGlyphSize));
+                        if (0 == i)
+                        {
+                            images.push_back(glyphs[j]->image);
+                        }
+                        else
+                        {
+                            FTK_ASSERT(glyphs[j]->image == images[j]);
+                        }
+                    }
+                }
+                const GlyphStats sdfStats = fontSystem->getGlyphStats(GlyphMode::SDF);
+                FTK_ASSERT(sdfStats.glyphCount - sdfStart.glyphCount == s.size());
+                fontSystem->setGlyphMode(GlyphMode::Bitmap);
+
+                _print(Format("Bitmap glyphs: {0}, {1} bytes, {2}us").
+                    arg(bitmapStats.glyphCount - bitmapStart.glyphCount).
+                    arg(bitmapStats.byteCount - bitmapStart.byteCount).
+                    arg((bitmapStats.time - bitmapStart.time).count()));
+                _print(Format("SDF glyphs: {0}, {1} bytes, {2}us").
+                    arg(sdfStats.glyphCount - sdfStart.glyphCount).
+                    arg(sdfStats.byteCount - sdfStart.byteCount).
+                    arg((sdfStats.time - sdfStart.time).count()));
             }
         }
     }
 }
-
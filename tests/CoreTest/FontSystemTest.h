@@ -25,7 +25,11 @@ namespace ftk
         private:
             void _info();
             void _size();
+            void _run();
+            void _kerning();
             void _add();
+            void _async();
+            void _sdf();
         };
     }
 }
@@ -0,0 +1,266 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <CoreTest/ImageCacheTest.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Context.h>
+#include <ftk/Core/ImageCache.h>
+
+#include <thread>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        ImageCacheTest::ImageCacheTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::core_test::ImageCacheTest")
+        {}
+
+        ImageCacheTest::~ImageCacheTest()
+        {}
+
+        std::shared_ptr<ImageCacheTest> ImageCacheTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<ImageCacheTest>(new ImageCacheTest(context));
+        }
+
+        void ImageCacheTest::run()
+        {
+            _members();
+            _pins();
+            _cancel();
+        }
+
+        namespace
+        {
+            void write(
+                const std::shared_ptr<Context>& context,
+                const std::filesystem::path& path,
+                const ImageInfo& info)
+            {
+                auto image = Image::create(info);
+                image->zero();
+                auto io = context->getSystem<ImageIO>();
+                auto write = io->write(path, info);
+                write->write(image);
+            }
+
+            void wait(
+                const std::shared_ptr<Context>& context,
+                const size_t& callbacks,
+                size_t count)
+            {
+                while (callbacks < count)
+                {
+                    context->tick();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        }
+
+        void ImageCacheTest::_members()
+        {
+            if (auto context = _context.lock())
+            {
+                auto cache = context->getSystem<ImageCache>();
+                cache->clear();
+                cache->resetStats();
+                FTK_ASSERT(imageCacheMax == cache->getMax());
+
+                const ImageInfo info(64, 32, ImageType::RGBA_U8);
+                const std::filesystem::path path = "ImageCacheTest.png";
+                write(context, path, info);
+
+                // Concurrent requests share the same read.
+                size_t callbacks = 0;
+                std::vector<std::shared_ptr<Image> > images;
+                const auto callback = [&callbacks, &images](const std::shared_ptr<Image>& value)
+                    {
+                        images.push_back(value);
+                        ++callbacks;
+                    };
+                auto request = cache->get(path, ImageIOOptions(), ImageIOPriority::Normal, callback);
+                auto request2 = cache->get(path, ImageIOOptions(), ImageIOPriority::Normal, callback);
+                FTK_ASSERT(2 == cache->getRequestCount());
+                FTK_ASSERT(cache->hasPendingWork());
+                wait(context, callbacks, 2);
+                FTK_ASSERT(0 == cache->getRequestCount());
+                FTK_ASSERT(!cache->hasPendingWork());
+                FTK_ASSERT(2 == images.size());
+                FTK_ASSERT(images[0]);
+                FTK_ASSERT(images[0] == images[1]);
+                FTK_ASSERT(images[0] == request.future.get());
+                FTK_ASSERT(images[0] == request2.future.get());
+                ImageCacheStats stats = cache->getStats();
+                FTK_ASSERT(1 == stats.count);
+                FTK_ASSERT(info.getByteCount() == stats.byteCount);
+                FTK_ASSERT(1 == stats.misses);
+                FTK_ASSERT(1 == stats.shared);
+                FTK_ASSERT(0 == stats.hits);
+
+                // The image is found in the cache.
+                request = cache->get(path, ImageIOOptions(), ImageIOPriority::Normal, callback);
+                FTK_ASSERT(images[0] == request.future.get());
+                wait(context, callbacks, 3);
+                FTK_ASSERT(images[0] == images[2]);
+                stats = cache->getStats();
+                FTK_ASSERT(1 == stats.hits);
+
+                // Different options are cached separately.
+                ImageIOOptions options;
+                options["Test"] = "1";
+                cache->get(path, options, ImageIOPriority::Normal, callback);
+                wait(context, callbacks, 4);
+                FTK_ASSERT(images[3]);
+                FTK_ASSERT(images[0] != images[3]);
+                stats = cache->getStats();
+                FTK_ASSERT(2 == stats.count);
+                FTK_ASSERT(2 == stats.misses);
+
+                // A file that changes is read again.
+                const ImageInfo info2(32, 16, ImageType::RGBA_U8);
+                write(context, path, info2);
+                std::filesystem::last_write_time(
+                    path,
+                    std::filesystem::last_write_time(path) + std::chrono::hours(1));
+                cache->get(path, ImageIOOptions(), ImageIOPriority::Normal, callback);
+                wait(context, callbacks, 5);
+                FTK_ASSERT(images[4]);
+                FTK_ASSERT(info2.size == images[4]->getSize());
+
+                // Files that cannot be read are not cached.
+                cache->get("ImageCacheTest2.png", ImageIOOptions(), ImageIOPriority::Normal, callback);
+                wait(context, callbacks, 6);
+                FTK_ASSERT(!images[5]);
+                stats = cache->getStats();
+                FTK_ASSERT(3 == stats.count);
+
+                // The least recently used images are evicted.
+                cache->setMax(info.getByteCount());
+                stats = cache->getStats();
+                FTK_ASSERT(1 == stats.count);
+                FTK_ASSERT(2 == stats.evictions);
+                cache->setMax(imageCacheMax);
+
+                cache->clear();
+                stats = cache->getStats();
+                FTK_ASSERT(0 == stats.count);
+                FTK_ASSERT(0 == stats.byteCount);
+                cache->resetStats();
+                stats = cache->getStats();
+                FTK_ASSERT(0 == stats.hits);
+                FTK_ASSERT(0 == stats.misses);
+                FTK_ASSERT(0 == stats.evictions);
+            }
+        }
+
+        void ImageCacheTest::_pins()
+        {
+            if (auto context = _context.lock())
+            {
+                auto cache = context->getSystem<ImageCache>();
+                cache->clear();
+                cache->resetStats();
+
+                const ImageInfo info(64, 32, ImageType::RGBA_U8);
+                const std::filesystem::path path = "ImageCacheTest.png";
+                write(context, path, info);
+
+                // Images can be pinned before they are read.
+                cache->pin(path);
+                size_t callbacks = 0;
+                const auto callback = [&callbacks](const std::shared_ptr<Image>&)
+                    {
+                        ++callbacks;
+                    };
+                cache->get(path, ImageIOOptions(), ImageIOPriority::Normal, callback);
+                wait(context, callbacks, 1);
+                ImageCacheStats stats = cache->getStats();
+                FTK_ASSERT(0 == stats.count);
+                FTK_ASSERT(1 == stats.pinnedCount);
+                FTK_ASSERT(info.getByteCount() == stats.pinnedByteCount);
+
+                // Pinned images are not evicted.
+                cache->setMax(0);
+                cache->clear();
+                cache->get(path, ImageIOOptions(), ImageIOPriority::Normal, callback);
+                wait(context, callbacks, 2);
+                stats = cache->getStats();
+                FTK_ASSERT(1 == stats.pinnedCount);
+                FTK_ASSERT(1 == stats.hits);
+
+                // Pins are counted.
+                cache->pin(path);
+                cache->unpin(path);
+                stats = cache->getStats();
+                FTK_ASSERT(1 == stats.pinnedCount);
+                cache->unpin(path);
+                stats = cache->getStats();
+                FTK_ASSERT(0 == stats.pinnedCount);
+                FTK_ASSERT(0 == stats.count);
+                FTK_ASSERT(1 == stats.evictions);
+                cache->setMax(imageCacheMax);
+
+                // Pinning an image moves it out of the cache.
+                cache->get(path, ImageIOOptions(), ImageIOPriority::Normal, callback);
+                wait(context, callbacks, 3);
+                stats = cache->getStats();
+                FTK_ASSERT(1 == stats.count);
+                cache->pin(path);
+                stats = cache->getStats();
+                FTK_ASSERT(0 == stats.count);
+                FTK_ASSERT(1 == stats.pinnedCount);
+                cache->unpin(path);
+                stats = cache->getStats();
+                FTK_ASSERT(1 == stats.count);
+                FTK_ASSERT(0 == stats.pinnedCount);
+                cache->clear();
+            }
+        }
+
+        void ImageCacheTest::_cancel()
+        {
+            if (auto context = _context.lock())
+            {
+                auto cache = context->getSystem<ImageCache>();
+                cache->clear();
+                cache->resetStats();
+
+                const ImageInfo info(64, 32, ImageType::RGBA_U8);
+                const std::filesystem::path path = "ImageCacheTest.png";
+                write(context, path, info);
+
+                size_t callbacks = 0;
+                const auto callback = [&callbacks](const std::shared_ptr<Image>&)
+                    {
+                        ++callbacks;
+                    };
+                auto request = cache->get(path, ImageIOOptions(), ImageIOPriority::Normal, callback);
+                auto request2 = cache->get(path, ImageIOOptions(), ImageIOPriority::Normal, callback);
+                cache->cancelRequests({ request.id });
+                wait(context, callbacks, 1);
+                FTK_ASSERT(request2.future.get());
+                cache->cancelRequests({ request2.id });
+
+                request = cache->get("ImageCacheTest3.png", ImageIOOptions(), ImageIOPriority::Normal, callback);
+                cache->cancelRequests({ request.id });
+                try
+                {
+                    FTK_ASSERT(!request.future.get());
+                }
+                catch (const std::exception&)
+                {}
+                auto io = context->getSystem<ImageIO>();
+                while (io->getRequestCount() > 0)
+                {
+                    context->tick();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                FTK_ASSERT(1 == callbacks);
+                cache->clear();
+            }
+        }
+    }
+}
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <TestLib/ITest.h>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        class ImageCacheTest : public test::ITest
+        {
+        protected:
+            ImageCacheTest(const std::shared_ptr<Context>&);
+
+        public:
+            virtual ~ImageCacheTest();
+
+            static std::shared_ptr<ImageCacheTest> create(
+                const std::shared_ptr<Context>&);
+
+            void run() override;
+            
+        private:
+            void _members();
+            void _pins();
+            void _cancel();
+        };
+    }
+}
+
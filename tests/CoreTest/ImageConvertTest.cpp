@@ -0,0 +1,343 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <CoreTest/ImageConvertTest.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/ImageConvert.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        ImageConvertTest::ImageConvertTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::core_test::ImageConvertTest")
+        {}
+
+        ImageConvertTest::~ImageConvertTest()
+        {}
+
+        std::shared_ptr<ImageConvertTest> ImageConvertTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<ImageConvertTest>(new ImageConvertTest(context));
+        }
+
+        void ImageConvertTest::run()
+        {
+            _enums();
+            _options();
+            _pixels();
+            _types();
+            _layout();
+            _yuv();
+        }
+
+        namespace
+        {
+            std::shared_ptr<Image> createPattern(const Size2I& size, ImageType type)
+            {
+                std::shared_ptr<Image> out;
+                if (isConvertOutput(type))
+                {
+                    auto rgba = Image::create(size, ImageType::RGBA_F32);
+                    float* p = reinterpret_cast<float*>(rgba->getData());
+                    for (int y = 0; y < size.h; ++y)
+                    {
+                        for (int x = 0; x < size.w; ++x)
+                        {
+                            for (int c = 0; c < 4; ++c, ++p)
+                            {
+                                *p = ((x * 7 + y * 13 + c * 29) % 101) / 100.F;
+                            }
+                        }
+                    }
+                    out = convertImage(rgba, type);
+                }
+                else
+                {
+                    out = Image::create(size, type);
+                    uint8_t* p = out->getData();
+                    for (size_t i = 0; i < out->getByteCount(); ++i)
+                    {
+                        p[i] = (i * 31) % 251;
+                    }
+                }
+                return out;
+            }
+
+            bool isEqual(
+                const std::shared_ptr<Image>& a,
+                const std::shared_ptr<Image>& b)
+            {
+                // ARGB_4444_Premult images are allocated with more bytes
+                // than the pixels use.
+                const ImageInfo& info = a->getInfo();
+                const size_t byteCount = ImageType::ARGB_4444_Premult == info.type ?
+                    (info.size.w * info.size.h * 2) :
+                    a->getByteCount();
+                return
+                    info == b->getInfo() &&
+                    0 == memcmp(a->getData(), b->getData(), byteCount);
+            }
+        }
+
+        void ImageConvertTest::_enums()
+        {
+            FTK_TEST_ENUM(ImageAlphaConvert);
+        }
+
+        void ImageConvertTest::_options()
+        {
+            ImageConvertOptions a;
+            ImageConvertOptions b;
+            FTK_ASSERT(a == b);
+            b.alpha = ImageAlphaConvert::Premultiply;
+            FTK_ASSERT(a != b);
+            _print(Format("SIMD: {0}").arg(getImageConvertSIMD()));
+        }
+
+        void ImageConvertTest::_pixels()
+        {
+            const std::vector<uint8_t> l = { 0, 64, 128, 255 };
+            for (bool simd : { true, false })
+            {
+                ImageConvertOptions options;
+                options.simd = simd;
+                {
+                    std::vector<uint8_t> out(l.size() * 4);
+                    convertPixels(l.data(), ImageType::L_U8, out.data(), ImageType::RGBA_U8, l.size(), options);
+                    FTK_ASSERT(64 == out[4] && 64 == out[5] && 64 == out[6] && 255 == out[7]);
+                    options.luminanceToAlpha = true;
+                    convertPixels(l.data(), ImageType::L_U8, out.data(), ImageType::RGBA_U8, l.size(), options);
+                    FTK_ASSERT(64 == out[4] && 64 == out[5] && 64 == out[6] && 64 == out[7]);
+                    options.luminanceToAlpha = false;
+                }
+                {
+                    std::vector<uint8_t> out(l.size() * 2);
+                    convertPixels(l.data(), ImageType::L_U8, out.data(), ImageType::LA_U8, l.size(), options);
+                    FTK_ASSERT(128 == out[4] && 255 == out[5]);
+                }
+                {
+                    std::vector<uint8_t> out(l.size() * 3);
+                    convertPixels(l.data(), ImageType::L_U8, out.data(), ImageType::RGB_U8, l.size(), options);
+                    FTK_ASSERT(255 == out[9] && 255 == out[10] && 255 == out[11]);
+                }
+                {
+                    const std::vector<uint8_t> bgra = { 10, 20, 30, 255, 200, 100, 50, 128 };
+                    std::vector<uint8_t> out(bgra.size());
+                    options.bgr = true;
+                    convertPixels(bgra.data(), ImageType::RGBA_U8, out.data(), ImageType::RGBA_U8, 2, options);
+                    FTK_ASSERT(30 == out[0] && 20 == out[1] && 10 == out[2] && 255 == out[3]);
+                    options.alpha = ImageAlphaConvert::Premultiply;
+                    convertPixels(bgra.data(), ImageType::RGBA_U8, out.data(), ImageType::RGBA_U8, 2, options);
+                    FTK_ASSERT(30 == out[0] && 20 == out[1] && 10 == out[2] && 255 == out[3]);
+                    FTK_ASSERT(25 == out[4] && 50 == out[5] && 100 == out[6] && 128 == out[7]);
+                    options.bgr = false;
+                    options.alpha = ImageAlphaConvert::None;
+                }
+                {
+                    const std::vector<float> rgb = { .5F, 1.F, 2.F, -1.F };
+                    std::vector<uint8_t> out(rgb.size());
+                    convertPixels(
+                        reinterpret_cast<const uint8_t*>(rgb.data()),
+                        ImageType::L_F32,
+                        out.data(),
+                        ImageType::L_U8,
+                        rgb.size(),
+                        options);
+                    FTK_ASSERT(128 == out[0] && 255 == out[1] && 255 == out[2] && 0 == out[3]);
+                }
+            }
+            try
+            {
+                uint8_t data[4] = { 0, 0, 0, 0 };
+                convertPixels(data, ImageType::L_U8, data, ImageType::YUV_420P_U8, 1);
+                FTK_ASSERT(false);
+            }
+            catch (const std::exception&)
+            {}
+        }
+
+        void ImageConvertTest::_types()
+        {
+            // The SIMD and scalar conversions should give the same
+            // results. The width is chosen to exercise the remainders.
+            const Size2I size(67, 5);
+            for (auto inType : getImageTypeEnums())
+            {
+                if (ImageType::None == inType)
+                    continue;
+                const auto in = createPattern(size, inType);
+                for (auto outType : getImageTypeEnums())
+                {
+                    if (!isConvertOutput(outType))
+                        continue;
+                    for (auto alpha : getImageAlphaConvertEnums())
+                    {
+                        ImageConvertOptions options;
+                        options.alpha = alpha;
+                        options.bgr = ImageAlphaConvert::Premultiply == alpha;
+                        const auto a = convertImage(in, outType, options);
+                        options.simd = false;
+                        const auto b = convertImage(in, outType, options);
+                        FTK_ASSERT(isEqual(a, b));
+                    }
+                }
+            }
+
+            // Conversions to higher precision types and back should give
+            // the original values.
+            const auto in = createPattern(size, ImageType::RGBA_U8);
+            for (auto type : {
+                ImageType::RGBA_U16,
+                ImageType::RGBA_U32,
+                ImageType::RGBA_F16,
+                ImageType::RGBA_F32 })
+            {
+                const auto tmp = convertImage(in, type);
+                const auto out = convertImage(tmp, ImageType::RGBA_U8);
+                FTK_ASSERT(isEqual(in, out));
+            }
+
+            // Premultiply and unpremultiply.
+            {
+                const auto tmp = convertImage(in, ImageType::RGBA_F32);
+                ImageConvertOptions options;
+                options.alpha = ImageAlphaConvert::Premultiply;
+                const auto tmp2 = convertImage(tmp, ImageType::RGBA_F32, options);
+                options.alpha = ImageAlphaConvert::Unpremultiply;
+                const auto out = convertImage(tmp2, ImageType::RGBA_U8, options);
+                const uint8_t* inP = in->getData();
+                const uint8_t* outP = out->getData();
+                for (size_t i = 0; i < in->getByteCount(); ++i)
+                {
+                    if (inP[i / 4 * 4 + 3] > 0)
+                    {
+                        FTK_ASSERT(std::abs(inP[i] - outP[i]) <= 1);
+                    }
+                }
+            }
+
+            // Multiple threads.
+            {
+                const auto in = createPattern(Size2I(1024, 512), ImageType::RGBA_F16);
+                ImageConvertOptions options;
+                options.threadCount = 1;
+                const auto a = convertImage(in, ImageType::RGB_U8, options);
+                options.threadCount = 4;
+                const auto b = convertImage(in, ImageType::RGB_U8, options);
+                FTK_ASSERT(isEqual(a, b));
+            }
+        }
+
+        void ImageConvertTest::_layout()
+        {
+            // Row alignment and mirroring.
+            ImageInfo inInfo(3, 2, ImageType::RGB_U8);
+            inInfo.layout.alignment = 4;
+            inInfo.layout.mirror.y = true;
+            auto in = Image::create(inInfo);
+            in->zero();
+            in->getData()[0] = 10;
+            in->getData()[12] = 20;
+            auto out = Image::create(3, 2, ImageType::RGBA_U8);
+            convertImage(in, out);
+            FTK_ASSERT(20 == out->getData()[0]);
+            FTK_ASSERT(255 == out->getData()[3]);
+            FTK_ASSERT(10 == out->getData()[12]);
+
+            // Mirror X.
+            ImageInfo outInfo(3, 2, ImageType::RGB_U8);
+            outInfo.layout.mirror = ImageMirror(true, true);
+            out = Image::create(outInfo);
+            convertImage(in, out);
+            FTK_ASSERT(10 == out->getData()[6]);
+
+            // Endian.
+            auto native = Image::create(1, 1, ImageType::L_U16);
+            const uint16_t value = 0x1234;
+            memcpy(native->getData(), &value, 2);
+            ImageInfo swapInfo(1, 1, ImageType::L_U16);
+            swapInfo.layout.endian = opposite(getEndian());
+            auto swap = Image::create(swapInfo);
+            convertImage(native, swap);
+            FTK_ASSERT(native->getData()[0] == swap->getData()[1]);
+            FTK_ASSERT(native->getData()[1] == swap->getData()[0]);
+            const auto swap2 = convertImage(swap, ImageType::L_U16);
+            FTK_ASSERT(0 == memcmp(native->getData(), swap2->getData(), 2));
+
+            // Video levels.
+            inInfo = ImageInfo(2, 1, ImageType::L_U8);
+            inInfo.videoLevels = VideoLevels::LegalRange;
+            in = Image::create(inInfo);
+            in->getData()[0] = 16;
+            in->getData()[1] = 235;
+            out = convertImage(in, ImageType::L_U8);
+            FTK_ASSERT(0 == out->getData()[0]);
+            FTK_ASSERT(255 == out->getData()[1]);
+
+            try
+            {
+                convertImage(in, Image::create(3, 2, ImageType::L_U8));
+                FTK_ASSERT(false);
+            }
+            catch (const std::exception&)
+            {}
+        }
+
+        void ImageConvertTest::_yuv()
+        {
+            // Grey values should give the same RGB values.
+            for (auto type : {
+                ImageType::YUV_420P_U8,
+                ImageType::YUV_422P_U8,
+                ImageType::YUV_444P_U8 })
+            {
+                auto in = Image::create(4, 4, type);
+                const size_t yByteCount = 4 * 4;
+                memset(in->getData(), 100, yByteCount);
+                memset(in->getData() + yByteCount, 128, in->getByteCount() - yByteCount);
+                const auto out = convertImage(in, ImageType::RGBA_U8);
+                const uint8_t* p = out->getData();
+                for (size_t i = 0; i < out->getByteCount(); i += 4)
+                {
+                    FTK_ASSERT(std::abs(p[i + 0] - 100) <= 1);
+                    FTK_ASSERT(std::abs(p[i + 1] - 100) <= 1);
+                    FTK_ASSERT(std::abs(p[i + 2] - 100) <= 1);
+                    FTK_ASSERT(255 == p[i + 3]);
+                }
+            }
+            {
+                // The chroma planes of odd sized images are rounded up.
+                auto in = Image::create(5, 3, ImageType::YUV_420P_U8);
+                FTK_ASSERT(5 * 3 + 3 * 2 * 2 == in->getByteCount());
+                uint8_t* p = in->getData();
+                memset(p, 100, 5 * 3);
+                memset(p + 5 * 3, 128, 3 * 2 * 2);
+                p[5 * 3 + 3 * 2 + 2] = 200;
+                const auto out = convertImage(in, ImageType::RGB_U8);
+                const uint8_t* outP = out->getData();
+                FTK_ASSERT(std::abs(outP[3 * 3] - 100) <= 1);
+                FTK_ASSERT(outP[4 * 3] > 150);
+                FTK_ASSERT(outP[(1 * 5 + 4) * 3] > 150);
+                FTK_ASSERT(std::abs(outP[(2 * 5 + 4) * 3] - 100) <= 1);
+            }
+            {
+                auto in = Image::create(4, 4, ImageType::YUV_420P_U16);
+                uint16_t* p = reinterpret_cast<uint16_t*>(in->getData());
+                for (size_t i = 0; i < in->getByteCount() / 2; ++i)
+                {
+                    p[i] = i < 16 ? 65535 : 32768;
+                }
+                const auto out = convertImage(in, ImageType::RGB_F32);
+                const float* outP = reinterpret_cast<const float*>(out->getData());
+                FTK_ASSERT(std::abs(outP[0] - 1.F) < .001F);
+            }
+        }
+    }
+}
@@ -8,6 +8,8 @@
 #include <ftk/Core/Format.h>
 #include <ftk/Core/ImageIO.h>
 
+#include <thread>
+
 namespace ftk
 {
     namespace core_test
@@ -29,6 +31,7 @@ namespace ftk
         {
             _members();
             _functions();
+            _async();
         }
         
         namespace
@@ -76,6 +79,102 @@ namespace ftk
             FTK_ASSERT(options3["Layer"] == "1");
             FTK_ASSERT(options3["Compression"] == "RLE");
         }
+   
+        void ImageIOTest::_async()
+        {
+            if (auto context = _context.lock())
+            {
+                auto io = context->getSystem<ImageIO>();
+                const ImageInfo info(64, 32, ImageType::RGBA_U8);
+                const std::filesystem::path path = "ImageIOTest.png";
+                {
+                    auto image = Image::create(info);
+                    image->zero();
+                    auto write = io->write(path, info);
+                    write->write(image);
+                }
+
+                ImageInfo info2;
+                std::shared_ptr<Image> image2;
+                bool error = false;
+                auto infoRequest = io->requestInfo(
+                    path,
+                    ImageIOOptions(),
+                    ImageIOPriority::High,
+                    [&info2](const ImageInfo& value)
+                    {
+                        info2 = value;
+                    });
+                auto readRequest = io->requestRead(
+                    path,
+                    ImageIOOptions(),
+                    ImageIOPriority::Normal,
+                    [&image2](const std::shared_ptr<Image>& value)
+                    {
+                        image2 = value;
+                    });
+                auto errorRequest = io->requestRead(
+                    "ImageIOTest.dum",
+                    ImageIOOptions(),
+                    ImageIOPriority::Low,
+                    [&error](const std::shared_ptr<Image>& value)
+                    {
+                        error = !value;
+                    });
+                FTK_ASSERT(io->hasPendingWork());
+                while (io->getRequestCount() > 0)
+                {
+                    context->tick();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                FTK_ASSERT(!io->hasPendingWork());
+                FTK_ASSERT(info.size == info2.size);
+                FTK_ASSERT(info.type == info2.type);
+                FTK_ASSERT(image2);
+                FTK_ASSERT(info.size == image2->getSize());
+                FTK_ASSERT(error);
+                FTK_ASSERT(info.size == infoRequest.future.get().size);
+                FTK_ASSERT(readRequest.future.get());
+                try
+                {
+                    errorRequest.future.get();
+                    FTK_ASSERT(false);
+                }
+                catch (const std::exception& e)
+                {
+                    _print(e.what());
+                }
+
+                size_t callbacks = 0;
+                std::vector<ImageReadRequest> requests;
+                for (size_t i = 0; i < 100; ++i)
+                {
+                    requests.push_back(io->requestRead(
+                        path,
+                        ImageIOOptions(),
+                        ImageIOPriority::Normal,
+                        [&callbacks](const std::shared_ptr<Image>&)
+                        {
+                            ++callbacks;
+                        }));
+                }
+                std::vector<uint64_t> ids;
+                for (const auto& request : requests)
+                {
+                    ids.push_back(request.id);
+                }
+                io->cancelRequests(ids);
+                while (io->getRequestCount() > 0)
+                {
+                    context->tick();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                FTK_ASSERT(0 == callbacks);
+                for (auto& request : requests)
+                {
+                    request.future.get();
+                }
+            }
+        }
     }
 }
-
@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <CoreTest/ImageResizeTest.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/ImageConvert.h>
+#include <ftk/Core/ImageResize.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        ImageResizeTest::ImageResizeTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::core_test::ImageResizeTest")
+        {}
+
+        ImageResizeTest::~ImageResizeTest()
+        {}
+
+        std::shared_ptr<ImageResizeTest> ImageResizeTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<ImageResizeTest>(new ImageResizeTest(context));
+        }
+
+        void ImageResizeTest::run()
+        {
+            _enums();
+            _options();
+            _filters();
+            _types();
+            _layout();
+        }
+
+        namespace
+        {
+            std::shared_ptr<Image> createPattern(const Size2I& size)
+            {
+                auto out = Image::create(size, ImageType::RGBA_U8);
+                uint8_t* p = out->getData();
+                for (int y = 0; y < size.h; ++y)
+                {
+                    for (int x = 0; x < size.w; ++x, p += 4)
+                    {
+                        p[0] = x * 255 / size.w;
+                        p[1] = y * 255 / size.h;
+                        p[2] = (x + y) % 2 ? 255 : 0;
+                        p[3] = 255;
+                    }
+                }
+                return out;
+            }
+
+            int getMaxDiff(
+                const std::shared_ptr<Image>& a,
+                const std::shared_ptr<Image>& b)
+            {
+                int out = 0;
+                for (size_t i = 0; i < a->getByteCount(); ++i)
+                {
+                    out = std::max(out, std::abs(a->getData()[i] - b->getData()[i]));
+                }
+                return out;
+            }
+        }
+
+        void ImageResizeTest::_enums()
+        {
+            FTK_TEST_ENUM(ImageResizeFilter);
+        }
+
+        void ImageResizeTest::_options()
+        {
+            ImageResizeOptions a;
+            ImageResizeOptions b;
+            FTK_ASSERT(a == b);
+            b.filter = ImageResizeFilter::Lanczos;
+            FTK_ASSERT(a != b);
+        }
+
+        void ImageResizeTest::_filters()
+        {
+            // Box filter.
+            {
+                auto in = Image::create(4, 1, ImageType::L_U8);
+                const uint8_t values[] = { 0, 100, 200, 250 };
+                memcpy(in->getData(), values, 4);
+                ImageResizeOptions options;
+                options.filter = ImageResizeFilter::Box;
+                auto out = resizeImage(in, Size2I(2, 1), options);
+                FTK_ASSERT(50 == out->getData()[0]);
+                FTK_ASSERT(225 == out->getData()[1]);
+
+                out = resizeImage(in, Size2I(8, 1), options);
+                FTK_ASSERT(0 == out->getData()[0]);
+                FTK_ASSERT(0 == out->getData()[1]);
+                FTK_ASSERT(100 == out->getData()[2]);
+                FTK_ASSERT(250 == out->getData()[7]);
+            }
+
+            // Constant images should stay constant, and images resized to
+            // the same size should not change.
+            for (auto filter : getImageResizeFilterEnums())
+            {
+                ImageResizeOptions options;
+                options.filter = filter;
+                auto in = Image::create(31, 17, ImageType::RGB_U8);
+                memset(in->getData(), 77, in->getByteCount());
+                for (const auto& size : { Size2I(7, 5), Size2I(64, 40), Size2I(31, 3) })
+                {
+                    auto out = resizeImage(in, size, options);
+                    FTK_ASSERT(size == out->getSize());
+                    for (size_t i = 0; i < out->getByteCount(); ++i)
+                    {
+                        FTK_ASSERT(77 == out->getData()[i]);
+                    }
+                }
+
+                in = createPattern(Size2I(13, 11));
+                auto out = resizeImage(in, in->getSize(), options);
+                FTK_ASSERT(0 == getMaxDiff(in, out));
+            }
+        }
+
+        void ImageResizeTest::_types()
+        {
+            // The SIMD and scalar results can differ by rounding.
+            const auto in = createPattern(Size2I(203, 101));
+            for (auto filter : getImageResizeFilterEnums())
+            {
+                for (auto type : {
+                    ImageType::L_U8,
+                    ImageType::RGB_U16,
+                    ImageType::RGBA_U8,
+                    ImageType::RGBA_F16 })
+                {
+                    const auto tmp = convertImage(in, type);
+                    ImageResizeOptions options;
+                    options.filter = filter;
+                    const auto a = convertImage(resizeImage(tmp, Size2I(67, 45), options), ImageType::RGBA_U8);
+                    options.simd = false;
+                    const auto b = convertImage(resizeImage(tmp, Size2I(67, 45), options), ImageType::RGBA_U8);
+                    FTK_ASSERT(getMaxDiff(a, b) <= 1);
+                }
+            }
+
+            // Resize to a different type.
+            {
+                auto out = Image::create(50, 25, ImageType::RGBA_F32);
+                resizeImage(in, out);
+                const float* p = reinterpret_cast<const float*>(out->getData());
+                FTK_ASSERT(std::abs(p[3] - 1.F) < .0001F);
+            }
+
+            // YUV images are resized to RGB.
+            {
+                auto yuv = Image::create(16, 16, ImageType::YUV_420P_U8);
+                memset(yuv->getData(), 128, yuv->getByteCount());
+                auto out = resizeImage(yuv, Size2I(8, 8));
+                FTK_ASSERT(ImageType::RGB_U8 == out->getType());
+            }
+
+            // Multiple threads.
+            {
+                const auto in = createPattern(Size2I(1024, 1024));
+                ImageResizeOptions options;
+                options.filter = ImageResizeFilter::Lanczos;
+                options.threadCount = 1;
+                const auto a = resizeImage(in, Size2I(300, 200), options);
+                options.threadCount = 4;
+                const auto b = resizeImage(in, Size2I(300, 200), options);
+                FTK_ASSERT(0 == getMaxDiff(a, b));
+            }
+        }
+
+        void ImageResizeTest::_layout()
+        {
+            const auto in = createPattern(Size2I(9, 7));
+            ImageInfo info(9, 7, ImageType::RGBA_U8);
+            info.layout.mirror = ImageMirror(true, true);
+            auto out = Image::create(info);
+            resizeImage(in, out);
+            const uint8_t* inP = in->getData();
+            const uint8_t* outP = out->getData() + (6 * 9 + 8) * 4;
+            FTK_ASSERT(0 == memcmp(inP, outP, 4));
+
+            try
+            {
+                resizeImage(in, Size2I(0, 0));
+                FTK_ASSERT(false);
+            }
+            catch (const std::exception&)
+            {}
+        }
+    }
+}
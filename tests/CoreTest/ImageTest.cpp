@@ -30,6 +30,7 @@ namespace ftk
             _info();
             _members();
             _functions();
+            _memory();
         }
         
         void ImageTest::_enums()
@@ -118,6 +119,46 @@ namespace ftk
                     arg(getYUVCoefficients(i)));
             }
         }
+
+        void ImageTest::_memory()
+        {
+            {
+                auto image = Image::create(1920, 1080, ImageType::RGBA_U8);
+                FTK_ASSERT(0 == reinterpret_cast<uintptr_t>(image->getData()) % imageDataAlignment);
+                image->zero();
+                FTK_ASSERT(0 == image->getData()[0]);
+                FTK_ASSERT(0 == image->getData()[image->getByteCount() - 1]);
+            }
+            {
+                clearImageMemoryPool();
+                const ImageMemoryStats stats = getImageMemoryStats();
+                FTK_ASSERT(0 == stats.poolByteCount);
+                {
+                    auto image = Image::create(640, 480, ImageType::RGB_U8);
+                    FTK_ASSERT(getImageMemoryStats().byteCount > stats.byteCount);
+                }
+                FTK_ASSERT(getImageMemoryStats().poolByteCount > 0);
+                {
+                    auto image = Image::create(640, 480, ImageType::L_U8);
+                    auto image2 = Image::create(640, 480, ImageType::RGB_U8);
+                    const ImageMemoryStats stats2 = getImageMemoryStats();
+                    FTK_ASSERT(stats2.allocCount == stats.allocCount + 3);
+                    FTK_ASSERT(stats2.poolHits == stats.poolHits + 1);
+                    FTK_ASSERT(stats2.byteCountMax >= stats2.byteCount);
+                }
+                FTK_ASSERT(getImageMemoryStats().byteCount == stats.byteCount);
+                setImageMemoryPoolMax(0);
+                FTK_ASSERT(0 == getImageMemoryStats().poolByteCount);
+                {
+                    auto image = Image::create(640, 480, ImageType::RGB_U8);
+                }
+                FTK_ASSERT(0 == getImageMemoryStats().poolByteCount);
+                setImageMemoryPoolMax(imageMemoryPoolMax);
+            }
+            {
+                auto image = Image::create(ImageInfo());
+                FTK_ASSERT(image->getData());
+            }
+        }
     }
 }
-
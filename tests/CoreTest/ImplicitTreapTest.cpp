@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <CoreTest/ImplicitTreapTest.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/ImplicitTreap.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        ImplicitTreapTest::ImplicitTreapTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::core_test::ImplicitTreapTest")
+        {}
+
+        ImplicitTreapTest::~ImplicitTreapTest()
+        {}
+
+        std::shared_ptr<ImplicitTreapTest> ImplicitTreapTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<ImplicitTreapTest>(new ImplicitTreapTest(context));
+        }
+
+        void ImplicitTreapTest::run()
+        {
+            _values();
+            _summary();
+            _random();
+        }
+
+        namespace
+        {
+            struct Summary
+            {
+                Summary() = default;
+                explicit Summary(int value) :
+                    sum(value),
+                    min(value)
+                {}
+
+                int sum = 0;
+                int min = std::numeric_limits<int>::max();
+
+                void merge(const Summary& other)
+                {
+                    sum += other.sum;
+                    min = std::min(min, other.min);
+                }
+            };
+
+            void compare(const ImplicitTreap<int, Summary>& treap, const std::vector<int>& values)
+            {
+                FTK_ASSERT(values.size() == treap.getSize());
+                int sum = 0;
+                for (size_t i = 0; i < values.size(); ++i)
+                {
+                    FTK_ASSERT(values[i] == treap.get(i));
+                    FTK_ASSERT(sum == treap.getPrefix(i).sum);
+                    sum += values[i];
+                }
+                FTK_ASSERT(sum == treap.getSummary().sum);
+                FTK_ASSERT(sum == treap.getPrefix(values.size()).sum);
+            }
+        }
+
+        void ImplicitTreapTest::_values()
+        {
+            ImplicitTreap<int, Summary> treap;
+            FTK_ASSERT(0 == treap.getSize());
+            FTK_ASSERT(0 == treap.getSummary().sum);
+
+            treap.insert(0, 3, 1);
+            compare(treap, { 1, 1, 1 });
+            treap.insert(1, { 2, 3 });
+            compare(treap, { 1, 2, 3, 1, 1 });
+            treap.insert(100, { 4 });
+            compare(treap, { 1, 2, 3, 1, 1, 4 });
+            treap.set(0, 5);
+            compare(treap, { 5, 2, 3, 1, 1, 4 });
+            treap.set(100, 5);
+            compare(treap, { 5, 2, 3, 1, 1, 4 });
+            treap.remove(1, 2);
+            compare(treap, { 5, 1, 1, 4 });
+            treap.remove(2, 100);
+            compare(treap, { 5, 1 });
+            treap.remove(100, 1);
+            compare(treap, { 5, 1 });
+            treap.clear();
+            compare(treap, {});
+        }
+
+        void ImplicitTreapTest::_summary()
+        {
+            ImplicitTreap<int, Summary> treap;
+            treap.insert(0, { 1, -1, 2, -1, 3 });
+            FTK_ASSERT(-1 == treap.getSummary().min);
+            FTK_ASSERT(4 == treap.getSummary().sum);
+            FTK_ASSERT(2 == treap.getPrefix(3).sum);
+
+            const auto negative = [](const Summary& value)
+            {
+                return value.min < 0;
+            };
+            FTK_ASSERT(1 == treap.find(0, negative));
+            FTK_ASSERT(1 == treap.find(1, negative));
+            FTK_ASSERT(3 == treap.find(2, negative));
+            FTK_ASSERT(5 == treap.find(4, negative));
+            FTK_ASSERT(5 == treap.find(100, negative));
+
+            // The sum is only increasing for values that are not negative.
+            treap.clear();
+            treap.insert(0, { 1, 0, 2, 0, 3 });
+            const auto sumGreater = [](const Summary& value)
+            {
+                return value.sum > 1;
+            };
+            FTK_ASSERT(2 == treap.find(0, sumGreater));
+            FTK_ASSERT(2 == treap.find(2, sumGreater));
+            FTK_ASSERT(4 == treap.find(3, sumGreater));
+        }
+
+        void ImplicitTreapTest::_random()
+        {
+            // Compare random edits with a vector.
+            std::mt19937 random(1);
+            ImplicitTreap<int, Summary> treap;
+            std::vector<int> values;
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                const size_t index = random() % (values.size() + 1);
+                switch (random() % 4)
+                {
+                case 0:
+                {
+                    std::vector<int> tmp(random() % 10);
+                    for (auto& value : tmp)
+                    {
+                        value = static_cast<int>(random() % 100) - 10;
+                    }
+                    treap.insert(index, tmp);
+                    values.insert(values.begin() + index, tmp.begin(), tmp.end());
+                    break;
+                }
+                case 1:
+                {
+                    const size_t count = std::min(
+                        static_cast<size_t>(random() % 10),
+                        values.size() - index);
+                    treap.remove(index, count);
+                    values.erase(values.begin() + index, values.begin() + index + count);
+                    break;
+                }
+                case 2:
+                    if (index < values.size())
+                    {
+                        const int value = static_cast<int>(random() % 100) - 10;
+                        treap.set(index, value);
+                        values[index] = value;
+                    }
+                    break;
+                case 3:
+                {
+                    size_t out = index;
+                    while (out < values.size() && values[out] >= 0)
+                    {
+                        ++out;
+                    }
+                    FTK_ASSERT(out == treap.find(
+                        index,
+                        [](const Summary& value)
+                        {
+                            return value.min < 0;
+                        }));
+                    break;
+                }
+                default: break;
+                }
+            }
+            compare(treap, values);
+        }
+    }
+}
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <TestLib/ITest.h>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        class ImplicitTreapTest : public test::ITest
+        {
+        protected:
+            ImplicitTreapTest(const std::shared_ptr<Context>&);
+
+        public:
+            virtual ~ImplicitTreapTest();
+
+            static std::shared_ptr<ImplicitTreapTest> create(
+                const std::shared_ptr<Context>&);
+
+            void run() override;
+
+        private:
+            void _values();
+            void _summary();
+            void _random();
+        };
+    }
+}
+
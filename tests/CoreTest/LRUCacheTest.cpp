@@ -25,6 +25,14 @@ namespace ftk
         }
         
         void LRUCacheTest::run()
+        {
+            _cache();
+            _stats();
+            _evictions();
+            _hash();
+        }
+
+        void LRUCacheTest::_cache()
         {
             LRUCache<int, bool> c;
             c.setMax(3);
@@ -68,6 +76,80 @@ namespace ftk
             c.setMax(2);
             FTK_ASSERT(2 == c.getSize());
         }
+
+        void LRUCacheTest::_stats()
+        {
+            LRUCache<int, int> c;
+            c.setMax(10);
+            c.add(0, 0, 4);
+            c.add(1, 1, 4);
+            FTK_ASSERT(8 == c.getSize());
+            c.add(1, 1, 2);
+            FTK_ASSERT(6 == c.getSize());
+            FTK_ASSERT(2 == c.getCount());
+
+            int v = 0;
+            FTK_ASSERT(c.get(0, v));
+            FTK_ASSERT(!c.get(2, v));
+            FTK_ASSERT(1 == c.getHits());
+            FTK_ASSERT(1 == c.getMisses());
+
+            c.add(2, 2, 4);
+            FTK_ASSERT(10 == c.getSize());
+            FTK_ASSERT(0 == c.getEvictions());
+            c.add(3, 3, 4);
+            FTK_ASSERT(2 == c.getEvictions());
+            FTK_ASSERT(!c.contains(0));
+            FTK_ASSERT(!c.contains(1));
+            FTK_ASSERT(8 == c.getSize());
+
+            c.touch(2);
+            c.add(4, 4, 4);
+            FTK_ASSERT(c.contains(2));
+            FTK_ASSERT(!c.contains(3));
+            FTK_ASSERT(3 == c.getEvictions());
+
+            c.remove(2);
+            FTK_ASSERT(4 == c.getSize());
+            c.resetStats();
+            FTK_ASSERT(0 == c.getHits());
+            FTK_ASSERT(0 == c.getMisses());
+            FTK_ASSERT(0 == c.getEvictions());
+        }
+
+        void LRUCacheTest::_evictions()
+        {
+            const int count = 1000;
+            LRUCache<int, int> c;
+            c.setMax(count / 10);
+            for (int i = 0; i < count; ++i)
+            {
+                c.add(i, i);
+            }
+            FTK_ASSERT(count / 10 == c.getSize());
+            FTK_ASSERT(count - count / 10 == c.getEvictions());
+            int v = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                FTK_ASSERT((i >= count - count / 10) == c.get(i, v));
+            }
+            FTK_ASSERT(count / 10 == c.getHits());
+            FTK_ASSERT(count - count / 10 == c.getMisses());
+        }
+
+        void LRUCacheTest::_hash()
+        {
+            std::size_t a = std::hash<std::string>()("a");
+            hashCombine(a, 1);
+            hashCombine(a, 2);
+            std::size_t b = std::hash<std::string>()("a");
+            hashCombine(b, 1);
+            hashCombine(b, 2);
+            FTK_ASSERT(a == b);
+            std::size_t c = std::hash<std::string>()("a");
+            hashCombine(c, 2);
+            hashCombine(c, 1);
+            FTK_ASSERT(a != c);
+        }
     }
 }
-
@@ -21,6 +21,12 @@ namespace ftk
                 const std::shared_ptr<Context>&);
 
             void run() override;
+
+        private:
+            void _cache();
+            void _stats();
+            void _evictions();
+            void _hash();
         };
     }
 }
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <CoreTest/MappedTextTest.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/FileIO.h>
+#include <ftk/Core/MappedText.h>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        MappedTextTest::MappedTextTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::core_test::MappedTextTest")
+        {}
+
+        MappedTextTest::~MappedTextTest()
+        {}
+
+        std::shared_ptr<MappedTextTest> MappedTextTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<MappedTextTest>(new MappedTextTest(context));
+        }
+
+        void MappedTextTest::run()
+        {
+            const std::filesystem::path path =
+                std::filesystem::temp_directory_path() / "MappedTextTest.txt";
+            const std::vector<std::pair<std::string, std::vector<std::string> > > data =
+            {
+                { "", {} },
+                { "a", { "a" } },
+                { "a\n", { "a" } },
+                { "\n", { "" } },
+                { "a\nbc\n\ndef", { "a", "bc", "", "def" } },
+                { "a\r\nbc\r\n", { "a", "bc" } }
+            };
+            for (const auto& i : data)
+            {
+                {
+                    auto io = FileIO::create(path, FileMode::Write);
+                    io->write(i.first);
+                }
+                auto text = MappedText::create(path);
+                FTK_ASSERT(path == text->getPath());
+                FTK_ASSERT(i.first.size() == text->getByteCount());
+                text->wait();
+                FTK_ASSERT(text->isIndexed());
+                FTK_ASSERT(i.second.size() == text->getLineCount());
+                for (size_t j = 0; j < i.second.size(); ++j)
+                {
+                    FTK_ASSERT(i.second[j] == text->getLine(j));
+                }
+                FTK_ASSERT(text->getLine(i.second.size()).empty());
+            }
+            {
+                std::vector<std::string> lines;
+                for (size_t i = 0; i < 100000; ++i)
+                {
+                    lines.push_back(std::string(i % 100, 'a' + i % 26));
+                }
+                writeLines(path, lines);
+                auto text = MappedText::create(path);
+                FTK_ASSERT(text->getLineCount() > 0);
+                FTK_ASSERT(lines[0] == text->getLine(0));
+                text->wait();
+                FTK_ASSERT(lines.size() == text->getLineCount());
+                for (size_t i = 0; i < lines.size(); ++i)
+                {
+                    FTK_ASSERT(lines[i] == text->getLine(i));
+                }
+            }
+            {
+                auto text = MappedText::create(path);
+            }
+            std::filesystem::remove(path);
+        }
+    }
+}
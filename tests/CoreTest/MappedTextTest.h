@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <TestLib/ITest.h>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        class MappedTextTest : public test::ITest
+        {
+        protected:
+            MappedTextTest(const std::shared_ptr<Context>&);
+
+        public:
+            virtual ~MappedTextTest();
+
+            static std::shared_ptr<MappedTextTest> create(
+                const std::shared_ptr<Context>&);
+
+            void run() override;
+        };
+    }
+}
+
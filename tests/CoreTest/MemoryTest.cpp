@@ -27,6 +27,7 @@ namespace ftk
         void MemoryTest::run()
         {
             _enums();
+            _aligned();
             _endian();
             _bits();
         }
@@ -36,6 +37,19 @@ namespace ftk
             FTK_TEST_ENUM(Endian);
         }
         
+        void MemoryTest::_aligned()
+        {
+            FTK_ASSERT(64 == getAlignedByteCount(1, 64));
+            FTK_ASSERT(128 == getAlignedByteCount(65, 64));
+            for (size_t alignment : { 16, 64, 4096 })
+            {
+                void* p = alignedAlloc(1000, alignment);
+                FTK_ASSERT(p);
+                FTK_ASSERT(0 == reinterpret_cast<uintptr_t>(p) % alignment);
+                alignedFree(p);
+            }
+        }
+        
         void MemoryTest::_endian()
         {
             _print(Format("Current endian: {0}").arg(getEndian()));
@@ -24,6 +24,7 @@ namespace ftk
 
         private:
             void _enums();
+            void _aligned();
             void _endian();
             void _bits();
         };
@@ -97,6 +97,7 @@ namespace ftk
 
                     olist->clear();
                     FTK_ASSERT(list.empty());
+                    FTK_ASSERT(ObservableListChange({ 0, 2, 0 }) == olist->getChange());
 
                     olist->pushBack(1);
                     olist->pushBack(2);
@@ -108,14 +109,26 @@ namespace ftk
                     FTK_ASSERT(!list.empty() && 1 == list[0]);
                     olist->pushBack({ 3, 4 });
                     FTK_ASSERT(4 == olist->getSize());
+                    FTK_ASSERT(ObservableListChange({ 2, 0, 2 }) == olist->getChange());
 
                     olist->setItem(0, 1);
                     olist->setItemOnlyIfChanged(0, 1);
                     olist->setItemOnlyIfChanged(0, 2);
+                    FTK_ASSERT(ObservableListChange({ 0, 1, 1 }) == olist->getChange());
                     olist->replaceItems(2, 4, { 5, 6 });
+                    FTK_ASSERT(ObservableListChange({ 2, 2, 2 }) == olist->getChange());
                     FTK_ASSERT(5 == olist->getItem(2));
                     FTK_ASSERT(6 == olist->getItem(3));
                     olist->removeItems(2, 4);
+                    FTK_ASSERT(ObservableListChange({ 2, 2, 0 }) == olist->getChange());
+
+                    olist->pushBack({ 3, 4 });
+                    olist->replaceItems(2, 4, { 5, 6, 7 });
+                    FTK_ASSERT(ObservableListChange({ 2, 2, 3 }) == olist->getChange());
+                    FTK_ASSERT(5 == olist->getSize());
+                    FTK_ASSERT(7 == olist->getItem(4));
+                    olist->removeItems(2, 5);
+                    FTK_ASSERT(ObservableListChange({ 2, 3, 0 }) == olist->getChange());
                     olist->removeItem(1);
                     olist->removeItem(0);
                     FTK_ASSERT(list.empty());
@@ -8,6 +8,9 @@
 #include <ftk/Core/FileIO.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/ImageIO.h>
+#include <ftk/Core/PNG.h>
+
+#include <cstring>
 
 namespace ftk
 {
@@ -101,6 +104,52 @@ namespace ftk
                         }
                     }
                 }
+
+                // Test the write options and reading into an existing
+                // image.
+                for (auto imageType : imageTypes)
+                {
+                    if (ImageType::None == imageType)
+                        continue;
+                    const ImageInfo info(512, 300, imageType);
+                    auto image = Image::create(info);
+                    uint8_t* data = image->getData();
+                    for (size_t i = 0; i < image->getByteCount(); ++i)
+                    {
+                        data[i] = (i * 7 + i / 1021) & 0xff;
+                    }
+                    std::vector<png::Filter> filters = { png::Filter::Adaptive };
+                    if (ImageType::RGBA_U8 == imageType || ImageType::RGB_U16 == imageType)
+                    {
+                        filters = png::getFilterEnums();
+                    }
+                    for (auto filter : filters)
+                    {
+                        for (const std::string threads : { "1", "0" })
+                        {
+                            const std::filesystem::path path = Format(
+                                "PNGTest_{0}_{1}_{2}.png").
+                                arg(imageType).
+                                arg(filter).
+                                arg(threads).str();
+                            ImageIOOptions options;
+                            options["PNG/Compression"] = "1";
+                            options["PNG/Filter"] = to_string(filter);
+                            options["PNG/Threads"] = threads;
+                            io->write(path, info, options)->write(image);
+
+                            auto read = io->read(path);
+                            FTK_ASSERT(info.size == read->getInfo().size);
+                            FTK_ASSERT(info.type == read->getInfo().type);
+                            auto image2 = Image::create(info);
+                            read->readInto(image2);
+                            FTK_ASSERT(0 == memcmp(
+                                image->getData(),
+                                image2->getData(),
+                                image->getByteCount()));
+                        }
+                    }
+                }
             }
         }
     }
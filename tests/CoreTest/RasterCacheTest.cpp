@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <CoreTest/RasterCacheTest.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Context.h>
+#include <ftk/Core/FileIO.h>
+#include <ftk/Core/FontSystem.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/RasterCache.h>
+
+#include <cstring>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        RasterCacheTest::RasterCacheTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::core_test::RasterCacheTest")
+        {}
+
+        RasterCacheTest::~RasterCacheTest()
+        {}
+
+        std::shared_ptr<RasterCacheTest> RasterCacheTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<RasterCacheTest>(new RasterCacheTest(context));
+        }
+        
+        void RasterCacheTest::run()
+        {
+            _cache();
+            _fontSystem();
+        }
+
+        void RasterCacheTest::_cache()
+        {
+            const std::filesystem::path path =
+                std::filesystem::temp_directory_path() / "RasterCacheTest.cache";
+            std::filesystem::remove(path);
+            {
+                const std::string s = "abc";
+                FTK_ASSERT(getRasterCacheHash(s.data(), s.size()) ==
+                    getRasterCacheHash(s.data(), s.size()));
+                FTK_ASSERT(getRasterCacheHash(s.data(), s.size()) !=
+                    getRasterCacheHash(s.data(), s.size() - 1));
+            }
+            auto image = Image::create(3, 2, ImageType::L_U8);
+            for (size_t i = 0; i < image->getByteCount(); ++i)
+            {
+                image->getData()[i] = i;
+            }
+            {
+                auto cache = RasterCache::create(path);
+                FTK_ASSERT(path == cache->getPath());
+                FTK_ASSERT(0 == cache->getCount());
+                std::shared_ptr<Image> image2;
+                FTK_ASSERT(!cache->get("image", image2));
+                cache->add("image", image, { 1, -2, 3 });
+                cache->add("empty", nullptr, { 4 });
+                cache->add("zero", Image::create(0, 0, ImageType::L_U8), { 5 });
+                FTK_ASSERT(3 == cache->getCount());
+                cache->save();
+                FTK_ASSERT(3 == cache->getCount());
+            }
+            {
+                auto cache = RasterCache::create(path);
+                FTK_ASSERT(3 == cache->getCount());
+                std::shared_ptr<Image> image2;
+                std::vector<int32_t> data;
+                FTK_ASSERT(cache->get("image", image2, &data));
+                FTK_ASSERT(image2);
+                FTK_ASSERT(image2->getInfo() == image->getInfo());
+                FTK_ASSERT(0 == memcmp(
+                    image2->getData(),
+                    image->getData(),
+                    image->getByteCount()));
+                FTK_ASSERT(std::vector<int32_t>({ 1, -2, 3 }) == data);
+                FTK_ASSERT(cache->get("empty", image2, &data));
+                FTK_ASSERT(!image2);
+                FTK_ASSERT(std::vector<int32_t>({ 4 }) == data);
+                FTK_ASSERT(cache->get("zero", image2, &data));
+                FTK_ASSERT(image2);
+                FTK_ASSERT(0 == image2->getByteCount());
+                FTK_ASSERT(std::vector<int32_t>({ 5 }) == data);
+            }
+            {
+                // Only the most recently used items that fit in the
+                // maximum size are written.
+                auto cache = RasterCache::create(path);
+                const size_t itemByteCount = 8 * sizeof(uint32_t) + 2 + sizeof(int32_t);
+                cache->setMax(4 * sizeof(uint32_t) + 2 * itemByteCount);
+                FTK_ASSERT(4 * sizeof(uint32_t) + 2 * itemByteCount == cache->getMax());
+                for (int i = 0; i < 4; ++i)
+                {
+                    cache->add(Format("a{0}").arg(i), nullptr, { i });
+                }
+                std::shared_ptr<Image> image2;
+                FTK_ASSERT(cache->get("a1", image2));
+                cache->save();
+                FTK_ASSERT(2 == cache->getCount());
+                FTK_ASSERT(cache->get("a1", image2));
+                FTK_ASSERT(cache->get("a3", image2));
+            }
+            {
+                auto cache = RasterCache::create(path);
+                FTK_ASSERT(2 == cache->getCount());
+                std::shared_ptr<Image> image2;
+                std::vector<int32_t> data;
+                FTK_ASSERT(!cache->get("image", image2));
+                FTK_ASSERT(cache->get("a1", image2, &data));
+                FTK_ASSERT(std::vector<int32_t>({ 1 }) == data);
+                FTK_ASSERT(cache->get("a3", image2, &data));
+                FTK_ASSERT(std::vector<int32_t>({ 3 }) == data);
+            }
+            {
+                // The items are kept if the file cannot be replaced.
+                const std::filesystem::path dir =
+                    std::filesystem::temp_directory_path() / "RasterCacheTest.dir";
+                std::filesystem::remove_all(dir);
+                std::filesystem::create_directories(dir / "dir");
+                auto cache = RasterCache::create(dir);
+                cache->add("image", image, { 1 });
+                bool error = false;
+                try
+                {
+                    cache->save();
+                }
+                catch (const std::exception&)
+                {
+                    error = true;
+                }
+                FTK_ASSERT(error);
+                FTK_ASSERT(1 == cache->getCount());
+                std::shared_ptr<Image> image2;
+                FTK_ASSERT(cache->get("image", image2));
+                FTK_ASSERT(image2 && image2->getInfo() == image->getInfo());
+                FTK_ASSERT(!std::filesystem::exists(
+                    std::filesystem::temp_directory_path() / "RasterCacheTest.dir.tmp"));
+                std::filesystem::remove_all(dir);
+            }
+            {
+                // Files with an invalid header are ignored.
+                auto io = FileIO::create(path, FileMode::Write);
+                io->writeU32(0);
+            }
+            {
+                auto cache = RasterCache::create(path);
+                FTK_ASSERT(0 == cache->getCount());
+            }
+            std::filesystem::remove(path);
+        }
+
+        void RasterCacheTest::_fontSystem()
+        {
+            if (auto context = _context.lock())
+            {
+                const std::filesystem::path path =
+                    std::filesystem::temp_directory_path() / "RasterCacheTest.cache";
+                std::filesystem::remove(path);
+                std::string s;
+                for (char c = '!'; c <= '~'; ++c)
+                {
+                    s.push_back(c);
+                }
+                const std::vector<int> sizes = { 12, 14, 16, 24, 32 };
+                std::vector<std::vector<std::shared_ptr<Glyph> > > glyphs[2];
+                for (int i = 0; i < 2; ++i)
+                {
+                    // The glyphs are rasterized with an empty cache, and
+                    // read from the cache with a new font system.
+                    auto fontSystem = FontSystem::create(context);
+                    auto cache = RasterCache::create(path);
+                    fontSystem->setRasterCache(cache);
+                    FTK_ASSERT(cache == fontSystem->getRasterCache());
+                    for (const int size : sizes)
+                    {
+                        glyphs[i].push_back(
+                            fontSystem->getGlyphs(s, FontInfo(getFont(Font::Regular), size)));
+                    }
+                    cache->save();
+                    const GlyphStats stats = fontSystem->getGlyphStats(GlyphMode::Bitmap);
+                    FTK_ASSERT(s.size() * sizes.size() == (0 == i ? stats.glyphCount : stats.cacheCount));
+                    FTK_ASSERT(0 == (0 == i ? stats.cacheCount : stats.glyphCount));
+                    FTK_ASSERT(s.size() * sizes.size() == cache->getCount());
+                }
+                for (size_t i = 0; i < glyphs[0].size(); ++i)
+                {
+                    FTK_ASSERT(glyphs[0][i].size() == glyphs[1][i].size());
+                    for (size_t j = 0; j < glyphs[0][i].size(); ++j)
+                    {
+                        const auto& a = glyphs[0][i][j];
+                        const auto& b = glyphs[1][i][j];
+                        FTK_ASSERT(a->info == b->info);
+                        FTK_ASSERT(a->offset == b->offset);
+                        FTK_ASSERT(a->advance == b->advance);
+                        FTK_ASSERT(a->image && b->image);
+                        FTK_ASSERT(a->image->getInfo() == b->image->getInfo());
+                        FTK_ASSERT(0 == memcmp(
+                            a->image->getData(),
+                            b->image->getData(),
+                            a->image->getByteCount()));
+                    }
+                }
+                std::filesystem::remove(path);
+            }
+        }
+    }
+}
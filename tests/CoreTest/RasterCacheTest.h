@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <TestLib/ITest.h>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        class RasterCacheTest : public test::ITest
+        {
+        protected:
+            RasterCacheTest(const std::shared_ptr<Context>&);
+
+        public:
+            virtual ~RasterCacheTest();
+
+            static std::shared_ptr<RasterCacheTest> create(
+                const std::shared_ptr<Context>&);
+
+            void run() override;
+
+        private:
+            void _cache();
+            void _fontSystem();
+        };
+    }
+}
+
@@ -0,0 +1,333 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <CoreTest/SoftwareRenderTest.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Context.h>
+#include <ftk/Core/FontSystem.h>
+#include <ftk/Core/SoftwareRender.h>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        SoftwareRenderTest::SoftwareRenderTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::core_test::SoftwareRenderTest")
+        {}
+
+        SoftwareRenderTest::~SoftwareRenderTest()
+        {}
+
+        std::shared_ptr<SoftwareRenderTest> SoftwareRenderTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<SoftwareRenderTest>(new SoftwareRenderTest(context));
+        }
+
+        void SoftwareRenderTest::run()
+        {
+            _members();
+            _prims();
+            _text();
+            _images();
+        }
+
+        namespace
+        {
+            // Get a pixel, with the Y axis pointing down.
+            Color4F getPixel(const std::shared_ptr<Image>& image, int x, int y)
+            {
+                const uint8_t* p =
+                    image->getData() +
+                    ((image->getHeight() - 1 - y) * image->getWidth() + x) * 4;
+                return Color4F(p[0] / 255.F, p[1] / 255.F, p[2] / 255.F, p[3] / 255.F);
+            }
+
+            bool isEqual(const Color4F& a, const Color4F& b)
+            {
+                const float e = 1.F / 255.F;
+                return
+                    std::fabs(a.r - b.r) <= e &&
+                    std::fabs(a.g - b.g) <= e &&
+                    std::fabs(a.b - b.b) <= e &&
+                    std::fabs(a.a - b.a) <= e;
+            }
+        }
+
+        void SoftwareRenderTest::_members()
+        {
+            if (auto context = _context.lock())
+            {
+                auto render = SoftwareRender::create(context->getLogSystem());
+                FTK_ASSERT(render->getImageCache());
+
+                Size2I size(1920, 1080);
+                render->begin(size);
+                FTK_ASSERT(render->getRenderSize() == size);
+                FTK_ASSERT(render->getImage());
+                FTK_ASSERT(render->getImage()->getSize() == size);
+                FTK_ASSERT(ImageType::RGBA_U8 == render->getImage()->getType());
+
+                size = Size2I(1280, 960);
+                render->setRenderSize(size);
+                FTK_ASSERT(render->getRenderSize() == size);
+
+                Box2I viewport(0, 0, 100, 100);
+                render->setViewport(viewport);
+                FTK_ASSERT(render->getViewport() == viewport);
+
+                render->setClipRectEnabled(true);
+                FTK_ASSERT(render->getClipRectEnabled());
+                Box2I clipRect(0, 0, 50, 50);
+                render->setClipRect(clipRect);
+                FTK_ASSERT(clipRect == render->getClipRect());
+                render->setClipRectEnabled(false);
+
+                M44F transform = perspective(60.F, 1.F, .1F, 10000.F);
+                render->setTransform(transform);
+                FTK_ASSERT(transform == render->getTransform());
+
+                render->end();
+            }
+        }
+
+        void SoftwareRenderTest::_prims()
+        {
+            if (auto context = _context.lock())
+            {
+                auto render = SoftwareRender::create(context->getLogSystem());
+                const Size2I size(100, 100);
+                RenderOptions options;
+                options.clearColor = Color4F(0.F, 0.F, 0.F, 1.F);
+                render->begin(size, options);
+                const auto& image = render->getImage();
+                FTK_ASSERT(isEqual(getPixel(image, 0, 0), Color4F(0.F, 0.F, 0.F, 1.F)));
+
+                // Rectangles cover the pixels with centers inside them.
+                render->drawRect(Box2F(10.F, 10.F, 10.F, 10.F), Color4F(1.F, 0.F, 0.F, 1.F));
+                FTK_ASSERT(isEqual(getPixel(image, 10, 10), Color4F(1.F, 0.F, 0.F, 1.F)));
+                FTK_ASSERT(isEqual(getPixel(image, 19, 19), Color4F(1.F, 0.F, 0.F, 1.F)));
+                FTK_ASSERT(isEqual(getPixel(image, 9, 10), Color4F(0.F, 0.F, 0.F, 1.F)));
+                FTK_ASSERT(isEqual(getPixel(image, 20, 19), Color4F(0.F, 0.F, 0.F, 1.F)));
+
+                // Blending.
+                render->drawRect(Box2F(10.F, 10.F, 10.F, 10.F), Color4F(0.F, 0.F, 1.F, .5F));
+                const Color4F c = getPixel(image, 15, 15);
+                FTK_ASSERT(std::fabs(c.r - .5F) < .01F);
+                FTK_ASSERT(std::fabs(c.b - .5F) < .01F);
+
+                // Clipping.
+                render->setClipRectEnabled(true);
+                render->setClipRect(Box2I(30, 30, 10, 10));
+                render->drawRect(Box2F(0.F, 0.F, 100.F, 100.F), Color4F(0.F, 1.F, 0.F, 1.F));
+                FTK_ASSERT(isEqual(getPixel(image, 30, 30), Color4F(0.F, 1.F, 0.F, 1.F)));
+                FTK_ASSERT(isEqual(getPixel(image, 39, 39), Color4F(0.F, 1.F, 0.F, 1.F)));
+                FTK_ASSERT(isEqual(getPixel(image, 29, 30), Color4F(0.F, 0.F, 0.F, 1.F)));
+                FTK_ASSERT(isEqual(getPixel(image, 40, 39), Color4F(0.F, 0.F, 0.F, 1.F)));
+                render->setClipRectEnabled(false);
+
+                // Transforms.
+                render->setTransform(
+                    ortho(0.F, 100.F, 100.F, 0.F, -1.F, 1.F) *
+                    translate(V3F(50.F, 50.F, 0.F)));
+                render->drawRect(Box2F(0.F, 0.F, 5.F, 5.F), Color4F(1.F, 1.F, 1.F, 1.F));
+                FTK_ASSERT(isEqual(getPixel(image, 50, 50), Color4F(1.F, 1.F, 1.F, 1.F)));
+                FTK_ASSERT(isEqual(getPixel(image, 55, 55), Color4F(0.F, 0.F, 0.F, 1.F)));
+                render->setTransform(
+                    ortho(0.F, 100.F, 100.F, 0.F, -1.F, 1.F) *
+                    scale(V3F(2.F, 2.F, 1.F)));
+                render->drawRect(Box2F(30.F, 0.F, 5.F, 5.F), Color4F(1.F, 1.F, 1.F, 1.F));
+                FTK_ASSERT(isEqual(getPixel(image, 60, 0), Color4F(1.F, 1.F, 1.F, 1.F)));
+                FTK_ASSERT(isEqual(getPixel(image, 69, 9), Color4F(1.F, 1.F, 1.F, 1.F)));
+                FTK_ASSERT(isEqual(getPixel(image, 70, 9), Color4F(0.F, 0.F, 0.F, 1.F)));
+                render->setTransform(ortho(0.F, 100.F, 100.F, 0.F, -1.F, 1.F));
+
+                // Meshes.
+                {
+                    TriMesh2F mesh;
+                    mesh.v.push_back(V2F(0.F, 80.F));
+                    mesh.v.push_back(V2F(10.F, 80.F));
+                    mesh.v.push_back(V2F(10.F, 90.F));
+                    mesh.v.push_back(V2F(0.F, 90.F));
+                    mesh.triangles.push_back({ 1, 3, 2 });
+                    mesh.triangles.push_back({ 3, 1, 4 });
+                    render->drawMesh(mesh, Color4F(1.F, 1.F, 0.F, 1.F), V2F(5.F, 0.F));
+                    FTK_ASSERT(isEqual(getPixel(image, 5, 80), Color4F(1.F, 1.F, 0.F, 1.F)));
+                    FTK_ASSERT(isEqual(getPixel(image, 14, 89), Color4F(1.F, 1.F, 0.F, 1.F)));
+                    FTK_ASSERT(isEqual(getPixel(image, 4, 80), Color4F(0.F, 0.F, 0.F, 1.F)));
+                }
+                {
+                    TriMesh2F mesh;
+                    mesh.v.push_back(V2F(80.F, 80.F));
+                    mesh.v.push_back(V2F(90.F, 80.F));
+                    mesh.v.push_back(V2F(90.F, 90.F));
+                    mesh.v.push_back(V2F(80.F, 90.F));
+                    mesh.c.push_back(V4F(1.F, 0.F, 0.F, 1.F));
+                    mesh.c.push_back(V4F(0.F, 1.F, 0.F, 1.F));
+                    Triangle2 triangle;
+                    triangle.v[0] = Vertex2(1, 0, 1);
+                    triangle.v[1] = Vertex2(3, 0, 2);
+                    triangle.v[2] = Vertex2(2, 0, 1);
+                    mesh.triangles.push_back(triangle);
+                    triangle.v[0] = Vertex2(3, 0, 2);
+                    triangle.v[1] = Vertex2(1, 0, 1);
+                    triangle.v[2] = Vertex2(4, 0, 2);
+                    mesh.triangles.push_back(triangle);
+                    render->drawColorMesh(mesh);
+                    const Color4F top = getPixel(image, 85, 80);
+                    const Color4F bottom = getPixel(image, 85, 89);
+                    FTK_ASSERT(top.r > .9F && top.g < .1F);
+                    FTK_ASSERT(bottom.r < .1F && bottom.g > .9F);
+                }
+
+                // Lines.
+                render->drawLine(
+                    V2F(0.F, 95.5F),
+                    V2F(100.F, 95.5F),
+                    Color4F(0.F, 1.F, 1.F, 1.F),
+                    LineOptions());
+                FTK_ASSERT(isEqual(getPixel(image, 50, 95), Color4F(0.F, 1.F, 1.F, 1.F)));
+                FTK_ASSERT(isEqual(getPixel(image, 50, 94), Color4F(0.F, 0.F, 0.F, 1.F)));
+
+                // Textures are not supported.
+                render->drawTexture(0, Box2I(0, 0, 10, 10));
+                FTK_ASSERT(isEqual(getPixel(image, 5, 5), Color4F(0.F, 0.F, 0.F, 1.F)));
+
+                // Viewport.
+                render->setViewport(Box2I(50, 0, 50, 50));
+                render->clearViewport(Color4F(1.F, 0.F, 1.F, 1.F));
+                FTK_ASSERT(isEqual(getPixel(image, 50, 0), Color4F(1.F, 0.F, 1.F, 1.F)));
+                FTK_ASSERT(isEqual(getPixel(image, 49, 0), Color4F(0.F, 0.F, 0.F, 1.F)));
+
+                render->end();
+            }
+        }
+
+        void SoftwareRenderTest::_text()
+        {
+            if (auto context = _context.lock())
+            {
+                auto render = SoftwareRender::create(context->getLogSystem());
+                const Size2I size(200, 100);
+                RenderOptions options;
+                options.clearColor = Color4F(0.F, 0.F, 0.F, 1.F);
+                render->begin(size, options);
+                const auto& image = render->getImage();
+
+                auto fontSystem = context->getSystem<FontSystem>();
+                const FontInfo fontInfo;
+                const auto fontMetrics = fontSystem->getMetrics(fontInfo);
+                const auto glyphs = fontSystem->getGlyphs("Hello world\nHello world", fontInfo);
+                render->drawText(glyphs, fontMetrics, V2F(10.F, 10.F), Color4F(1.F, 1.F, 1.F, 1.F));
+
+                float sum = 0.F;
+                for (int y = 0; y < size.h; ++y)
+                {
+                    for (int x = 0; x < size.w; ++x)
+                    {
+                        sum += getPixel(image, x, y).r;
+                    }
+                }
+                FTK_ASSERT(sum > 0.F);
+                for (int y = 0; y < size.h; ++y)
+                {
+                    FTK_ASSERT(isEqual(getPixel(image, 0, y), Color4F(0.F, 0.F, 0.F, 1.F)));
+                }
+
+                // Scaled text.
+                render->setTransform(
+                    ortho(0.F, 200.F, 100.F, 0.F, -1.F, 1.F) *
+                    scale(V3F(2.F, 2.F, 1.F)));
+                render->drawText(glyphs, fontMetrics, V2F(10.F, 10.F), Color4F(1.F, 1.F, 1.F, 1.F));
+
+                render->end();
+            }
+        }
+
+        void SoftwareRenderTest::_images()
+        {
+            if (auto context = _context.lock())
+            {
+                auto render = SoftwareRender::create(context->getLogSystem());
+                const Size2I size(100, 100);
+                render->begin(size);
+                const auto& image = render->getImage();
+
+                // The image rows are stored from bottom to top unless the
+                // image is mirrored.
+                for (bool mirrorY : { false, true })
+                {
+                    ImageInfo info(2, 2, ImageType::L_U8);
+                    info.layout.mirror.y = mirrorY;
+                    auto l = Image::create(info);
+                    l->getData()[0] = 255;
+                    l->getData()[1] = 255;
+                    l->getData()[2] = 0;
+                    l->getData()[3] = 0;
+                    ImageOptions imageOptions;
+                    imageOptions.imageFilters.minify = ImageFilter::Nearest;
+                    imageOptions.imageFilters.magnify = ImageFilter::Nearest;
+                    render->drawImage(l, Box2F(0.F, 0.F, 10.F, 10.F), Color4F(1.F, 1.F, 1.F, 1.F), imageOptions);
+                    const Color4F top = getPixel(image, 5, 1);
+                    const Color4F bottom = getPixel(image, 5, 8);
+                    FTK_ASSERT(isEqual(top, mirrorY ? Color4F(1.F, 1.F, 1.F, 1.F) : Color4F(0.F, 0.F, 0.F, 1.F)));
+                    FTK_ASSERT(isEqual(bottom, mirrorY ? Color4F(0.F, 0.F, 0.F, 1.F) : Color4F(1.F, 1.F, 1.F, 1.F)));
+                }
+
+                std::vector<ImageOptions> imageOptionsList;
+                for (auto i : getInputVideoLevelsEnums())
+                {
+                    ImageOptions imageOptions;
+                    imageOptions.videoLevels = i;
+                    imageOptionsList.push_back(imageOptions);
+                }
+                for (auto i : getAlphaBlendEnums())
+                {
+                    ImageOptions imageOptions;
+                    imageOptions.alphaBlend = i;
+                    imageOptionsList.push_back(imageOptions);
+                }
+                for (auto i : getChannelDisplayEnums())
+                {
+                    ImageOptions imageOptions;
+                    imageOptions.channelDisplay = i;
+                    imageOptionsList.push_back(imageOptions);
+                }
+                {
+                    ImageOptions imageOptions;
+                    imageOptions.cache = false;
+                    imageOptionsList.push_back(imageOptions);
+                }
+                {
+                    ImageOptions imageOptions;
+                    imageOptions.imageFilters.minify = ImageFilter::Nearest;
+                    imageOptions.imageFilters.magnify = ImageFilter::Nearest;
+                    imageOptionsList.push_back(imageOptions);
+                }
+                for (const auto& imageSize : { Size2I(16, 16), Size2I(15, 9), Size2I(256, 256) })
+                {
+                    for (auto imageType : getImageTypeEnums())
+                    {
+                        auto image = Image::create(imageSize, imageType);
+                        if (image->isValid())
+                        {
+                            image->zero();
+                        }
+                        for (const auto& imageOptions : imageOptionsList)
+                        {
+                            render->drawImage(
+                                image,
+                                Box2F(20.F, 20.F, 64.F, 64.F),
+                                Color4F(1.F, 1.F, 1.F, 1.F),
+                                imageOptions);
+                        }
+                    }
+                }
+                FTK_ASSERT(render->getImageCache()->getSize() > 0);
+
+                render->end();
+            }
+        }
+    }
+}
@@ -62,6 +62,7 @@ namespace ftk
             auto system = System1::create(context);
             FTK_ASSERT(system->getContext().lock());
             FTK_ASSERT(!system->getName().empty());
+            FTK_ASSERT(!system->hasPendingWork());
             context->addSystem(system);
             context->addSystem(System2::create(context));
         }
@@ -52,6 +52,10 @@ namespace ftk
                     }
                 });
 
+            auto timerSystem = context->getSystem<TimerSystem>();
+            FTK_ASSERT(timerSystem->getNextTimeout() <= timeout);
+            FTK_ASSERT(timer->getDeadline() > std::chrono::steady_clock::now() - timeout);
+
             auto t0 = std::chrono::steady_clock::now();
             while (!timedout || repeatCount > 0)
             {
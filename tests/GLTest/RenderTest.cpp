@@ -3,6 +3,7 @@
 
 #include <GLTest/RenderTest.h>
 
+#include <ftk/GL/GL.h>
 #include <ftk/GL/OffscreenBuffer.h>
 #include <ftk/GL/Render.h>
 #include <ftk/GL/Window.h>
@@ -48,6 +49,39 @@ namespace ftk
                 options.color = offscreenColorDefault;
                 return OffscreenBuffer::create(size, options);
             }
+
+            std::shared_ptr<Image> drawText(
+                const std::shared_ptr<Context>& context,
+                const std::string& text,
+                const FontInfo& fontInfo,
+                const RenderOptions& renderOptions)
+            {
+                auto fontSystem = context->getSystem<FontSystem>();
+                const FontMetrics fontMetrics = fontSystem->getMetrics(fontInfo);
+                const Size2I size(
+                    fontSystem->getSize(text, fontInfo).w,
+                    fontMetrics.lineHeight);
+                auto buffer = createBuffer(size);
+                OffscreenBufferBinding bufferBinding(buffer);
+                auto render = Render::create(context->getLogSystem());
+                render->begin(size, renderOptions);
+                render->drawText(
+                    fontSystem->getGlyphs(text, fontInfo),
+                    fontMetrics,
+                    V2F(0.F, 0.F));
+                render->end();
+                auto out = Image::create(size, ImageType::RGBA_U8);
+                glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                glReadPixels(
+                    0,
+                    0,
+                    size.w,
+                    size.h,
+                    GL_RGBA,
+                    GL_UNSIGNED_BYTE,
+                    out->getData());
+                return out;
+            }
         }
         
         void RenderTest::run()
@@ -146,6 +180,21 @@ namespace ftk
                     mesh.triangles.push_back(triangle);
                     render->drawColorMesh(mesh);
                 }
+
+                // Rectangles with the same state are batched into a single
+                // draw call.
+                render->flush();
+                const size_t drawCount = render->getDrawCount();
+                for (int i = 0; i < 1000; ++i)
+                {
+                    render->drawRect(
+                        Box2F(i, i, 10.F, 10.F),
+                        Color4F(1.F, 1.F, 1.F, .5F));
+                }
+                render->flush();
+                FTK_ASSERT(drawCount + 1 == render->getDrawCount());
+                render->drawRect(box, Color4F(0.F, 0.F, 1.F, .5F));
+                FTK_ASSERT(render->getShader("mesh"));
                 
                 std::string text = "Hello world";
                 auto fontSystem = context->getSystem<FontSystem>();
@@ -199,8 +248,85 @@ namespace ftk
                     }
                 }
 
+                // A nested render should not drop the pending commands of
+                // the outer render.
+                render->flush();
+                const size_t drawCount2 = render->getDrawCount();
+                render->drawRect(box, Color4F(1.F, 1.F, 1.F, 1.F));
+                {
+                    auto render2 = Render::create(context->getLogSystem());
+                    render2->begin(Size2I(100, 100));
+                    render2->drawRect(Box2F(0, 0, 100, 100), Color4F(1.F, 0.F, 0.F, 1.F));
+                    render2->end();
+                }
+                flushRender();
+                FTK_ASSERT(drawCount2 + 1 == render->getDrawCount());
+
                 render->end();
             }
+            if (auto context = _context.lock())
+            {
+                // The pending commands of the outer render are drawn
+                // before the commands of a nested render.
+                auto window = createWindow(context);
+                const Size2I size(100, 100);
+                auto buffer = createBuffer(size);
+                OffscreenBufferBinding bufferBinding(buffer);
+                auto render = Render::create(context->getLogSystem());
+                render->begin(size);
+                render->drawRect(Box2F(0, 0, 100, 100), Color4F(1.F, 0.F, 0.F, 1.F));
+                {
+                    auto render2 = Render::create(context->getLogSystem());
+                    RenderOptions renderOptions;
+                    renderOptions.clear = false;
+                    render2->begin(size, renderOptions);
+                    render2->drawRect(Box2F(0, 0, 50, 100), Color4F(0.F, 1.F, 0.F, 1.F));
+                    render2->end();
+                }
+                render->end();
+                auto image = Image::create(size, ImageType::RGBA_U8);
+                glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                glReadPixels(
+                    0,
+                    0,
+                    size.w,
+                    size.h,
+                    GL_RGBA,
+                    GL_UNSIGNED_BYTE,
+                    image->getData());
+                const uint8_t* left = image->getData() + (50 * size.w + 25) * 4;
+                const uint8_t* right = image->getData() + (50 * size.w + 75) * 4;
+                FTK_ASSERT(0 == left[0] && 255 == left[1] && 0 == left[2]);
+                FTK_ASSERT(255 == right[0] && 0 == right[1] && 0 == right[2]);
+            }
+            if (auto context = _context.lock())
+            {
+                // Glyphs that are evicted from the atlas while drawing a
+                // string should not be drawn with the wrong texture
+                // coordinates. Compare a string drawn with an atlas that
+                // is too small to hold it, to the same string drawn with
+                // the default atlas.
+                auto window = createWindow(context);
+                const std::string text = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+                const FontInfo fontInfo(getFont(Font::Regular), 32);
+                RenderOptions renderOptions;
+                renderOptions.clearColor = Color4F(0.F, 0.F, 0.F, 1.F);
+                const auto image = drawText(context, text, fontInfo, renderOptions);
+                renderOptions.glyphAtlasSize = 64;
+                renderOptions.glyphAtlasPages = 1;
+                const auto image2 = drawText(context, text, fontInfo, renderOptions);
+                FTK_ASSERT(image->getInfo() == image2->getInfo());
+                // The texture coordinates are quantized differently for
+                // the different atlas sizes, so allow small differences.
+                int diffMax = 0;
+                for (size_t i = 0; i < image->getByteCount(); ++i)
+                {
+                    diffMax = std::max(
+                        diffMax,
+                        std::abs(image->getData()[i] - image2->getData()[i]));
+                }
+                FTK_ASSERT(diffMax < 32);
+            }
         }
     }
 }
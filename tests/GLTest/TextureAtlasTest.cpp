@@ -76,6 +76,58 @@ namespace ftk
                     _print(format(item));
                     _print(Format("Percentage: {0}").arg(atlas->getPercentageUsed()));
                 }
+
+                atlas = TextureAtlas::create(
+                    1024,
+                    ImageType::L_U8,
+                    ImageFilter::Linear,
+                    0,
+                    2);
+                FTK_ASSERT(2 == atlas->getMaxPages());
+                FTK_ASSERT(1 == atlas->getPageCount());
+                FTK_ASSERT(atlas->getTexture(0));
+                FTK_ASSERT(!atlas->getTexture(1));
+                std::vector<TextureAtlasItem> items;
+                for (size_t i = 0; i < 8; ++i)
+                {
+                    auto image = Image::create(512, 512, ImageType::L_U8);
+                    TextureAtlasItem item;
+                    FTK_ASSERT(atlas->addItem(image, item));
+                    FTK_ASSERT(i / 4 == item.page);
+                    items.push_back(item);
+                }
+                FTK_ASSERT(2 == atlas->getPageCount());
+                FTK_ASSERT(atlas->getTexture(1));
+                FTK_ASSERT(8 == atlas->getCount());
+                FTK_ASSERT(1.F == atlas->getPercentageUsed());
+                FTK_ASSERT(0 == atlas->getEvictionCount());
+
+                // The first page is the least recently used.
+                TextureAtlasItem item;
+                FTK_ASSERT(atlas->getItem(items[4].id, item));
+                FTK_ASSERT(1 == item.page);
+                FTK_ASSERT(!atlas->addItem(Image::create(512, 512, ImageType::L_U8), item, false));
+                FTK_ASSERT(8 == atlas->getCount());
+                FTK_ASSERT(0 == atlas->getEvictionCount());
+                FTK_ASSERT(atlas->addItem(Image::create(512, 512, ImageType::L_U8), item));
+                FTK_ASSERT(0 == item.page);
+                FTK_ASSERT(1 == atlas->getEvictionCount());
+                FTK_ASSERT(!atlas->hasItem(items[0].id));
+                FTK_ASSERT(atlas->hasItem(items[1].id));
+                FTK_ASSERT(atlas->hasItem(items[4].id));
+
+                // Release the least recently used page.
+                atlas->defragment(.5F);
+                FTK_ASSERT(2 == atlas->getPageCount());
+                FTK_ASSERT(atlas->getItem(items[5].id, item));
+                atlas->defragment(1.1F);
+                FTK_ASSERT(1 == atlas->getPageCount());
+                FTK_ASSERT(!atlas->getTexture(0));
+                FTK_ASSERT(!atlas->hasItem(items[1].id));
+                FTK_ASSERT(atlas->hasItem(items[5].id));
+                FTK_ASSERT(5 == atlas->getEvictionCount());
+                atlas->defragment(1.1F);
+                FTK_ASSERT(1 == atlas->getPageCount());
             }
         }
     }
@@ -6,6 +6,7 @@
 #include <ftk/UI/App.h>
 #include <ftk/UI/Divider.h>
 #include <ftk/UI/GridLayout.h>
+#include <ftk/UI/Label.h>
 #include <ftk/UI/Spacer.h>
 #include <ftk/UI/Window.h>
 
@@ -30,6 +31,12 @@ namespace ftk
         }
 
         void GridLayoutTest::run()
+        {
+            _layout();
+            _update();
+        }
+
+        void GridLayoutTest::_layout()
         {
             if (auto context = _context.lock())
             {
@@ -68,6 +75,52 @@ namespace ftk
                 app->tick();
             }
         }
+
+        void GridLayoutTest::_update()
+        {
+            if (auto context = _context.lock())
+            {
+                std::vector<std::string> argv;
+                argv.push_back("GridLayoutTest");
+                auto app = App::create(
+                    context,
+                    argv,
+                    "GridLayoutTest",
+                    "Grid layout test.");
+                auto window = Window::create(context, "GridLayoutTest");
+                app->addWindow(window);
+                window->show();
+                app->tick();
+
+                auto layout = GridLayout::create(context, window);
+                std::vector<std::shared_ptr<Label> > labels;
+                for (int row = 0; row < 10; ++row)
+                {
+                    for (int column = 0; column < 5; ++column)
+                    {
+                        auto label = Label::create(
+                            context,
+                            Format("{0}, {1}").arg(row).arg(column),
+                            layout);
+                        layout->setGridPos(label, row, column);
+                        labels.push_back(label);
+                    }
+                }
+                app->tick();
+
+                // Update a single widget.
+                auto label = labels[labels.size() / 2];
+                label->setText("The quick brown fox jumps over the lazy dog");
+                app->tick();
+                FTK_ASSERT(label->getGeometry().w() >= label->getSizeHint().w());
+                app->tick();
+                FTK_ASSERT(!window->hasSizeUpdate(true));
+
+                // Update all of the widgets.
+                window->setDisplayScale(2.F);
+                app->tick();
+                FTK_ASSERT(label->getGeometry().w() >= label->getSizeHint().w());
+            }
+        }
     }
 }
-
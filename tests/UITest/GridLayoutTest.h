@@ -21,6 +21,10 @@ namespace ftk
                 const std::shared_ptr<Context>&);
 
             void run() override;
+
+        private:
+            void _layout();
+            void _update();
         };
     }
 }
@@ -44,6 +44,22 @@ namespace ftk
                     out->_init(context, "Widget", parent);
                     return out;
                 }
+
+                void setTickEnabled(bool value)
+                {
+                    _setTickEnabled(value);
+                }
+
+                void tickEvent(
+                    bool parentsVisible,
+                    bool parentsEnabled,
+                    const TickEvent& event) override
+                {
+                    IWidget::tickEvent(parentsVisible, parentsEnabled, event);
+                    ++ticks;
+                }
+
+                size_t ticks = 0;
             };
         }
 
@@ -108,6 +124,62 @@ namespace ftk
                 FTK_ASSERT(0 == layout->getChildIndex(widget2));
                 FTK_ASSERT(1 == layout->getChildIndex(widget0));
                 FTK_ASSERT(2 == layout->getChildIndex(widget1));
+
+                widget0->setSizeUpdate();
+                FTK_ASSERT(widget0->hasSizeUpdate());
+                FTK_ASSERT(!layout->hasSizeUpdate());
+                FTK_ASSERT(layout->hasSizeUpdate(true));
+                FTK_ASSERT(window->hasSizeUpdate(true));
+                app->tick();
+                FTK_ASSERT(!widget0->hasSizeUpdate());
+                FTK_ASSERT(!window->hasSizeUpdate(true));
+
+                widget1->setDrawUpdate();
+                FTK_ASSERT(widget1->hasDrawUpdate());
+                FTK_ASSERT(!layout->hasDrawUpdate());
+                FTK_ASSERT(layout->hasDrawUpdate(true));
+                FTK_ASSERT(window->hasDrawUpdate(true));
+                app->tick();
+                FTK_ASSERT(!window->hasDrawUpdate(true));
+
+                layout->setDrawUpdate();
+                app->tick();
+                const Box2I& g = layout->getGeometry();
+                const Box2I& windowGeometry = window->getGeometry();
+                FTK_ASSERT(window->getDamagedPixelCount() ==
+                    static_cast<size_t>(g.w()) * g.h());
+                FTK_ASSERT(window->getDamagedPixelCount() <
+                    static_cast<size_t>(windowGeometry.w()) * windowGeometry.h());
+                app->tick();
+                FTK_ASSERT(0 == window->getDamagedPixelCount());
+
+                app->tick();
+                FTK_ASSERT(0 == widget0->ticks);
+                widget0->setTickEnabled(true);
+                app->tick();
+                FTK_ASSERT(1 == widget0->ticks);
+                FTK_ASSERT(0 == widget1->ticks);
+                widget0->setParent(nullptr);
+                app->tick();
+                FTK_ASSERT(1 == widget0->ticks);
+                widget0->setParent(layout);
+                app->tick();
+                FTK_ASSERT(2 == widget0->ticks);
+                widget0->setTickEnabled(false);
+                app->tick();
+                FTK_ASSERT(2 == widget0->ticks);
+
+                auto widget3 = Widget::create(context, widget0);
+                FTK_ASSERT(widget3->isVisible(true));
+                layout->hide();
+                FTK_ASSERT(!widget0->isVisible(true));
+                FTK_ASSERT(!widget3->isVisible(true));
+                layout->show();
+                FTK_ASSERT(widget3->isVisible(true));
+                widget0->setEnabled(false);
+                FTK_ASSERT(!widget3->isEnabled(true));
+                widget3->setParent(layout);
+                FTK_ASSERT(widget3->isEnabled(true));
             }
         }
     }
@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <UITest/ListViewTest.h>
+
+#include <ftk/UI/ListViewPrivate.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Format.h>
+
+#include <chrono>
+#include <numeric>
+
+namespace ftk
+{
+    namespace ui_test
+    {
+        ListViewTest::ListViewTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::ui_test::ListViewTest")
+        {}
+
+        ListViewTest::~ListViewTest()
+        {}
+
+        std::shared_ptr<ListViewTest> ListViewTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<ListViewTest>(new ListViewTest(context));
+        }
+
+        void ListViewTest::run()
+        {
+            _index();
+            if (auto context = _context.lock())
+            {
+                std::vector<std::string> argv;
+                argv.push_back("ListViewTest");
+                auto app = App::create(
+                    context,
+                    argv,
+                    "ListViewTest",
+                    "List view test.");
+                auto window = Window::create(context, "ListViewTest");
+                app->addWindow(window);
+                window->show();
+                app->tick();
+                _test(context, app, window, true);
+                _test(context, app, window, false);
+            }
+        }
+
+        namespace
+        {
+            void compare(const ListViewIndex& index, const std::vector<int>& heights)
+            {
+                FTK_ASSERT(heights.size() == index.getCount());
+                int offset = 0;
+                for (size_t i = 0; i < heights.size(); ++i)
+                {
+                    FTK_ASSERT(heights[i] == index.getHeight(i));
+                    FTK_ASSERT(offset == index.getOffset(i));
+                    if (heights[i] > 0)
+                    {
+                        FTK_ASSERT(i == index.find(offset));
+                        FTK_ASSERT(i == index.find(offset + heights[i] - 1));
+                    }
+                    offset += heights[i];
+                }
+                FTK_ASSERT(offset == index.getTotal());
+                FTK_ASSERT(offset == index.getOffset(heights.size()));
+            }
+
+            size_t countWidgets(const std::shared_ptr<IWidget>& widget, bool visible)
+            {
+                size_t out = 0;
+                for (const auto& child : widget->getChildren())
+                {
+                    if (!visible || child->isVisible(false))
+                    {
+                        out += 1 + countWidgets(child, visible);
+                    }
+                }
+                return out;
+            }
+        }
+
+        void ListViewTest::_index()
+        {
+            ListViewIndex index;
+            index.setUniform(10, 20);
+            FTK_ASSERT(index.isUniform());
+            FTK_ASSERT(10 == index.getCount());
+            FTK_ASSERT(20 == index.getHeight(5));
+            FTK_ASSERT(100 == index.getOffset(5));
+            FTK_ASSERT(200 == index.getTotal());
+            FTK_ASSERT(5 == index.find(100));
+            FTK_ASSERT(5 == index.find(119));
+            FTK_ASSERT(0 == index.find(-10));
+            FTK_ASSERT(9 == index.find(1000));
+            index.insert(0, 5);
+            FTK_ASSERT(15 == index.getCount());
+            index.remove(10, 10);
+            FTK_ASSERT(10 == index.getCount());
+
+            // Rows with different heights.
+            std::vector<int> heights(1000, 20);
+            index.setVariable(heights.size(), 20);
+            FTK_ASSERT(!index.isUniform());
+            compare(index, heights);
+            for (size_t i = 0; i < heights.size(); ++i)
+            {
+                heights[i] = (i * 7) % 31;
+                index.setHeight(i, heights[i]);
+            }
+            compare(index, heights);
+            FTK_ASSERT(0 == index.find(-10));
+            FTK_ASSERT(heights.size() - 1 == index.find(index.getTotal() + 10));
+
+            // Inserting and removing rows keeps the measured heights.
+            index.insert(100, 50);
+            heights.insert(heights.begin() + 100, 50, 20);
+            compare(index, heights);
+            index.insert(0, 3);
+            heights.insert(heights.begin(), 3, 20);
+            index.insert(index.getCount(), 2);
+            heights.insert(heights.end(), 2, 20);
+            compare(index, heights);
+            index.remove(10, 200);
+            heights.erase(heights.begin() + 10, heights.begin() + 210);
+            compare(index, heights);
+            index.setHeight(10, 100);
+            heights[10] = 100;
+            compare(index, heights);
+            index.remove(0, index.getCount());
+            FTK_ASSERT(0 == index.getCount());
+            FTK_ASSERT(0 == index.getTotal());
+            FTK_ASSERT(0 == index.find(10));
+            index.insert(0, 4);
+            compare(index, std::vector<int>(4, 20));
+        }
+
+        void ListViewTest::_test(
+            const std::shared_ptr<Context>& context,
+            const std::shared_ptr<App>& app,
+            const std::shared_ptr<Window>& window,
+            bool uniformRowHeights)
+        {
+            std::vector<ListItem> items;
+            for (size_t i = 0; i < 100000; ++i)
+            {
+                items.push_back(ListItem(Format("Item {0}").arg(i)));
+            }
+            auto list = ObservableList<ListItem>::create(items);
+            const auto t0 = std::chrono::steady_clock::now();
+            auto widget = ListView::create(context, list, window);
+            widget->setUniformRowHeights(uniformRowHeights);
+            widget->setUniformRowHeights(uniformRowHeights);
+            FTK_ASSERT(uniformRowHeights == widget->hasUniformRowHeights());
+            FTK_ASSERT(list == widget->getItems());
+            app->tick();
+            app->tick();
+            const auto t1 = std::chrono::steady_clock::now();
+            const std::chrono::duration<float> diff = t1 - t0;
+            _print(Format("Uniform row heights: {0}, items: {1}, time: {2}ms").
+                arg(uniformRowHeights).
+                arg(items.size()).
+                arg(diff.count() * 1000.F, 2));
+
+            const Box2I r0 = widget->getRect(0);
+            FTK_ASSERT(r0.h() > 0);
+            const Box2I r1 = widget->getRect(1);
+            FTK_ASSERT(r1.min.y == r0.min.y + r0.h());
+            const Box2I r2 = widget->getRect(items.size() - 1);
+            FTK_ASSERT(r2.min.y == r0.h() * static_cast<int>(items.size() - 1));
+            FTK_ASSERT(widget->getRect(items.size()) == Box2I());
+
+            int current = -1;
+            widget->setCallback(
+                [&current](int value)
+                {
+                    current = value;
+                });
+            widget->setCurrent(items.size() - 1);
+            FTK_ASSERT(static_cast<int>(items.size()) - 1 == widget->getCurrent());
+            app->tick();
+            widget->setCurrent(items.size() / 2);
+            app->tick();
+            widget->setCurrent(-1);
+            FTK_ASSERT(0 == widget->getCurrent());
+            app->tick();
+
+            // Only the visible rows have widgets.
+            const size_t visibleCount = countWidgets(widget, true);
+            FTK_ASSERT(visibleCount > 0);
+            FTK_ASSERT(visibleCount < 1000);
+            FTK_ASSERT(countWidgets(widget, false) < 1000);
+            widget->setCurrent(items.size() - 1);
+            app->tick();
+            FTK_ASSERT(countWidgets(widget, false) < 1000);
+
+            // Inserting and removing items.
+            list->insertItem(10, ListItem("Insert"));
+            app->tick();
+            FTK_ASSERT(items.size() + 1 == widget->getItems()->getSize());
+            FTK_ASSERT(widget->getRect(items.size()).h() > 0);
+            list->removeItems(10, 20);
+            app->tick();
+            FTK_ASSERT(widget->getRect(items.size() - 9) == Box2I());
+            FTK_ASSERT(widget->getRect(items.size() - 10).h() > 0);
+            list->replaceItems(0, 10, { ListItem("Replace") });
+            app->tick();
+
+            list->pushBack(ListItem("Item"));
+            app->tick();
+            FTK_ASSERT(widget->getRect(items.size() - 18).h() > 0);
+            list->clear();
+            app->tick();
+            FTK_ASSERT(-1 == widget->getCurrent());
+
+            widget->setParent(nullptr);
+        }
+    }
+}
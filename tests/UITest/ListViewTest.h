@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/UI/App.h>
+#include <ftk/UI/Window.h>
+
+#include <TestLib/ITest.h>
+
+namespace ftk
+{
+    namespace ui_test
+    {
+        class ListViewTest : public test::ITest
+        {
+        protected:
+            ListViewTest(const std::shared_ptr<Context>&);
+
+        public:
+            virtual ~ListViewTest();
+
+            static std::shared_ptr<ListViewTest> create(
+                const std::shared_ptr<Context>&);
+
+            void run() override;
+
+        private:
+            void _index();
+            void _test(
+                const std::shared_ptr<Context>&,
+                const std::shared_ptr<App>&,
+                const std::shared_ptr<Window>&,
+                bool uniformRowHeights);
+        };
+    }
+}
@@ -106,6 +106,23 @@ namespace ftk
             window->setSize(Size2I(size.w * 2, size.h * 2));
             app->tick();
             window->setSize(Size2I(1280, 960));
+            app->tick();
+
+            scrollWidget->setScrollTransform(true);
+            scrollWidget->setScrollTransform(true);
+            FTK_ASSERT(scrollWidget->isScrollTransform());
+            scrollWidget->setScrollPos(V2I());
+            app->tick();
+            app->tick();
+            const Box2I g = layout->getGeometry();
+            scrollWidget->setScrollPos(V2I(100, 100));
+            FTK_ASSERT(!window->hasSizeUpdate(true));
+            FTK_ASSERT(window->hasDrawUpdate(true));
+            app->tick();
+            FTK_ASSERT(layout->getGeometry() == g);
+            FTK_ASSERT(layout->getWindowOffset() == -scrollWidget->getScrollPos());
+            scrollWidget->setScrollTransform(false);
+            FTK_ASSERT(layout->getWindowOffset() == V2I());
 
             scrollWidget->setParent(nullptr);
         }
@@ -7,9 +7,12 @@
 #include <ftk/UI/TextEditModel.h>
 
 #include <ftk/Core/Assert.h>
+#include <ftk/Core/FileIO.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/String.h>
 
+#include <thread>
+
 namespace ftk
 {
     namespace ui_test
@@ -650,6 +653,170 @@ namespace ftk
                 FTK_ASSERT(text2[5] == "0123456789");
                 FTK_ASSERT(cursor2 == TextEditPos(3, 0));
             }
+            if (auto context = _context.lock())
+            {
+                auto model = TextEditModel::create(context);
+                std::vector<std::string> text =
+                {
+                    "abc",
+                    "def"
+                };
+                model->setText(text);
+
+                bool hasUndo = false;
+                bool hasRedo = false;
+                auto undoObserver = ValueObserver<bool>::create(
+                    model->observeHasUndo(),
+                    [&hasUndo](bool value)
+                    {
+                        hasUndo = value;
+                    });
+                auto redoObserver = ValueObserver<bool>::create(
+                    model->observeHasRedo(),
+                    [&hasRedo](bool value)
+                    {
+                        hasRedo = value;
+                    });
+                FTK_ASSERT(!hasUndo);
+                FTK_ASSERT(!hasRedo);
+
+                model->setCursor(TextEditPos(0, 3));
+                model->input("1");
+                model->input("2");
+                model->input("3");
+                FTK_ASSERT("abc123" == model->getText()[0]);
+                FTK_ASSERT(hasUndo);
+                model->key(Key::Return);
+                FTK_ASSERT(3 == model->getText().size());
+                model->setSelection(TextEditSelection(
+                    TextEditPos(0, 1),
+                    TextEditPos(2, 1)));
+                model->key(Key::Delete);
+                FTK_ASSERT(std::vector<std::string>({ "aef" }) == model->getText());
+                FTK_ASSERT(TextEditPos(0, 1) == model->getCursor());
+
+                model->undo();
+                FTK_ASSERT(std::vector<std::string>({ "abc123", "", "def" }) == model->getText());
+                FTK_ASSERT(TextEditSelection(TextEditPos(0, 1), TextEditPos(2, 1)) == model->getSelection());
+                FTK_ASSERT(hasRedo);
+                model->undo();
+                FTK_ASSERT(std::vector<std::string>({ "abc123", "def" }) == model->getText());
+                FTK_ASSERT(TextEditPos(0, 6) == model->getCursor());
+                model->key(Key::Z, static_cast<int>(KeyModifier::Control));
+                FTK_ASSERT(text == model->getText());
+                FTK_ASSERT(TextEditPos(0, 3) == model->getCursor());
+                FTK_ASSERT(!hasUndo);
+                model->undo();
+                FTK_ASSERT(text == model->getText());
+
+                model->redo();
+                FTK_ASSERT("abc123" == model->getText()[0]);
+                model->key(Key::Y, static_cast<int>(KeyModifier::Control));
+                model->redo();
+                FTK_ASSERT(std::vector<std::string>({ "aef" }) == model->getText());
+                FTK_ASSERT(!hasRedo);
+
+                model->undo();
+                model->input("4");
+                FTK_ASSERT(!hasRedo);
+                model->undo();
+                FTK_ASSERT(std::vector<std::string>({ "abc123", "", "def" }) == model->getText());
+
+                model->setText(text);
+                FTK_ASSERT(!hasUndo);
+                FTK_ASSERT(!hasRedo);
+
+                // The oldest edits are removed from the undo history.
+                model->setCursor(TextEditPos(0, 0));
+                for (size_t i = 0; i < textEditUndoMax + 1; ++i)
+                {
+                    model->key(Key::Return);
+                }
+                for (size_t i = 0; i < textEditUndoMax; ++i)
+                {
+                    model->undo();
+                }
+                FTK_ASSERT(!hasUndo);
+                FTK_ASSERT(text.size() + 1 == model->getText().size());
+            }
+            if (auto context = _context.lock())
+            {
+                const std::filesystem::path path =
+                    std::filesystem::temp_directory_path() / "TextEditModelTest.txt";
+                std::vector<std::string> text;
+                for (size_t i = 0; i < 200000; ++i)
+                {
+                    text.push_back("Line " + std::to_string(i));
+                }
+                writeLines(path, text);
+
+                auto model = TextEditModel::create(context, MappedText::create(path));
+                FTK_ASSERT(model->isMapped());
+                FTK_ASSERT(model->getLineCount() > 0);
+                FTK_ASSERT(text[0] == model->getLine(0));
+                if (model->isReadOnly())
+                {
+                    // Edits are ignored and don't move the cursor while the
+                    // model is read only.
+                    model->setCursor(TextEditPos(0, 4));
+                    model->input("X");
+                    model->key(Key::Return);
+                    FTK_ASSERT(text[0] == model->getLine(0));
+                    FTK_ASSERT(TextEditPos(0, 4) == model->getCursor());
+                    FTK_ASSERT(!model->observeHasUndo()->get());
+                }
+                std::vector<ObservableListChange> changes;
+                auto observer = ValueObserver<ObservableListChange>::create(
+                    model->observeLines(),
+                    [&changes](const ObservableListChange& value)
+                    {
+                        changes.push_back(value);
+                    },
+                    ObserverAction::Suppress);
+                while (model->isReadOnly())
+                {
+                    context->tick();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+                FTK_ASSERT(text.size() == model->getLineCount());
+                for (const auto& change : changes)
+                {
+                    FTK_ASSERT(0 == change.removed);
+                }
+                FTK_ASSERT(text[text.size() - 1] == model->getLine(text.size() - 1));
+
+                changes.clear();
+                model->setCursor(TextEditPos(1000, 4));
+                model->input("X");
+                FTK_ASSERT("LineX 1000" == model->getLine(1000));
+                FTK_ASSERT(1 == changes.size());
+                FTK_ASSERT(ObservableListChange({ 1000, 1, 1 }) == changes.back());
+                model->key(Key::Return);
+                FTK_ASSERT(text.size() + 1 == model->getLineCount());
+                FTK_ASSERT("LineX" == model->getLine(1000));
+                FTK_ASSERT(" 1000" == model->getLine(1001));
+                FTK_ASSERT(text[1001] == model->getLine(1002));
+                model->setSelection(TextEditSelection(
+                    TextEditPos(10, 0),
+                    TextEditPos(100000, 0)));
+                model->key(Key::Delete);
+                FTK_ASSERT(text.size() + 1 - 99990 == model->getLineCount());
+                FTK_ASSERT(text[99999] == model->getLine(10));
+                model->undo();
+                model->undo();
+                model->undo();
+                FTK_ASSERT(text.size() == model->getLineCount());
+                FTK_ASSERT(text == model->getText());
+                model->redo();
+                FTK_ASSERT("LineX 1000" == model->getLine(1000));
+
+                model->setText({ "abc" });
+                FTK_ASSERT(1 == model->getLineCount());
+                FTK_ASSERT(!model->isReadOnly());
+                FTK_ASSERT(!model->isMapped());
+                model.reset();
+                std::filesystem::remove(path);
+            }
         }
     }
 }
@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <UITest/TextEditTest.h>
+
+#include <ftk/UI/App.h>
+#include <ftk/UI/RowLayout.h>
+#include <ftk/UI/TextEditPrivate.h>
+#include <ftk/UI/Window.h>
+
+#include <ftk/Core/Assert.h>
+
+namespace ftk
+{
+    namespace ui_test
+    {
+        TextEditTest::TextEditTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::ui_test::TextEditTest")
+        {}
+
+        TextEditTest::~TextEditTest()
+        {}
+
+        std::shared_ptr<TextEditTest> TextEditTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<TextEditTest>(new TextEditTest(context));
+        }
+                
+        void TextEditTest::run()
+        {
+            _lineIndex();
+            _widget();
+        }
+
+        void TextEditTest::_lineIndex()
+        {
+            TextEditLineIndex index;
+            FTK_ASSERT(0 == index.getSize());
+            FTK_ASSERT(0 == index.getMaxWidth());
+
+            index.replace(0, 0, { 1, 5, 3 });
+            FTK_ASSERT(3 == index.getSize());
+            FTK_ASSERT(5 == index.getWidth(1));
+            FTK_ASSERT(5 == index.getMaxWidth());
+
+            index.setWidth(2, 10);
+            FTK_ASSERT(10 == index.getMaxWidth());
+            index.setWidth(2, 2);
+            FTK_ASSERT(5 == index.getMaxWidth());
+
+            index.replace(1, 1, { 4, 4, 4, 4 });
+            FTK_ASSERT(6 == index.getSize());
+            FTK_ASSERT(4 == index.getMaxWidth());
+            FTK_ASSERT(2 == index.getWidth(5));
+
+            index.replace(0, 6, {});
+            FTK_ASSERT(0 == index.getSize());
+            FTK_ASSERT(0 == index.getMaxWidth());
+
+            std::vector<int> widths;
+            for (int i = 0; i < 1000; ++i)
+            {
+                widths.push_back(i % 100);
+            }
+            index.replace(0, 0, widths);
+            FTK_ASSERT(99 == index.getMaxWidth());
+            for (size_t i = 99; i < widths.size(); i += 100)
+            {
+                index.setWidth(i, 0);
+            }
+            FTK_ASSERT(98 == index.getMaxWidth());
+            index.clear();
+            FTK_ASSERT(0 == index.getSize());
+
+            // Insert and remove lines, and find the lines that have not
+            // been measured.
+            index.replace(0, 0, { 1, -1, 2, -1 });
+            FTK_ASSERT(1 == index.findUnmeasured(0));
+            FTK_ASSERT(1 == index.findUnmeasured(1));
+            FTK_ASSERT(3 == index.findUnmeasured(2));
+            FTK_ASSERT(4 == index.findUnmeasured(4));
+            index.setWidth(1, 3);
+            index.setWidth(3, 3);
+            FTK_ASSERT(4 == index.findUnmeasured(0));
+            widths.clear();
+            for (int i = 0; i < 4; ++i)
+            {
+                widths.push_back(index.getWidth(i));
+            }
+            for (size_t i = 0; i < 200; ++i)
+            {
+                const size_t pos = (i * 37) % (widths.size() + 1);
+                const size_t removed = std::min(i % 5, widths.size() - pos);
+                const std::vector<int> added(i % 7, 0 == i % 3 ? -1 : static_cast<int>(i));
+                index.replace(pos, removed, added);
+                widths.erase(widths.begin() + pos, widths.begin() + pos + removed);
+                widths.insert(widths.begin() + pos, added.begin(), added.end());
+                FTK_ASSERT(widths.size() == index.getSize());
+                int maxWidth = 0;
+                for (size_t j = 0; j < widths.size(); ++j)
+                {
+                    FTK_ASSERT(widths[j] == index.getWidth(j));
+                    maxWidth = 0 == j ? widths[j] : std::max(maxWidth, widths[j]);
+                }
+                FTK_ASSERT(maxWidth == index.getMaxWidth());
+                size_t unmeasured = widths.size();
+                for (size_t j = widths.size(); j > 0; --j)
+                {
+                    if (widths[j - 1] < 0)
+                    {
+                        unmeasured = j - 1;
+                    }
+                    FTK_ASSERT(unmeasured == index.findUnmeasured(j - 1));
+                }
+            }
+        }
+
+        void TextEditTest::_widget()
+        {
+            if (auto context = _context.lock())
+            {
+                std::vector<std::string> argv;
+                argv.push_back("TextEditTest");
+                auto app = App::create(
+                    context,
+                    argv,
+                    "TextEditTest",
+                    "Text edit test.");
+                auto window = Window::create(context, "TextEditTest");
+                auto layout = VerticalLayout::create(context, window);
+                layout->setMarginRole(SizeRole::MarginLarge);
+                app->addWindow(window);
+                window->show();
+                app->tick();
+
+                auto edit = TextEdit::create(context, nullptr, layout);
+                std::vector<std::string> text;
+                for (size_t i = 0; i < 100000; ++i)
+                {
+                    text.push_back(std::string(i % 80, 'a'));
+                }
+                edit->setText(text);
+                FTK_ASSERT(text == edit->getText());
+                app->tick();
+
+                size_t textCount = 0;
+                edit->setTextCallback(
+                    [&textCount](const std::vector<std::string>& value)
+                    {
+                        textCount = value.size();
+                    });
+                std::vector<ObservableListChange> changes;
+                edit->setLinesCallback(
+                    [&changes](const ObservableListChange& value)
+                    {
+                        changes.push_back(value);
+                    });
+
+                auto model = edit->getModel();
+                model->setCursor(TextEditPos(50000, 0));
+                model->input("Test");
+                app->tick();
+                FTK_ASSERT(text.size() == textCount);
+                FTK_ASSERT(1 == changes.size());
+                FTK_ASSERT(ObservableListChange({ 50000, 1, 1 }) == changes.back());
+                model->setCursor(TextEditPos(50000, 0));
+                model->key(Key::Return);
+                app->tick();
+                FTK_ASSERT(100001 == edit->getText().size());
+                FTK_ASSERT(100001 == textCount);
+                model->key(Key::Backspace);
+                app->tick();
+                FTK_ASSERT(100000 == edit->getText().size());
+
+                model->setSelection(TextEditSelection(
+                    TextEditPos(10, 0),
+                    TextEditPos(90000, 0)));
+                app->tick();
+                model->key(Key::Delete);
+                app->tick();
+                FTK_ASSERT(10010 == edit->getText().size());
+
+                edit->setText({});
+                app->tick();
+                FTK_ASSERT(1 == edit->getText().size());
+            }
+        }
+    }
+}
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <TestLib/ITest.h>
+
+namespace ftk
+{
+    namespace ui_test
+    {
+        class TextEditTest : public test::ITest
+        {
+        protected:
+            TextEditTest(const std::shared_ptr<Context>&);
+
+        public:
+            virtual ~TextEditTest();
+
+            static std::shared_ptr<TextEditTest> create(
+                const std::shared_ptr<Context>&);
+
+            void run() override;
+
+        private:
+            void _lineIndex();
+            void _widget();
+        };
+    }
+}
+
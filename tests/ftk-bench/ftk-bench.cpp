@@ -0,0 +1,419 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include "ftk-bench.h"
+
+#if defined(FTK_UI_LIB) && (defined(FTK_API_GL_4_1) || defined(FTK_API_GLES_2))
+#include <ftk/UI/App.h>
+#include <ftk/UI/GridLayout.h>
+#include <ftk/UI/Init.h>
+#include <ftk/UI/Label.h>
+#include <ftk/UI/Window.h>
+
+#include <ftk/GL/Init.h>
+#endif // FTK_UI_LIB
+
+#include <ftk/Core/CmdLine.h>
+#include <ftk/Core/Context.h>
+#include <ftk/Core/FontSystem.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/LRUCache.h>
+#include <ftk/Core/RasterCache.h>
+#include <ftk/Core/SoftwareRender.h>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+namespace ftk
+{
+    namespace tests
+    {
+        struct BenchApp::Private
+        {
+            std::shared_ptr<CmdLineValueOption<int> > width;
+            std::shared_ptr<CmdLineValueOption<int> > height;
+            std::shared_ptr<CmdLineValueOption<int> > iterations;
+            std::shared_ptr<CmdLineValueOption<int> > threads;
+
+            Size2I size;
+            int iterationCount = 1;
+            size_t threadCount = 0;
+        };
+
+        void BenchApp::_init(
+            const std::shared_ptr<Context>& context,
+            std::vector<std::string>& argv)
+        {
+            FTK_P();
+            p.width = CmdLineValueOption<int>::create(
+                { "-width" },
+                "Image width.",
+                std::string(),
+                3840);
+            p.height = CmdLineValueOption<int>::create(
+                { "-height" },
+                "Image height.",
+                std::string(),
+                2160);
+            p.iterations = CmdLineValueOption<int>::create(
+                { "-iterations" },
+                "Number of iterations for each benchmark.",
+                std::string(),
+                10);
+            p.threads = CmdLineValueOption<int>::create(
+                { "-threads" },
+                "Number of threads, zero uses the hardware concurrency.",
+                std::string(),
+                0);
+            IApp::_init(
+                context,
+                argv,
+                "ftk-bench",
+                "Image conversion, resizing, cache, rendering, and layout benchmarks",
+                {},
+                { p.width, p.height, p.iterations, p.threads });
+#if defined(FTK_UI_LIB) && (defined(FTK_API_GL_4_1) || defined(FTK_API_GLES_2))
+            gl::init(context);
+            uiInit(context);
+#endif // FTK_UI_LIB
+        }
+
+        BenchApp::BenchApp() :
+            _p(new Private)
+        {}
+
+        BenchApp::~BenchApp()
+        {}
+
+        std::shared_ptr<BenchApp> BenchApp::create(
+            const std::shared_ptr<Context>& context,
+            std::vector<std::string>& argv)
+        {
+            auto out = std::shared_ptr<BenchApp>(new BenchApp);
+            out->_init(context, argv);
+            return out;
+        }
+
+        void BenchApp::run()
+        {
+            FTK_P();
+            p.size = Size2I(
+                std::max(p.width->getValue(), 2),
+                std::max(p.height->getValue(), 2));
+            p.iterationCount = std::max(p.iterations->getValue(), 1);
+            p.threadCount = std::max(p.threads->getValue(), 0);
+            IApp::_print(Format("Size: {0}").arg(p.size));
+            IApp::_print(Format("Iterations: {0}").arg(p.iterationCount));
+            IApp::_print(Format("SIMD: {0}").arg(getImageConvertSIMD()));
+
+            _convert(ImageType::L_U8, ImageType::RGBA_U8);
+            ImageConvertOptions options;
+            options.luminanceToAlpha = true;
+            _convert(ImageType::L_U8, ImageType::RGBA_U8, options);
+            options = ImageConvertOptions();
+            options.bgr = true;
+            options.alpha = ImageAlphaConvert::Premultiply;
+            _convert(ImageType::RGBA_U8, ImageType::RGBA_U8, options);
+            _convert(ImageType::RGB_U8, ImageType::RGBA_U8);
+            _convert(ImageType::RGBA_U8, ImageType::RGBA_F32);
+            _convert(ImageType::RGBA_F32, ImageType::RGBA_U8);
+            _convert(ImageType::RGBA_F16, ImageType::RGBA_U8);
+            _convert(ImageType::RGBA_U16, ImageType::RGBA_F16);
+            _convert(ImageType::RGB_U10, ImageType::RGBA_U8);
+            _convert(ImageType::YUV_420P_U8, ImageType::RGBA_U8);
+
+            for (auto filter : getImageResizeFilterEnums())
+            {
+                _resize(ImageType::RGBA_U8, filter);
+            }
+            _resize(ImageType::RGBA_F32, ImageResizeFilter::Bilinear);
+
+            _lruCache();
+            _rasterCache();
+            _softwareRender();
+            _gridLayout();
+        }
+
+        void BenchApp::_convert(
+            ImageType inType,
+            ImageType outType,
+            const ImageConvertOptions& options)
+        {
+            FTK_P();
+            auto in = Image::create(p.size, inType);
+            in->zero();
+            auto out = Image::create(p.size, outType);
+            for (bool simd : { true, false })
+            {
+                ImageConvertOptions options2 = options;
+                options2.threadCount = p.threadCount;
+                options2.simd = simd;
+                std::stringstream ss;
+                ss << inType << " -> " << outType;
+                if (options.bgr)
+                {
+                    ss << " BGR";
+                }
+                if (options.alpha != ImageAlphaConvert::None)
+                {
+                    ss << " " << options.alpha;
+                }
+                if (options.luminanceToAlpha)
+                {
+                    ss << " LuminanceToAlpha";
+                }
+                ss << (simd ? " SIMD" : " Scalar");
+                _bench(
+                    ss.str(),
+                    p.size.w * p.size.h,
+                    in->getByteCount() + out->getByteCount(),
+                    [in, out, options2]
+                    {
+                        convertImage(in, out, options2);
+                    });
+            }
+        }
+
+        void BenchApp::_resize(ImageType type, ImageResizeFilter filter)
+        {
+            FTK_P();
+            auto in = Image::create(p.size, type);
+            in->zero();
+            const Size2I size(p.size.w / 2, p.size.h / 2);
+            auto out = Image::create(size, type);
+            for (bool simd : { true, false })
+            {
+                ImageResizeOptions options;
+                options.filter = filter;
+                options.threadCount = p.threadCount;
+                options.simd = simd;
+                std::stringstream ss;
+                ss << type << " " << filter << " " << p.size << " -> " << size;
+                ss << (simd ? " SIMD" : " Scalar");
+                _bench(
+                    ss.str(),
+                    p.size.w * p.size.h,
+                    in->getByteCount() + out->getByteCount(),
+                    [in, out, options]
+                    {
+                        resizeImage(in, out, options);
+                    });
+            }
+        }
+
+        void BenchApp::_lruCache()
+        {
+            const int count = 1000000;
+            LRUCache<int, int> c;
+            c.setMax(count / 10);
+
+            auto t0 = std::chrono::steady_clock::now();
+            for (int i = 0; i < count; ++i)
+            {
+                c.add(i, i);
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            std::chrono::duration<double> diff = t1 - t0;
+            IApp::_print(Format("LRU cache add {0} items: {1}ms").
+                arg(count).
+                arg(diff.count() * 1000.0, 2));
+
+            t0 = std::chrono::steady_clock::now();
+            int v = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                c.get(i, v);
+            }
+            t1 = std::chrono::steady_clock::now();
+            diff = t1 - t0;
+            IApp::_print(Format("LRU cache get {0} items: {1}ms").
+                arg(count).
+                arg(diff.count() * 1000.0, 2));
+        }
+
+        void BenchApp::_rasterCache()
+        {
+            const std::filesystem::path path =
+                std::filesystem::temp_directory_path() / "ftk-bench.cache";
+            std::filesystem::remove(path);
+            std::string s;
+            for (char c = '!'; c <= '~'; ++c)
+            {
+                s.push_back(c);
+            }
+            for (int i = 0; i < 2; ++i)
+            {
+                // Simulate a cold and a warm startup with a new font
+                // system and cache each time.
+                auto fontSystem = FontSystem::create(_context);
+                auto cache = RasterCache::create(path);
+                fontSystem->setRasterCache(cache);
+                const auto t0 = std::chrono::steady_clock::now();
+                for (const int size : { 12, 14, 16, 24, 32 })
+                {
+                    fontSystem->getGlyphs(s, FontInfo(getFont(Font::Regular), size));
+                }
+                const auto t1 = std::chrono::steady_clock::now();
+                cache->save();
+                const GlyphStats stats = fontSystem->getGlyphStats(GlyphMode::Bitmap);
+                IApp::_print(Format("{0} startup: {1} glyphs rasterized, {2} glyphs cached, {3}us total, {4}us rasterizing, {5}us reading the cache").
+                    arg(0 == i ? "Cold" : "Warm").
+                    arg(stats.glyphCount).
+                    arg(stats.cacheCount).
+                    arg(std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count()).
+                    arg(stats.time.count()).
+                    arg(stats.cacheTime.count()));
+            }
+            std::filesystem::remove(path);
+        }
+
+        void BenchApp::_softwareRender()
+        {
+            auto render = SoftwareRender::create(_context->getLogSystem());
+            auto fontSystem = _context->getSystem<FontSystem>();
+            const FontInfo fontInfo;
+            const auto fontMetrics = fontSystem->getMetrics(fontInfo);
+            const auto glyphs = fontSystem->getGlyphs("The quick brown fox jumps over the lazy dog", fontInfo);
+            auto icon = Image::create(24, 24, ImageType::RGBA_U8);
+            icon->zero();
+
+            const Size2I size(1920, 1080);
+            const size_t frames = 10;
+            const auto t0 = std::chrono::steady_clock::now();
+            for (size_t frame = 0; frame < frames; ++frame)
+            {
+                render->begin(size);
+                render->setClipRectEnabled(true);
+                render->setClipRect(Box2I(0, 0, size.w, size.h));
+                for (int y = 0; y < size.h; y += 30)
+                {
+                    for (int x = 0; x < size.w; x += 240)
+                    {
+                        render->drawRect(
+                            Box2F(x, y, 230.F, 28.F),
+                            Color4F(.2F, .2F, .2F, 1.F));
+                        render->drawImage(icon, Box2F(x + 2, y + 2, 24.F, 24.F));
+                        render->drawText(
+                            glyphs,
+                            fontMetrics,
+                            V2F(x + 30, y + 4),
+                            Color4F(.9F, .9F, .9F, 1.F));
+                    }
+                }
+                render->end();
+            }
+            const auto t1 = std::chrono::steady_clock::now();
+            const std::chrono::duration<double> diff = t1 - t0;
+            IApp::_print(Format("Software render {0}: {1} frames per second").
+                arg(size).
+                arg(frames / diff.count(), 2));
+        }
+
+        void BenchApp::_gridLayout()
+        {
+#if defined(FTK_UI_LIB) && (defined(FTK_API_GL_4_1) || defined(FTK_API_GLES_2))
+            std::vector<std::string> argv;
+            argv.push_back("ftk-bench");
+            auto app = App::create(
+                _context,
+                argv,
+                "ftk-bench",
+                "Grid layout benchmark.");
+            auto window = Window::create(_context, "ftk-bench");
+            app->addWindow(window);
+            window->show();
+            app->tick();
+
+            // Create a grid of 5,000 widgets.
+            const int rows = 100;
+            const int columns = 50;
+            auto layout = GridLayout::create(_context, window);
+            std::vector<std::shared_ptr<Label> > labels;
+            for (int row = 0; row < rows; ++row)
+            {
+                for (int column = 0; column < columns; ++column)
+                {
+                    auto label = Label::create(
+                        _context,
+                        Format("{0}, {1}").arg(row).arg(column),
+                        layout);
+                    layout->setGridPos(label, row, column);
+                    labels.push_back(label);
+                }
+            }
+            auto t0 = std::chrono::steady_clock::now();
+            app->tick();
+            auto t1 = std::chrono::steady_clock::now();
+            std::chrono::duration<double> diff = t1 - t0;
+            IApp::_print(Format("Grid layout initial: {0}ms").
+                arg(diff.count() * 1000.0, 2));
+
+            // Update a single widget.
+            labels[labels.size() / 2]->setText("The quick brown fox jumps over the lazy dog");
+            t0 = std::chrono::steady_clock::now();
+            app->tick();
+            t1 = std::chrono::steady_clock::now();
+            diff = t1 - t0;
+            IApp::_print(Format("Grid layout single widget: {0}ms").
+                arg(diff.count() * 1000.0, 2));
+
+            // Update all of the widgets.
+            window->setDisplayScale(2.F);
+            t0 = std::chrono::steady_clock::now();
+            app->tick();
+            t1 = std::chrono::steady_clock::now();
+            diff = t1 - t0;
+            IApp::_print(Format("Grid layout all widgets: {0}ms").
+                arg(diff.count() * 1000.0, 2));
+#endif // FTK_UI_LIB
+        }
+
+        void BenchApp::_bench(
+            const std::string& name,
+            size_t pixelCount,
+            size_t byteCount,
+            const std::function<void(void)>& callback)
+        {
+            FTK_P();
+
+            // Run once to warm up the caches and thread pool.
+            callback();
+
+            const auto t0 = std::chrono::steady_clock::now();
+            for (int i = 0; i < p.iterationCount; ++i)
+            {
+                callback();
+            }
+            const auto t1 = std::chrono::steady_clock::now();
+            const std::chrono::duration<double> diff = t1 - t0;
+            const double seconds = diff.count() / p.iterationCount;
+            IApp::_print(Format("{0}: {1}ms, {2} MPixels/s, {3} GB/s").
+                arg(name).
+                arg(seconds * 1000.0, 2).
+                arg(pixelCount / seconds / 1000000.0, 1).
+                arg(byteCount / seconds / 1000000000.0, 2));
+        }
+    }
+}
+
+FTK_MAIN()
+{
+    int r = 0;
+    try
+    {
+        auto context = ftk::Context::create();
+        auto args = ftk::convert(argc, argv);
+        auto app = ftk::tests::BenchApp::create(context, args);
+        r = app->getExit();
+        if (0 == r)
+        {
+            app->run();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "ERROR: " << e.what() << std::endl;
+    }
+    return r;
+}
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/IApp.h>
+#include <ftk/Core/ImageConvert.h>
+#include <ftk/Core/ImageResize.h>
+
+#include <functional>
+
+namespace ftk
+{
+    namespace tests
+    {
+        //! Benchmark application for the image conversion and resizing
+        //! throughput, the caches, the software renderer, and the layout.
+        class BenchApp : public IApp
+        {
+        protected:
+            void _init(
+                const std::shared_ptr<Context>&,
+                std::vector<std::string>& argv);
+
+            BenchApp();
+
+        public:
+            virtual ~BenchApp();
+
+            static std::shared_ptr<BenchApp> create(
+                const std::shared_ptr<Context>&,
+                std::vector<std::string>&);
+
+            void run() override;
+
+        private:
+            void _convert(ImageType, ImageType, const ImageConvertOptions& = ImageConvertOptions());
+            void _resize(ImageType, ImageResizeFilter);
+            void _lruCache();
+            void _rasterCache();
+            void _softwareRender();
+            void _gridLayout();
+            void _bench(
+                const std::string& name,
+                size_t pixelCount,
+                size_t byteCount,
+                const std::function<void(void)>&);
+
+            FTK_PRIVATE();
+        };
+    }
+}
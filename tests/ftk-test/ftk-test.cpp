@@ -36,6 +36,7 @@
 #include <UITest/LabelTest.h>
 #include <UITest/LayoutUtilTest.h>
 #include <UITest/LineEditTest.h>
+#include <UITest/ListViewTest.h>
 #include <UITest/ListWidgetTest.h>
 #include <UITest/MDIWidgetTest.h>
 #include <UITest/MenuBarTest.h>
@@ -53,6 +54,7 @@
 #include <UITest/StyleTest.h>
 #include <UITest/TabWidgetTest.h>
 #include <UITest/TextEditModelTest.h>
+#include <UITest/TextEditTest.h>
 #include <UITest/WidgetOptionsTest.h>
 
 #if defined(FTK_API_GL_4_1) || defined(FTK_API_GLES_2)
@@ -78,9 +80,14 @@
 #include <CoreTest/FileTest.h>
 #include <CoreTest/FontSystemTest.h>
 #include <CoreTest/FormatTest.h>
+#include <CoreTest/ImageCacheTest.h>
+#include <CoreTest/ImageConvertTest.h>
 #include <CoreTest/ImageIOTest.h>
+#include <CoreTest/ImageResizeTest.h>
 #include <CoreTest/ImageTest.h>
+#include <CoreTest/ImplicitTreapTest.h>
 #include <CoreTest/LRUCacheTest.h>
+#include <CoreTest/MappedTextTest.h>
 #include <CoreTest/MathTest.h>
 #include <CoreTest/MatrixTest.h>
 #include <CoreTest/MemoryTest.h>
@@ -90,10 +97,12 @@
 #include <CoreTest/ObservableTest.h>
 #include <CoreTest/PNGTest.h>
 #include <CoreTest/RandomTest.h>
+#include <CoreTest/RasterCacheTest.h>
 #include <CoreTest/RangeTest.h>
 #include <CoreTest/RenderOptionsTest.h>
 #include <CoreTest/RenderUtilTest.h>
 #include <CoreTest/SizeTest.h>
+#include <CoreTest/SoftwareRenderTest.h>
 #include <CoreTest/StringTest.h>
 #include <CoreTest/SystemTest.h>
 #include <CoreTest/TimeTest.h>
@@ -162,9 +171,14 @@ namespace ftk
             p.tests.push_back(core_test::FileTest::create(context));
             p.tests.push_back(core_test::FontSystemTest::create(context));
             p.tests.push_back(core_test::FormatTest::create(context));
+            p.tests.push_back(core_test::ImageCacheTest::create(context));
+            p.tests.push_back(core_test::ImageConvertTest::create(context));
             p.tests.push_back(core_test::ImageIOTest::create(context));
+            p.tests.push_back(core_test::ImageResizeTest::create(context));
             p.tests.push_back(core_test::ImageTest::create(context));
+            p.tests.push_back(core_test::ImplicitTreapTest::create(context));
             p.tests.push_back(core_test::LRUCacheTest::create(context));
+            p.tests.push_back(core_test::MappedTextTest::create(context));
             p.tests.push_back(core_test::MathTest::create(context));
             p.tests.push_back(core_test::MatrixTest::create(context));
             p.tests.push_back(core_test::MemoryTest::create(context));
@@ -174,10 +188,12 @@ namespace ftk
             p.tests.push_back(core_test::ObservableTest::create(context));
             p.tests.push_back(core_test::PNGTest::create(context));
             p.tests.push_back(core_test::RandomTest::create(context));
+            p.tests.push_back(core_test::RasterCacheTest::create(context));
             p.tests.push_back(core_test::RangeTest::create(context));
             p.tests.push_back(core_test::RenderOptionsTest::create(context));
             p.tests.push_back(core_test::RenderUtilTest::create(context));
             p.tests.push_back(core_test::SizeTest::create(context));
+            p.tests.push_back(core_test::SoftwareRenderTest::create(context));
             p.tests.push_back(core_test::StringTest::create(context));
             p.tests.push_back(core_test::SystemTest::create(context));
             p.tests.push_back(core_test::TimeTest::create(context));
@@ -227,6 +243,7 @@ namespace ftk
             p.tests.push_back(ui_test::LabelTest::create(context));
             p.tests.push_back(ui_test::LayoutUtilTest::create(context));
             p.tests.push_back(ui_test::LineEditTest::create(context));
+            p.tests.push_back(ui_test::ListViewTest::create(context));
             p.tests.push_back(ui_test::ListWidgetTest::create(context));
             p.tests.push_back(ui_test::MDIWidgetTest::create(context));
             p.tests.push_back(ui_test::MenuBarTest::create(context));
@@ -244,6 +261,7 @@ namespace ftk
             p.tests.push_back(ui_test::StyleTest::create(context));
             p.tests.push_back(ui_test::TabWidgetTest::create(context));
             p.tests.push_back(ui_test::TextEditModelTest::create(context));
+            p.tests.push_back(ui_test::TextEditTest::create(context));
             p.tests.push_back(ui_test::WidgetOptionsTest::create(context));
 
             p.tests.push_back(ui_test::AppTest::create(context));